@@ -14,6 +14,7 @@
 #define __crc_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* Version infomation */
 
@@ -21,6 +22,10 @@
 #define CRC_V_MINOR                         0
 #define CRC_V_PATCH                         0
 
+/* Configuration information */
+
+#define CRC_SLICE                           8   /**< tables of a table model, 8 processes 8 bytes per step with 8 KB, 1 processes byte by byte with 1 KB */
+
 /* CRC algorithm customization options define */
 typedef struct 
 {
@@ -43,6 +48,32 @@ typedef struct
     uint32_t xorout;
 } crcOptType;
 
+/* Table driven model, prepared by `crc_table_init()`, members are not for external use */
+typedef struct
+{
+    /**< Options of the model */
+    crcOptType opt;
+
+    /**< table[k][i] is the register after byte i followed by k zero bytes is shifted through from 0 */
+    uint32_t table[CRC_SLICE][256];
+} crcTableType;
+
+/* Streaming context, started by `crc_init()` or `crc_init_table()`, members are not for external use */
+typedef struct
+{
+    /**< Options of the model */
+    crcOptType opt;
+
+    /**< Table driving the calculation, NULL when calculated bit by bit */
+    const void *table;
+
+    /**< Engine of the calculation */
+    uint8_t engine;
+
+    /**< Register holding the data fed so far */
+    uint32_t crc;
+} crcCtxType;
+
 /*
 |-------------------------------------------------------------------------------------------------------|
 | index     |CRC name           | width     | refin     | refout    | poly      | init      | xorout    |
@@ -72,10 +103,48 @@ typedef struct
  */
 extern crcOptType crcParaModelTable[21];
 
+/* Index of the models in `crcParaModelTable`, in the order of the table above */
+enum
+{
+    CRC_MODEL_CRC4_ITU = 0,
+    CRC_MODEL_CRC5_EPC,
+    CRC_MODEL_CRC5_ITU,
+    CRC_MODEL_CRC5_USB,
+    CRC_MODEL_CRC6_ITU,
+    CRC_MODEL_CRC7_MMC,
+    CRC_MODEL_CRC8,
+    CRC_MODEL_CRC8_ITU,
+    CRC_MODEL_CRC8_ROHC,
+    CRC_MODEL_CRC8_MAXIM,
+    CRC_MODEL_CRC16_IBM,
+    CRC_MODEL_CRC16_MAXIM,
+    CRC_MODEL_CRC16_USB,
+    CRC_MODEL_CRC16_MODBUS,
+    CRC_MODEL_CRC16_CCITT,
+    CRC_MODEL_CRC16_CCITT_FALSE,
+    CRC_MODEL_CRC16_X25,
+    CRC_MODEL_CRC16_XMODEM,
+    CRC_MODEL_CRC16_DNP,
+    CRC_MODEL_CRC32,
+    CRC_MODEL_CRC32_MPEG_2,
+};
+
 /* Custom universal model, within 32 bits, any customization is possible */
 
 uint32_t crc(uint8_t* data, uint32_t len, const crcOptType * const opt);
 
+/* Table driven universal model, the same results as `crc()`, for repeated use of one customization */
+
+int crc_table_init(crcTableType* table, const crcOptType * const opt);
+uint32_t crc_table(uint8_t* data, uint32_t len, const crcTableType * const table);
+
+/* Streaming model, the data can be fed in chunks as it arrives, the result is the same as over the whole data */
+
+int crc_init(crcCtxType* ctx, const crcOptType * const opt);
+int crc_init_table(crcCtxType* ctx, const crcTableType * const table);
+void crc_update(crcCtxType* ctx, uint8_t* data, uint32_t len);
+uint32_t crc_final(const crcCtxType* ctx);
+
 /* Standard reference model */
 
 uint8_t crc4_itu(uint8_t* data, uint32_t len);
@@ -100,4 +169,22 @@ uint16_t crc16_dnp(uint8_t* data, uint32_t len);
 uint32_t crc32(uint8_t* data, uint32_t len);
 uint32_t crc32_mpeg_2(uint8_t* data, uint32_t len);
 
+#if 0 /* for example */
+static void test(void)
+{
+    crcCtxType ctx;
+    uint8_t frame[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD};
+
+    /* CRC-16/MODBUS fed byte by byte, as received from a serial port */
+    crc_init(&ctx, &crcParaModelTable[CRC_MODEL_CRC16_MODBUS]);
+    for (int i = 0; i < sizeof(frame); i++)
+    {
+        crc_update(&ctx, &frame[i], 1);
+    }
+
+    /* Including the check bytes, a correct frame leaves 0 */
+    printf("%04X\n", crc_final(&ctx));
+}
+#endif
+
 #endif 
@@ -0,0 +1,489 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fbank.c
+ *         \unit  fbank
+ *        \brief  This is a C language filter bank, biquad and FIR filters over many channels
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fbank.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI                                3.14159265358979323846
+#endif
+
+/* Vector of 4 floats, one lane per channel */
+#if FBANK_USE_SSE
+#include <xmmintrin.h>
+#define FBANK_USE_VECTOR                    1
+typedef __m128 vfloat;
+#define vload(p)                            _mm_loadu_ps(p)
+#define vstore(p, v)                        _mm_storeu_ps(p, v)
+#define vdup(x)                             _mm_set1_ps(x)
+#define vzero()                             _mm_setzero_ps()
+#define vadd(a, b)                          _mm_add_ps(a, b)
+#define vsub(a, b)                          _mm_sub_ps(a, b)
+#define vmul(a, b)                          _mm_mul_ps(a, b)
+#elif FBANK_USE_NEON
+#include <arm_neon.h>
+#define FBANK_USE_VECTOR                    1
+typedef float32x4_t vfloat;
+#define vload(p)                            vld1q_f32(p)
+#define vstore(p, v)                        vst1q_f32(p, v)
+#define vdup(x)                             vdupq_n_f32(x)
+#define vzero()                             vdupq_n_f32(0.0f)
+#define vadd(a, b)                          vaddq_f32(a, b)
+#define vsub(a, b)                          vsubq_f32(a, b)
+#define vmul(a, b)                          vmulq_f32(a, b)
+#else
+#define FBANK_USE_VECTOR                    0
+#endif
+
+static int16_t sat16(int64_t x)
+{
+    if (x > INT16_MAX) return INT16_MAX;
+    if (x < INT16_MIN) return INT16_MIN;
+    return (int16_t)x;
+}
+
+static int32_t sat32(int64_t x)
+{
+    if (x > INT32_MAX) return INT32_MAX;
+    if (x < INT32_MIN) return INT32_MIN;
+    return (int32_t)x;
+}
+
+/* Convert to fixed point with `bits` fraction bits, rounded and saturated */
+static int64_t fixed(double x, int bits)
+{
+    return (int64_t)floor(ldexp(x, bits) + 0.5);
+}
+
+/* The bilinear transform of the cookbook, shared by the designs */
+static int design_check(double fs, double f0, double q, double *w0, double *alpha)
+{
+    if (fs <= 0 || f0 <= 0 || f0 >= fs / 2 || q <= 0) return 0;
+
+    *w0 = 2 * M_PI * f0 / fs;
+    *alpha = sin(*w0) / (2 * q);
+
+    return 1;
+}
+
+int fbank_design_lowpass(fbank_coef_t *coef, double fs, double f0, double q)
+{
+    double w0, alpha, a0;
+
+    if (!coef) return 0;
+    if (!design_check(fs, f0, q, &w0, &alpha)) return 0;
+
+    a0 = 1 + alpha;
+    coef->b0 = (1 - cos(w0)) / 2 / a0;
+    coef->b1 = (1 - cos(w0)) / a0;
+    coef->b2 = coef->b0;
+    coef->a1 = -2 * cos(w0) / a0;
+    coef->a2 = (1 - alpha) / a0;
+
+    return 1;
+}
+
+int fbank_design_highpass(fbank_coef_t *coef, double fs, double f0, double q)
+{
+    double w0, alpha, a0;
+
+    if (!coef) return 0;
+    if (!design_check(fs, f0, q, &w0, &alpha)) return 0;
+
+    a0 = 1 + alpha;
+    coef->b0 = (1 + cos(w0)) / 2 / a0;
+    coef->b1 = -(1 + cos(w0)) / a0;
+    coef->b2 = coef->b0;
+    coef->a1 = -2 * cos(w0) / a0;
+    coef->a2 = (1 - alpha) / a0;
+
+    return 1;
+}
+
+int fbank_design_notch(fbank_coef_t *coef, double fs, double f0, double q)
+{
+    double w0, alpha, a0;
+
+    if (!coef) return 0;
+    if (!design_check(fs, f0, q, &w0, &alpha)) return 0;
+
+    a0 = 1 + alpha;
+    coef->b0 = 1 / a0;
+    coef->b1 = -2 * cos(w0) / a0;
+    coef->b2 = coef->b0;
+    coef->a1 = coef->b1;
+    coef->a2 = (1 - alpha) / a0;
+
+    return 1;
+}
+
+int fbank_design_fir_lowpass(double *taps, int count, double fs, double fc)
+{
+    int i;
+    double m, x, sum = 0.0;
+
+    if (!taps) return 0;
+    if (count <= 0) return 0;
+    if (fs <= 0 || fc <= 0 || fc >= fs / 2) return 0;
+
+    m = (count - 1) / 2.0;
+    for (i = 0; i < count; i++)
+    {
+        x = i - m;
+        taps[i] = (x == 0) ? 2 * fc / fs : sin(2 * M_PI * fc / fs * x) / (M_PI * x);
+        if (count > 1) taps[i] *= 0.54 - 0.46 * cos(2 * M_PI * i / (count - 1));
+        sum += taps[i];
+    }
+
+    /* Unit gain at DC */
+    for (i = 0; i < count; i++) taps[i] /= sum;
+
+    return 1;
+}
+
+int fbank_biquad_init(fbank_biquad_t *bank, int format, int channels, int stages, const fbank_coef_t *coef, void *buffer)
+{
+    int i;
+    float *f;
+    int16_t *q15;
+    int32_t *q31;
+
+    /* Check the validity of input parameters */
+    if (!bank || !coef || !buffer) return 0;
+    if (channels <= 0 || stages <= 0) return 0;
+    if (format != FBANK_F32 && format != FBANK_Q15 && format != FBANK_Q31) return 0;
+
+    bank->coef = buffer;
+    bank->state = (char *)buffer + stages * 5 * 4;
+    bank->channels = channels;
+    bank->stages = stages;
+    bank->format = format;
+
+    /* Coefficients in the order b0, b1, b2, a1, a2 for each stage */
+    for (i = 0; i < stages; i++)
+    {
+        if (format == FBANK_F32)
+        {
+            f = (float *)bank->coef + i * 5;
+            f[0] = (float)coef[i].b0;
+            f[1] = (float)coef[i].b1;
+            f[2] = (float)coef[i].b2;
+            f[3] = (float)coef[i].a1;
+            f[4] = (float)coef[i].a2;
+        }
+        else if (format == FBANK_Q15)
+        {
+            q15 = (int16_t *)bank->coef + i * 5;
+            q15[0] = sat16(fixed(coef[i].b0, 14));
+            q15[1] = sat16(fixed(coef[i].b1, 14));
+            q15[2] = sat16(fixed(coef[i].b2, 14));
+            q15[3] = sat16(fixed(coef[i].a1, 14));
+            q15[4] = sat16(fixed(coef[i].a2, 14));
+        }
+        else
+        {
+            q31 = (int32_t *)bank->coef + i * 5;
+            q31[0] = sat32(fixed(coef[i].b0, 30));
+            q31[1] = sat32(fixed(coef[i].b1, 30));
+            q31[2] = sat32(fixed(coef[i].b2, 30));
+            q31[3] = sat32(fixed(coef[i].a1, 30));
+            q31[4] = sat32(fixed(coef[i].a2, 30));
+        }
+    }
+
+    /* Float stages keep z1, z2 of the transposed direct form II, fixed point stages keep x1, x2, y1, y2
+     * of the direct form I, where the state stays in the sample format without overflow */
+    memset(bank->state, 0, stages * 4 * channels * 4);
+
+    return 1;
+}
+
+void fbank_biquad_f32(fbank_biquad_t *bank, const float *in, float *out, int frames)
+{
+    int s, f, c, n;
+    const float *k, *src = in;
+    float *z1, *z2;
+    float x, y;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_F32) return;
+
+    n = bank->channels;
+
+    /* Stage by stage over all frames, the first stage reads the input and the others filter the output in place */
+    for (s = 0; s < bank->stages; s++)
+    {
+        k = (const float *)bank->coef + s * 5;
+        z1 = (float *)bank->state + s * 2 * n;
+        z2 = z1 + n;
+        c = 0;
+
+#if FBANK_USE_VECTOR
+        {
+            vfloat b0 = vdup(k[0]), b1 = vdup(k[1]), b2 = vdup(k[2]), a1 = vdup(k[3]), a2 = vdup(k[4]);
+            vfloat vx, vy, v1, v2;
+
+            /* The state of 4 channels stays in registers through the frames */
+            for (; c + 4 <= n; c += 4)
+            {
+                v1 = vload(z1 + c);
+                v2 = vload(z2 + c);
+                for (f = 0; f < frames; f++)
+                {
+                    vx = vload(src + f * n + c);
+                    vy = vadd(vmul(b0, vx), v1);
+                    v1 = vadd(vsub(vmul(b1, vx), vmul(a1, vy)), v2);
+                    v2 = vsub(vmul(b2, vx), vmul(a2, vy));
+                    vstore(out + f * n + c, vy);
+                }
+                vstore(z1 + c, v1);
+                vstore(z2 + c, v2);
+            }
+        }
+#endif
+
+        /* The rest of the channels */
+        if (c < n)
+        {
+            for (f = 0; f < frames; f++)
+            {
+                int i;
+                for (i = c; i < n; i++)
+                {
+                    x = src[f * n + i];
+                    y = k[0] * x + z1[i];
+                    z1[i] = k[1] * x - k[3] * y + z2[i];
+                    z2[i] = k[2] * x - k[4] * y;
+                    out[f * n + i] = y;
+                }
+            }
+        }
+
+        src = out;
+    }
+}
+
+void fbank_biquad_q15(fbank_biquad_t *bank, const int16_t *in, int16_t *out, int frames)
+{
+    int s, f, i, n;
+    const int16_t *k, *src = in;
+    int16_t *x1, *x2, *y1, *y2;
+    int16_t x, y;
+    int64_t acc;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_Q15) return;
+
+    n = bank->channels;
+
+    for (s = 0; s < bank->stages; s++)
+    {
+        k = (const int16_t *)bank->coef + s * 5;
+        x1 = (int16_t *)bank->state + s * 4 * n;
+        x2 = x1 + n;
+        y1 = x2 + n;
+        y2 = y1 + n;
+
+        for (f = 0; f < frames; f++)
+        {
+            for (i = 0; i < n; i++)
+            {
+                x = src[f * n + i];
+
+                /* Q15 samples by Q14 coefficients */
+                acc = (int64_t)k[0] * x + (int64_t)k[1] * x1[i] + (int64_t)k[2] * x2[i] - (int64_t)k[3] * y1[i] - (int64_t)k[4] * y2[i];
+                y = sat16((acc + (1 << 13)) >> 14);
+
+                x2[i] = x1[i];
+                x1[i] = x;
+                y2[i] = y1[i];
+                y1[i] = y;
+                out[f * n + i] = y;
+            }
+        }
+
+        src = out;
+    }
+}
+
+void fbank_biquad_q31(fbank_biquad_t *bank, const int32_t *in, int32_t *out, int frames)
+{
+    int s, f, i, n;
+    const int32_t *k, *src = in;
+    int32_t *x1, *x2, *y1, *y2;
+    int32_t x, y;
+    int64_t acc;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_Q31) return;
+
+    n = bank->channels;
+
+    for (s = 0; s < bank->stages; s++)
+    {
+        k = (const int32_t *)bank->coef + s * 5;
+        x1 = (int32_t *)bank->state + s * 4 * n;
+        x2 = x1 + n;
+        y1 = x2 + n;
+        y2 = y1 + n;
+
+        for (f = 0; f < frames; f++)
+        {
+            for (i = 0; i < n; i++)
+            {
+                x = src[f * n + i];
+
+                /* Q31 samples by Q30 coefficients, each product drops 2 bits so the sum of 5 fits in 64 bits */
+                acc = (((int64_t)k[0] * x) >> 2) + (((int64_t)k[1] * x1[i]) >> 2) + (((int64_t)k[2] * x2[i]) >> 2) -
+                      (((int64_t)k[3] * y1[i]) >> 2) - (((int64_t)k[4] * y2[i]) >> 2);
+                y = sat32((acc + (1 << 27)) >> 28);
+
+                x2[i] = x1[i];
+                x1[i] = x;
+                y2[i] = y1[i];
+                y1[i] = y;
+                out[f * n + i] = y;
+            }
+        }
+
+        src = out;
+    }
+}
+
+int fbank_fir_init(fbank_fir_t *bank, int format, int channels, int count, const double *taps, void *buffer)
+{
+    int i;
+
+    /* Check the validity of input parameters */
+    if (!bank || !taps || !buffer) return 0;
+    if (channels <= 0 || count <= 0) return 0;
+    if (format != FBANK_F32 && format != FBANK_Q15 && format != FBANK_Q31) return 0;
+
+    bank->taps = buffer;
+    bank->history = (char *)buffer + count * 4;
+    bank->channels = channels;
+    bank->count = count;
+    bank->index = 0;
+    bank->format = format;
+
+    for (i = 0; i < count; i++)
+    {
+        if (format == FBANK_F32) ((float *)bank->taps)[i] = (float)taps[i];
+        else if (format == FBANK_Q15) ((int16_t *)bank->taps)[i] = sat16(fixed(taps[i], 15));
+        else ((int32_t *)bank->taps)[i] = sat32(fixed(taps[i], 31));
+    }
+
+    memset(bank->history, 0, 2 * count * channels * 4);
+
+    return 1;
+}
+
+/* Store a frame as the newest row of the history, at the row and again `count` rows after it,
+ * then the newest `count` frames are the rows from the index on, newest first */
+#define fir_push(bank, type, frame)                                                                     \
+do {                                                                                                    \
+    type *h_ = (type *)(bank)->history;                                                                 \
+    (bank)->index = ((bank)->index == 0) ? (bank)->count - 1 : (bank)->index - 1;                       \
+    memcpy(h_ + (bank)->index * (bank)->channels, frame, (bank)->channels * sizeof(type));              \
+    memcpy(h_ + ((bank)->index + (bank)->count) * (bank)->channels, frame, (bank)->channels * sizeof(type)); \
+} while (0)
+
+void fbank_fir_f32(fbank_fir_t *bank, const float *in, float *out, int frames)
+{
+    int f, c, i, t, n;
+    const float *h, *row;
+    float *y;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_F32) return;
+
+    n = bank->channels;
+    h = (const float *)bank->taps;
+
+    for (f = 0; f < frames; f++)
+    {
+        /* The input frame is taken before the output frame is written, so `out` can be `in` */
+        fir_push(bank, float, in + f * n);
+        row = (const float *)bank->history + bank->index * n;
+        y = out + f * n;
+        c = 0;
+
+#if FBANK_USE_VECTOR
+        for (; c + 4 <= n; c += 4)
+        {
+            vfloat acc = vzero();
+            for (t = 0; t < bank->count; t++) acc = vadd(acc, vmul(vdup(h[t]), vload(row + t * n + c)));
+            vstore(y + c, acc);
+        }
+#endif
+
+        /* The rest of the channels accumulate in the output frame */
+        for (i = c; i < n; i++) y[i] = 0.0f;
+        for (t = 0; t < bank->count; t++)
+        {
+            for (i = c; i < n; i++) y[i] += h[t] * row[t * n + i];
+        }
+    }
+}
+
+void fbank_fir_q15(fbank_fir_t *bank, const int16_t *in, int16_t *out, int frames)
+{
+    int f, i, t, n;
+    const int16_t *h, *row;
+    int64_t acc;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_Q15) return;
+
+    n = bank->channels;
+    h = (const int16_t *)bank->taps;
+
+    for (f = 0; f < frames; f++)
+    {
+        fir_push(bank, int16_t, in + f * n);
+        row = (const int16_t *)bank->history + bank->index * n;
+
+        for (i = 0; i < n; i++)
+        {
+            acc = 0;
+            for (t = 0; t < bank->count; t++) acc += (int32_t)h[t] * row[t * n + i];
+            out[f * n + i] = sat16((acc + (1 << 14)) >> 15);
+        }
+    }
+}
+
+void fbank_fir_q31(fbank_fir_t *bank, const int32_t *in, int32_t *out, int frames)
+{
+    int f, i, t, n;
+    const int32_t *h, *row;
+    int64_t acc;
+
+    if (!bank || !in || !out) return;
+    if (bank->format != FBANK_Q31) return;
+
+    n = bank->channels;
+    h = (const int32_t *)bank->taps;
+
+    for (f = 0; f < frames; f++)
+    {
+        fir_push(bank, int32_t, in + f * n);
+        row = (const int32_t *)bank->history + bank->index * n;
+
+        for (i = 0; i < n; i++)
+        {
+            acc = 0;
+            for (t = 0; t < bank->count; t++) acc += (int64_t)h[t] * row[t * n + i];
+            out[f * n + i] = sat32((acc + ((int64_t)1 << 30)) >> 31);
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fbank.h
+ *         \unit  fbank
+ *        \brief  This is a C language filter bank, biquad and FIR filters over many channels
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __fbank_H
+#define __fbank_H
+
+#include <stdint.h>
+
+#define FBANK_V_MAJOR                       1
+#define FBANK_V_MINOR                       0
+#define FBANK_V_PATCH                       0
+
+/* Configuration information */
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FBANK_USE_SSE                       1   /**< 1 float kernels on SSE, 4 channels at once */
+#else
+#define FBANK_USE_SSE                       0
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FBANK_USE_NEON                      1   /**< 1 float kernels on NEON, 4 channels at once */
+#else
+#define FBANK_USE_NEON                      0
+#endif
+
+/* Sample formats of a bank */
+#define FBANK_F32                           0   /**< float */
+#define FBANK_Q15                           1   /**< int16_t of Q15, biquad coefficients in Q14 */
+#define FBANK_Q31                           2   /**< int32_t of Q31, biquad coefficients in Q30 */
+
+/* Biquad coefficients normalized by a0, y = b0*x0 + b1*x1 + b2*x2 - a1*y1 - a2*y2 */
+typedef struct
+{
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+} fbank_coef_t;
+
+/* Cascaded biquads, every channel runs the same stages with its own state */
+typedef struct
+{
+    /**< Coefficients of the stages in the format of the bank */
+    void *coef;
+    /**< State of the stages, each state variable is an array over the channels */
+    void *state;
+    /**< Count of channels */
+    int channels;
+    /**< Count of stages */
+    int stages;
+    /**< Sample format */
+    int format;
+} fbank_biquad_t;
+
+/* FIR filters, every channel runs the same taps with its own history */
+typedef struct
+{
+    /**< Taps in the format of the bank */
+    void *taps;
+    /**< History of the frames, kept twice so the newest `count` frames are always adjacent */
+    void *history;
+    /**< Count of channels */
+    int channels;
+    /**< Count of taps */
+    int count;
+    /**< Row of the newest frame in history */
+    int index;
+    /**< Sample format */
+    int format;
+} fbank_fir_t;
+
+/* Size in bytes of the buffer of a bank, aligned to 4 bytes */
+#define FBANK_BIQUAD_BUFFER(channels, stages)   ((stages) * (5 + 4 * (channels)) * 4)
+#define FBANK_FIR_BUFFER(channels, count)       ((count) * (1 + 2 * (channels)) * 4)
+
+/* Coefficient design, the biquads follow the audio EQ cookbook of R. Bristow-Johnson
+ *
+ *  \param[out] coef: coefficients
+ *  \param[in] fs: sample rate
+ *  \param[in] f0: cutoff or center frequency, below fs / 2
+ *  \param[in] q: quality factor, 0.7071 for the Butterworth response, the width of the notch is f0 / q
+ *  \return 1 success or 0 fail
+ */
+
+int fbank_design_lowpass(fbank_coef_t *coef, double fs, double f0, double q);
+int fbank_design_highpass(fbank_coef_t *coef, double fs, double f0, double q);
+int fbank_design_notch(fbank_coef_t *coef, double fs, double f0, double q);
+
+/**
+ *  \brief design a lowpass FIR by the windowed sinc with Hamming window, the gain at DC is 1
+ *  \param[out] taps: taps
+ *  \param[in] count: count of taps, odd for a symmetric response around the center tap
+ *  \param[in] fs: sample rate
+ *  \param[in] fc: cutoff frequency, below fs / 2
+ *  \return 1 success or 0 fail
+ */
+int fbank_design_fir_lowpass(double *taps, int count, double fs, double fc);
+
+/**
+ *  \brief initialize a bank of cascaded biquads, the coefficients are converted to the format and the state is cleared
+ *  \param[out] bank: bank
+ *  \param[in] format: FBANK_F32, FBANK_Q15 or FBANK_Q31
+ *  \param[in] channels: count of channels
+ *  \param[in] stages: count of stages
+ *  \param[in] coef: coefficients of the stages
+ *  \param[in] buffer: `FBANK_BIQUAD_BUFFER(channels, stages)` bytes, kept by the bank
+ *  \return 1 success or 0 fail
+ */
+int fbank_biquad_init(fbank_biquad_t *bank, int format, int channels, int stages, const fbank_coef_t *coef, void *buffer);
+
+/**
+ *  \brief initialize a bank of FIR filters, the taps are converted to the format and the history is cleared
+ *  \param[out] bank: bank
+ *  \param[in] format: FBANK_F32, FBANK_Q15 or FBANK_Q31
+ *  \param[in] channels: count of channels
+ *  \param[in] count: count of taps
+ *  \param[in] taps: taps, `taps[0]` applies to the newest sample
+ *  \param[in] buffer: `FBANK_FIR_BUFFER(channels, count)` bytes, kept by the bank
+ *  \return 1 success or 0 fail
+ */
+int fbank_fir_init(fbank_fir_t *bank, int format, int channels, int count, const double *taps, void *buffer);
+
+/* Filtering of frames
+ *
+ * A frame holds one sample of every channel, the frames are adjacent, `in[frame * channels + channel]`,
+ * the layout of a multi-channel ADC scan. `out` can be `in`. The function must match the format of the bank.
+ *
+ * The float kernels filter 4 channels at once on SSE or NEON, the rest of the channels, and the kernels
+ * without them, loop over the channels innermost over the state arrays for the compiler to vectorize.
+ *
+ * The fixed point kernels accumulate in 64 bits and saturate the outputs. The Q31 FIR keeps the full
+ * products, the sum of |taps| must stay below 2.
+ *
+ *  \param[in] bank: bank
+ *  \param[in] in: input frames
+ *  \param[out] out: output frames
+ *  \param[in] frames: count of frames
+ *  \return none
+ */
+
+void fbank_biquad_f32(fbank_biquad_t *bank, const float *in, float *out, int frames);
+void fbank_biquad_q15(fbank_biquad_t *bank, const int16_t *in, int16_t *out, int frames);
+void fbank_biquad_q31(fbank_biquad_t *bank, const int32_t *in, int32_t *out, int frames);
+
+void fbank_fir_f32(fbank_fir_t *bank, const float *in, float *out, int frames);
+void fbank_fir_q15(fbank_fir_t *bank, const int16_t *in, int16_t *out, int frames);
+void fbank_fir_q31(fbank_fir_t *bank, const int32_t *in, int32_t *out, int frames);
+
+#if 0 /* for example */
+static void test(void)
+{
+    static uint32_t buffer[FBANK_BIQUAD_BUFFER(25, 2) / 4];
+    fbank_coef_t coef[2];
+    fbank_biquad_t bank;
+    float frame[25];
+
+    /* 4th order lowpass at 50 Hz for 25 channels scanned at 1 kHz, two Butterworth stages */
+    fbank_design_lowpass(&coef[0], 1000, 50, 0.5412);
+    fbank_design_lowpass(&coef[1], 1000, 50, 1.3066);
+    fbank_biquad_init(&bank, FBANK_F32, 25, 2, coef, buffer);
+
+    /* Each scan of the ADC is filtered in place */
+    adc_scan(frame);
+    fbank_biquad_f32(&bank, frame, frame, 1);
+}
+#endif
+
+#endif
@@ -12,65 +12,168 @@
  ********************************************************************************************************/
 #include "filter.h"
 
-static void filter_median_s(double *data, int size, const int const window, int index)
+/* The median filter keeps the window in two heaps around the median, `heap[0]` is the median,
+ * `heap[-1]` down to `heap[-maxCount]` is the max heap of the lower half, `heap[1]` up to `heap[minCount]`
+ * is the min heap of the upper half. The children of `i` are `2i` and `2i+1` (`2i-1` below 0), so both
+ * heaps share the root 0. Each sample of the ring knows its position in the heaps, the newest sample
+ * replaces the oldest one in place and is sifted in O(log window) */
+
+#define median_less(f, i, j)            ((f)->data[(f)->heap[i]] < (f)->data[(f)->heap[j]])
+
+/* Exchange the heap nodes i and j if i is less than j, return 1 when exchanged */
+static int median_exchange(filter_median_t *filter, int i, int j)
 {
-    double array[window];
-    double temp;
-    int i, j, half; // half windows size
-    int start, end;
+    int t;
 
-    half = window / 2;
+    if (!median_less(filter, i, j)) return 0;
 
-    /* Calculate the window range for the current data point */
-    start = index - half;
-    end = start + window;
+    t = filter->heap[i];
+    filter->heap[i] = filter->heap[j];
+    filter->heap[j] = t;
+    filter->pos[filter->heap[i]] = i;
+    filter->pos[filter->heap[j]] = j;
 
-    /* Ensure the window does not exceed the boundaries of the data */
-    if (start < 0) 
+    return 1;
+}
+
+static void median_min_down(filter_median_t *filter, int i)
+{
+    for (i *= 2; i <= filter->minCount; i *= 2)
     {
-        start = 0;
-        end = window;
-    } 
-    else if (end > size) 
+        if (i < filter->minCount && median_less(filter, i + 1, i)) i++;
+        if (!median_exchange(filter, i, i / 2)) break;
+    }
+}
+
+static void median_max_down(filter_median_t *filter, int i)
+{
+    for (i *= 2; i >= -filter->maxCount; i *= 2)
     {
-        end = size;
+        if (i > -filter->maxCount && median_less(filter, i, i - 1)) i--;
+        if (!median_exchange(filter, i / 2, i)) break;
     }
+}
+
+/* Sift up, return 1 when the node reaches the root */
+static int median_min_up(filter_median_t *filter, int i)
+{
+    while (i > 0 && median_exchange(filter, i, i / 2)) i /= 2;
+    return i == 0;
+}
+
+static int median_max_up(filter_median_t *filter, int i)
+{
+    while (i < 0 && median_exchange(filter, i / 2, i)) i /= 2;
+    return i == 0;
+}
 
-    /* Copy the data within the window to the temporary array */
-    for (i = start; i < end; i++) 
+int filter_median_init(filter_median_t *filter, int window, double *buffer)
+{
+    int i;
+
+    /* Check the validity of input parameters */
+    if (!filter || !buffer) return 0;
+    if (window <= 0) return 0;
+
+    filter->data = buffer;
+    filter->pos = (int *)(buffer + window);
+    filter->heap = filter->pos + window + window / 2;
+    filter->window = window;
+    filter->index = 0;
+    filter->count = 0;
+    filter->minCount = 0;
+    filter->maxCount = 0;
+
+    /* The ring is filled in the order 0, -1, 1, -2, 2 ... of the heaps, the halves grow alternately */
+    for (i = 0; i < window; i++)
     {
-        array[i - start] = data[i];
+        filter->pos[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+        filter->heap[filter->pos[i]] = i;
     }
 
-    /* Sort the temporary array */
-    for (i = 0; i < window - 1; i++) 
+    return 1;
+}
+
+double filter_median_update(filter_median_t *filter, double sample)
+{
+    int p;
+    double old;
+
+    if (!filter) return 0.0;
+
+    /* Replace the oldest sample */
+    p = filter->pos[filter->index];
+    old = filter->data[filter->index];
+    filter->data[filter->index] = sample;
+    if (++filter->index == filter->window) filter->index = 0;
+    if (filter->count < filter->window) filter->count++;
+
+    if (p > 0)
     {
-        for (j = 0; j < window - i - 1; j++) 
+        /* In the upper half, a larger sample than the old one only sinks */
+        if (filter->minCount < (filter->window - 1) / 2) filter->minCount++;
+        else if (sample > old) 
         {
-            if (array[j] > array[j + 1]) 
-            {
-                temp = array[j];
-                array[j] = array[j + 1];
-                array[j + 1] = temp;
-            }
+            median_min_down(filter, p);
+            goto out;
         }
+        if (median_min_up(filter, p) && median_exchange(filter, 0, -1)) median_max_down(filter, -1);
+    }
+    else if (p < 0)
+    {
+        /* In the lower half, a smaller sample than the old one only sinks */
+        if (filter->maxCount < filter->window / 2) filter->maxCount++;
+        else if (sample < old) 
+        {
+            median_max_down(filter, p);
+            goto out;
+        }
+        if (median_max_up(filter, p) && filter->minCount && median_exchange(filter, 1, 0)) median_min_down(filter, 1);
+    }
+    else
+    {
+        /* The median is replaced, move it to the half it belongs to */
+        if (filter->maxCount && median_max_up(filter, -1)) median_max_down(filter, -1);
+        if (filter->minCount && median_min_up(filter, 1)) median_min_down(filter, 1);
     }
 
-    /* Calculate the median value and assign it to the current data point */
-    data[index] = array[half];
+out:
+    /* An even count has the two middle samples at the root and the top of the lower half */
+    if (filter->minCount < filter->maxCount) return (filter->data[filter->heap[0]] + filter->data[filter->heap[-1]]) / 2;
+    return filter->data[filter->heap[0]];
 }
 
 void filter_median(double *data, int size, int window) 
 {
-    int i;
+    int i, half;
+    double median;
+
+    if (!data) return;
+    if (size <= 0 || window <= 0) return;
 
     /* Check if the window size is even, and adjust it to the next odd number if necessary */ 
     if (window % 2 == 0) window++;
 
-    /* Perform filtering for each data point */
-    for (i = 0; i < size; i++) 
+    /* The window does not exceed the boundaries of the data */
+    if (window > size) window = size;
+    half = window / 2;
+
     {
-        filter_median_s(data, size, window, i);
+        double buffer[FILTER_MEDIAN_BUFFER(window)];
+        filter_median_t filter;
+
+        filter_median_init(&filter, window, buffer);
+
+        /* The points of the head share the first window */
+        for (i = 0; i < window; i++) median = filter_median_update(&filter, data[i]);
+        for (i = 0; i <= half; i++) data[i] = median;
+
+        /* Slide the window, the sample entering is ahead of the point written */
+        for (i = half + 1; i < size - half; i++) data[i] = filter_median_update(&filter, data[i + half]);
+
+        /* The points of the tail share the last window */
+        median = data[size - half - 1];
+        for (i = size - half; i < size; i++) data[i] = median;
     }
 }
 
@@ -106,39 +209,85 @@ void filter_kalman(double *measurements, double *estimates, int numMeasurements,
     estimates[0] = estimate;
 }
 
+int filter_average_init(filter_average_t *filter, int window, double *buffer)
+{
+    /* Check the validity of input parameters */
+    if (!filter || !buffer) return 0;
+    if (window <= 0) return 0;
+
+    filter->data = buffer;
+    filter->sum = 0.0;
+    filter->window = window;
+    filter->index = 0;
+    filter->count = 0;
+
+    return 1;
+}
+
+double filter_average_update(filter_average_t *filter, double sample)
+{
+    int i;
+
+    if (!filter) return 0.0;
+
+    /* Replace the oldest sample in the running sum */
+    if (filter->count < filter->window) filter->count++;
+    else filter->sum -= filter->data[filter->index];
+    filter->data[filter->index] = sample;
+    filter->sum += sample;
+
+    /* Sum again once per round of the ring, so the rounding of the running sum does not accumulate */
+    if (++filter->index == filter->window)
+    {
+        filter->index = 0;
+        filter->sum = 0.0;
+        for (i = 0; i < filter->window; i++) filter->sum += filter->data[i];
+    }
+
+    return filter->sum / filter->count;
+}
+
 void filter_average(double *data, int size, int window) 
 {
-    int i, j, half;
-    double sum = 0.0;
+    int i, half;
     int start, end;
+    double sum = 0.0;
+
+    if (!data) return;
+    if (size <= 0 || window <= 0) return;
 
     /* Check if the window size is even, and adjust it to the next odd number if necessary */
     if (window % 2 == 0) window++;
 
     half = window / 2;
 
-    /* Perform filtering for each data point */
-    for (i = 0; i < size; i++) 
     {
-        /* Reset the sum of elements within the window */
-        sum = 0.0; 
+        /* The original values behind the current point, the points are overwritten in place */
+        double ring[half + 1];
 
-        /* Calculate the window range for the current data point */
-        start = i - half;
-        end = start + window;
+        /* Sum of the window of the point 0 */
+        for (i = 0; i <= half && i < size; i++) sum += data[i];
 
-        /* Ensure the window does not exceed the boundaries of the data */
-        if (start < 0) start = 0;
-        if (end > size) end = size;
-
-        /* Calculate the sum of all data within the window */
-        for (j = start; j < end; j++) 
+        for (i = 0; i < size; i++) 
         {
-            sum += data[j];
-        }
+            /* Calculate the window range for the current data point */
+            start = i - half;
+            end = i + half;
+
+            /* Slide the running sum, the point leaving is read from the ring, the point entering is not written yet */
+            if (i > 0)
+            {
+                if (start - 1 >= 0) sum -= ring[(start - 1) % (half + 1)];
+                if (end < size) sum += data[end];
+            }
+
+            /* Ensure the window does not exceed the boundaries of the data */
+            if (start < 0) start = 0;
+            if (end >= size) end = size - 1;
 
-        /* Calculate the average and assign it to the current data point */
-        data[i] = sum / window;
+            /* Calculate the average and assign it to the current data point */
+            ring[i % (half + 1)] = data[i];
+            data[i] = sum / (end - start + 1);
+        }
     }
 }
-
@@ -17,11 +17,60 @@
 #define FILTER_V_MINOR                      0
 #define FILTER_V_PATCH                      0
 
+/* Sliding median filter, the samples are fed one by one */
+typedef struct
+{
+    /**< Ring of the samples in the window */
+    double *data;
+    /**< Position of each sample in the heaps */
+    int *pos;
+    /**< Heaps of the samples around the median */
+    int *heap;
+    /**< Size of the window */
+    int window;
+    /**< Index of the oldest sample in the ring */
+    int index;
+    /**< Count of the samples in the window */
+    int count;
+    /**< Count of the samples in the min heap of the upper half */
+    int minCount;
+    /**< Count of the samples in the max heap of the lower half */
+    int maxCount;
+} filter_median_t;
+
+/* Count of doubles in the buffer of a median filter with the window */
+#define FILTER_MEDIAN_BUFFER(window)    ((window) + ((window) * 2 * sizeof(int) + sizeof(double) - 1) / sizeof(double))
+
+/**
+* \brief Initializes a sliding median filter.
+*
+* \param[out] filter A pointer to the filter.
+* \param[in] window The size of the window, odd or even.
+* \param[in] buffer A buffer of `FILTER_MEDIAN_BUFFER(window)` doubles, kept by the filter.
+*
+* \return 1 success or 0 fail.
+*/
+int filter_median_init(filter_median_t *filter, int window, double *buffer);
+
+/**
+* \brief Feeds a sample to a sliding median filter.
+*
+* The sample replaces the oldest one in the window, in O(log window) time.
+*
+* \param[in] filter A pointer to the filter.
+* \param[in] sample The new sample.
+*
+* \return The median of the samples in the window, the mean of the two middle samples for an even count.
+*/
+double filter_median_update(filter_median_t *filter, double sample);
+
 /**
 * \brief Performs median filtering on a data array.
 *
 * This function applies median filtering to a data array using a sliding window of a specified size.
-* The filtered value at each data point is calculated as the median of the values within the window.
+* The filtered value at each data point is calculated as the median of the original values within the window.
+* The window slides in O(log window) time per point. Near the boundaries the window is shifted inside the data,
+* the points of the head and the tail share the first and the last window.
 *
 * \param[in,out] data A pointer to the data array to be filtered. The filtered values will be stored in this array.
 * \param[in] size The size of the data array.
@@ -43,11 +92,51 @@ void filter_median(double *data, int size, int window);
 */
 void filter_kalman(double *measurements, double *estimates, int numMeasurements, double processNoise, double measurementNoise);
 
+/* Moving average filter, the samples are fed one by one */
+typedef struct
+{
+    /**< Ring of the samples in the window */
+    double *data;
+    /**< Running sum of the samples in the window */
+    double sum;
+    /**< Size of the window */
+    int window;
+    /**< Index of the oldest sample in the ring */
+    int index;
+    /**< Count of the samples in the window */
+    int count;
+} filter_average_t;
+
+/**
+* \brief Initializes a moving average filter.
+*
+* \param[out] filter A pointer to the filter.
+* \param[in] window The size of the window.
+* \param[in] buffer A buffer of `window` doubles, kept by the filter.
+*
+* \return 1 success or 0 fail.
+*/
+int filter_average_init(filter_average_t *filter, int window, double *buffer);
+
+/**
+* \brief Feeds a sample to a moving average filter.
+*
+* The sample replaces the oldest one in the running sum, in O(1) time.
+*
+* \param[in] filter A pointer to the filter.
+* \param[in] sample The new sample.
+*
+* \return The average of the samples in the window.
+*/
+double filter_average_update(filter_average_t *filter, double sample);
+
 /**
 * \brief Performs average filtering on a data array.
 *
 * This function applies average filtering to a data array using a sliding window of a specified size.
-* The filtered value at each data point is calculated as the average of the values within the window.
+* The filtered value at each data point is calculated as the average of the original values within the window.
+* The window slides with a running sum in O(1) time per point. Near the boundaries the window is cut by the data,
+* and the average is taken over the values left.
 *
 * \param[in,out] data A pointer to the data array to be filtered. The filtered values will be stored in this array.
 * \param[in] size The size of the data array.
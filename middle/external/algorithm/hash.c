@@ -281,3 +281,116 @@ uint32_t hash_jdk6(void *data, uint32_t size)
     return (hash & 0x7FFFFFFF);
 }
 
+
+/* The 64-bit hash follows the wyhash design, the data is read 8 bytes at a time in little endian order
+ * and folded by 64x64 -> 128 bit multiplications, the secret constants are odd with balanced bits */
+static const uint64_t wy_secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+static void wy_mum(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl, lo;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static uint64_t wy_mix(uint64_t a, uint64_t b)
+{
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+static uint64_t wy_r8(const uint8_t *p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static uint64_t wy_r4(const uint8_t *p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24);
+}
+
+/**
+ *  \brief 64-bit hash with a seed, different seeds give unrelated hash values,
+ *  \brief a random seed keeps the hash values unpredictable against hash flooding
+ *  \param[in] data: address of data
+ *  \param[in] size: size of data
+ *  \param[in] seed: seed
+ *  \return hash value
+ */
+uint64_t hash_wy_seed(void *data, uint32_t size, uint64_t seed)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t a, b, see1, see2;
+    uint32_t i = size;
+
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+
+    if (size <= 16)
+    {
+        /* Short data is read by overlapping words, every byte takes part exactly as in the long path */
+        if (size >= 4)
+        {
+            a = (wy_r4(p) << 32) | wy_r4(p + ((size >> 3) << 2));
+            b = (wy_r4(p + size - 4) << 32) | wy_r4(p + size - 4 - ((size >> 3) << 2));
+        }
+        else if (size > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[size >> 1] << 8) | p[size - 1];
+            b = 0;
+        }
+        else a = b = 0;
+    }
+    else
+    {
+        /* Three independent lanes, so the multiplications of a block do not wait for each other */
+        if (i >= 48)
+        {
+            see1 = seed;
+            see2 = seed;
+            do {
+                seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+                see1 = wy_mix(wy_r8(p + 16) ^ wy_secret[2], wy_r8(p + 24) ^ see1);
+                see2 = wy_mix(wy_r8(p + 32) ^ wy_secret[3], wy_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* The last 16 bytes, overlapping the processed ones when the rest is shorter */
+        a = wy_r8(p + i - 16);
+        b = wy_r8(p + i - 8);
+    }
+
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ wy_secret[0] ^ size, b ^ wy_secret[1]);
+}
+
+/**
+ *  \brief 64-bit hash, reads 8 bytes at a time, much faster than the byte by byte hashes over long data.
+ *  \param[in] data: address of data
+ *  \param[in] size: size of data
+ *  \return hash value
+ */
+uint64_t hash_wy(void *data, uint32_t size)
+{
+    return hash_wy_seed(data, size, 0);
+}
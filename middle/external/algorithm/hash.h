@@ -39,4 +39,19 @@ uint32_t hash_bp(void *data, uint32_t size);
 uint32_t hash_fnv(void *data, uint32_t size);
 uint32_t hash_jdk6(void *data, uint32_t size);
 
+/* 64-bit hash algorithm declare
+ *
+ * Reads 8 bytes at a time, suitable for long data and for hash tables that need well distributed
+ * low bits. The seeded version gives unrelated values for different seeds, use a random seed
+ * where the keys may come from outside, so that colliding keys can not be prepared in advance.
+ *
+ *  \param[in] data: address of data
+ *  \param[in] size: size of data
+ *  \param[in] seed: seed
+ *  \return hash value
+ */
+
+uint64_t hash_wy(void *data, uint32_t size);
+uint64_t hash_wy_seed(void *data, uint32_t size, uint64_t seed);
+
 #endif
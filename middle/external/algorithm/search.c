@@ -11,6 +11,7 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "search.h"
+#include <string.h>
 
 int search_linear(void *array, int left, int right, void *target, SearchOPS *ops)
 {
@@ -38,29 +39,24 @@ int search_linear(void *array, int left, int right, void *target, SearchOPS *ops
 static int search_binary_s(void *array, int left, int right, int r, void *target, SearchOPS *ops)
 {
     int c = 0;
-    int mid = left + (right - left) / 2;
+    int mid = 0;
 
-    /* There is an error on the left and right boundaries, and the search has failed */
-    if (left > right) return -1;
+    /* Narrow the interval until it is empty, the probes are the same as halving recursively */
+    while (left <= right)
+    {
+        mid = left + (right - left) / 2;
 
-    /* Obtain comparison results */
-    c = ops->cmp(ops->addr(array, mid), target) * r;
+        /* Obtain comparison results */
+        c = ops->cmp(ops->addr(array, mid), target) * r;
 
-    /* According to the comparison results, search in segments */
-    if (c == 0)
-    {
-        return mid;
-    } 
-    else if (c > 0)
-    {
-        /* Search for the left interval */
-        return search_binary_s(array, left, mid - 1, r, target, ops);
-    }
-    else 
-    {
-        /* Search for the right interval */
-        return search_binary_s(array, mid + 1, right, r, target, ops);
+        /* According to the comparison results, search in segments */
+        if (c == 0) return mid;
+        else if (c > 0) right = mid - 1; /* Search for the left interval */
+        else left = mid + 1; /* Search for the right interval */
     }
+
+    /* There is an error on the left and right boundaries, and the search has failed */
+    return -1;
 }
 
 int search_binary(void *array, int left, int right, void *target, SearchOPS *ops)
@@ -76,8 +72,145 @@ int search_binary(void *array, int left, int right, void *target, SearchOPS *ops
     /* Get the current sorting rule */
     r = -ops->cmp(ops->addr(array, left), ops->addr(array, right));
 
+    /* The ends are equal, so all elements are equal, and either rule works */
+    if (r == 0) r = 1;
+
     /* Return binary search results */
     return search_binary_s(array, left, right, r, target, ops);
 }
 
+/* Prefetch the cache line at an address, a hint without effect on the results */
+#if defined(__GNUC__)
+#define prefetch(addr)          __builtin_prefetch(addr)
+#else
+#define prefetch(addr)
+#endif
+
+/* Shift out the trailing ones and the zero above them */
+#if defined(__GNUC__)
+#define ffs_shift(k)            ((unsigned long long)(k) >> (__builtin_ctzll(~(unsigned long long)(k)) + 1))
+#else
+static size_t ffs_shift(size_t k)
+{
+    while (k & 1) k >>= 1;
+    return k >> 1;
+}
+#endif
+
+/**
+ *  \brief Fill the Eytzinger layout in order of the binary tree, the in-order walk of the tree
+ *  \brief takes the sorted elements one by one
+ *  \param[in] layout: layout to fill
+ *  \param[in] sorted: sorted elements
+ *  \param[in] i: index of the next sorted element
+ *  \param[in] k: node of the layout
+ *  \param[in] count: count of elements
+ *  \param[in] size: size of element
+ *  \return index of the next sorted element after the subtree of k
+ */
+static int eytzinger_fill(char *layout, const char *sorted, int i, size_t k, int count, int size)
+{
+    if (k <= (size_t)count)
+    {
+        i = eytzinger_fill(layout, sorted, i, k << 1, count, size);
+        memcpy(layout + k * size, sorted + (size_t)i * size, size);
+        i = eytzinger_fill(layout, sorted, i + 1, (k << 1) + 1, count, size);
+    }
+    return i;
+}
+
+int search_eytzinger_build(void *layout, const void *sorted, int count, int size)
+{
+    /* Check the validity of input parameters */
+    if (!layout || !sorted) return 0;
+    if (count <= 0 || size <= 0) return 0;
+
+    eytzinger_fill((char *)layout, (const char *)sorted, 0, 1, count, size);
+
+    return 1;
+}
+
+/* Type specialized searches over ascending arrays, `lower` is the first index in [left, right] whose element
+ * is not less than the target. The halving selects the half by a conditional move instead of a branch,
+ * so the time does not depend on mispredicted comparisons */
+#define SEARCH_TYPE_DEFINE(name, type)                                                                  \
+static int name##_lower(const type *array, int left, int right, type target)                           \
+{                                                                                                       \
+    const type *base = array + left;                                                                    \
+    int n = right - left + 1, half;                                                                     \
+    while (n > 1)                                                                                       \
+    {                                                                                                   \
+        half = n >> 1;                                                                                  \
+        base = (base[half] < target) ? base + half : base;                                              \
+        n -= half;                                                                                      \
+    }                                                                                                   \
+    return (int)(base - array) + (*base < target);                                                      \
+}                                                                                                       \
+int search_lower_##name(const type *array, int left, int right, type target)                           \
+{                                                                                                       \
+    if (!array) return -1;                                                                              \
+    if (left > right || left < 0) return -1;                                                            \
+    return name##_lower(array, left, right, target);                                                    \
+}                                                                                                       \
+int search_binary_##name(const type *array, int left, int right, type target)                          \
+{                                                                                                       \
+    int i;                                                                                              \
+    if (!array) return -1;                                                                              \
+    if (left > right || left < 0) return -1;                                                            \
+    i = name##_lower(array, left, right, target);                                                       \
+    return (i <= right && array[i] == target) ? i : -1;                                                 \
+}                                                                                                       \
+int search_exponential_##name(const type *array, int left, int right, type target)                     \
+{                                                                                                       \
+    int step = 1;                                                                                       \
+    if (!array) return -1;                                                                              \
+    if (left > right || left < 0) return -1;                                                            \
+    /* Gallop while the probed element is less than the target, everything before `left` is less */    \
+    while (step <= right - left && array[left + step - 1] < target)                                     \
+    {                                                                                                   \
+        left += step;                                                                                   \
+        step <<= 1;                                                                                     \
+    }                                                                                                   \
+    return name##_lower(array, left, (step <= right - left) ? left + step - 1 : right, target);         \
+}                                                                                                       \
+int search_scan_##name(const type *array, int left, int right, type target)                            \
+{                                                                                                       \
+    int i, c0 = 0, c1 = 0, c2 = 0, c3 = 0;                                                              \
+    if (!array) return -1;                                                                              \
+    if (left > right || left < 0) return -1;                                                            \
+    /* Count the elements less than the target, without early exit the loop can be vectorized,         \
+     * the separate counters keep the compares independent where it is not */                          \
+    for (i = left; i + 3 <= right; i += 4)                                                              \
+    {                                                                                                   \
+        c0 += (array[i] < target);                                                                      \
+        c1 += (array[i + 1] < target);                                                                  \
+        c2 += (array[i + 2] < target);                                                                  \
+        c3 += (array[i + 3] < target);                                                                  \
+    }                                                                                                   \
+    for (; i <= right; i++) c0 += (array[i] < target);                                                  \
+    return left + c0 + c1 + c2 + c3;                                                                    \
+}                                                                                                       \
+int search_eytzinger_##name(const type *layout, int count, type target)                                \
+{                                                                                                       \
+    /* Nodes go up to 2 * count + 1, beyond int for the largest counts */                              \
+    size_t k = 1;                                                                                       \
+    size_t n = (size_t)count;                                                                           \
+    if (!layout || count <= 0) return 0;                                                                \
+    while (k <= n)                                                                                      \
+    {                                                                                                   \
+        /* The 16 descendants 4 levels below are adjacent, fetch them ahead when they exist */          \
+        if (k <= (n >> 4)) prefetch(layout + (k << 4));                                                 \
+        k = (k << 1) + (layout[k] < target);                                                            \
+    }                                                                                                   \
+    /* Leave the right turns at the bottom, the last left turn is at the answer */                      \
+    return (int)ffs_shift(k);                                                                           \
+}
 
+SEARCH_TYPE_DEFINE(char, char)
+SEARCH_TYPE_DEFINE(uchar, unsigned char)
+SEARCH_TYPE_DEFINE(short, short)
+SEARCH_TYPE_DEFINE(ushort, unsigned short)
+SEARCH_TYPE_DEFINE(int, int)
+SEARCH_TYPE_DEFINE(uint, unsigned int)
+SEARCH_TYPE_DEFINE(float, float)
+SEARCH_TYPE_DEFINE(double, double)
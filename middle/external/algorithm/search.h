@@ -70,4 +70,97 @@ int search_linear(void *array, int left, int right, void *target, SearchOPS *ops
 */
 int search_binary(void *array, int left, int right, void *target, SearchOPS *ops);
 
+
+/**
+* \brief Builds the Eytzinger layout of a sorted array.
+*
+* The layout stores the implicit binary search tree breadth first, element `k` has the children `2k` and `2k+1`,
+* so the first levels of every search share the same few cache lines. Elements of any type can be laid out,
+* a table of pairs laid out together, or a second table laid out alike, keeps the values found by the search.
+*
+* \param[out] layout A pointer to the layout, `count + 1` elements, the element 0 is not used.
+* \param[in] sorted A pointer to the ascending array of `count` elements.
+* \param[in] count The count of elements.
+* \param[in] size The size of an element.
+*
+* \return 1 success or 0 fail.
+*/
+int search_eytzinger_build(void *layout, const void *sorted, int count, int size);
+
+/* Type specialized search algorithm declare
+ *
+ * Search ascending arrays of basic types without `SearchOPS`, the compare is inlined. NaN of floats are not supported.
+ *
+ * `search_binary_xxx` returns the index of an element equal to the target, or -1 when not found.
+ *
+ * `search_lower_xxx` returns the index of the first element not less than the target, or `right + 1` when every
+ * element is less, the halving chooses the half without branch.
+ *
+ * `search_exponential_xxx` returns the same as `search_lower_xxx`, it gallops from `left` in steps of 1, 2, 4 ...
+ * then halves the last step, so the time grows with the distance from `left` instead of the length of the range.
+ * Passing the previous result as `left` suits targets that change slowly.
+ *
+ * `search_scan_xxx` returns the same as `search_lower_xxx`, it counts the elements less than the target through
+ * the whole range, the loop can be vectorized by the compiler and suits short arrays.
+ *
+ *  \param[in] array: array address
+ *  \param[in] left: left index of the search range
+ *  \param[in] right: right index of the search range
+ *  \param[in] target: target value
+ *  \return index or -1: error
+ *
+ * `search_eytzinger_xxx` searches a layout of `search_eytzinger_build()`, and returns the position in the layout of
+ * the first element not less than the target, or 0 when every element is less.
+ *
+ *  \param[in] layout: layout address
+ *  \param[in] count: count of elements
+ *  \param[in] target: target value
+ *  \return position in layout
+ */
+
+int search_binary_char(const char *array, int left, int right, char target);
+int search_binary_uchar(const unsigned char *array, int left, int right, unsigned char target);
+int search_binary_short(const short *array, int left, int right, short target);
+int search_binary_ushort(const unsigned short *array, int left, int right, unsigned short target);
+int search_binary_int(const int *array, int left, int right, int target);
+int search_binary_uint(const unsigned int *array, int left, int right, unsigned int target);
+int search_binary_float(const float *array, int left, int right, float target);
+int search_binary_double(const double *array, int left, int right, double target);
+
+int search_lower_char(const char *array, int left, int right, char target);
+int search_lower_uchar(const unsigned char *array, int left, int right, unsigned char target);
+int search_lower_short(const short *array, int left, int right, short target);
+int search_lower_ushort(const unsigned short *array, int left, int right, unsigned short target);
+int search_lower_int(const int *array, int left, int right, int target);
+int search_lower_uint(const unsigned int *array, int left, int right, unsigned int target);
+int search_lower_float(const float *array, int left, int right, float target);
+int search_lower_double(const double *array, int left, int right, double target);
+
+int search_exponential_char(const char *array, int left, int right, char target);
+int search_exponential_uchar(const unsigned char *array, int left, int right, unsigned char target);
+int search_exponential_short(const short *array, int left, int right, short target);
+int search_exponential_ushort(const unsigned short *array, int left, int right, unsigned short target);
+int search_exponential_int(const int *array, int left, int right, int target);
+int search_exponential_uint(const unsigned int *array, int left, int right, unsigned int target);
+int search_exponential_float(const float *array, int left, int right, float target);
+int search_exponential_double(const double *array, int left, int right, double target);
+
+int search_scan_char(const char *array, int left, int right, char target);
+int search_scan_uchar(const unsigned char *array, int left, int right, unsigned char target);
+int search_scan_short(const short *array, int left, int right, short target);
+int search_scan_ushort(const unsigned short *array, int left, int right, unsigned short target);
+int search_scan_int(const int *array, int left, int right, int target);
+int search_scan_uint(const unsigned int *array, int left, int right, unsigned int target);
+int search_scan_float(const float *array, int left, int right, float target);
+int search_scan_double(const double *array, int left, int right, double target);
+
+int search_eytzinger_char(const char *layout, int count, char target);
+int search_eytzinger_uchar(const unsigned char *layout, int count, unsigned char target);
+int search_eytzinger_short(const short *layout, int count, short target);
+int search_eytzinger_ushort(const unsigned short *layout, int count, unsigned short target);
+int search_eytzinger_int(const int *layout, int count, int target);
+int search_eytzinger_uint(const unsigned int *layout, int count, unsigned int target);
+int search_eytzinger_float(const float *layout, int count, float target);
+int search_eytzinger_double(const double *layout, int count, double target);
+
 #endif
@@ -13,12 +13,20 @@
 #include "sort.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#if SORT_USE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 /* simplify the operation function for obtaining `ops` */
 #define ptr(i)          ((ops)->addr(array, (i))) 
 #define order(f, b)     ((ops)->order(ptr(f), ptr(b))) 
 #define swap(i, j)      ((ops)->swap(array, (i), (j))) 
 
+/**< Ranges shorter than this are finished by insert sort */
+#define INSERT_THRESHOLD        16
+
 /** 
  *  \brief Bubble sort algorithm
  *  \param[in] array: Data handle
@@ -102,7 +110,7 @@ int sort_insert(void *array, int begin, int end, SOPS* ops)
     if (!ops || !ops->order || !ops->addr || !ops->swap) return 0;
     
     /* Traverse data */
-    for (i = 1; i < tail; i++)
+    for (i = begin + 1; i < tail; i++)
     {
         if (order(i - 1, i) < 0)
         {
@@ -160,6 +168,40 @@ int sort_shell(void *array, int begin, int end, SOPS* ops)
     return 1;
 }
 
+/** 
+ *  \brief Partition around the median of the first, middle and last elements, the smallest and largest
+ *  \brief of them stay at the ends as sentinels of the scans, elements equal to the reference stop both
+ *  \brief scans so that repeated values still split evenly
+ *  \param[in] array: Data handle
+ *  \param[in] begin: Begin index
+ *  \param[in] end: End index, at least begin + 2
+ *  \param[in] ops: Function operation set
+ *  \return final index of the reference element
+ */
+static int partition(void *array, int begin, int end, SOPS* ops)
+{
+    int mid = begin + ((end - begin) >> 1);
+    int ref = end - 1;
+    int i = begin;
+    int j = ref;
+
+    if (order(mid, begin) > 0) swap(mid, begin);
+    if (order(end, mid) > 0) swap(end, mid);
+    if (order(mid, begin) > 0) swap(mid, begin);
+    swap(mid, ref);
+
+    while (1)
+    {
+        do i++; while (order(i, ref) > 0);
+        do j--; while (order(ref, j) > 0);
+        if (i >= j) break;
+        swap(i, j);
+    }
+    swap(i, ref);
+
+    return i;
+}
+
 /** 
  *  \brief Quick sort algorithm
  *  \param[in] array: Data handle
@@ -170,30 +212,34 @@ int sort_shell(void *array, int begin, int end, SOPS* ops)
  */
 int sort_quick(void *array, int begin, int end, SOPS* ops)
 {
-    int temp = begin;           /* reference */
-    int i = begin;
-    int j = end;
+    int i = 0;
 
     /* Check the validity of input parameters. */
     if (!array) return 0;
     if (begin >= end || begin < 0) return 0;
     if (!ops || !ops->order || !ops->addr || !ops->swap) return 0;
 
-    /* Traverse data */
-    while (i != j)
+    /* Recursively sort the shorter subsequence and loop on the longer one, the stack depth stays within log2(n) */
+    while (begin < end)
     {
-        /* Find numbers that do not conform to the sorting rules from right to left */
-        while (order(j, temp) <= 0 && j > i) j--;
-        /* Find numbers that do not violate the ordering rules from left to right */
-        while (order(i, temp) >= 0 && j > i) i++;
+        if (end - begin < 2)
+        {
+            if (order(end, begin) > 0) swap(begin, end);
+            break;
+        }
 
-        if (j > i) swap(i, j);
+        i = partition(array, begin, end, ops);
+        if (i - begin < end - i)
+        {
+            sort_quick(array, begin, i - 1, ops);
+            begin = i + 1;
+        }
+        else
+        {
+            sort_quick(array, i + 1, end, ops);
+            end = i - 1;
+        }
     }
-    swap(i, temp);
-
-    /* Recursively sort subsequences */
-    sort_quick(array, begin, i, ops);
-    sort_quick(array, i + 1, end, ops);
 
     return 1;
 }
@@ -261,6 +307,192 @@ int sort_heap(void *array, int begin, int end, SOPS* ops)
     return 1;
 }
 
+/** 
+ *  \brief Introspective sort, quick sort that switches to heap sort when the partitions
+ *  \brief keep being unbalanced, and to insert sort for short ranges
+ *  \param[in] array: Data handle
+ *  \param[in] begin: Begin index
+ *  \param[in] end: End index
+ *  \param[in] depth: Remaining partition depth
+ *  \param[in] ops: Function operation set
+ *  \return none
+ */
+static void intro(void *array, int begin, int end, int depth, SOPS* ops)
+{
+    int i = 0;
+
+    while (end - begin >= INSERT_THRESHOLD)
+    {
+        if (depth-- == 0)
+        {
+            sort_heap(array, begin, end, ops);
+            return;
+        }
+
+        i = partition(array, begin, end, ops);
+        if (i - begin < end - i)
+        {
+            intro(array, begin, i - 1, depth, ops);
+            begin = i + 1;
+        }
+        else
+        {
+            intro(array, i + 1, end, depth, ops);
+            end = i - 1;
+        }
+    }
+
+    if (begin < end) sort_insert(array, begin, end, ops);
+}
+
+/** 
+ *  \brief Introspective sort algorithm
+ *  \param[in] array: Data handle
+ *  \param[in] begin: Begin index
+ *  \param[in] end: End index
+ *  \param[in] ops: Function operation set
+ *  \return 1: success or 0: fail
+ */
+int sort_intro(void *array, int begin, int end, SOPS* ops)
+{
+    int depth = 0;
+    int n = 0;
+
+    /* Check the validity of input parameters. */
+    if (!array) return 0;
+    if (begin >= end || begin < 0) return 0;
+    if (!ops || !ops->order || !ops->addr || !ops->swap) return 0;
+
+    /* Allow 2 * log2(n) levels of partition before falling back to heap sort */
+    for (n = end - begin + 1; n > 1; n >>= 1) depth += 2;
+
+    intro(array, begin, end, depth, ops);
+
+    return 1;
+}
+
+/** 
+ *  \brief Exchange the ranges [a, m) and [m, b) by three reversals
+ *  \param[in] array: Data handle
+ *  \param[in] a: Begin of the first range
+ *  \param[in] m: Begin of the second range
+ *  \param[in] b: End of the second range, exclusive
+ *  \param[in] ops: Function operation set
+ *  \return none
+ */
+static void rotate(void *array, int a, int m, int b, SOPS* ops)
+{
+    int i = 0, j = 0;
+
+    for (i = a, j = m - 1; i < j; i++, j--) swap(i, j);
+    for (i = m, j = b - 1; i < j; i++, j--) swap(i, j);
+    for (i = a, j = b - 1; i < j; i++, j--) swap(i, j);
+}
+
+/** 
+ *  \brief Stable merge of the sorted ranges [a, m) and [m, b) without extra space,
+ *  \brief the symmerge algorithm of Kim and Kutzner
+ *  \param[in] array: Data handle
+ *  \param[in] a: Begin of the first range
+ *  \param[in] m: Begin of the second range
+ *  \param[in] b: End of the second range, exclusive
+ *  \param[in] ops: Function operation set
+ *  \return none
+ */
+static void merge(void *array, int a, int m, int b, SOPS* ops)
+{
+    int mid = 0, n = 0, start = 0, stop = 0, c = 0, i = 0, j = 0;
+
+    /* A single element is inserted after the equal elements of the other side, so equal elements keep their order */
+    if (m - a == 1)
+    {
+        i = m, j = b;
+        while (i < j)
+        {
+            c = i + ((j - i) >> 1);
+            if (order(c, a) > 0) i = c + 1;
+            else j = c;
+        }
+        for (c = a; c < i - 1; c++) swap(c, c + 1);
+        return;
+    }
+    if (b - m == 1)
+    {
+        i = a, j = m;
+        while (i < j)
+        {
+            c = i + ((j - i) >> 1);
+            if (order(m, c) <= 0) i = c + 1;
+            else j = c;
+        }
+        for (c = m; c > i; c--) swap(c, c - 1);
+        return;
+    }
+
+    /* Find the split of the first range that pairs with the mirrored split of the second one */
+    mid = a + ((b - a) >> 1);
+    n = mid + m;
+    if (m > mid)
+    {
+        start = n - b;
+        stop = mid;
+    }
+    else
+    {
+        start = a;
+        stop = m;
+    }
+    while (start < stop)
+    {
+        c = start + ((stop - start) >> 1);
+        if (order(n - 1 - c, c) <= 0) start = c + 1;
+        else stop = c;
+    }
+
+    stop = n - start;
+    if (start < m && m < stop) rotate(array, start, m, stop, ops);
+    if (a < start && start < mid) merge(array, a, start, mid, ops);
+    if (mid < stop && stop < b) merge(array, mid, stop, b, ops);
+}
+
+/** 
+ *  \brief Merge sort algorithm, stable, equal elements keep their original order,
+ *  \brief merges in place by rotations because `SOPS` can only swap elements
+ *  \param[in] array: Data handle
+ *  \param[in] begin: Begin index
+ *  \param[in] end: End index
+ *  \param[in] ops: Function operation set
+ *  \return 1: success or 0: fail
+ */
+int sort_merge(void *array, int begin, int end, SOPS* ops)
+{
+    int i = 0;
+    int size = INSERT_THRESHOLD;
+    int tail = end + 1;
+
+    /* Check the validity of input parameters. */
+    if (!array) return 0;
+    if (begin >= end || begin < 0) return 0;
+    if (!ops || !ops->order || !ops->addr || !ops->swap) return 0;
+
+    /* Short runs are sorted by the stable insert sort first */
+    for (i = begin; i < tail; i += size)
+    {
+        if (i + size < tail) sort_insert(array, i, i + size - 1, ops);
+        else if (i < end) sort_insert(array, i, end, ops);
+    }
+
+    for (; size < tail - begin; size <<= 1)
+    {
+        for (i = begin; i + size < tail; i += (size << 1))
+        {
+            merge(array, i, i + size, (i + (size << 1) < tail) ? i + (size << 1) : tail, ops);
+        }
+    }
+
+    return 1;
+}
+
 /* int */
 static int int_ascend(void *front, void *back)
 {
@@ -440,3 +672,504 @@ SOPS sops_float_ascend      = {float_ascend,    float_addr,     float_swap  };
 SOPS sops_float_descend     = {float_descend,   float_addr,     float_swap  };
 SOPS sops_double_ascend     = {double_ascend,   double_addr,    double_swap };
 SOPS sops_double_descend    = {double_descend,  double_addr,    double_swap };
+
+/* Type specialized kernels, the same introspective sort with the compare and move of the type inlined.
+ * `less(x, y)` is true when x must be placed before y */
+
+#define ascend_less(x, y)       ((x) < (y))
+#define descend_less(x, y)      ((y) < (x))
+
+#define SORT_KERNEL(name, type, less)                                                                   \
+static void name##_insert(type *a, int n)                                                               \
+{                                                                                                       \
+    int i, j;                                                                                           \
+    type t;                                                                                             \
+    for (i = 1; i < n; i++)                                                                             \
+    {                                                                                                   \
+        t = a[i];                                                                                       \
+        for (j = i; j > 0 && less(t, a[j - 1]); j--) a[j] = a[j - 1];                                   \
+        a[j] = t;                                                                                       \
+    }                                                                                                   \
+}                                                                                                       \
+static void name##_sift(type *a, int i, int n)                                                          \
+{                                                                                                       \
+    int c;                                                                                              \
+    type t = a[i];                                                                                      \
+    while ((c = (i << 1) + 1) < n)                                                                      \
+    {                                                                                                   \
+        if (c + 1 < n && less(a[c], a[c + 1])) c++;                                                     \
+        if (!less(t, a[c])) break;                                                                      \
+        a[i] = a[c];                                                                                    \
+        i = c;                                                                                          \
+    }                                                                                                   \
+    a[i] = t;                                                                                           \
+}                                                                                                       \
+static void name##_heap(type *a, int n)                                                                 \
+{                                                                                                       \
+    int i;                                                                                              \
+    type t;                                                                                             \
+    for (i = (n >> 1) - 1; i >= 0; i--) name##_sift(a, i, n);                                          \
+    for (i = n - 1; i > 0; i--)                                                                         \
+    {                                                                                                   \
+        t = a[0], a[0] = a[i], a[i] = t;                                                                \
+        name##_sift(a, 0, i);                                                                           \
+    }                                                                                                   \
+}                                                                                                       \
+static void name##_intro(type *a, int n, int depth)                                                     \
+{                                                                                                       \
+    int i, j, m;                                                                                        \
+    type t, p;                                                                                          \
+    while (n > INSERT_THRESHOLD)                                                                        \
+    {                                                                                                   \
+        if (depth-- == 0) { name##_heap(a, n); return; }                                                \
+        /* median of three, the smallest and largest are sentinels of the scans */                      \
+        m = n >> 1;                                                                                     \
+        if (less(a[m], a[0])) t = a[m], a[m] = a[0], a[0] = t;                                          \
+        if (less(a[n - 1], a[m])) t = a[n - 1], a[n - 1] = a[m], a[m] = t;                              \
+        if (less(a[m], a[0])) t = a[m], a[m] = a[0], a[0] = t;                                          \
+        p = a[m];                                                                                       \
+        i = 0, j = n - 1;                                                                               \
+        while (1)                                                                                       \
+        {                                                                                               \
+            do i++; while (less(a[i], p));                                                              \
+            do j--; while (less(p, a[j]));                                                              \
+            if (i >= j) break;                                                                          \
+            t = a[i], a[i] = a[j], a[j] = t;                                                            \
+        }                                                                                               \
+        /* [0, j] and [j + 1, n) are both shorter than n, recurse on the shorter one */                 \
+        j++;                                                                                            \
+        if (j < n - j) { name##_intro(a, j, depth); a += j; n -= j; }                                   \
+        else { name##_intro(a + j, n - j, depth); n = j; }                                              \
+    }                                                                                                   \
+    name##_insert(a, n);                                                                                \
+}
+
+#define SORT_TYPE_DEFINE(name, type)                                                                    \
+SORT_KERNEL(name##_ascend, type, ascend_less)                                                           \
+SORT_KERNEL(name##_descend, type, descend_less)                                                         \
+int sort_##name(type *array, int begin, int end, int descend)                                           \
+{                                                                                                       \
+    int depth = 0, n = 0;                                                                               \
+    if (!array) return 0;                                                                               \
+    if (begin >= end || begin < 0) return 0;                                                            \
+    for (n = end - begin + 1; n > 1; n >>= 1) depth += 2;                                               \
+    if (descend) name##_descend_intro(array + begin, end - begin + 1, depth);                           \
+    else name##_ascend_intro(array + begin, end - begin + 1, depth);                                    \
+    return 1;                                                                                           \
+}
+
+SORT_TYPE_DEFINE(char, char)
+SORT_TYPE_DEFINE(uchar, unsigned char)
+SORT_TYPE_DEFINE(short, short)
+SORT_TYPE_DEFINE(ushort, unsigned short)
+SORT_TYPE_DEFINE(int, int)
+SORT_TYPE_DEFINE(uint, unsigned int)
+SORT_TYPE_DEFINE(float, float)
+SORT_TYPE_DEFINE(double, double)
+
+/* Radix sort keys, the value mapped to an unsigned integer of the same order,
+ * negative numbers are flipped to sort below positive numbers, descending order inverts the key */
+
+static uint32_t key_int(const void *v)
+{
+    return *(const uint32_t *)v ^ 0x80000000u;
+}
+
+static uint32_t key_uint(const void *v)
+{
+    return *(const uint32_t *)v;
+}
+
+static uint32_t key_float(const void *v)
+{
+    uint32_t u;
+    memcpy(&u, v, sizeof(u));
+    return u ^ ((u & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+static uint64_t key_double(const void *v)
+{
+    uint64_t u;
+    memcpy(&u, v, sizeof(u));
+    return u ^ ((u & 0x8000000000000000ull) ? 0xFFFFFFFFFFFFFFFFull : 0x8000000000000000ull);
+}
+
+/* LSD radix sort by bytes, the counts of all digits are taken in one pass, and the passes where
+ * every element has the same digit are skipped. Elements move between the array and a buffer of the
+ * same size, and end in the array */
+#define SORT_RADIX_DEFINE(name, type, key_t, key)                                                       \
+int sort_radix_##name(type *array, int begin, int end, int descend)                                     \
+{                                                                                                       \
+    uint32_t (*count)[256];                                                                             \
+    type *src, *dst, *t;                                                                                \
+    key_t mask, k;                                                                                      \
+    uint32_t pos, c;                                                                                    \
+    int n, i, d;                                                                                        \
+    if (!array) return 0;                                                                               \
+    if (begin >= end || begin < 0) return 0;                                                            \
+    n = end - begin + 1;                                                                                \
+    src = array + begin;                                                                                \
+    dst = (type *)malloc(n * sizeof(type) + sizeof(key_t) * 256 * sizeof(uint32_t));                    \
+    if (!dst) return 0;                                                                                 \
+    count = (uint32_t (*)[256])(dst + n);                                                               \
+    memset(count, 0, sizeof(key_t) * 256 * sizeof(uint32_t));                                           \
+    mask = descend ? (key_t)~(key_t)0 : 0;                                                              \
+    for (i = 0; i < n; i++)                                                                             \
+    {                                                                                                   \
+        k = key(&src[i]) ^ mask;                                                                        \
+        for (d = 0; d < (int)sizeof(key_t); d++) count[d][(k >> (d << 3)) & 0xFF]++;                    \
+    }                                                                                                   \
+    for (d = 0; d < (int)sizeof(key_t); d++)                                                            \
+    {                                                                                                   \
+        k = key(&src[0]) ^ mask;                                                                        \
+        if (count[d][(k >> (d << 3)) & 0xFF] == (uint32_t)n) continue;                                  \
+        for (pos = 0, i = 0; i < 256; i++) c = count[d][i], count[d][i] = pos, pos += c;                \
+        for (i = 0; i < n; i++)                                                                         \
+        {                                                                                               \
+            k = key(&src[i]) ^ mask;                                                                    \
+            dst[count[d][(k >> (d << 3)) & 0xFF]++] = src[i];                                           \
+        }                                                                                               \
+        t = src, src = dst, dst = t;                                                                    \
+    }                                                                                                   \
+    if (src != array + begin)                                                                           \
+    {                                                                                                   \
+        memcpy(array + begin, src, n * sizeof(type));                                                   \
+        dst = src;                                                                                      \
+    }                                                                                                   \
+    free(dst);                                                                                          \
+    return 1;                                                                                           \
+}
+
+SORT_RADIX_DEFINE(int, int, uint32_t, key_int)
+SORT_RADIX_DEFINE(uint, unsigned int, uint32_t, key_uint)
+SORT_RADIX_DEFINE(float, float, uint32_t, key_float)
+SORT_RADIX_DEFINE(double, double, uint64_t, key_double)
+
+#if SORT_USE_PTHREAD
+
+/* A part of the work of a parallel sort, done by one thread */
+typedef struct
+{
+    void *src;                              /**< elements sorted or merged from */
+    void *dst;                              /**< elements merged or copied to */
+    const int *bounds;                      /**< boundaries of the sorted runs of `src`, `runs + 1` items */
+    int runs;                               /**< count of sorted runs */
+    int start;                              /**< first element of the part */
+    int stop;                               /**< element after the part */
+    int phase;                              /**< 0 sort, 1 merge, 2 copy */
+    int descend;                            /**< sorting direction */
+    size_t size;                            /**< size of element */
+    void (*sort)(void *array, int n, int descend);
+    void (*merge)(const void *src, void *dst, const int *bounds, int runs, int start, int stop);
+} PART;
+
+/**
+ *  \brief Do the work of the current phase for one part.
+ *  \param[in] arg: part
+ *  \return NULL
+ */
+static void* part_work(void *arg)
+{
+    PART *part = (PART *)arg;
+
+    switch (part->phase)
+    {
+    case 0:
+        part->sort((char *)part->src + part->start * part->size, part->stop - part->start, part->descend);
+        break;
+    case 1:
+        part->merge(part->src, part->dst, part->bounds, part->runs, part->start, part->stop);
+        break;
+    case 2:
+        memcpy((char *)part->dst + part->start * part->size, (char *)part->src + part->start * part->size, (part->stop - part->start) * part->size);
+        break;
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+/**
+ *  \brief Run one phase over all parts, the first part is done on the calling thread.
+ *         A part whose thread can not be created is done on the calling thread as well.
+ *  \param[in] parts: parts
+ *  \param[in] count: count of parts
+ *  \param[in] phase: phase, @ref PART
+ *  \return none
+ */
+static void part_run(PART *parts, int count, int phase)
+{
+    pthread_t threads[SORT_THREAD_MAX];
+    int created[SORT_THREAD_MAX];
+    int i;
+
+    for (i = 0; i < count; i++) parts[i].phase = phase;
+
+    for (i = 1; i < count; i++)
+    {
+        created[i] = (pthread_create(&threads[i], NULL, part_work, &parts[i]) == 0);
+    }
+
+    part_work(&parts[0]);
+
+    for (i = 1; i < count; i++)
+    {
+        if (created[i]) pthread_join(threads[i], NULL);
+        else part_work(&parts[i]);
+    }
+}
+
+/**
+ *  \brief Count of threads worth using for n elements.
+ *  \param[in] threads: count of threads asked for, not greater than 0 uses the count of online processors
+ *  \param[in] n: count of elements
+ *  \return count of threads, 1 means sequential
+ */
+static int thread_count(int threads, int n)
+{
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > SORT_THREAD_MAX) threads = SORT_THREAD_MAX;
+    if (threads > n / SORT_PARALLEL_MIN) threads = n / SORT_PARALLEL_MIN;
+    return (threads < 1) ? 1 : threads;
+}
+
+/**
+ *  \brief Parallel merge sort of an array, each thread sorts an even run, then the runs are merged
+ *         pairwise in rounds. Every round cuts the output evenly among the threads, a thread finds where
+ *         its cut falls in the two runs by binary search, so all threads stay busy until the last round.
+ *  \param[in] array: array address
+ *  \param[in] n: count of elements
+ *  \param[in] size: size of element
+ *  \param[in] descend: sorting direction
+ *  \param[in] threads: count of threads
+ *  \param[in] sort: sorts a run
+ *  \param[in] merge: merges the parts of runs in the direction
+ *  \return 1: success or 0: fail, nothing is changed when fail
+ */
+static int parallel_merge_sort(void *array, int n, size_t size, int descend, int threads,
+                               void (*sort)(void *array, int n, int descend),
+                               void (*merge)(const void *src, void *dst, const int *bounds, int runs, int start, int stop))
+{
+    PART parts[SORT_THREAD_MAX];
+    int bounds[SORT_THREAD_MAX + 1];
+    void *buffer, *src, *t;
+    int runs, i;
+
+    buffer = malloc(n * size);
+    if (!buffer) return 0;
+
+    for (i = 0; i <= threads; i++) bounds[i] = (int)((long long)n * i / threads);
+    for (i = 0; i < threads; i++)
+    {
+        parts[i].src = array;
+        parts[i].dst = buffer;
+        parts[i].bounds = bounds;
+        parts[i].start = bounds[i];
+        parts[i].stop = bounds[i + 1];
+        parts[i].descend = descend;
+        parts[i].size = size;
+        parts[i].sort = sort;
+        parts[i].merge = merge;
+    }
+    part_run(parts, threads, 0);
+
+    /* The cuts of the output stay at the initial boundaries, only the runs grow */
+    src = array;
+    for (runs = threads; runs > 1; runs = (runs + 1) >> 1)
+    {
+        for (i = 0; i < threads; i++) parts[i].runs = runs;
+        part_run(parts, threads, 1);
+
+        for (i = 1; (i << 1) < runs; i++) bounds[i] = bounds[i << 1];
+        bounds[(runs + 1) >> 1] = n;
+
+        t = src, src = parts[0].dst;
+        for (i = 0; i < threads; i++) parts[i].src = src, parts[i].dst = t;
+    }
+
+    /* The last round merged into the buffer, copy back */
+    if (src != array) part_run(parts, threads, 2);
+
+    free(buffer);
+
+    return 1;
+}
+
+/* Merge the output range [start, stop) of each pair of runs, runs are merged stably */
+#define SORT_MERGE_KERNEL(name, type, less)                                                             \
+static void name##_merge(const void *src, void *dst, const int *bounds, int runs, int start, int stop) \
+{                                                                                                       \
+    const type *s = (const type *)src, *A, *B;                                                          \
+    type *d = (type *)dst;                                                                              \
+    int p, lo, mid, hi, a, b, k, i, j, l, h, out, end;                                                  \
+    for (p = 0; p < runs; p += 2)                                                                       \
+    {                                                                                                   \
+        lo = bounds[p];                                                                                 \
+        mid = bounds[p + 1];                                                                            \
+        hi = (p + 2 <= runs) ? bounds[p + 2] : mid;                                                     \
+        if (hi <= start || lo >= stop) continue;                                                        \
+        out = (start > lo) ? start : lo;                                                                \
+        end = (stop < hi) ? stop : hi;                                                                  \
+        A = s + lo, a = mid - lo;                                                                       \
+        B = s + mid, b = hi - mid;                                                                      \
+        /* i elements of A and k - i of B come before the output position k */                         \
+        k = out - lo;                                                                                   \
+        l = (k > b) ? k - b : 0;                                                                        \
+        h = (k < a) ? k : a;                                                                            \
+        while (l < h)                                                                                   \
+        {                                                                                               \
+            i = l + ((h - l) >> 1);                                                                     \
+            if (!less(B[k - i - 1], A[i])) l = i + 1;                                                   \
+            else h = i;                                                                                 \
+        }                                                                                               \
+        i = l, j = k - l;                                                                               \
+        while (out < end)                                                                               \
+        {                                                                                               \
+            if (j >= b || (i < a && !less(B[j], A[i]))) d[out++] = A[i++];                              \
+            else d[out++] = B[j++];                                                                     \
+        }                                                                                               \
+    }                                                                                                   \
+}
+
+#define SORT_PARALLEL_DEFINE(name, type)                                                                \
+SORT_MERGE_KERNEL(name##_ascend, type, ascend_less)                                                     \
+SORT_MERGE_KERNEL(name##_descend, type, descend_less)                                                   \
+static void name##_sort_run(void *array, int n, int descend)                                            \
+{                                                                                                       \
+    sort_##name((type *)array, 0, n - 1, descend);                                                      \
+}                                                                                                       \
+int sort_parallel_##name(type *array, int begin, int end, int descend, int threads)                     \
+{                                                                                                       \
+    if (!array) return 0;                                                                               \
+    if (begin >= end || begin < 0) return 0;                                                            \
+    threads = thread_count(threads, end - begin + 1);                                                   \
+    if (threads > 1 && parallel_merge_sort(array + begin, end - begin + 1, sizeof(type), descend, threads, \
+        name##_sort_run, descend ? name##_descend_merge : name##_ascend_merge)) return 1;               \
+    return sort_##name(array, begin, end, descend);                                                     \
+}
+
+/* A range of the generic parallel sort, with the threads it may use */
+typedef struct
+{
+    void *array;                            /**< data handle */
+    int begin;                              /**< begin index */
+    int end;                                /**< end index */
+    int depth;                              /**< remaining partition depth */
+    int threads;                            /**< threads for the range */
+    SOPS *ops;                              /**< operation function set */
+} SPLIT;
+
+/**
+ *  \brief Partition the range and hand one side to a new thread, the threads are shared in proportion
+ *         to the sizes of the sides. A side too small for a share of the threads is sorted at once by `intro()`
+ *         and the other side keeps all of them, so unbalanced partitions do not leave threads idle.
+ *  \param[in] arg: range
+ *  \return NULL
+ */
+static void* split_work(void *arg)
+{
+    SPLIT *split = (SPLIT *)arg;
+    SPLIT others[SORT_THREAD_MAX];
+    pthread_t threads[SORT_THREAD_MAX];
+    int created[SORT_THREAD_MAX];
+    void *array = split->array;
+    SOPS *ops = split->ops;
+    int count = 0, n = 0, share = 0, i = 0;
+
+    while (split->threads > 1 && split->depth > 0 && split->end - split->begin >= SORT_PARALLEL_MIN)
+    {
+        i = partition(array, split->begin, split->end, ops);
+        split->depth--;
+
+        n = split->end - split->begin + 1;
+        share = (int)(((long long)split->threads * (split->end - i) * 2 + n) / (n * 2));
+
+        if (share == 0)
+        {
+            intro(array, i + 1, split->end, split->depth, ops);
+            split->end = i - 1;
+        }
+        else if (share == split->threads)
+        {
+            intro(array, split->begin, i - 1, split->depth, ops);
+            split->begin = i + 1;
+        }
+        else
+        {
+            others[count] = *split;
+            others[count].begin = i + 1;
+            others[count].threads = share;
+            split->end = i - 1;
+            split->threads -= share;
+            created[count] = (pthread_create(&threads[count], NULL, split_work, &others[count]) == 0);
+            count++;
+        }
+    }
+
+    intro(array, split->begin, split->end, split->depth, ops);
+
+    for (i = 0; i < count; i++)
+    {
+        if (created[i]) pthread_join(threads[i], NULL);
+        else split_work(&others[i]);
+    }
+
+    return NULL;
+}
+
+#else
+
+#define SORT_PARALLEL_DEFINE(name, type)                                                                \
+int sort_parallel_##name(type *array, int begin, int end, int descend, int threads)                     \
+{                                                                                                       \
+    return sort_##name(array, begin, end, descend);                                                     \
+}
+
+#endif
+
+SORT_PARALLEL_DEFINE(char, char)
+SORT_PARALLEL_DEFINE(uchar, unsigned char)
+SORT_PARALLEL_DEFINE(short, short)
+SORT_PARALLEL_DEFINE(ushort, unsigned short)
+SORT_PARALLEL_DEFINE(int, int)
+SORT_PARALLEL_DEFINE(uint, unsigned int)
+SORT_PARALLEL_DEFINE(float, float)
+SORT_PARALLEL_DEFINE(double, double)
+
+/** 
+ *  \brief Parallel sort algorithm, introspective sort whose partitions are sorted on separate threads,
+ *  \brief the functions of `ops` are called from several threads at once on disjoint elements
+ *  \param[in] array: Data handle
+ *  \param[in] begin: Begin index
+ *  \param[in] end: End index
+ *  \param[in] ops: Function operation set
+ *  \param[in] threads: count of threads, not greater than 0 uses the count of online processors
+ *  \return 1: success or 0: fail
+ */
+int sort_parallel(void *array, int begin, int end, SOPS* ops, int threads)
+{
+#if SORT_USE_PTHREAD
+    SPLIT split;
+    int n = 0;
+
+    /* Check the validity of input parameters. */
+    if (!array) return 0;
+    if (begin >= end || begin < 0) return 0;
+    if (!ops || !ops->order || !ops->addr || !ops->swap) return 0;
+
+    split.array = array;
+    split.begin = begin;
+    split.end = end;
+    split.depth = 0;
+    split.threads = thread_count(threads, end - begin + 1);
+    split.ops = ops;
+    for (n = end - begin + 1; n > 1; n >>= 1) split.depth += 2;
+
+    split_work(&split);
+
+    return 1;
+#else
+    return sort_intro(array, begin, end, ops);
+#endif
+}
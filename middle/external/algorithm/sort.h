@@ -16,6 +16,16 @@
 #define SORT_V_MAJOR                        1
 #define SORT_V_MINOR                        0
 #define SORT_V_PATCH                        0
+
+/* Configuration information */
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define SORT_USE_PTHREAD                    1   /**< 1 sort on POSIX threads in `sort_parallel()` and `sort_parallel_xxx()`, 0 always sort sequentially */
+#else
+#define SORT_USE_PTHREAD                    0
+#endif
+#define SORT_THREAD_MAX                     64  /**< most threads used by a parallel sort */
+#define SORT_PARALLEL_MIN                   4096 /**< least elements given to each thread */
           
 /* Sorting algorithm operation function set structure definition */
 typedef struct 
@@ -71,6 +81,19 @@ int sort_insert(void *array, int begin, int end, SOPS* ops);
 int sort_shell(void *array, int begin, int end, SOPS* ops);
 int sort_quick(void *array, int begin, int end, SOPS* ops);
 int sort_heap(void *array, int begin, int end, SOPS* ops);
+int sort_intro(void *array, int begin, int end, SOPS* ops);
+int sort_merge(void *array, int begin, int end, SOPS* ops);
+
+/* Parallel sorting algorithm declare
+ *
+ * The introspective sort with the partitions sorted on separate threads, the functions of `ops` are called
+ * from several threads at once on disjoint elements, so they must not share writable state.
+ * Short ranges, or a build without `SORT_USE_PTHREAD`, are sorted sequentially by `sort_intro()`.
+ *
+ *  \param[in] threads: count of threads, not greater than 0 uses the count of online processors
+ */
+
+int sort_parallel(void *array, int begin, int end, SOPS* ops, int threads);
 
 /* Basic `SOPS` declare
  * 
@@ -99,4 +122,52 @@ extern SOPS sops_float_descend;
 extern SOPS sops_double_ascend;
 extern SOPS sops_double_descend;
 
+/* Type specialized sorting algorithm declare
+ *
+ * Sort arrays of basic types without `SOPS`, the compare and move of the type are inlined.
+ *
+ * `sort_xxx` is the introspective sort, in place and not stable.
+ *
+ * `sort_radix_xxx` is the LSD radix sort, stable and in linear time, it allocates a buffer as large as
+ * the range to be sorted, fails when the allocation fails. NaN of floats are not supported by either.
+ *
+ *  \param[in] array: array address
+ *  \param[in] begin: begin index
+ *  \param[in] end: end index
+ *  \param[in] descend: 0 ascending, other descending
+ *  \return 1: success or 0: fail
+ */
+
+int sort_char(char *array, int begin, int end, int descend);
+int sort_uchar(unsigned char *array, int begin, int end, int descend);
+int sort_short(short *array, int begin, int end, int descend);
+int sort_ushort(unsigned short *array, int begin, int end, int descend);
+int sort_int(int *array, int begin, int end, int descend);
+int sort_uint(unsigned int *array, int begin, int end, int descend);
+int sort_float(float *array, int begin, int end, int descend);
+int sort_double(double *array, int begin, int end, int descend);
+
+int sort_radix_int(int *array, int begin, int end, int descend);
+int sort_radix_uint(unsigned int *array, int begin, int end, int descend);
+int sort_radix_float(float *array, int begin, int end, int descend);
+int sort_radix_double(double *array, int begin, int end, int descend);
+
+/* Type specialized parallel sorting algorithm declare
+ *
+ * Merge sort on several threads, each thread sorts a run with `sort_xxx()`, then the runs are merged in rounds
+ * with all threads sharing each round. It allocates a buffer as large as the range to be sorted, and sorts
+ * sequentially by `sort_xxx()` when the allocation fails, the range is short or there is no `SORT_USE_PTHREAD`.
+ *
+ *  \param[in] threads: count of threads, not greater than 0 uses the count of online processors
+ */
+
+int sort_parallel_char(char *array, int begin, int end, int descend, int threads);
+int sort_parallel_uchar(unsigned char *array, int begin, int end, int descend, int threads);
+int sort_parallel_short(short *array, int begin, int end, int descend, int threads);
+int sort_parallel_ushort(unsigned short *array, int begin, int end, int descend, int threads);
+int sort_parallel_int(int *array, int begin, int end, int descend, int threads);
+int sort_parallel_uint(unsigned int *array, int begin, int end, int descend, int threads);
+int sort_parallel_float(float *array, int begin, int end, int descend, int threads);
+int sort_parallel_double(double *array, int begin, int end, int descend, int threads);
+
 #endif 
@@ -11,6 +11,7 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "calculate.h"
+#include "fpconv.h"
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
@@ -93,52 +94,23 @@ static char* skip(char* in)
  */
 static double v_atof(const char *s, int len)
 {
-    long double result = 0.0L;
-    int sign = 1; /* +/- sign */
-    int fraction = 0; /* decimal part flag, 1 has a decimal part, but 0 does not. */
-    long double div = 1.0L; /* decimal division factor */
-    
-    /* Get the numerical prefix, positive or negative */
-    if (*s == '-') { sign = -1; s++; }
-    else if (*s == '+') { s++; }
-    
-    /* Within the valid length and legal characters, convert bit by bit */
-    while (len-- > 0 && (isdigit(*s) || *s == '.'))
-    {
-        /* Parsed to the decimal point, the value has a decimal part */
-        if (*s == '.')
-        {
-            /* There is already a decimal point, no more decimal points are allowed. */
-            if (fraction == 1) return NAN;
-            
-            /* Mark the decimal point and skip the decimal point */
-            fraction = 1;
-            s++;
-            continue;
-        }
-        
-        /* Integer part */
-        if (fraction == 0)
-        {
-            result = result * 10.0L + (long double) (*s - '0');
-        }
-        /* Decimal part */
-        else 
-        {
-            div *= 10.0L;
-            result = result + (long double) (*s - '0') / div;
-        }
-        
-        s++;
-    }
-    
+    char *end;
+    double result;
+
+    /* Convert the longest valid numeric prefix within the length */
+    result = fpconv_strntod(s, len, &end);
+    if (end == s) return NAN;
+
+    /* There is already a decimal point, no more decimal points are allowed. */
+    if (end < s + len && *end == '.') return NAN;
+
     /* Skip extra spaces */
-    while (len-- > 0)
+    for (; end < s + len; end++)
     {
-        if (*s++ > ' ') return NAN;
+        if (*end > ' ') return NAN;
     }
-    
-    return sign * result;
+
+    return result;
 }
 
 static double get_number(char *p, int size)
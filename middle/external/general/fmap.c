@@ -0,0 +1,321 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fmap.c
+ *         \unit  fmap
+ *        \brief  This is a C language read-only file mapping module, to load whole text files without copying
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if FMAP_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sched.h>
+#include <string.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS                       MAP_ANON
+#endif
+#endif
+
+/* how the content is held */
+#define TYPE_EMPTY                          (0) /* empty file, points to a static terminator */
+#define TYPE_HEAP                           (1) /* read into allocated memory */
+#define TYPE_MMAP                           (2) /* mapped file */
+
+#if FMAP_USE_MMAP
+/* state of a map slot */
+#define SLOT_FREE                           (0) /* not used */
+#define SLOT_BUSY                           (1) /* being set up or released, the handler skips it */
+#define SLOT_MAPPED                         (2) /* holds a mapped file */
+
+/* Mapped files, the SIGBUS handler looks up the faulting address in them */
+typedef struct
+{
+    volatile int state;                     /**< SLOT_xxx */
+    char* base;                             /**< address of the reservation */
+    unsigned long length;                   /**< length of the reservation, whole pages */
+    volatile sig_atomic_t changed;          /**< pages were lost to a truncation and replaced by zero pages */
+} SLOT;
+
+static SLOT slots[FMAP_MAP_MAX];
+static volatile int installed = 0;          /* 0 no handler, 1 being installed, 2 installed */
+static struct sigaction previous;           /* handler installed before, for the faults of other addresses */
+static long page_size = 0;
+
+/**
+ *  \brief SIGBUS handler, a page of a mapped file lost to a truncation is replaced by a zero page,
+ *  \brief so the reader sees the text end there instead of being killed. Other signals are passed on.
+ *  \param[in] sig: signal number
+ *  \param[in] info: signal information, `si_addr` is the faulting address
+ *  \param[in] context: signal context
+ *  \return none
+ */
+static void fmap_sigbus(int sig, siginfo_t* info, void* context)
+{
+    char* address = (char*)info->si_addr;
+    char* page;
+    int i;
+
+    for (i = 0; i < FMAP_MAP_MAX; i++)
+    {
+        if (slots[i].state != SLOT_MAPPED) continue;
+        if (address < slots[i].base || address >= slots[i].base + slots[i].length) continue;
+
+        page = slots[i].base + (address - slots[i].base) / page_size * page_size;
+        if (mmap(page, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED)
+        {
+            slots[i].changed = 1;
+            return;
+        }
+        break;
+    }
+
+    /* Not a mapped file */
+    if (previous.sa_flags & SA_SIGINFO)
+    {
+        previous.sa_sigaction(sig, info, context);
+    }
+    else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+    {
+        previous.sa_handler(sig);
+    }
+    else
+    {
+        /* The default action, delivered as soon as the handler returns */
+        sigaction(SIGBUS, &previous, NULL);
+        raise(sig);
+    }
+}
+
+/**
+ *  \brief Install the SIGBUS handler once, concurrent callers wait for the first one.
+ *  \return 1 installed or 0 fail
+ */
+static int fmap_install(void)
+{
+    struct sigaction action;
+
+    if (installed == 2) return 1;
+
+    if (__sync_bool_compare_and_swap(&installed, 0, 1))
+    {
+        page_size = sysconf(_SC_PAGESIZE);
+
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = fmap_sigbus;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        if (page_size <= 0 || sigaction(SIGBUS, &action, &previous) < 0)
+        {
+            __sync_lock_release(&installed);
+            return 0;
+        }
+
+        __sync_bool_compare_and_swap(&installed, 1, 2);
+        return 1;
+    }
+
+    while (installed == 1) sched_yield();
+
+    return installed == 2;
+}
+
+/**
+ *  \brief Map a regular file into a reservation of whole pages, at least one byte longer than the file,
+ *  \brief and write the terminator after the content.
+ *  \param[out] map: file map
+ *  \param[in] fd: file descriptor
+ *  \param[in] size: size of file
+ *  \return 1 success or 0 fail, the file is then read
+ */
+static int fmap_map(FMAP* map, int fd, unsigned long size)
+{
+    unsigned long length;
+    char* base;
+    int i;
+
+    if (!fmap_install()) return 0;
+
+    for (i = 0; i < FMAP_MAP_MAX; i++)
+    {
+        if (__sync_bool_compare_and_swap(&slots[i].state, SLOT_FREE, SLOT_BUSY)) break;
+    }
+    if (i >= FMAP_MAP_MAX) return 0;
+
+    /* Reserve zero pages first, the file is mapped over the front of them,
+     * so a file that ends on a page boundary is still followed by a zero page */
+    length = (size / page_size + 1) * page_size;
+    base = (char*)mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == (char*)MAP_FAILED)
+    {
+        __sync_lock_release(&slots[i].state);
+        return 0;
+    }
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(base, length);
+        __sync_lock_release(&slots[i].state);
+        return 0;
+    }
+
+    slots[i].base = base;
+    slots[i].length = length;
+    slots[i].changed = 0;
+    __sync_bool_compare_and_swap(&slots[i].state, SLOT_BUSY, SLOT_MAPPED);
+
+    /* The terminator is written, not taken from the zero fill of the last page, it makes a private copy of
+     * that page, so a writer appending to the file can no longer reach it */
+    base[size] = 0;
+    mprotect(base, length, PROT_READ);
+
+#ifdef MADV_SEQUENTIAL
+    /* Parsers read from front to back */
+    madvise(base, length, MADV_SEQUENTIAL);
+#endif
+
+    map->data = base;
+    map->size = size;
+    map->type = TYPE_MMAP;
+    map->slot = i;
+
+    return 1;
+}
+
+/**
+ *  \brief Release a map slot and its mapping.
+ *  \param[in] slot: map slot
+ *  \return error type
+ */
+static int fmap_unmap(int slot)
+{
+    int error;
+
+    __sync_bool_compare_and_swap(&slots[slot].state, SLOT_MAPPED, SLOT_BUSY);
+    error = slots[slot].changed ? FMAP_E_CHANGED : FMAP_E_OK;
+    munmap(slots[slot].base, slots[slot].length);
+    slots[slot].base = NULL;
+    slots[slot].length = 0;
+    __sync_lock_release(&slots[slot].state);
+
+    return error;
+}
+#endif
+
+/**
+ *  \brief Read a file into allocated memory and terminate it.
+ *  \param[out] map: file map
+ *  \param[in] filename: file name
+ *  \return error type
+ */
+static int fmap_read(FMAP* map, const char* filename)
+{
+    FILE* f;
+    long len;
+    char* data;
+
+    /* open file and get the length of file */
+    f = fopen(filename, "rb");
+    if (!f) return FMAP_E_OPEN;
+
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len < 0)
+    {
+        fclose(f);
+        return FMAP_E_OPEN;
+    }
+
+    /* read file */
+    data = (char*)malloc(len + 1);
+    if (!data)
+    {
+        fclose(f);
+        return FMAP_E_MEMORY;
+    }
+    len = fread(data, 1, len, f);
+    fclose(f);
+
+    data[len] = 0;
+
+    map->data = data;
+    map->size = len;
+    map->type = TYPE_HEAP;
+
+    return FMAP_E_OK;
+}
+
+int fmap_open(FMAP* map, const char* filename)
+{
+#if FMAP_USE_MMAP
+    struct stat st;
+    int fd;
+#endif
+
+    if (!map || !filename) return FMAP_E_INVALID;
+
+    map->data = "";
+    map->size = 0;
+    map->type = TYPE_EMPTY;
+    map->slot = -1;
+
+#if FMAP_USE_MMAP
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return FMAP_E_OPEN;
+
+    if (fstat(fd, &st) < 0)
+    {
+        close(fd);
+        return FMAP_E_OPEN;
+    }
+
+    /* Empty files have nothing to map */
+    if (S_ISREG(st.st_mode) && st.st_size == 0)
+    {
+        close(fd);
+        return FMAP_E_OK;
+    }
+
+    /* Regular files are mapped, the mapping stays valid after the descriptor is closed */
+    if (S_ISREG(st.st_mode) && (off_t)(unsigned long)st.st_size == st.st_size && fmap_map(map, fd, st.st_size))
+    {
+        close(fd);
+        return FMAP_E_OK;
+    }
+
+    close(fd);
+#endif
+
+    return fmap_read(map, filename);
+}
+
+int fmap_close(FMAP* map)
+{
+    int error = FMAP_E_OK;
+
+    if (!map) return FMAP_E_INVALID;
+
+#if FMAP_USE_MMAP
+    if (map->type == TYPE_MMAP) error = fmap_unmap(map->slot);
+#endif
+    if (map->type == TYPE_HEAP) free((void*)map->data);
+
+    map->data = "";
+    map->size = 0;
+    map->type = TYPE_EMPTY;
+    map->slot = -1;
+
+    return error;
+}
@@ -0,0 +1,100 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fmap.h
+ *         \unit  fmap
+ *        \brief  This is a C language read-only file mapping module, to load whole text files without copying
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __fmap_H
+#define __fmap_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Version infomation */
+
+#define FMAP_V_MAJOR                        1
+#define FMAP_V_MINOR                        0
+#define FMAP_V_PATCH                        0
+
+/* Configuration information */
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define FMAP_USE_MMAP                       1   /**< 1 map files with mmap, 0 always read files into memory */
+#else
+#define FMAP_USE_MMAP                       0
+#endif
+
+#define FMAP_MAP_MAX                        16  /**< maps open at once, further files are read into memory */
+
+/* Error type define */
+
+#define FMAP_E_OK                           (0) /* ok, no error */
+#define FMAP_E_INVALID                      (1) /* invalid parameter */
+#define FMAP_E_OPEN                         (2) /* failed to open or read file */
+#define FMAP_E_MEMORY                       (3) /* memory allocation failed */
+#define FMAP_E_CHANGED                      (4) /* the file was truncated while mapped, the lost part read as zeros */
+
+/* File map define */
+typedef struct
+{
+    const char* data;                       /**< file content, always followed by a terminator */
+    unsigned long size;                     /**< size of file content */
+    int type;                               /**< how the content is held, not for external use */
+    int slot;                               /**< map slot, not for external use */
+} FMAP;
+
+/**
+ *  \brief Open a file as a terminated read-only text.
+ *         Regular files are mapped into whole pages with room for one more byte, and the terminator is written
+ *         after the content, into a private copy of the last page or into the zero page after it,
+ *         so the text stays terminated when a writer appends to the file while it is open.
+ *         When a writer truncates the file, the pages lost would fault on reading, a SIGBUS handler installed
+ *         by the first mapping replaces them by zero pages instead, and `fmap_close()` reports it.
+ *         SIGBUS of other addresses goes on to the handler installed before.
+ *         Other files, or when mapping is not available or `FMAP_MAP_MAX` maps are open, are read into
+ *         allocated memory.
+ *  \param[out] map: file map
+ *  \param[in] filename: file name
+ *  \return error type, @ref FMAP_E_xxx
+ */
+int fmap_open(FMAP* map, const char* filename);
+
+/**
+ *  \brief Release a file map opened by `fmap_open()`, `map->data` is invalid afterwards.
+ *  \param[in] map: file map
+ *  \return error type, FMAP_E_CHANGED when the file was truncated while open and what was read of it is not valid
+ */
+int fmap_close(FMAP* map);
+
+#if 0 /* for example */
+#include <stdio.h>
+#include <string.h>
+#include "fmap.h"
+
+int main(void)
+{
+    FMAP map;
+
+    if (fmap_open(&map, "data.csv") != FMAP_E_OK) return 1;
+
+    printf("%lu bytes, first line: %.*s\r\n", map.size, (int)strcspn(map.data, "\r\n"), map.data);
+
+    if (fmap_close(&map) == FMAP_E_CHANGED) printf("the file was truncated while reading\r\n");
+
+    return 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,221 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fsave.c
+ *         \unit  fsave
+ *        \brief  This is a C language file saving module, to replace whole files atomically or patch them in place
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fsave.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if FSAVE_USE_FSYNC
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#endif
+
+/**
+ *  \brief Flush a written file to the device and close it.
+ *  \param[in] f: file
+ *  \return 1 success or 0 fail
+ */
+static int fsave_close(FILE* f)
+{
+    int ok = 1;
+
+    if (fflush(f) != 0) ok = 0;
+#if FSAVE_USE_FSYNC
+    if (ok && fsync(fileno(f)) != 0) ok = 0;
+#elif defined(_WIN32)
+    if (ok && _commit(_fileno(f)) != 0) ok = 0;
+#endif
+    if (fclose(f) != 0) ok = 0;
+
+    return ok;
+}
+
+#if FSAVE_USE_FSYNC
+/**
+ *  \brief Flush the directory holding a file, so that a rename in it reaches the device.
+ *  \param[in] filename: file name
+ *  \return 1 success or 0 fail
+ */
+static int fsave_sync_dir(const char* filename)
+{
+    const char* slash = strrchr(filename, '/');
+    char* dir;
+    int fd, ok;
+
+    if (!slash) dir = strdup(".");
+    else if (slash == filename) dir = strdup("/");
+    else
+    {
+        dir = (char*)malloc(slash - filename + 1);
+        if (dir)
+        {
+            memcpy(dir, filename, slash - filename);
+            dir[slash - filename] = '\0';
+        }
+    }
+    if (!dir) return 0;
+
+    fd = open(dir, O_RDONLY);
+    free(dir);
+    if (fd < 0) return 0;
+
+    ok = (fsync(fd) == 0);
+    close(fd);
+
+    return ok;
+}
+#endif
+
+int fsave_atomic(const char* filename, const char* data, unsigned long size)
+{
+    FILE* f;
+    char* temp;
+    size_t len;
+
+    if (!filename) return FSAVE_E_INVALID;
+    if (!data && size > 0) return FSAVE_E_INVALID;
+
+    /* Temporary file next to the target, so that renaming stays on one file system */
+    len = strlen(filename);
+    temp = (char*)malloc(len + 5);
+    if (!temp) return FSAVE_E_MEMORY;
+    memcpy(temp, filename, len);
+    memcpy(temp + len, ".tmp", 5);
+
+    f = fopen(temp, "wb");
+    if (!f)
+    {
+        free(temp);
+        return FSAVE_E_OPEN;
+    }
+
+    /* The content must reach the device before it replaces the file */
+    if (fwrite(data, 1, size, f) != size)
+    {
+        fclose(f);
+        goto FAIL;
+    }
+    if (!fsave_close(f)) goto FAIL;
+
+#if defined(_WIN32)
+    /* rename does not replace an existing file here, the move replaces it in one step */
+    if (!MoveFileExA(temp, filename, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) goto FAIL;
+#else
+    if (rename(temp, filename) != 0) goto FAIL;
+#endif
+
+    free(temp);
+
+#if FSAVE_USE_FSYNC
+    /* The file is replaced, but the rename is only durable once the directory is flushed */
+    if (!fsave_sync_dir(filename)) return FSAVE_E_WRITE;
+#endif
+
+    return FSAVE_E_OK;
+
+FAIL:
+    remove(temp);
+    free(temp);
+    return FSAVE_E_WRITE;
+}
+
+unsigned long fsave_check(const char* data, unsigned long size)
+{
+    unsigned long hash = 2166136261UL;
+    unsigned long i;
+
+    /* FNV-1a over the content, then the size */
+    for (i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    hash ^= size & 0xFFFFFFFFUL;
+    hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+
+    return hash;
+}
+
+int fsave_patch(const char* filename, unsigned long* check, const FSAVE_PATCH* patches, int count)
+{
+    FILE* f;
+    char* content;
+    long length;
+    unsigned long size;
+    int i;
+
+    if (!filename || !check) return FSAVE_E_INVALID;
+    if (!patches && count > 0) return FSAVE_E_INVALID;
+
+    f = fopen(filename, "r+b");
+    if (!f) return FSAVE_E_OPEN;
+
+    if (fseek(f, 0, SEEK_END) != 0 || (length = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0)
+    {
+        fclose(f);
+        return FSAVE_E_OPEN;
+    }
+    size = (unsigned long)length;
+
+    /* The offsets only hold for the file they were taken from, the whole content is compared */
+    content = (char*)malloc(size + 1);
+    if (!content)
+    {
+        fclose(f);
+        return FSAVE_E_MEMORY;
+    }
+    if (fread(content, 1, size, f) != size || fsave_check(content, size) != *check)
+    {
+        free(content);
+        fclose(f);
+        return FSAVE_E_CHANGED;
+    }
+
+    /* All patches must lie within the file */
+    for (i = 0; i < count; i++)
+    {
+        if (patches[i].offset > size || patches[i].size > size - patches[i].offset)
+        {
+            free(content);
+            fclose(f);
+            return FSAVE_E_INVALID;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (fseek(f, (long)patches[i].offset, SEEK_SET) != 0 ||
+            fwrite(patches[i].data, 1, patches[i].size, f) != patches[i].size)
+        {
+            free(content);
+            fclose(f);
+            return FSAVE_E_WRITE;
+        }
+        memcpy(content + patches[i].offset, patches[i].data, patches[i].size);
+    }
+
+    if (!fsave_close(f))
+    {
+        free(content);
+        return FSAVE_E_WRITE;
+    }
+
+    *check = fsave_check(content, size);
+    free(content);
+
+    return FSAVE_E_OK;
+}
@@ -0,0 +1,106 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fsave.h
+ *         \unit  fsave
+ *        \brief  This is a C language file saving module, to replace whole files atomically or patch them in place
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __fsave_H
+#define __fsave_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Version infomation */
+
+#define FSAVE_V_MAJOR                       1
+#define FSAVE_V_MINOR                       0
+#define FSAVE_V_PATCH                       0
+
+/* Configuration information */
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define FSAVE_USE_FSYNC                     1   /**< 1 flush written files to the device before they take effect */
+#else
+#define FSAVE_USE_FSYNC                     0
+#endif
+
+/* Error type define */
+
+#define FSAVE_E_OK                          (0) /* ok, no error */
+#define FSAVE_E_INVALID                     (1) /* invalid parameter */
+#define FSAVE_E_OPEN                        (2) /* failed to open file */
+#define FSAVE_E_WRITE                       (3) /* failed to write or replace file */
+#define FSAVE_E_MEMORY                      (4) /* memory allocation failed */
+#define FSAVE_E_CHANGED                     (5) /* file content is not the expected one, nothing patched */
+
+/* Patch define, a range of the file to overwrite */
+typedef struct
+{
+    unsigned long offset;                   /**< offset in file */
+    const char* data;                       /**< new content */
+    unsigned long size;                     /**< size of new content */
+} FSAVE_PATCH;
+
+/**
+ *  \brief Replace a whole file atomically.
+ *         The content is written to `<filename>.tmp` first, then renamed to the file,
+ *         so the file always holds either the old or the new content.
+ *  \param[in] filename: file name
+ *  \param[in] data: file content
+ *  \param[in] size: size of file content
+ *  \return error type, @ref FSAVE_E_xxx
+ */
+int fsave_atomic(const char* filename, const char* data, unsigned long size);
+
+/**
+ *  \brief Check value of a file content, covering its size, to know a file is still the one patches refer to.
+ *  \param[in] data: file content
+ *  \param[in] size: size of file content
+ *  \return check value
+ */
+unsigned long fsave_check(const char* data, unsigned long size);
+
+/**
+ *  \brief Overwrite ranges of a file in place, the file size is not changed.
+ *         The file is read first and left untouched when its check value is not the expected one,
+ *         such as a file edited by others since it was loaded or saved.
+ *         The ranges are written in order, when interrupted, the file may have a part of them.
+ *  \param[in] filename: file name
+ *  \param[in,out] check: check value of the expected file, updated to the patched file
+ *  \param[in] patches: ranges to overwrite, all within the file
+ *  \param[in] count: count of patches
+ *  \return error type, @ref FSAVE_E_xxx
+ */
+int fsave_patch(const char* filename, unsigned long* check, const FSAVE_PATCH* patches, int count);
+
+#if 0 /* for example */
+#include <stdio.h>
+#include <string.h>
+#include "fsave.h"
+
+int main(void)
+{
+    const char* text = "[net]\nport = 8080\n";
+    FSAVE_PATCH patch = { 13, "9090", 4 };
+    unsigned long check = fsave_check(text, strlen(text));
+
+    if (fsave_atomic("net.ini", text, strlen(text)) != FSAVE_E_OK) return 1;
+    if (fsave_patch("net.ini", &check, &patch, 1) != FSAVE_E_OK) return 1;
+
+    return 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -47,6 +47,14 @@ typedef struct
 
 static rbtree_t mrbtree = NULL;
 
+/* allocation statistics */
+static int vcount = 0;          /**< count of allocations since the last reset */
+static int vused = 0;           /**< size of memory currently allocated */
+static int vpeak = 0;           /**< peak of vused since the last reset */
+
+/* account a change of the allocated size */
+#define v_account(n)            do { vused += (n); if (vused > vpeak) vpeak = vused; } while (0)
+
 static rbtree_t rbtree_create(void)
 {
     rbtree_t rbtree;
@@ -366,18 +374,6 @@ static int rbtree_size(rbtree_t rbtree)
     return rbtree->size;
 }
 
-static int rbtree_find(rbtree_t rbtree, void* pointer)
-{
-    if (!rbtree) return 0;
-    return rbtree_find_node(rbtree, pointer)==rbtree->nil?0:1;
-}
-
-static minfo* rbtree_data(rbtree_t rbtree, void* pointer)
-{
-    if (!rbtree) return NULL;
-    return &(rbtree_find_node(rbtree, pointer)->info);
-}
-
 
 static NODE* node_next(rbtree_t rbtree, NODE* node)
 {
@@ -428,6 +424,8 @@ void* vm_malloc(size_t size, char *file, int line)
         free(p);
         return NULL;
     }
+    vcount++;
+    v_account((int)size);
     return p;
 }
 
@@ -442,7 +440,12 @@ void* vm_calloc(size_t num, size_t size, char *file, int line)
 
 void vm_free(void* block)
 {
+    NODE* node;
     if (!block) return;
+    if (!mrbtree) return;
+    node = rbtree_find_node(mrbtree, block);
+    if (node == mrbtree->nil) return;
+    vused -= node->info.size;
     if (rbtree_erase(mrbtree, block)) free(block);
     if (rbtree_size(mrbtree) == 0) 
     {
@@ -454,6 +457,7 @@ void vm_free(void* block)
 void* vm_realloc(void* block, size_t size, char *file, int line)
 {
     void* p;
+    NODE* node;
     if (!block) 
     {
         return vm_malloc(size, file, line);
@@ -463,21 +467,24 @@ void* vm_realloc(void* block, size_t size, char *file, int line)
         vm_free(block);
         return NULL;
     }
-    if (!rbtree_find(mrbtree, block)) return NULL;
+    if (!mrbtree) return NULL;
+    /* Only the node is used after realloc, `block` may have been released */
+    node = rbtree_find_node(mrbtree, block);
+    if (node == mrbtree->nil) return NULL;
     p = realloc(block, size);
     if (!p) return NULL;
-    if (p == block)
+    vcount++;
+    v_account((int)size - node->info.size);
+    if (p == node->pointer)
     {
-        minfo *info;
-        info = rbtree_data(mrbtree, block);
-        info->file = file;
-        info->line = line;
-        info->size = size;
+        node->info.file = file;
+        node->info.line = line;
+        node->info.size = size;
     }
     else  
     {
         minfo info;
-        rbtree_erase(mrbtree, block);
+        rbtree_erase(mrbtree, node->pointer);
         info.file = file;
         info.line = line;
         info.size = size;
@@ -509,16 +516,21 @@ int v_check_count(void)
 
 int v_check_used(void)
 {
-    int size, i;
-    int used = 0;
-    NODE* node;
-    if (!mrbtree) return 0;
-    size = rbtree_size(mrbtree);
-    node = node_min(mrbtree, mrbtree->root);
-    for (i = 0; i < size; i++)
-    {
-        used += node->info.size;
-        node = node_next(mrbtree, node);
-    }
-    return used;
-}
\ No newline at end of file
+    return vused;
+}
+
+int v_check_peak(void)
+{
+    return vpeak;
+}
+
+int v_check_allocs(void)
+{
+    return vcount;
+}
+
+void v_check_reset(void)
+{
+    vcount = 0;
+    vpeak = vused;
+}
@@ -54,6 +54,25 @@ int v_check_count(void);
  */
 int v_check_used(void);
 
+/**
+ *  \brief Get the peak of memory allocated at the same time since the last reset
+ *  \return peak size of memory
+ */
+int v_check_peak(void);
+
+/**
+ *  \brief Count how many times memory was allocated or reallocated since the last reset
+ *  \return count of allocations
+ */
+int v_check_allocs(void);
+
+/**
+ *  \brief Reset the allocation count, and the peak to the memory currently used
+ *         Call it before a piece of code to measure the allocations and peak memory of that code alone
+ *  \return none
+ */
+void v_check_reset(void);
+
 /* These memory APIs, named the same as those provided by stdlib, 
  * are intended to replace the method of Valloc in stdlib to track memory usage.
  * 
@@ -67,6 +86,38 @@ int v_check_used(void);
 #define free(b)                             vm_free(b)
 #define realloc(b, s)                       vm_realloc(b, s, __FILE__, __LINE__)
 
+#if 0 /* for example */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "json.h"     /* json.c is built with `-include valloc.h` to be measured */
+#include "valloc.h"
+
+int main(void)
+{
+    const char* text = "{\"name\":\"valloc\",\"list\":[1,2,3,4.5e6,\"str\"]}";
+    int i, count = 10000;
+    clock_t t;
+    json_t json;
+
+    v_check_reset();
+    t = clock();
+    for (i = 0; i < count; i++)
+    {
+        json = json_loads(text);
+        json_delete(json);
+    }
+    t = clock() - t;
+
+    printf("%.2f MB/s, %.1f allocations per document, peak %d bytes\r\n",
+        (double)strlen(text) * count / 1e6 / ((double)t / CLOCKS_PER_SEC),
+        (double)v_check_allocs() / count, v_check_peak());
+    v_check_unfree();
+
+    return 0;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
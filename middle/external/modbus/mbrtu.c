@@ -21,91 +21,6 @@
 
 #include "mbrtu.h"
 
-//CRC_16高8位数据区
-const_t uint8_t auchCRCHi[] = {
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41,
-  0x00, 0xC1, 0x81, 0x40, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0,
-  0x80, 0x41, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1,
-  0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0, 0x80, 0x41,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1,
-  0x81, 0x40, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x00, 0xC1, 0x81, 0x40,
-  0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1,
-  0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x00, 0xC1, 0x81, 0x40,
-  0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0,
-  0x80, 0x41, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41,
-  0x00, 0xC1, 0x81, 0x40, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41,
-  0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40, 0x00, 0xC1, 0x81, 0x40,
-  0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0, 0x80, 0x41, 0x00, 0xC1,
-  0x81, 0x40, 0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41,
-  0x00, 0xC1, 0x81, 0x40, 0x01, 0xC0, 0x80, 0x41, 0x01, 0xC0,
-  0x80, 0x41, 0x00, 0xC1, 0x81, 0x40};
-//CRC低位字节值表
-const_t uint8_t auchCRCLo[] = { //CRC_16低8位数据区
-  0x00, 0xC0, 0xC1, 0x01, 0xC3, 0x03, 0x02, 0xC2, 0xC6, 0x06,
-  0x07, 0xC7, 0x05, 0xC5, 0xC4, 0x04, 0xCC, 0x0C, 0x0D, 0xCD,
-  0x0F, 0xCF, 0xCE, 0x0E, 0x0A, 0xCA, 0xCB, 0x0B, 0xC9, 0x09,
-  0x08, 0xC8, 0xD8, 0x18, 0x19, 0xD9, 0x1B, 0xDB, 0xDA, 0x1A,
-  0x1E, 0xDE, 0xDF, 0x1F, 0xDD, 0x1D, 0x1C, 0xDC, 0x14, 0xD4,
-  0xD5, 0x15, 0xD7, 0x17, 0x16, 0xD6, 0xD2, 0x12, 0x13, 0xD3,
-  0x11, 0xD1, 0xD0, 0x10, 0xF0, 0x30, 0x31, 0xF1, 0x33, 0xF3,
-  0xF2, 0x32, 0x36, 0xF6, 0xF7, 0x37, 0xF5, 0x35, 0x34, 0xF4,
-  0x3C, 0xFC, 0xFD, 0x3D, 0xFF, 0x3F, 0x3E, 0xFE, 0xFA, 0x3A,
-  0x3B, 0xFB, 0x39, 0xF9, 0xF8, 0x38, 0x28, 0xE8, 0xE9, 0x29,
-  0xEB, 0x2B, 0x2A, 0xEA, 0xEE, 0x2E, 0x2F, 0xEF, 0x2D, 0xED,
-  0xEC, 0x2C, 0xE4, 0x24, 0x25, 0xE5, 0x27, 0xE7, 0xE6, 0x26,
-  0x22, 0xE2, 0xE3, 0x23, 0xE1, 0x21, 0x20, 0xE0, 0xA0, 0x60,
-  0x61, 0xA1, 0x63, 0xA3, 0xA2, 0x62, 0x66, 0xA6, 0xA7, 0x67,
-  0xA5, 0x65, 0x64, 0xA4, 0x6C, 0xAC, 0xAD, 0x6D, 0xAF, 0x6F,
-  0x6E, 0xAE, 0xAA, 0x6A, 0x6B, 0xAB, 0x69, 0xA9, 0xA8, 0x68,
-  0x78, 0xB8, 0xB9, 0x79, 0xBB, 0x7B, 0x7A, 0xBA, 0xBE, 0x7E,
-  0x7F, 0xBF, 0x7D, 0xBD, 0xBC, 0x7C, 0xB4, 0x74, 0x75, 0xB5,
-  0x77, 0xB7, 0xB6, 0x76, 0x72, 0xB2, 0xB3, 0x73, 0xB1, 0x71,
-  0x70, 0xB0, 0x50, 0x90, 0x91, 0x51, 0x93, 0x53, 0x52, 0x92,
-  0x96, 0x56, 0x57, 0x97, 0x55, 0x95, 0x94, 0x54, 0x9C, 0x5C,
-  0x5D, 0x9D, 0x5F, 0x9F, 0x9E, 0x5E, 0x5A, 0x9A, 0x9B, 0x5B,
-  0x99, 0x59, 0x58, 0x98, 0x88, 0x48, 0x49, 0x89, 0x4B, 0x8B,
-  0x8A, 0x4A, 0x4E, 0x8E, 0x8F, 0x4F, 0x8D, 0x4D, 0x4C, 0x8C,
-  0x44, 0x84, 0x85, 0x45, 0x87, 0x47, 0x46, 0x86, 0x82, 0x42,
-  0x43, 0x83, 0x41, 0x81, 0x80, 0x40};
-
-/*CRC16查表计算函数*/
-static uint16_t GenerateCRC16CheckCode(uint8_t *puckMsg, uint16_t usDataLen);
-
-/*函数功能：CRC校验码生成
-输入参数：puchMsgg是要进行CRC校验的消息，usDataLen是消息中字节数
-函数输出：计算出来的CRC校验码
-GenerateCRC16CheckCode查表计算函数*/
-static uint16_t GenerateCRC16CheckCode(uint8_t *puckMsg, uint16_t usDataLen)
-{
-  uint8_t uchCRCHi; //高CRC字节初始化
-  uint8_t uchCRCLo; //低CRC 字节初始化
-  uint32_t uIndex;         //CRC循环中的索引
-
-  uchCRCHi = 0xFF;
-  uchCRCLo = 0xFF;
-
-  //传输消息缓冲区
-  while (usDataLen--)
-  {
-    //计算CRC
-    uIndex = uchCRCLo ^ *puckMsg++;
-    uchCRCLo = uchCRCHi ^ auchCRCHi[uIndex];
-    uchCRCHi = auchCRCLo[uIndex];
-  }
-  //返回结果，高位在前
-  return (uchCRCLo << 8 | uchCRCHi);
-}
-
 /*函数功能：用于校验接收到的信息是否有误
 输入参数：message是接收到的待校验消息，length是消息字节的长度
 函数输出：输出校验结果，没有错返回True，有错返回False
@@ -113,10 +28,35 @@ static uint16_t GenerateCRC16CheckCode(uint8_t *puckMsg, uint16_t usDataLen)
 bool CheckRTUMessageIntegrity(uint8_t *message, uint16_t length)
 {
   bool checkResult;
-  checkResult = (GenerateCRC16CheckCode(message, length) == 0x00) ? true : false;
+  checkResult = (crc16_modbus(message, length) == 0x00) ? true : false;
   return checkResult;
 }
 
+/*函数功能：开始逐段校验接收中的信息
+输入参数：check是校验上下文
+函数输出：无
+用于边接收边校验，不必在接收完整后再遍历一次*/
+void StartRTUMessageCheck(crcCtxType *check)
+{
+  crc_init(check, &crcParaModelTable[CRC_MODEL_CRC16_MODBUS]);
+}
+
+/*函数功能：校验新接收到的一段信息
+输入参数：check是校验上下文，bytes是新接收的字节，length是字节数
+函数输出：无*/
+void UpdateRTUMessageCheck(crcCtxType *check, uint8_t *bytes, uint16_t length)
+{
+  crc_update(check, bytes, length);
+}
+
+/*函数功能：结束逐段校验
+输入参数：check是已接收完整信息（包括2个校验字节）的校验上下文
+函数输出：输出校验结果，没有错返回True，有错返回False*/
+bool FinishRTUMessageCheck(crcCtxType *check)
+{
+  return (crc_final(check) == 0x00) ? true : false;
+}
+
 /*生成读写从站数据对象的命令,命令长度包括2个校验字节*/
 uint16_t SyntheticReadWriteSlaveCommand(ObjAccessInfo slaveInfo, bool *statusList, uint16_t *registerList, uint8_t *commandBytes)
 {
@@ -136,9 +76,9 @@ uint16_t SyntheticReadWriteSlaveCommand(ObjAccessInfo slaveInfo, bool *statusLis
   // {
   //   commandBytes[index++] = command[i];
   // }
-  chk = GenerateCRC16CheckCode(commandBytes, bytesCount);
+  chk = crc16_modbus(commandBytes, bytesCount);
+  commandBytes[bytesCount++] = chk & 0xFF; //低字节在前
   commandBytes[bytesCount++] = (chk >> 8) & 0xFF;
-  commandBytes[bytesCount++] = chk & 0xFF;
   return bytesCount;
 }
 
@@ -154,9 +94,9 @@ uint16_t SyntheticSlaveAccessRespond(uint8_t *receivedMessage, bool *statusList,
   // {
   //   respondBytes[respondLength++] = respond[i];
   // }
-  chk = GenerateCRC16CheckCode(respondBytes, respondLength);
+  chk = crc16_modbus(respondBytes, respondLength);
+  respondBytes[respondLength++] = chk & 0xFF; //低字节在前
   respondBytes[respondLength++] = (chk >> 8) & 0xFF;
-  respondBytes[respondLength++] = chk & 0xFF;
   return respondLength;
 }
 
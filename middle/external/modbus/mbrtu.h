@@ -22,11 +22,17 @@
 #ifndef __mbrtu_h
 #define __mbrtu_h
 
+#include "crc.h" //需在mbpdu.h之前，其数据类型为宏定义
 #include "mbpdu.h"
 
 /*通过CRC校验校验接收的信息是否正确*/
 bool CheckRTUMessageIntegrity (uint8_t *message,uint16_t length);
 
+/*边接收边校验：接收前开始，每收到一段数据更新，接收完整（包括2个校验字节）后结束并得到校验结果*/
+void StartRTUMessageCheck(crcCtxType *check);
+void UpdateRTUMessageCheck(crcCtxType *check,uint8_t *bytes,uint16_t length);
+bool FinishRTUMessageCheck(crcCtxType *check);
+
 /*生成读写从站数据对象的命令,命令长度包括2个校验字节*/
 uint16_t SyntheticReadWriteSlaveCommand(ObjAccessInfo slaveInfo,bool *statusList,uint16_t *registerList,uint8_t *commandBytes);
 
@@ -0,0 +1,688 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  cbor.c
+ *         \unit  cbor
+ *        \brief  This is a C language version of CBOR (RFC 8949) encoder and zero-copy streaming reader
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "cbor.h"
+#include <string.h>
+
+/* additional information of the initial byte */
+#define AI_1BYTE                            (24)
+#define AI_2BYTE                            (25)
+#define AI_4BYTE                            (26)
+#define AI_8BYTE                            (27)
+#define AI_INDEFINITE                       (31)
+
+/* simple values */
+#define SIMPLE_FALSE                        (20)
+#define SIMPLE_TRUE                         (21)
+#define SIMPLE_NULL                         (22)
+#define SIMPLE_UNDEFINED                    (23)
+
+typedef union
+{
+    float f;
+    uint32_t u;
+} FLOAT_BITS;
+
+typedef union
+{
+    double f;
+    uint64_t u;
+} DOUBLE_BITS;
+
+/**
+ *  \brief write a big endian unsigned integer.
+ *  \param[out] out: output
+ *  \param[in] value: value
+ *  \param[in] n: count of bytes
+ *  \return none
+ */
+static void put_be(unsigned char* out, uint64_t value, int n)
+{
+    while (n-- > 0)
+    {
+        out[n] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+/**
+ *  \brief read a big endian unsigned integer.
+ *  \param[in] in: input
+ *  \param[in] n: count of bytes
+ *  \return value
+ */
+static uint64_t get_be(const unsigned char* in, int n)
+{
+    uint64_t value = 0;
+    while (n-- > 0) value = (value << 8) | *in++;
+    return value;
+}
+
+/**
+ *  \brief write the head of an item, the value is encoded in the shortest form.
+ *  \param[out] out: output, at least `CBOR_HEAD_MAX` bytes
+ *  \param[in] major: major type, @ref CBOR_MAJOR_xxx
+ *  \param[in] value: argument of head, length, count or integer
+ *  \return length written
+ */
+int cbor_put_head(unsigned char* out, int major, uint64_t value)
+{
+    major <<= 5;
+
+    if (value < AI_1BYTE)
+    {
+        out[0] = (unsigned char)(major | value);
+        return 1;
+    }
+    if (value <= 0xFF)
+    {
+        out[0] = (unsigned char)(major | AI_1BYTE);
+        out[1] = (unsigned char)value;
+        return 2;
+    }
+    if (value <= 0xFFFF)
+    {
+        out[0] = (unsigned char)(major | AI_2BYTE);
+        put_be(out + 1, value, 2);
+        return 3;
+    }
+    if (value <= 0xFFFFFFFF)
+    {
+        out[0] = (unsigned char)(major | AI_4BYTE);
+        put_be(out + 1, value, 4);
+        return 5;
+    }
+
+    out[0] = (unsigned char)(major | AI_8BYTE);
+    put_be(out + 1, value, 8);
+    return 9;
+}
+
+/**
+ *  \brief convert a float to half precision when it is exactly representable.
+ *  \param[in] f: float
+ *  \param[out] half: half precision bits
+ *  \return 1 exact or 0 not representable
+ */
+static int float_to_half(float f, unsigned int* half)
+{
+    FLOAT_BITS b;
+    unsigned int sign, mant, m;
+    int exp, shift;
+
+    b.f = f;
+    sign = (b.u >> 16) & 0x8000;
+    exp = (int)((b.u >> 23) & 0xFF);
+    mant = b.u & 0x7FFFFF;
+
+    /* Zero */
+    if (exp == 0 && mant == 0)
+    {
+        *half = sign;
+        return 1;
+    }
+
+    /* Infinity, NaN is handled by the caller */
+    if (exp == 0xFF)
+    {
+        if (mant) return 0;
+        *half = sign | 0x7C00;
+        return 1;
+    }
+
+    exp -= 127;
+
+    /* Normal half */
+    if (exp >= -14 && exp <= 15)
+    {
+        if (mant & 0x1FFF) return 0;
+        *half = sign | ((unsigned int)(exp + 15) << 10) | (mant >> 13);
+        return 1;
+    }
+
+    /* Subnormal half, no significant bits may be lost */
+    if (exp >= -24 && exp < -14)
+    {
+        m = mant | 0x800000;
+        shift = 13 + (-14 - exp);
+        if (m & ((1u << shift) - 1)) return 0;
+        *half = sign | (m >> shift);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ *  \brief convert half precision bits to double.
+ *  \param[in] half: half precision bits
+ *  \return value
+ */
+static double half_to_double(unsigned int half)
+{
+    unsigned int exp = (half >> 10) & 0x1F;
+    unsigned int mant = half & 0x3FF;
+    double value;
+
+    if (exp == 0) value = mant * (1.0 / 16777216.0); /* mant * 2^-24 */
+    else if (exp != 31)
+    {
+        /* (1024 + mant) * 2^(exp - 25) */
+        value = (double)(mant + 1024);
+        if (exp >= 25) value *= (double)(1u << (exp - 25));
+        else value /= (double)(1u << (25 - exp));
+    }
+    else
+    {
+        DOUBLE_BITS b;
+        b.u = mant ? 0x7FF8000000000000ULL : 0x7FF0000000000000ULL;
+        value = b.f;
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+/**
+ *  \brief write a float in the shortest of half, single and double precision that keeps the value exact.
+ *  \param[out] out: output, at least `CBOR_HEAD_MAX` bytes
+ *  \param[in] value: value
+ *  \return length written
+ */
+int cbor_put_float(unsigned char* out, double value)
+{
+    FLOAT_BITS fb;
+    DOUBLE_BITS db;
+    unsigned int half;
+    float f;
+
+    /* Canonical NaN */
+    if (value != value)
+    {
+        out[0] = (CBOR_MAJOR_SIMPLE << 5) | AI_2BYTE;
+        out[1] = 0x7E;
+        out[2] = 0x00;
+        return 3;
+    }
+
+    f = (float)value;
+    if ((double)f == value)
+    {
+        if (float_to_half(f, &half))
+        {
+            out[0] = (CBOR_MAJOR_SIMPLE << 5) | AI_2BYTE;
+            put_be(out + 1, half, 2);
+            return 3;
+        }
+
+        fb.f = f;
+        out[0] = (CBOR_MAJOR_SIMPLE << 5) | AI_4BYTE;
+        put_be(out + 1, fb.u, 4);
+        return 5;
+    }
+
+    db.f = value;
+    out[0] = (CBOR_MAJOR_SIMPLE << 5) | AI_8BYTE;
+    put_be(out + 1, db.u, 8);
+    return 9;
+}
+
+/**
+ *  \brief init encoder.
+ *  \param[in] enc: encoder
+ *  \param[in] buffer: output buffer
+ *  \param[in] size: size of buffer
+ *  \return none
+ */
+void cbor_encoder_init(CBOR_ENCODER* enc, void* buffer, unsigned int size)
+{
+    if (!enc) return;
+    enc->buffer = (unsigned char*)buffer;
+    enc->size = buffer ? size : 0;
+    enc->end = 0;
+    enc->error = buffer ? CBOR_E_OK : CBOR_E_INVALID;
+}
+
+/**
+ *  \brief reserve space in encoder.
+ *  \param[in] enc: encoder
+ *  \param[in] n: bytes needed
+ *  \return address of space or NULL fail
+ */
+static unsigned char* reserve(CBOR_ENCODER* enc, unsigned int n)
+{
+    if (enc->error) return NULL;
+    if (enc->size - enc->end < n)
+    {
+        enc->error = CBOR_E_SPACE;
+        return NULL;
+    }
+    return enc->buffer + enc->end;
+}
+
+/**
+ *  \brief encode the head of an item.
+ *  \param[in] enc: encoder
+ *  \param[in] major: major type
+ *  \param[in] value: argument of head
+ *  \return error type
+ */
+static int encode_head(CBOR_ENCODER* enc, int major, uint64_t value)
+{
+    unsigned char temp[CBOR_HEAD_MAX];
+    unsigned char* p;
+    int len;
+
+    if (!enc) return CBOR_E_INVALID;
+
+    len = cbor_put_head(temp, major, value);
+    p = reserve(enc, len);
+    if (!p) return enc->error;
+    memcpy(p, temp, len);
+    enc->end += len;
+
+    return CBOR_E_OK;
+}
+
+/**
+ *  \brief encode a simple value.
+ */
+static int encode_simple(CBOR_ENCODER* enc, unsigned int simple)
+{
+    return encode_head(enc, CBOR_MAJOR_SIMPLE, simple);
+}
+
+/**
+ *  \brief encode null.
+ *  \param[in] enc: encoder
+ *  \return error type, the error is also kept in `enc->error`
+ */
+int cbor_encode_null(CBOR_ENCODER* enc)
+{
+    return encode_simple(enc, SIMPLE_NULL);
+}
+
+/**
+ *  \brief encode bool.
+ *  \param[in] enc: encoder
+ *  \param[in] b: bool
+ *  \return error type
+ */
+int cbor_encode_bool(CBOR_ENCODER* enc, int b)
+{
+    return encode_simple(enc, b ? SIMPLE_TRUE : SIMPLE_FALSE);
+}
+
+/**
+ *  \brief encode signed integer in the shortest form.
+ *  \param[in] enc: encoder
+ *  \param[in] value: value
+ *  \return error type
+ */
+int cbor_encode_int(CBOR_ENCODER* enc, int64_t value)
+{
+    if (value >= 0) return encode_head(enc, CBOR_MAJOR_UINT, (uint64_t)value);
+    return encode_head(enc, CBOR_MAJOR_NINT, ~(uint64_t)value); /* -1 - value */
+}
+
+/**
+ *  \brief encode unsigned integer in the shortest form.
+ *  \param[in] enc: encoder
+ *  \param[in] value: value
+ *  \return error type
+ */
+int cbor_encode_uint(CBOR_ENCODER* enc, uint64_t value)
+{
+    return encode_head(enc, CBOR_MAJOR_UINT, value);
+}
+
+/**
+ *  \brief encode float in the shortest precision that keeps the value exact.
+ *  \param[in] enc: encoder
+ *  \param[in] value: value
+ *  \return error type
+ */
+int cbor_encode_float(CBOR_ENCODER* enc, double value)
+{
+    unsigned char temp[CBOR_HEAD_MAX];
+    unsigned char* p;
+    int len;
+
+    if (!enc) return CBOR_E_INVALID;
+
+    len = cbor_put_float(temp, value);
+    p = reserve(enc, len);
+    if (!p) return enc->error;
+    memcpy(p, temp, len);
+    enc->end += len;
+
+    return CBOR_E_OK;
+}
+
+/**
+ *  \brief encode a head followed by raw content.
+ */
+static int encode_data(CBOR_ENCODER* enc, int major, const void* data, unsigned int len)
+{
+    unsigned char* p;
+    int error;
+
+    error = encode_head(enc, major, len);
+    if (error) return error;
+
+    p = reserve(enc, len);
+    if (!p) return enc->error;
+    if (len) memcpy(p, data, len);
+    enc->end += len;
+
+    return CBOR_E_OK;
+}
+
+/**
+ *  \brief encode text string.
+ *  \param[in] enc: encoder
+ *  \param[in] string: UTF-8 string
+ *  \param[in] len: length of string, negative for a terminated string
+ *  \return error type
+ */
+int cbor_encode_string(CBOR_ENCODER* enc, const char* string, int len)
+{
+    if (!string) return cbor_encode_null(enc);
+    if (len < 0) len = strlen(string);
+    return encode_data(enc, CBOR_MAJOR_TEXT, string, len);
+}
+
+/**
+ *  \brief encode byte string.
+ *  \param[in] enc: encoder
+ *  \param[in] data: data
+ *  \param[in] len: length of data
+ *  \return error type
+ */
+int cbor_encode_bytes(CBOR_ENCODER* enc, const void* data, unsigned int len)
+{
+    if (!data && len) return CBOR_E_INVALID;
+    return encode_data(enc, CBOR_MAJOR_BYTES, data, len);
+}
+
+/**
+ *  \brief encode array head, `count` items should be encoded after it.
+ *  \param[in] enc: encoder
+ *  \param[in] count: count of elements
+ *  \return error type
+ */
+int cbor_encode_array(CBOR_ENCODER* enc, unsigned int count)
+{
+    return encode_head(enc, CBOR_MAJOR_ARRAY, count);
+}
+
+/**
+ *  \brief encode map head, `count` key and value pairs should be encoded after it.
+ *  \param[in] enc: encoder
+ *  \param[in] count: count of pairs
+ *  \return error type
+ */
+int cbor_encode_map(CBOR_ENCODER* enc, unsigned int count)
+{
+    return encode_head(enc, CBOR_MAJOR_MAP, count);
+}
+
+/**
+ *  \brief encode tag head, the tagged item should be encoded after it.
+ *  \param[in] enc: encoder
+ *  \param[in] tag: tag number
+ *  \return error type
+ */
+int cbor_encode_tag(CBOR_ENCODER* enc, uint64_t tag)
+{
+    return encode_head(enc, CBOR_MAJOR_TAG, tag);
+}
+
+/**
+ *  \brief init reader.
+ *  \param[in] reader: reader
+ *  \param[in] data: cbor data, must stay valid while items are in use
+ *  \param[in] len: length of data
+ *  \return none
+ */
+void cbor_reader_init(CBOR_READER* reader, const void* data, unsigned int len)
+{
+    if (!reader) return;
+    reader->base = (const unsigned char*)data;
+    reader->s = reader->base;
+    reader->e = reader->base ? reader->base + len : reader->base;
+}
+
+/**
+ *  \brief read the next item, strings are not copied and containers are reported as heads.
+ *  \param[in] reader: reader
+ *  \param[out] item: item
+ *  \return error type, the reader does not move on error
+ */
+int cbor_read(CBOR_READER* reader, CBOR_ITEM* item)
+{
+    const unsigned char* s;
+    uint64_t value = 0;
+    unsigned int major, ai, n;
+    DOUBLE_BITS db;
+    FLOAT_BITS fb;
+
+    if (!reader || !item) return CBOR_E_INVALID;
+
+    s = reader->s;
+    if (s >= reader->e) return CBOR_E_END;
+
+    major = *s >> 5;
+    ai = *s & 0x1F;
+    s++;
+
+    /* Argument of head */
+    if (ai < AI_1BYTE) value = ai;
+    else if (ai <= AI_8BYTE)
+    {
+        n = 1u << (ai - AI_1BYTE);
+        if ((unsigned int)(reader->e - s) < n) return CBOR_E_TRUNCATED;
+        value = get_be(s, n);
+        s += n;
+    }
+    else if (ai != AI_INDEFINITE) return CBOR_E_SYNTAX;
+    else if (major == CBOR_MAJOR_UINT || major == CBOR_MAJOR_NINT || major == CBOR_MAJOR_TAG) return CBOR_E_SYNTAX;
+
+    switch (major)
+    {
+    case CBOR_MAJOR_UINT:
+        if (value > (uint64_t)INT64_MAX)
+        {
+            item->type = CBOR_T_UINT;
+            item->value.u = value;
+        }
+        else
+        {
+            item->type = CBOR_T_INT;
+            item->value.i = (int64_t)value;
+        }
+        break;
+
+    case CBOR_MAJOR_NINT:
+        if (value > (uint64_t)INT64_MAX)
+        {
+            item->type = CBOR_T_FLOAT;
+            item->value.f = -1.0 - (double)value;
+        }
+        else
+        {
+            item->type = CBOR_T_INT;
+            item->value.i = -1 - (int64_t)value;
+        }
+        break;
+
+    case CBOR_MAJOR_BYTES:
+    case CBOR_MAJOR_TEXT:
+        item->type = (major == CBOR_MAJOR_TEXT) ? CBOR_T_STRING : CBOR_T_BYTES;
+        item->value.s.data = (const char*)s;
+        if (ai == AI_INDEFINITE) item->value.s.len = CBOR_INDEFINITE;
+        else
+        {
+            if ((uint64_t)(reader->e - s) < value) return CBOR_E_TRUNCATED;
+            item->value.s.len = (unsigned int)value;
+            s += value;
+        }
+        break;
+
+    case CBOR_MAJOR_ARRAY:
+    case CBOR_MAJOR_MAP:
+        item->type = (major == CBOR_MAJOR_ARRAY) ? CBOR_T_ARRAY : CBOR_T_MAP;
+        if (ai == AI_INDEFINITE) item->value.count = CBOR_INDEFINITE;
+        else
+        {
+            /* Every element takes at least one byte, larger counts can not be valid */
+            if ((uint64_t)(reader->e - s) < value * (major == CBOR_MAJOR_MAP ? 2 : 1) || value >= CBOR_INDEFINITE) return CBOR_E_TRUNCATED;
+            item->value.count = (unsigned int)value;
+        }
+        break;
+
+    case CBOR_MAJOR_TAG:
+        item->type = CBOR_T_TAG;
+        item->value.u = value;
+        break;
+
+    default: /* CBOR_MAJOR_SIMPLE */
+        if (ai == AI_2BYTE)
+        {
+            item->type = CBOR_T_FLOAT;
+            item->value.f = half_to_double((unsigned int)value);
+        }
+        else if (ai == AI_4BYTE)
+        {
+            fb.u = (uint32_t)value;
+            item->type = CBOR_T_FLOAT;
+            item->value.f = fb.f;
+        }
+        else if (ai == AI_8BYTE)
+        {
+            db.u = value;
+            item->type = CBOR_T_FLOAT;
+            item->value.f = db.f;
+        }
+        else if (ai == AI_INDEFINITE) item->type = CBOR_T_BREAK;
+        else if (value == SIMPLE_FALSE || value == SIMPLE_TRUE)
+        {
+            item->type = CBOR_T_BOOL;
+            item->value.b = (value == SIMPLE_TRUE);
+        }
+        else if (value == SIMPLE_NULL || value == SIMPLE_UNDEFINED) item->type = CBOR_T_NULL;
+        else
+        {
+            /* One byte simple values below 32 are not well formed */
+            if (ai == AI_1BYTE && value < 32) return CBOR_E_SYNTAX;
+            item->type = CBOR_T_SIMPLE;
+            item->value.u = value;
+        }
+        break;
+    }
+
+    reader->s = s;
+
+    return CBOR_E_OK;
+}
+
+/**
+ *  \brief skip one complete item, including the elements of containers.
+ *  \param[in] reader: reader
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int skip_item(CBOR_READER* reader, int depth)
+{
+    CBOR_ITEM item;
+    unsigned int i, n;
+    int error;
+
+    if (depth > CBOR_DEPTH_MAX) return CBOR_E_DEPTH;
+
+    error = cbor_read(reader, &item);
+    if (error) return (error == CBOR_E_END) ? CBOR_E_TRUNCATED : error;
+
+    switch (item.type)
+    {
+    case CBOR_T_STRING:
+    case CBOR_T_BYTES:
+        if (item.value.s.len != CBOR_INDEFINITE) return CBOR_E_OK;
+
+        /* Chunks of an indefinite string are definite strings of the same type */
+        while (1)
+        {
+            i = item.type;
+            error = cbor_read(reader, &item);
+            if (error) return (error == CBOR_E_END) ? CBOR_E_TRUNCATED : error;
+            if (item.type == CBOR_T_BREAK) return CBOR_E_OK;
+            if (item.type != (int)i || item.value.s.len == CBOR_INDEFINITE) return CBOR_E_SYNTAX;
+        }
+
+    case CBOR_T_ARRAY:
+    case CBOR_T_MAP:
+        n = item.value.count;
+        if (n == CBOR_INDEFINITE)
+        {
+            while (1)
+            {
+                /* Peek for the break */
+                if (reader->s < reader->e && *reader->s == 0xFF)
+                {
+                    reader->s++;
+                    return CBOR_E_OK;
+                }
+                error = skip_item(reader, depth + 1);
+                if (error) return error;
+                if (item.type == CBOR_T_MAP)
+                {
+                    error = skip_item(reader, depth + 1);
+                    if (error) return error;
+                }
+            }
+        }
+        if (item.type == CBOR_T_MAP) n *= 2;
+        for (i = 0; i < n; i++)
+        {
+            error = skip_item(reader, depth + 1);
+            if (error) return error;
+        }
+        return CBOR_E_OK;
+
+    case CBOR_T_TAG:
+        return skip_item(reader, depth + 1);
+
+    case CBOR_T_BREAK:
+        return CBOR_E_SYNTAX;
+    }
+
+    return CBOR_E_OK;
+}
+
+/**
+ *  \brief skip the next complete item, arrays and maps are skipped with all their elements.
+ *  \param[in] reader: reader
+ *  \return error type, the reader does not move on error
+ */
+int cbor_skip(CBOR_READER* reader)
+{
+    const unsigned char* s;
+    int error;
+
+    if (!reader) return CBOR_E_INVALID;
+    if (reader->s >= reader->e) return CBOR_E_END;
+
+    s = reader->s;
+    error = skip_item(reader, 1);
+    if (error) reader->s = s;
+
+    return error;
+}
@@ -0,0 +1,189 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  cbor.h
+ *         \unit  cbor
+ *        \brief  This is a C language version of CBOR (RFC 8949) encoder and zero-copy streaming reader
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __cbor_H
+#define __cbor_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* version infomation */
+
+#define CBOR_V_MAJOR                        1
+#define CBOR_V_MINOR                        0
+#define CBOR_V_PATCH                        0
+
+/* configuration information */
+
+#define CBOR_DEPTH_MAX                      (256) /* maximum nesting depth of arrays, maps and tags, it bounds the recursion */
+
+/* maximum size of one encoded head or float, `cbor_put_head()` and `cbor_put_float()` never write more */
+
+#define CBOR_HEAD_MAX                       (9)
+
+/* major type define */
+
+#define CBOR_MAJOR_UINT                     (0) /* unsigned integer */
+#define CBOR_MAJOR_NINT                     (1) /* negative integer, -1 - value */
+#define CBOR_MAJOR_BYTES                    (2) /* byte string */
+#define CBOR_MAJOR_TEXT                     (3) /* UTF-8 text string */
+#define CBOR_MAJOR_ARRAY                    (4) /* array */
+#define CBOR_MAJOR_MAP                      (5) /* map of key value pairs */
+#define CBOR_MAJOR_TAG                      (6) /* semantic tag */
+#define CBOR_MAJOR_SIMPLE                   (7) /* simple values and floats */
+
+/* item type define, the types that `cbor_read()` reports */
+
+#define CBOR_T_UNKNOW                       (0) /* unknown type */
+#define CBOR_T_NULL                         (1) /* null, undefined is also reported as null */
+#define CBOR_T_BOOL                         (2) /* bool, `value.b` */
+#define CBOR_T_INT                          (3) /* integer that fits int64, `value.i` */
+#define CBOR_T_UINT                         (4) /* unsigned integer above INT64_MAX, `value.u` */
+#define CBOR_T_FLOAT                        (5) /* half, single or double float, also integers below INT64_MIN, `value.f` */
+#define CBOR_T_STRING                       (6) /* text string, `value.s` points into the input */
+#define CBOR_T_BYTES                        (7) /* byte string, `value.s` points into the input */
+#define CBOR_T_ARRAY                        (8) /* array head, `value.count` elements follow */
+#define CBOR_T_MAP                          (9) /* map head, `value.count` key value pairs follow */
+#define CBOR_T_TAG                          (10) /* tag head, `value.u` tag number, one tagged item follows */
+#define CBOR_T_SIMPLE                       (11) /* unassigned simple value, `value.u` */
+#define CBOR_T_BREAK                        (12) /* end of an indefinite length array, map or string */
+
+/* `value.count` and `value.s.len` of indefinite length items, the items or chunks are ended by `CBOR_T_BREAK` */
+
+#define CBOR_INDEFINITE                     (0xFFFFFFFF)
+
+/* error type define */
+
+#define CBOR_E_OK                           (0) /* ok, no error */
+#define CBOR_E_INVALID                      (1) /* invalid parameter */
+#define CBOR_E_END                          (2) /* no more data to read */
+#define CBOR_E_TRUNCATED                    (3) /* data ends in the middle of an item */
+#define CBOR_E_SYNTAX                       (4) /* reserved or malformed encoding */
+#define CBOR_E_DEPTH                        (5) /* nesting deeper than `CBOR_DEPTH_MAX` */
+#define CBOR_E_SPACE                        (6) /* encoder buffer is not enough */
+
+/* encoder define, writes into a caller buffer */
+typedef struct
+{
+    unsigned char* buffer;                  /**< output buffer */
+    unsigned int size;                      /**< size of buffer */
+    unsigned int end;                       /**< end of buffer used */
+    int error;                              /**< first error, later writes are ignored once set */
+} CBOR_ENCODER;
+
+/* reader define, walks the input without copying */
+typedef struct
+{
+    const unsigned char* s;                 /**< current position */
+    const unsigned char* e;                 /**< end of data */
+    const unsigned char* base;              /**< beginning of data */
+} CBOR_READER;
+
+/* item define */
+typedef struct
+{
+    int type;                               /**< item type, @ref CBOR_T_xxx */
+    union
+    {
+        int b;                              /**< bool */
+        int64_t i;                          /**< integer */
+        uint64_t u;                         /**< big unsigned integer, tag number or simple value */
+        double f;                           /**< float */
+        unsigned int count;                 /**< count of array elements or map pairs */
+        struct
+        {
+            const char* data;               /**< string content in the input, not terminated */
+            unsigned int len;               /**< length of string */
+        } s;
+    } value;
+} CBOR_ITEM;
+
+/* Raw writers, `out` must have `CBOR_HEAD_MAX` bytes, return the length written */
+
+int cbor_put_head(unsigned char* out, int major, uint64_t value);
+int cbor_put_float(unsigned char* out, double value);
+
+/* Encoder */
+
+void cbor_encoder_init(CBOR_ENCODER* enc, void* buffer, unsigned int size);
+int cbor_encode_null(CBOR_ENCODER* enc);
+int cbor_encode_bool(CBOR_ENCODER* enc, int b);
+int cbor_encode_int(CBOR_ENCODER* enc, int64_t value);
+int cbor_encode_uint(CBOR_ENCODER* enc, uint64_t value);
+int cbor_encode_float(CBOR_ENCODER* enc, double value);
+int cbor_encode_string(CBOR_ENCODER* enc, const char* string, int len);
+int cbor_encode_bytes(CBOR_ENCODER* enc, const void* data, unsigned int len);
+int cbor_encode_array(CBOR_ENCODER* enc, unsigned int count);
+int cbor_encode_map(CBOR_ENCODER* enc, unsigned int count);
+int cbor_encode_tag(CBOR_ENCODER* enc, uint64_t tag);
+
+/* Streaming reader */
+
+void cbor_reader_init(CBOR_READER* reader, const void* data, unsigned int len);
+int cbor_read(CBOR_READER* reader, CBOR_ITEM* item);
+int cbor_skip(CBOR_READER* reader);
+
+/* Get the count of bytes that has been read */
+
+#define cbor_reader_offset(reader)              ((unsigned int)((reader)->s - (reader)->base))
+
+/* Get the count of bytes that has been encoded */
+
+#define cbor_encoder_length(enc)                ((enc)->end)
+
+#if 0 /* for example */
+#include <stdio.h>
+#include "cbor.h"
+
+int main(void)
+{
+    unsigned char buffer[64];
+    CBOR_ENCODER enc;
+    CBOR_READER reader;
+    CBOR_ITEM item;
+    unsigned int i, n;
+
+    /* {"gain":1.5,"taps":[1,2,3]} in 20 bytes */
+    cbor_encoder_init(&enc, buffer, sizeof(buffer));
+    cbor_encode_map(&enc, 2);
+    cbor_encode_string(&enc, "gain", -1);
+    cbor_encode_float(&enc, 1.5);
+    cbor_encode_string(&enc, "taps", -1);
+    cbor_encode_array(&enc, 3);
+    for (i = 1; i <= 3; i++) cbor_encode_int(&enc, i);
+    if (enc.error) return 1;
+
+    /* Walk the items without copying, strings point into `buffer` */
+    cbor_reader_init(&reader, buffer, cbor_encoder_length(&enc));
+    if (cbor_read(&reader, &item) || item.type != CBOR_T_MAP) return 1;
+    for (n = item.value.count; n > 0; n--)
+    {
+        if (cbor_read(&reader, &item) || item.type != CBOR_T_STRING) return 1;
+        printf("%.*s\r\n", (int)item.value.s.len, item.value.s.data);
+
+        /* Values that are not needed are skipped as a whole */
+        if (cbor_skip(&reader)) return 1;
+    }
+
+    return 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
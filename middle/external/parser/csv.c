@@ -11,8 +11,16 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "csv.h"
+#include "fmap.h"
+#include "fpconv.h"
 #include <string.h>
 #include <stdio.h>
+#include <ctype.h>
+#include <float.h>
+#if CSV_USE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 /* dump buffer define */
 typedef struct
@@ -45,36 +53,92 @@ typedef struct ROW
     ITERATOR iterator;          /**< cell list iterator */
 } ROW;
 
+/* compact storage of loaded text, the header, offsets and text share one allocation */
+typedef struct
+{
+    unsigned int rows;          /**< count of rows */
+    unsigned int cols;          /**< count of cells of the longest row */
+    unsigned int cells;         /**< count of cells */
+    unsigned int length;        /**< length of cell texts, including terminators */
+    unsigned int *index;        /**< first cell of each row, `rows + 1` items */
+    unsigned int *offset;       /**< offset of each cell text in `text` */
+    char *text;                 /**< cell texts, each one terminated */
+} TABLE;
+
+/* search index of `csv_find()`, built on demand and dropped on edits */
+typedef struct
+{
+    unsigned int cells;         /**< count of indexed cells, the non-empty ones in row order */
+    unsigned int cols;          /**< count of columns */
+    unsigned int *rows;         /**< row of each cell, counting from 1 */
+    unsigned int *columns;      /**< column of each cell, counting from 1 */
+    unsigned int *hashes;       /**< case folded hash of each cell text */
+    unsigned int *chain;        /**< next cell in the same hash bucket, `cells` ends the chain */
+    unsigned int *buckets;      /**< first cell of each hash bucket, NULL until an entire match is searched */
+    unsigned int mask;          /**< mask of hash buckets */
+    unsigned int *grams;        /**< start of the cell list of each trigram bucket, NULL until a substring is searched */
+    unsigned int *posts;        /**< cells that contain each trigram bucket */
+    unsigned int *hits;         /**< candidate cells of the current search, in search order */
+    unsigned int count;         /**< count of candidates */
+} INDEX;
+
 /* type of csv */
 typedef struct CSV
 {
     ROW *rows;                  /**< rows base */
     unsigned int size;          /**< rows of csv */
     ITERATOR iterator;          /**< rows list iterator */
+    TABLE *table;               /**< compact storage, used until the first edit, then `rows` takes over */
+    TABLE *retired;             /**< compact storage that has been expanded, kept so that returned texts stay valid */
+    INDEX *index;               /**< search index, NULL when not built */
+    int indexing;               /**< build the search index when searching */
+    const CSV_ALLOC *alloc;     /**< allocator of the rows, cells and tables, NULL the C library */
 } CSV;
 
-/* parsing error message storage */
-static int etype = 0;
-static int eline = 0;
-static int ecolumn = 0;
-static const char* lbegin = NULL;
+/* error information of the calls without context */
+static CSV_CTX ectx;
 
 #define Tarray(a, r, c, i, j)   (*(char**)(((char *)a)+((i)*(c)+(j))*sizeof(void*)))
 #define E(type) etype=(type)
 
+/**
+ *  \brief Allocate memory of a csv with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] size Size of memory.
+ *  \return Address of memory or NULL fail.
+ */
+static void* csv_malloc(const CSV_ALLOC* alloc, unsigned int size)
+{
+    return alloc ? alloc->alloc(alloc->user, size) : malloc(size);
+}
+
+/**
+ *  \brief Release memory of a csv with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] block Address of memory.
+ */
+static void csv_free(const CSV_ALLOC* alloc, void* block)
+{
+    if (alloc) alloc->free(alloc->user, block);
+    else free(block);
+}
+
 /**
  *  \brief Duplicate a given string.
  * 
+ *  \param[in] alloc Allocator of the copy, NULL the C library.
  *  \param[in] str String to be duplicated.
  *  \param[in] len Length of the string.
  *  \return Pointer to the duplicated string if successful, NULL otherwise.
  */
-static char* csv_strdup(const char* str, int len)
+static char* csv_strdup(const CSV_ALLOC* alloc, const char* str, int len)
 {
     char* s;
 
     /* Allocate memory for the new string */
-    s = (char*)malloc(len + 1);
+    s = (char*)csv_malloc(alloc, len + 1);
     if (!s) return NULL;
 
     /* Copy the given string into the allocated memory */
@@ -119,6 +183,7 @@ static CELL *it_cell(ROW *row, int index, int size)
 /**
  *  \brief Free the memory occupied by a linked list of CELL structures.
  * 
+ *  \param[in] alloc Allocator of the cells.
  *  \param[in] cell Pointer to the first CELL in the linked list.
  * 
  * This function frees the memory occupied by a linked list of CELL structures.
@@ -126,7 +191,7 @@ static CELL *it_cell(ROW *row, int index, int size)
  * 
  *  \note This function does not return a value.
  */
-static void cell_free(CELL* cell)
+static void cell_free(const CSV_ALLOC* alloc, CELL* cell)
 {
     CELL* t;
 
@@ -138,11 +203,11 @@ static void cell_free(CELL* cell)
         /* Free the address string if it exists */
         if (cell->address) 
         {
-            free(cell->address);
+            csv_free(alloc, cell->address);
         }
 
         /* Free the CELL structure */
-        free(cell);
+        csv_free(alloc, cell);
 
         cell = t;
     }
@@ -151,6 +216,7 @@ static void cell_free(CELL* cell)
 /**
  *  \brief Create a linked list of CELL structures with the specified number of elements.
  * 
+ *  \param[in] alloc Allocator of the cells.
  *  \param[in] number Number of CELL structures to create in the linked list.
  *  \return Pointer to the first CELL in the linked list if successful, NULL otherwise.
  * 
@@ -160,7 +226,7 @@ static void cell_free(CELL* cell)
  * 
  *  \note The caller is responsible for freeing the allocated memory.
  */
-static CELL* cell_new(unsigned int number)
+static CELL* cell_new(const CSV_ALLOC* alloc, unsigned int number)
 {
     CELL* cell = NULL, *t, *p = NULL;
     unsigned int i = 0;
@@ -168,17 +234,18 @@ static CELL* cell_new(unsigned int number)
     /* Create the specified number of CELL structures in the linked list */
     for (i = 0; i < number; i++)
     {
-        t = (CELL*)malloc(sizeof(CELL));
+        t = (CELL*)csv_malloc(alloc, sizeof(CELL));
         if (!t)
         {
-            cell_free(cell);
+            cell_free(alloc, cell);
             return NULL;
         }
 
-        t->address = malloc(sizeof(char));
+        t->address = csv_malloc(alloc, sizeof(char));
         if (!t->address)
         {
-            cell_free(cell);
+            csv_free(alloc, t);
+            cell_free(alloc, cell);
             return NULL;
         }
 
@@ -203,6 +270,7 @@ static CELL* cell_new(unsigned int number)
 /**
  *  \brief Free the memory occupied by a linked list of ROW structures.
  * 
+ *  \param[in] alloc Allocator of the rows.
  *  \param[in] row Pointer to the first ROW in the linked list.
  * 
  * This function frees the memory occupied by a linked list of ROW structures.
@@ -211,7 +279,7 @@ static CELL* cell_new(unsigned int number)
  * 
  *  \note This function does not return a value.
  */
-static void row_free(ROW *row)
+static void row_free(const CSV_ALLOC* alloc, ROW *row)
 {
     ROW* t;
 
@@ -221,10 +289,10 @@ static void row_free(ROW *row)
         t = row->next;
 
         /* Free the memory occupied by the cells in the ROW structure */
-        cell_free(row->cells);
+        cell_free(alloc, row->cells);
 
         /* Free the ROW structure */
-        free(row);
+        csv_free(alloc, row);
 
         row = t;
     }
@@ -233,6 +301,7 @@ static void row_free(ROW *row)
 /**
  *  \brief Create a linked list of ROW structures with the specified number of elements.
  * 
+ *  \param[in] alloc Allocator of the rows.
  *  \param[in] number Number of ROW structures to create in the linked list.
  *  \return Pointer to the first ROW in the linked list if successful, NULL otherwise.
  * 
@@ -242,7 +311,7 @@ static void row_free(ROW *row)
  * 
  *  \note The caller is responsible for freeing the allocated memory.
  */
-static ROW *row_new(unsigned int number)
+static ROW *row_new(const CSV_ALLOC* alloc, unsigned int number)
 {
     ROW *row = NULL, *t, *p = NULL;
     unsigned int i = 0;
@@ -250,10 +319,10 @@ static ROW *row_new(unsigned int number)
     /* Create the specified number of ROW structures in the linked list */
     for (i = 0; i < number; i++)
     {
-        t = (ROW *)malloc(sizeof(ROW));
+        t = (ROW *)csv_malloc(alloc, sizeof(ROW));
         if (!t)
         {
-            row_free(row);
+            row_free(alloc, row);
             return NULL;
         }
 
@@ -278,12 +347,295 @@ static ROW *row_new(unsigned int number)
     return row;
 }
 
+/**
+ *  \brief Scan csv text into table, run once to measure and once to fill.
+ *
+ *  \param[in] text csv text
+ *  \param[in] tail end of a chunk that ends after a line break, or NULL to scan to the terminator
+ *  \param[in,out] table table, sizes are output when measuring,
+ *                  when filling, the arrays point to where the scanned rows go,
+ *                  and `cells` and `length` are the counts that come before them
+ *  \param[in] fill 0 measure or 1 fill
+ */
+static void table_scan(const char* text, const char* tail, TABLE* table, int fill)
+{
+    const char* s = text;
+    const char* start = s;
+    const char* end = NULL;                 /* [start, end) is a cell text interval */
+    const char* quotation = NULL;           /* (start, quotation) is a cell text escape interval */
+    const char* t;
+    unsigned int rows = 0, cells = 0, cols = 0, count = 0, length = 0;
+    unsigned int cbase = 0, lbase = 0;
+    int open = 0;                           /* a row is being filled */
+
+    if (fill)
+    {
+        cbase = table->cells;
+        lbase = table->length;
+    }
+
+    while (1)
+    {
+        /* A chunk ends after a line break, there is nothing pending */
+        if (s == tail) break;
+
+        switch (*s)
+        {
+        case '\0':
+            end = s;
+            if (*start == '"') quotation = s; /* At the end of the text, use the end as an escape closed interval */
+        case '\n':
+        case ',':
+            if (*start == '"')
+            {
+                if (quotation) end = s; /* Leaving the escape interval, it can be concluded now */
+            }
+            else
+            {
+                end = s; /* Not within the escape interval, ending directly */
+            }
+
+            /* Parsing string has reached the end */
+            if (end)
+            {
+#if defined(_WIN32) || defined(_WIN64)
+                if (*end == '\n') end--; /* skip '\r' */
+#endif 
+                /* If there is currently no open row, start a new row */
+                if (!open)
+                {
+                    if (fill) table->index[rows] = cbase + cells;
+                    rows++;
+                    count = 0;
+                    open = 1;
+                }
+
+                /* Convert text to cell, escape `"` are dropped */
+                if (fill) table->offset[cells] = lbase + length;
+                for (t = start; t < end; t++)
+                {
+                    /* Double quotation marks including escape */
+                    if (*start == '"')
+                    {
+                        if (*t == '"')
+                        {
+                            if (t == start || t == quotation) continue; /* Skip both ends of quotation marks directly */
+                            if (t < quotation) t++; /* Escaped quotation marks skip the first one */
+                        }
+                    }
+                    if (fill) table->text[length] = *t;
+                    length++;
+                }
+                if (fill) table->text[length] = '\0';
+                length++;
+
+                cells++;
+                if (++count > cols) cols = count;
+
+                /* Reset to resolve the next one */
+                if (*s == '\n') open = 0;
+                start = s + 1;
+                end = NULL;
+                quotation = NULL;
+            }
+            break;
+        case '"':
+            /* Starting with quotation marks, there is an escaped interval */
+            if (*start == '"' && s != start && !quotation)
+            {
+                /* The quotation marks have not yet formed a closed interval, they are still within the scope of escape */
+                if (s[1] == '"') s++; /* it is an escaped quotation mark */
+                else quotation = s; /* A single quotation mark indicates the formation of a closed interval */
+            }
+            break;
+        default:
+            break;
+        }
+
+        /* Exit of loop parsing */
+        if (!*s) break;
+
+        s++;
+    }
+
+    if (fill)
+    {
+        if (!tail) table->index[rows] = cbase + cells;
+    }
+    else
+    {
+        table->rows = rows;
+        table->cols = cols;
+        table->cells = cells;
+        table->length = length;
+    }
+}
+
+/**
+ *  \brief Point the arrays of table into the allocation that follows the header.
+ *
+ *  \param[in] table table with sizes set
+ *  \return size of the whole allocation
+ */
+static unsigned int table_bind(TABLE* table)
+{
+    table->index = (unsigned int *)(table + 1);
+    table->offset = table->index + table->rows + 1;
+    table->text = (char *)(table->offset + table->cells);
+
+    return sizeof(TABLE) + (table->rows + 1 + table->cells) * sizeof(unsigned int) + table->length;
+}
+
+/**
+ *  \brief Build compact storage of csv text with one allocation.
+ *
+ *  \param[in] alloc allocator of the table
+ *  \param[in] text csv text
+ *  \return table or NULL fail
+ */
+static TABLE* table_new(const CSV_ALLOC* alloc, const char* text)
+{
+    TABLE temp, *table;
+
+    /* Measure first, so that everything fits in one allocation */
+    table_scan(text, NULL, &temp, 0);
+
+    table = (TABLE *)csv_malloc(alloc, table_bind(&temp));
+    if (!table) return NULL;
+
+    *table = temp;
+    table_bind(table);
+
+    temp = *table;
+    temp.cells = 0;
+    temp.length = 0;
+    table_scan(text, NULL, &temp, 1);
+
+    return table;
+}
+
+/**
+ *  \brief Get the text of a cell in compact storage.
+ *
+ *  \param[in] table table
+ *  \param[in] row row index, counting from 0
+ *  \param[in] col column index, counting from 0
+ *  \return text or NULL when out of range
+ */
+static const char* table_text(TABLE* table, unsigned int row, unsigned int col)
+{
+    if (row >= table->rows) return NULL;
+    if (col >= table->index[row + 1] - table->index[row]) return NULL;
+
+    return table->text + table->offset[table->index[row] + col];
+}
+
+/**
+ *  \brief Get the text length of a cell in compact storage.
+ *
+ *  \param[in] table table
+ *  \param[in] cell cell index, counting from 0
+ *  \return length of text
+ */
+static unsigned int table_length(TABLE* table, unsigned int cell)
+{
+    unsigned int next = (cell + 1 < table->cells) ? table->offset[cell + 1] : table->length;
+
+    return next - table->offset[cell] - 1;
+}
+
+/**
+ *  \brief Free a search index.
+ *
+ *  \param[in] index search index
+ */
+static void index_free(INDEX* index)
+{
+    if (!index) return;
+
+    free(index->rows);
+    free(index->columns);
+    free(index->hashes);
+    free(index->chain);
+    free(index->buckets);
+    free(index->grams);
+    free(index->posts);
+    free(index->hits);
+    free(index);
+}
+
+/**
+ *  \brief Prepare csv for an edit, done at the start of every editing method.
+ *         The search index is dropped, and compact storage is converted into the editable row and cell lists.
+ *
+ *  \param[in] csv csv handle
+ *  \return 1 success or 0 fail, the content is unchanged on failure
+ */
+static int csv_modify(csv_t csv)
+{
+    TABLE *table = csv->table;
+    ROW *rows = NULL, *row, *prow = NULL;
+    CELL *cell, *pcell;
+    unsigned int i, j;
+
+    if (csv->index)
+    {
+        index_free(csv->index);
+        csv->index = NULL;
+    }
+
+    if (!table) return 1;
+
+    for (i = 0; i < table->rows; i++)
+    {
+        row = row_new(csv->alloc, 1);
+        if (!row) goto FAIL;
+
+        if (prow) prow->next = row;
+        else rows = row;
+        prow = row;
+
+        pcell = NULL;
+        for (j = table->index[i]; j < table->index[i + 1]; j++)
+        {
+            cell = (CELL*)csv_malloc(csv->alloc, sizeof(CELL));
+            if (!cell) goto FAIL;
+            cell->next = NULL;
+
+            if (pcell) pcell->next = cell;
+            else row->cells = cell;
+            pcell = cell;
+            row->size++;
+
+            cell->address = csv_strdup(csv->alloc, table->text + table->offset[j], table_length(table, j));
+            if (!cell->address) goto FAIL;
+        }
+    }
+
+    /* The text of compact storage may still be referenced by the caller, release it with csv */
+    if (csv->retired) csv_free(csv->alloc, csv->retired);
+    csv->retired = table;
+    csv->table = NULL;
+
+    csv->rows = rows;
+    csv->size = table->rows;
+    csv->iterator.p = NULL;
+    csv->iterator.i = 0;
+
+    return 1;
+
+FAIL:
+    row_free(csv->alloc, rows);
+    return 0;
+}
+
 /**
  *  \brief Minify the given row by removing empty cells at the end.
  *
+ *  \param[in] alloc Allocator of the row
  *  \param[in] row The row object to be minified
  */
-static void row_minify(ROW *row)
+static void row_minify(const CSV_ALLOC* alloc, ROW *row)
 {
     CELL *cell, *t = NULL;
     unsigned int i = 0;
@@ -311,7 +663,7 @@ static void row_minify(ROW *row)
     /* If there are consecutive null cells at the end, remove them */
     if (i > 0 && t)
     {
-        cell_free(t->next);  /* Free the memory of the consecutive null cells */
+        cell_free(alloc, t->next);  /* Free the memory of the consecutive null cells */
         t->next = NULL;  /* Set the next pointer of the last non-null cell to NULL */
         row->size -= i;  /* Subtract the number of consecutive null cells from the row size */
     }
@@ -328,13 +680,14 @@ void csv_minify(csv_t csv)
     unsigned int i = 0;
 
     if (!csv) return;
+    if (!csv_modify(csv)) return;
     if (!csv->rows) return;
 
     row = csv->rows;
     while (row)
     {
         /* Minify the current row by removing empty cells */
-        row_minify(row);
+        row_minify(csv->alloc, row);
 
         /* Check if the row is empty (null row) */
         if (!row->cells || row->size == 0)
@@ -353,12 +706,37 @@ void csv_minify(csv_t csv)
     /* If there are consecutive null rows at the end, remove them */
     if (i > 0 && t)
     {
-        row_free(t->next);  /* Free the memory of the consecutive null rows */
+        row_free(csv->alloc, t->next);  /* Free the memory of the consecutive null rows */
         t->next = NULL;  /* Set the next pointer of the last non-null row to NULL */
         csv->size -= i;  /* Subtract the number of consecutive null rows from the total size */
     }
 }
 
+/**
+ *  \brief Create a null csv whose rows, cells and tables come from an allocator.
+ *
+ *  \param[in] alloc allocator, NULL the C library
+ *  \return csv handle or NULL fail
+ */
+static csv_t csv_new(const CSV_ALLOC* alloc)
+{
+    csv_t csv;
+
+    csv = (csv_t)csv_malloc(alloc, sizeof(CSV));
+    if (!csv) return NULL;
+    csv->rows = NULL;
+    csv->size = 0;
+    csv->iterator.p = NULL;
+    csv->iterator.i = 0;
+    csv->table = NULL;
+    csv->retired = NULL;
+    csv->index = NULL;
+    csv->indexing = 0;
+    csv->alloc = alloc;
+
+    return csv;
+}
+
 /**
  *  \brief create a csv object
  *  \param[in] col: number of columns
@@ -373,12 +751,8 @@ csv_t csv_create(unsigned int row, unsigned int col, const void *array)
     char *text = NULL;
 
     /* create null csv */
-    csv = (csv_t)malloc(sizeof(CSV));
+    csv = csv_new(NULL);
     if (!csv) return NULL;
-    csv->rows = NULL;
-    csv->size = 0;
-    csv->iterator.p = NULL;
-    csv->iterator.i = 0;
 
     for (i = 0; i < row; i++)
     {
@@ -411,8 +785,11 @@ void csv_delete(csv_t csv)
 {
     if (csv)
     {
-        row_free(csv->rows);
-        free(csv);
+        row_free(csv->alloc, csv->rows);
+        if (csv->table) csv_free(csv->alloc, csv->table);
+        if (csv->retired) csv_free(csv->alloc, csv->retired);
+        index_free(csv->index);
+        csv_free(csv->alloc, csv);
     }
 }
 
@@ -434,6 +811,10 @@ static int attach_row(csv_t csv, unsigned int pos, ROW *row)
     {
         next = csv->rows;
         csv->rows = row; 
+
+        /* The row indexes have moved, restart the iterator */
+        csv->iterator.p = NULL;
+        csv->iterator.i = 0;
     }
     else
     {
@@ -470,6 +851,10 @@ static ROW *detach_row(csv_t csv, unsigned int pos)
         /* Delete the first row */
         row = it_row(csv, 0, csv->size);
         csv->rows = row->next;
+
+        /* The iterator stays on the detached row, restart it */
+        csv->iterator.p = NULL;
+        csv->iterator.i = 0;
     }
     else
     {
@@ -502,6 +887,7 @@ int csv_insert_row(csv_t csv, unsigned int pos, const char **array, unsigned int
 
     /* Check if input parameter is valid */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
 
     /* Adjust the position if it is 0 (insert at the end) */
     if (pos == 0)
@@ -518,7 +904,7 @@ int csv_insert_row(csv_t csv, unsigned int pos, const char **array, unsigned int
         ins = csv->size + 1;
     }
 
-    row = row_new(i);
+    row = row_new(csv->alloc, i);
     if (!row) return 0;
 
     csv->size += attach_row(csv, ins, row);
@@ -556,6 +942,7 @@ int csv_delete_row(csv_t csv, unsigned int pos)
 
     /* Check if input parameter is valid */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
 
     if (csv->size == 0) return 0;
 
@@ -566,7 +953,7 @@ int csv_delete_row(csv_t csv, unsigned int pos)
 
     row = detach_row(csv, pos);
 
-    row_free(row);
+    row_free(csv->alloc, row);
 
     csv->size--;
 
@@ -594,6 +981,10 @@ static int attach_cell(ROW *row, unsigned int pos, CELL *cell)
     {
         next = row->cells;
         row->cells = cell; 
+
+        /* The cell indexes have moved, restart the iterator */
+        row->iterator.p = NULL;
+        row->iterator.i = 0;
     }
     else
     {
@@ -630,6 +1021,10 @@ static CELL *detach_cell(ROW *row, unsigned int pos)
     {
         cell = it_cell(row, 0, row->size);
         row->cells = cell->next;
+
+        /* The iterator stays on the detached cell, restart it */
+        row->iterator.p = NULL;
+        row->iterator.i = 0;
     }
     else
     {
@@ -646,6 +1041,7 @@ static CELL *detach_cell(ROW *row, unsigned int pos)
 /**
  *  \brief Insert a new cell at the specified position in a row.
  * 
+ *  \param[in] alloc Allocator of the row.
  *  \param[in] row Pointer to the row where the cell will be inserted.
  *  \param[in] pos Position to insert the new cell (counting from 1). If pos is 0, the new cell will be inserted at the end of the row.
  *  \return 1 if the cell is successfully inserted, 0 otherwise.
@@ -657,7 +1053,7 @@ static CELL *detach_cell(ROW *row, unsigned int pos)
  *  \note It is the responsibility of the caller to ensure the validity of the row structure.
  *  \note The memory for the new cell is allocated dynamically using the `cell_new` function.
  */
-static int row_insert_cell(ROW *row, unsigned int pos)
+static int row_insert_cell(const CSV_ALLOC* alloc, ROW *row, unsigned int pos)
 {
     CELL* cell = NULL;
     unsigned int i = 1, ins;
@@ -679,7 +1075,7 @@ static int row_insert_cell(ROW *row, unsigned int pos)
         ins = row->size + 1;
     }
 
-    cell = cell_new(i);
+    cell = cell_new(alloc, i);
     if (!cell) return 0;
 
     row->size += attach_cell(row, ins, cell);
@@ -690,6 +1086,7 @@ static int row_insert_cell(ROW *row, unsigned int pos)
 /**
  *  \brief Delete the cell at the specified position in a row.
  * 
+ *  \param[in] alloc Allocator of the row.
  *  \param[in] row Pointer to the row from which the cell will be deleted.
  *  \param[in] pos Position of the cell to delete (counting from 1). If pos is 0, the last cell will be deleted.
  *  \return 1 if the cell is successfully deleted, 0 otherwise.
@@ -701,7 +1098,7 @@ static int row_insert_cell(ROW *row, unsigned int pos)
  *  \note It is the responsibility of the caller to ensure the validity of the row structure.
  *  \note The memory occupied by the deleted cell will be freed using the `cell_free` function.
  */
-static int row_delete_cell(ROW* row, unsigned int pos)
+static int row_delete_cell(const CSV_ALLOC* alloc, ROW* row, unsigned int pos)
 {
     CELL* cell = NULL;
 
@@ -716,7 +1113,7 @@ static int row_delete_cell(ROW* row, unsigned int pos)
     cell = detach_cell(row, pos);
 
     /* Free the memory occupied by the deleted cell */
-    cell_free(cell);
+    cell_free(alloc, cell);
 
     row->size--;
 
@@ -740,6 +1137,7 @@ int csv_insert_col(csv_t csv, unsigned int pos, const char **array, unsigned int
 
     /* Check if input parameter is valid */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
 
     /* Adjust the position if it is 0 (insert at the end) */
     if (pos == 0)
@@ -753,7 +1151,7 @@ int csv_insert_col(csv_t csv, unsigned int pos, const char **array, unsigned int
     for (i = 1; i <= csv->size; i++)
     {
         row = it_row(csv, i - 1, csv->size);
-        if (!row_insert_cell(row, pos))
+        if (!row_insert_cell(csv->alloc, row, pos))
         {
             goto FAIL;
         }
@@ -778,7 +1176,7 @@ FAIL:
     for (i--; i >= 1; i--)
     {
         row = it_row(csv, i - 1, csv->size);
-        row_delete_cell(row, pos);
+        row_delete_cell(csv->alloc, row, pos);
     }
     for (; csv->size > old; )
     {
@@ -801,6 +1199,7 @@ int csv_delete_col(csv_t csv, unsigned int pos)
 
     /* Check if input parameter is valid */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
 
     /* Adjust the position if it is 0 (delete the last column) */
     if (pos == 0)
@@ -812,7 +1211,7 @@ int csv_delete_col(csv_t csv, unsigned int pos)
     for (i = 1; i <= csv->size; i++)
     {
         row = it_row(csv, i - 1, csv->size);
-        row_delete_cell(row, pos);
+        row_delete_cell(csv->alloc, row, pos);
     }
 
     return 1;
@@ -840,6 +1239,7 @@ int csv_move_row_to(csv_t csv, unsigned int pos, unsigned int dest)
 
     /* Check if the CSV data structure exists and is not empty */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (csv->size == 0) return 0;
 
     /* If the current position is greater than the size, check if the new position is also greater than the size */
@@ -891,6 +1291,7 @@ int csv_move_col_to(csv_t csv, unsigned int pos, unsigned int dest)
 
     /* Check if the CSV data structure exists and is not empty */
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (csv->size == 0) return 0;
 
     /* Determine the maximum column index in the CSV data structure */
@@ -952,6 +1353,7 @@ int csv_copy_row_to(csv_t csv, unsigned int pos, unsigned int dest)
     unsigned int size;
 
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (csv->size == 0) return 0;
 
     if (pos == 0)
@@ -999,6 +1401,7 @@ int csv_copy_col_to(csv_t csv, unsigned int pos, unsigned int dest)
     const char *text;
 
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (csv->size == 0) return 0;
 
     max_col = csv_col(csv);
@@ -1054,6 +1457,8 @@ unsigned int csv_col(csv_t csv)
     ROW *row;
 
     if (!csv) return 0;
+    if (csv->table) return csv->table->cols;
+
     row = csv->rows;
     
     while (row)
@@ -1076,11 +1481,21 @@ unsigned int csv_col(csv_t csv)
 unsigned int csv_cell(csv_t csv)
 {
     unsigned int count = 0;
+    unsigned int i;
     ROW *row;
     CELL *cell;
 
     if (!csv) return 0;
 
+    if (csv->table)
+    {
+        for (i = 0; i < csv->table->cells; i++)
+        {
+            if (csv->table->text[csv->table->offset[i]]) count++;
+        }
+        return count;
+    }
+
     row = csv->rows;
     while (row)
     {
@@ -1122,6 +1537,7 @@ int csv_set_text(csv_t csv, unsigned int row, unsigned int col, const char* text
     if (!text) return 0;
     if (col < 1) return 0;
     if (row < 1) return 0;
+    if (!csv_modify(csv)) return 0;
 
     /* If the specified row exceeds the size of the CSV data, insert a new row */
     if (row > csv->size)
@@ -1136,7 +1552,7 @@ int csv_set_text(csv_t csv, unsigned int row, unsigned int col, const char* text
     /* If the specified column exceeds the size of the row, insert a new cell */
     if (col > srow->size)
     {
-        if (!row_insert_cell(srow, col)) return 0;
+        if (!row_insert_cell(csv->alloc, srow, col)) return 0;
     }
 
     /* Get the specified cell */
@@ -1155,11 +1571,11 @@ int csv_set_text(csv_t csv, unsigned int row, unsigned int col, const char* text
     }
 
     /* Copy the text content to a newly allocated memory space */
-    s = csv_strdup(text, len);
+    s = csv_strdup(csv->alloc, text, len);
     if (!s) return 0;
 
     /* Free the old address pointer and update it with the new address */
-    if (cell->address) free(cell->address);
+    if (cell->address) csv_free(csv->alloc, cell->address);
     cell->address = s;
 
     return 1;
@@ -1181,6 +1597,9 @@ const char* csv_get_text(csv_t csv, unsigned int row, unsigned int col)
     /* Check if input parameter is valid */
     if (!csv) return NULL;
 
+    /* Loaded and not edited yet, index the compact table directly */
+    if (csv->table) return table_text(csv->table, row - 1, col - 1);
+
     /* Get the specified row */
     srow = it_row(csv, row - 1, csv->size);
     if (!srow) return NULL;
@@ -1265,7 +1684,7 @@ static int expansion(BUFFER* buf, unsigned int needed)
 /**
  *  \brief Print the content of a CELL structure to a BUFFER structure.
  * 
- *  \param[in] cell Pointer to the CELL structure containing the content to be printed.
+ *  \param[in] address Text of the cell to be printed.
  *  \param[in] buf Pointer to the BUFFER structure where the content will be stored.
  *  \return 1 if the content is successfully printed, 0 otherwise.
  * 
@@ -1275,17 +1694,17 @@ static int expansion(BUFFER* buf, unsigned int needed)
  * 
  *  \note The caller is responsible for managing the BUFFER structure and ensuring its validity.
  */
-static int print_cel(CELL* cell, BUFFER* buf)
+static int print_cel(const char* address, BUFFER* buf)
 {
-    char* addr;
+    const char* addr;
     char escape = 0;
     unsigned int size = 0;
 
-    /* Check if the address string in the CELL structure is valid */
-    if (!cell->address) return 1;
+    /* Check if the address string of the cell is valid */
+    if (!address) return 1;
 
     /* Calculate the size of the content and determine if any special characters need to be escaped */
-    for (addr = cell->address; *addr; addr++)
+    for (addr = address; *addr; addr++)
     {
         switch (*addr)
         {
@@ -1308,7 +1727,7 @@ static int print_cel(CELL* cell, BUFFER* buf)
 
     /* Print the content to the BUFFER structure, properly escaping special characters */
     if (escape) buf_putc('"');
-    for (addr = cell->address; *addr; addr++)
+    for (addr = address; *addr; addr++)
     {
         switch (*addr)
         {
@@ -1343,9 +1762,41 @@ static int print_csv(csv_t csv, BUFFER* buf)
 {
     ROW* row, *rnext;
     CELL* cell, *cnext;
+    TABLE* table;
+    unsigned int i, j;
 
     /* Check if the CSV data structure is valid */
-    if (csv)
+    if (csv && csv->table)
+    {
+        table = csv->table;
+
+        for (i = 0; i < table->rows; i++)
+        {
+            for (j = table->index[i]; j < table->index[i + 1]; j++)
+            {
+                if (!print_cel(table->text + table->offset[j], buf)) return 0;
+
+                /* Append a comma if there are more cells in the row */
+                if (j + 1 < table->index[i + 1])
+                {
+                    if (!buf_append(1)) return 0;
+                    buf_putc(',');
+                }
+            }
+
+            /* Append a newline if there are more rows in the CSV data structure */
+            if (i + 1 < table->rows)
+            {
+                if (!buf_append(1)) return 0;
+                buf_putc('\n');
+            }
+        }
+
+        /* Null-terminate the BUFFER structure */
+        if (!buf_append(1)) return 0;
+        buf_end() = '\0';
+    }
+    else if (csv)
     {
         row = csv->rows;
 
@@ -1364,7 +1815,7 @@ static int print_csv(csv_t csv, BUFFER* buf)
                     cnext = cell->next;
 
                     /* Print the cell's content to the BUFFER structure */
-                    print_cel(cell, buf);
+                    print_cel(cell->address, buf);
 
                     cell = cnext;
 
@@ -1388,6 +1839,7 @@ static int print_csv(csv_t csv, BUFFER* buf)
         }
 
         /* Null-terminate the BUFFER structure */
+        if (!buf_append(1)) return 0;
         buf_end() = '\0';
     }
 
@@ -1486,148 +1938,45 @@ int csv_file_dump(csv_t csv, const char* filename)
 }
 
 /**
- *  \brief load csv text and generate csv.
+ *  \brief load csv text and generate csv, the error information is kept in the context,
+ *         so it can be called on several threads at once.
  *  \param[in] *text: address of text
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
  *  \return csv handler
  */
-csv_t csv_loads(const char* text)
+csv_t csv_loads_ex(const char* text, CSV_CTX* ctx)
 {
     csv_t csv;
-    ROW* row = NULL;
-    CELL* cell = NULL;
+    int etype = CSV_E_OK;                   /* error information of this call */
+    int eline = 1;
+    int ecolumn = 0;
     const char* s = text;
-    const char* start = s;
-    const char* end = NULL;                 /* [start, end) is a cell text interval */
-    const char* quotation = NULL;           /* (start, quotation) is a cell text escape interval */
-    const char* t;
-    int len = 0;
+    const char* lbegin = s;
     
     if (!text) return NULL;
 
-    /* Initialize static parameters for parsing */
-    etype = CSV_E_OK;
-    eline = 1;
-    ecolumn = 0;
-    lbegin = s;
-
     /* create a null csv */
-    csv = csv_create(0, 0, NULL);
+    csv = csv_new(ctx ? ctx->alloc : NULL);
     if (!csv)
     {
         E(CSV_E_MEMORY);
-        return NULL;
+        goto FAIL;
     }
 
-    while (1)
+    /* The whole text goes into one compact table, the rows and cells are only built on the first edit */
+    csv->table = table_new(csv->alloc, text);
+    if (!csv->table)
     {
-        switch (*s)
-        {
-        case '\0':
-            end = s;
-            if (*start == '"') quotation = s; /* At the end of the text, use the end as an escape closed interval */
-        case '\n':
-            eline++;
-            lbegin = s + 1;
-        case ',':
-            if (*start == '"')
-            {
-                if (quotation) end = s; /* Leaving the escape interval, it can be concluded now */
-            }
-            else
-            {
-                end = s; /* Not within the escape interval, ending directly */
-            }
+        E(CSV_E_MEMORY);
+        goto FAIL;
+    }
+    csv->size = csv->table->rows;
 
-            /* Parsing string has reached the end */
-            if (end)
-            {
-#if defined(_WIN32) || defined(_WIN64)
-                if (*end == '\n') end--; /* skip '\r' */
-#endif 
-                /* If there is currently no selected row, create a new row */
-                if (!row)
-                {
-                    if (!csv_insert_row(csv, 0, NULL, 0))
-                    {
-                        E(CSV_E_MEMORY);
-                        goto FAIL;
-                    }
-                    row = it_row(csv, csv->size - 1, csv->size);
-                }
-                
-                /* Add a cell to store parsed text */
-                if (!row_insert_cell(row, 0))
-                {
-                    E(CSV_E_MEMORY);
-                    goto FAIL;
-                }
-                cell = it_cell(row, row->size - 1, row->size);
-
-                /* The length of the string is end minus start, and then subtract the excess in the escape `"` */
-                len = end - start - len;
-                
-                cell->address = malloc(len + 1);
-                if (!cell->address)
-                {
-                    E(CSV_E_MEMORY);
-                    goto FAIL;
-                }
-                
-                /* Convert text to cells */
-                len = 0;
-                for (t = start; t < end; t++)
-                {
-                    /* Double quotation marks including escape */
-                    if (*start == '"')
-                    {
-                        if (*t == '"')
-                        {
-                            if (t == start || t == quotation) continue; /* Skip both ends of quotation marks directly */
-                            if (t < quotation) t++; /* Escaped quotation marks skip the first one */
-                        }
-                    }
-                    cell->address[len++] = *t;
-                }
-                cell->address[len] = '\0';
-
-                /* Reset to resolve the next one */
-                if (*s == '\n') row = NULL;
-                cell = NULL;
-                start = s + 1;
-                end = NULL;
-                quotation = NULL;
-                len = 0;
-            }
-            break;
-        case '"':
-            /* Starting with quotation marks, there is an escaped interval */
-            if (*start == '"')
-            {
-                /* Currently at the starting position */
-                if (s == start)
-                {
-                    len++;
-                }
-                else
-                {
-                    /* The quotation marks have not yet formed a closed interval, they are still within the scope of escape */
-                    if (!quotation)
-                    {
-                        if (s[1] == '"') s++; /* it is an escaped quotation mark */
-                        else quotation = s; /* A single quotation mark indicates the formation of a closed interval */
-                        len++;
-                    }
-                }
-            }
-            break;
-        default:
-            break;
-        }
-
-        /* Exit of loop parsing */
-        if (!*s) break;
-
-        s++;
+    if (ctx)
+    {
+        ctx->type = CSV_E_OK;
+        ctx->line = 0;
+        ctx->column = 0;
     }
 
     return csv;
@@ -1635,9 +1984,25 @@ csv_t csv_loads(const char* text)
 FAIL:
     ecolumn = s - lbegin + 1;
     csv_delete(csv);
+    if (ctx)
+    {
+        ctx->type = etype;
+        ctx->line = eline;
+        ctx->column = ecolumn;
+    }
     return NULL;
 }
 
+/**
+ *  \brief load csv text and generate csv.
+ *  \param[in] *text: address of text
+ *  \return csv handler, use `csv_error_info()` to locate the error
+ */
+csv_t csv_loads(const char* text)
+{
+    return csv_loads_ex(text, &ectx);
+}
+
 /**
  *  \brief load csv file and generate csv.
  *  \param[in] *filename: filename
@@ -1646,56 +2011,317 @@ FAIL:
 csv_t csv_file_load(const char* filename)
 {
     csv_t csv;
-    FILE* f;
-    long len;
-    char* text = NULL;
+    FMAP map;
+    int error;
 
     if (!filename) return NULL;
 
-    eline = 0;
+    /* map file, the content is parsed in place without copying */
+    error = fmap_open(&map, filename);
+    if (error != FMAP_E_OK)
+    {
+        ectx.type = (error == FMAP_E_MEMORY) ? CSV_E_MEMORY : CSV_E_OPEN;
+        ectx.line = 0;
+        ectx.column = 0;
+        return NULL;
+    }
 
-    /* open file and get the length of file */
-    f = fopen(filename, "rb");
-    if (!f)
+    csv = csv_loads(map.data); /* load text */
+
+    /* The file was truncated while loading, the text read is not valid */
+    if (fmap_close(&map) != FMAP_E_OK && csv)
     {
-        E(CSV_E_OPEN);
-        goto FAIL;
+        csv_delete(csv);
+        csv = NULL;
+        ectx.type = CSV_E_OPEN;
+        ectx.line = 0;
+        ectx.column = 0;
     }
 
-    /* get file length */
-    fseek(f, 0, SEEK_END);
-    len = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    return csv;
+}
+
+#if CSV_USE_PTHREAD
+/* one chunk of the text for a thread of `csv_loads_mt()` */
+typedef struct
+{
+    const char* text;                       /**< start of chunk */
+    const char* tail;                       /**< end of chunk, NULL for the last chunk when scanning */
+    const char* head;                       /**< start of the whole text */
+    unsigned int quotes;                    /**< count of quotation marks in chunk */
+    int valid;                              /**< bit n set when the quotation marks enclose whole cells, with a parity of n before chunk */
+    TABLE table;                            /**< sizes of chunk, then the part of the table it fills */
+    int phase;                              /**< 0 count quotation marks, 1 measure, 2 fill */
+} CHUNK;
+
+/**
+ *  \brief Do the work of the current phase for one chunk.
+ *  \param[in] arg: chunk
+ *  \return NULL
+ */
+static void* chunk_work(void* arg)
+{
+    CHUNK* chunk = (CHUNK*)arg;
+    const char* s;
 
-    /* read file */
-    text = (char*)malloc(len + 1);
-    if (text)
+    switch (chunk->phase)
     {
-        fread(text, 1, len, f);
-        fclose(f);
-        f = NULL;
+    case 0:
+        chunk->quotes = 0;
+        chunk->valid = 3;
+        for (s = chunk->text; (s = (const char*)memchr(s, '"', chunk->tail - s)) != NULL; s++)
+        {
+            /* Outside quotation marks, a quotation mark must open a cell, or be the second one of an escape,
+             * otherwise `table_scan()` takes it as text and the parity of the marks no longer tells the rows */
+            if (s != chunk->head && s[-1] != ',' && s[-1] != '\n' && s[-1] != '"')
+            {
+                chunk->valid &= (chunk->quotes & 1) ? 1 : 2;
+            }
+            chunk->quotes++;
+        }
+        break;
+    case 1:
+        table_scan(chunk->text, chunk->tail, &chunk->table, 0);
+        break;
+    case 2:
+        table_scan(chunk->text, chunk->tail, &chunk->table, 1);
+        break;
+    default:
+        break;
     }
-    else
+
+    return NULL;
+}
+
+/**
+ *  \brief Run one phase over all chunks, the first chunk is done on the calling thread.
+ *         A chunk whose thread can not be created is done on the calling thread as well.
+ *  \param[in] chunks: chunks
+ *  \param[in] count: count of chunks
+ *  \param[in] phase: phase, @ref CHUNK
+ *  \return none
+ */
+static void chunk_run(CHUNK* chunks, int count, int phase)
+{
+    pthread_t threads[CSV_THREAD_MAX];
+    int created[CSV_THREAD_MAX];
+    int i;
+
+    for (i = 0; i < count; i++) chunks[i].phase = phase;
+
+    for (i = 1; i < count; i++)
     {
-        E(CSV_E_MEMORY);
-        goto FAIL;
+        created[i] = (pthread_create(&threads[i], NULL, chunk_work, &chunks[i]) == 0);
     }
-    text[len] = 0;
 
-    csv = csv_loads(text); /* load text */
-    if (!csv)
+    chunk_work(&chunks[0]);
+
+    for (i = 1; i < count; i++)
     {
-        goto FAIL;
+        if (created[i]) pthread_join(threads[i], NULL);
+        else chunk_work(&chunks[i]);
+    }
+}
+#endif
+
+/**
+ *  \brief load csv text on several threads and generate csv, the result is the same as `csv_loads_ex()`.
+ *         The text is cut into chunks at line breaks that are outside quotation marks,
+ *         this is decided by the parity of the quotation marks before them. Text with an odd count of quotation marks,
+ *         or with quotation marks that do not enclose whole cells as RFC 4180 describes, like `ab"c`,
+ *         short text, or a build without `CSV_USE_PTHREAD` is parsed sequentially.
+ *  \param[in] *text: address of text
+ *  \param[in] threads: count of threads, not greater than 0 uses the count of online processors
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
+ *  \return csv handler
+ */
+csv_t csv_loads_mt(const char* text, int threads, CSV_CTX* ctx)
+{
+#if CSV_USE_PTHREAD
+    CHUNK chunks[CSV_THREAD_MAX];
+    const char* starts[CSV_THREAD_MAX];
+    const char* s;
+    const char* tail;
+    csv_t csv;
+    TABLE *table, total;
+    unsigned int rows, cells, length;
+    size_t size;
+    int parity, p, found, count, i;
+
+    if (!text) return NULL;
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > CSV_THREAD_MAX) threads = CSV_THREAD_MAX;
+
+    size = strlen(text);
+    tail = text + size;
+    count = (size / CSV_CHUNK_MIN < (size_t)threads) ? (int)(size / CSV_CHUNK_MIN) : threads;
+    if (count <= 1) return csv_loads_ex(text, ctx);
+
+    /* Count the quotation marks of evenly cut chunks */
+    for (i = 0; i < count; i++)
+    {
+        chunks[i].text = text + size * i / count;
+        chunks[i].tail = text + size * (i + 1) / count;
+        chunks[i].head = text;
+    }
+    chunk_run(chunks, count, 0);
+
+    /* Unbalanced quotation marks, or ones that do not enclose whole cells, can not be cut safely */
+    parity = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (!(chunks[i].valid & (1 << parity))) return csv_loads_ex(text, ctx);
+        parity ^= chunks[i].quotes & 1;
+    }
+    if (parity) return csv_loads_ex(text, ctx);
+
+    /* Move each cut forward to just after the next line break outside quotation marks */
+    starts[0] = text;
+    for (i = 1; i < count; i++)
+    {
+        parity ^= chunks[i - 1].quotes & 1;
+
+        s = chunks[i].text;
+        p = parity;
+
+        /* The previous cut has been moved past this one, go on from there, it is a row start */
+        if (s < starts[i - 1])
+        {
+            s = starts[i - 1];
+            p = 0;
+        }
+
+        for (found = 0; s < tail; s++)
+        {
+            if (*s == '"') p ^= 1;
+            else if (*s == '\n' && !p)
+            {
+                found = 1;
+                s++;
+                break;
+            }
+        }
+
+        /* No more line breaks, the rest belongs to the previous chunk */
+        if (!found)
+        {
+            count = i;
+            break;
+        }
+
+        starts[i] = s;
+    }
+
+    /* Measure each chunk */
+    for (i = 0; i < count; i++)
+    {
+        chunks[i].text = starts[i];
+        chunks[i].tail = (i + 1 < count) ? starts[i + 1] : NULL;
+    }
+    chunk_run(chunks, count, 1);
+
+    /* Lay the chunks out one after another in one table */
+    total.rows = 0;
+    total.cols = 0;
+    total.cells = 0;
+    total.length = 0;
+    for (i = 0; i < count; i++)
+    {
+        total.rows += chunks[i].table.rows;
+        total.cells += chunks[i].table.cells;
+        total.length += chunks[i].table.length;
+        if (chunks[i].table.cols > total.cols) total.cols = chunks[i].table.cols;
+    }
+
+    csv = csv_new(ctx ? ctx->alloc : NULL);
+    table = csv ? (TABLE *)csv_malloc(csv->alloc, table_bind(&total)) : NULL;
+    if (!csv || !table)
+    {
+        if (csv) csv_delete(csv);
+        if (ctx)
+        {
+            ctx->type = CSV_E_MEMORY;
+            ctx->line = 1;
+            ctx->column = 1;
+        }
+        return NULL;
     }
+    *table = total;
+    table_bind(table);
 
-    free(text);
+    /* Fill each chunk into its part of the table */
+    rows = 0;
+    cells = 0;
+    length = 0;
+    for (i = 0; i < count; i++)
+    {
+        total = chunks[i].table;
+        chunks[i].table.index = table->index + rows;
+        chunks[i].table.offset = table->offset + cells;
+        chunks[i].table.text = table->text + length;
+        chunks[i].table.cells = cells;
+        chunks[i].table.length = length;
+        rows += total.rows;
+        cells += total.cells;
+        length += total.length;
+    }
+    chunk_run(chunks, count, 2);
+
+    csv->table = table;
+    csv->size = table->rows;
+
+    if (ctx)
+    {
+        ctx->type = CSV_E_OK;
+        ctx->line = 0;
+        ctx->column = 0;
+    }
 
     return csv;
+#else
+    (void)threads;
+    return csv_loads_ex(text, ctx);
+#endif
+}
 
-FAIL:
-    if (f) fclose(f);
-    if (text) free(text);
-    return NULL;
+/**
+ *  \brief load csv file on several threads and generate csv.
+ *  \param[in] *filename: filename
+ *  \param[in] threads: count of threads, not greater than 0 uses the count of online processors
+ *  \return csv handler, use `csv_error_info()` to locate the error
+ */
+csv_t csv_file_load_mt(const char* filename, int threads)
+{
+    csv_t csv;
+    FMAP map;
+    int error;
+
+    if (!filename) return NULL;
+
+    /* map file, the content is parsed in place without copying */
+    error = fmap_open(&map, filename);
+    if (error != FMAP_E_OK)
+    {
+        ectx.type = (error == FMAP_E_MEMORY) ? CSV_E_MEMORY : CSV_E_OPEN;
+        ectx.line = 0;
+        ectx.column = 0;
+        return NULL;
+    }
+
+    csv = csv_loads_mt(map.data, threads, &ectx); /* load text */
+
+    /* The file was truncated while loading, the text read is not valid */
+    if (fmap_close(&map) != FMAP_E_OK && csv)
+    {
+        csv_delete(csv);
+        csv = NULL;
+        ectx.type = CSV_E_OPEN;
+        ectx.line = 0;
+        ectx.column = 0;
+    }
+
+    return csv;
 }
 
 /**
@@ -1706,10 +2332,349 @@ FAIL:
  */
 int csv_error_info(int* line, int* column)
 {
-    if (etype == CSV_E_OK) return 0;
-    if (line) *line = eline;
-    if (column) *column = ecolumn;
-    return etype;
+    if (ectx.type == CSV_E_OK) return 0;
+    if (line) *line = ectx.line;
+    if (column) *column = ectx.column;
+    return ectx.type;
+}
+
+/**
+ *  \brief Initialize a streaming reader, no memory is allocated.
+ *  \param[out] reader: reader
+ *  \param[in] buffer: sliding buffer, must be able to hold the longest row plus one byte
+ *  \param[in] size: size of buffer
+ *  \param[in] fields: array that receives the fields of each row
+ *  \param[in] capacity: capacity of fields, the most fields a row can have
+ *  \param[in] read: read callback, `csv_fread` reads from a `FILE*`
+ *  \param[in] context: context of read callback
+ *  \return none
+ */
+void csv_reader_init(CSV_READER* reader, char* buffer, unsigned int size, CSV_FIELD* fields, unsigned int capacity, csv_read_t read, void* context)
+{
+    if (!reader) return;
+
+    reader->buffer = buffer;
+    reader->size = size;
+    reader->begin = 0;
+    reader->end = 0;
+    reader->fields = fields;
+    reader->capacity = capacity;
+    reader->read = read;
+    reader->context = context;
+    reader->line = 1;
+    reader->eof = 0;
+    reader->error = (buffer && size > 1 && fields && capacity > 0 && read) ? CSV_E_OK : CSV_E_OVERFLOW;
+}
+
+/**
+ *  \brief Read the next row, quoted fields follow RFC 4180 and may span several lines.
+ *         The fields are unescaped in place and stay valid until the next call.
+ *  \param[in] reader: reader
+ *  \return count of fields of the row, 0 at the end, or -1 on error,
+ *          `reader->error` tells the error type and `reader->line` the line of the failing row
+ */
+int csv_read_row(CSV_READER* reader)
+{
+    char* buffer;
+    unsigned int scan = 0;                  /* end of scanned data */
+    unsigned int next;                      /* start of next row */
+    unsigned int rend;                      /* end of row text */
+    unsigned int r, w, start, lines = 0;
+    unsigned int count = 0;
+    int quote = 0;                          /* inside quotation marks */
+    int comma;
+    int n;
+
+    if (!reader) return -1;
+    if (reader->error != CSV_E_OK) return -1;
+
+    buffer = reader->buffer;
+
+    /* Slide the data that has not been consumed to the front */
+    if (reader->begin > 0)
+    {
+        memmove(buffer, buffer + reader->begin, reader->end - reader->begin);
+        reader->end -= reader->begin;
+        reader->begin = 0;
+    }
+
+    /* Find the newline that ends the row outside quotation marks, read more data until there is one */
+    while (1)
+    {
+        for (; scan < reader->end; scan++)
+        {
+            if (buffer[scan] == '"') quote = !quote;
+            else if (buffer[scan] == '\n')
+            {
+                if (!quote) break;
+                lines++;
+            }
+        }
+        if (scan < reader->end || reader->eof) break;
+
+        /* One byte is kept for the terminator of the last field */
+        if (reader->end >= reader->size - 1)
+        {
+            reader->error = CSV_E_OVERFLOW;
+            return -1;
+        }
+
+        n = reader->read(reader->context, buffer + reader->end, reader->size - 1 - reader->end);
+        if (n < 0)
+        {
+            reader->error = CSV_E_READ;
+            return -1;
+        }
+        if (n == 0) reader->eof = 1;
+        else reader->end += n;
+    }
+
+    /* Nothing left */
+    if (reader->end == 0) return 0;
+
+    next = (scan < reader->end) ? scan + 1 : scan;
+    rend = scan;
+    if (rend > 0 && buffer[rend - 1] == '\r') rend--; /* CRLF line break */
+
+    /* Split the row into fields, unescaping in place, the written text never passes the read position */
+    r = 0;
+    while (1)
+    {
+        if (count >= reader->capacity)
+        {
+            reader->error = CSV_E_OVERFLOW;
+            return -1;
+        }
+
+        start = r;
+        w = r;
+
+        if (r < rend && buffer[r] == '"')
+        {
+            r++;
+            while (r < rend)
+            {
+                if (buffer[r] == '"')
+                {
+                    if (r + 1 < rend && buffer[r + 1] == '"') r++; /* escaped quotation mark */
+                    else
+                    {
+                        r++;
+                        break;
+                    }
+                }
+                buffer[w++] = buffer[r++];
+            }
+        }
+
+        /* Unquoted text, or text after the closing quotation mark, is taken as it is */
+        while (r < rend && buffer[r] != ',') buffer[w++] = buffer[r++];
+
+        comma = (r < rend);
+        buffer[w] = '\0';
+
+        reader->fields[count].text = buffer + start;
+        reader->fields[count].length = w - start;
+        count++;
+
+        if (!comma) break;
+        r++;
+    }
+
+    reader->begin = next;
+    reader->line += lines + 1;
+
+    return (int)count;
+}
+
+/**
+ *  \brief Initialize a buffered streaming writer, no memory is allocated.
+ *  \param[out] writer: writer
+ *  \param[in] buffer: output buffer, the data is handed to the callback when it is full
+ *  \param[in] size: size of buffer
+ *  \param[in] write: write callback, `csv_fwrite` writes to a `FILE*` opened for appending or writing
+ *  \param[in] context: context of write callback
+ *  \return none
+ */
+void csv_writer_init(CSV_WRITER* writer, char* buffer, unsigned int size, csv_write_t write, void* context)
+{
+    if (!writer) return;
+
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->end = 0;
+    writer->count = 0;
+    writer->write = write;
+    writer->context = context;
+    writer->error = (buffer && size > 0 && write) ? CSV_E_OK : CSV_E_OVERFLOW;
+}
+
+/**
+ *  \brief Hand the buffered data to the write callback.
+ *  \param[in] writer: writer
+ *  \return 1 success or 0 fail
+ */
+int csv_writer_flush(CSV_WRITER* writer)
+{
+    if (!writer) return 0;
+    if (writer->error != CSV_E_OK) return 0;
+
+    if (writer->end > 0)
+    {
+        if (!writer->write(writer->context, writer->buffer, (int)writer->end))
+        {
+            writer->error = CSV_E_WRITE;
+            return 0;
+        }
+        writer->end = 0;
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief Put data into the writer buffer, flushing whenever it is full.
+ *  \param[in] writer: writer
+ *  \param[in] data: data
+ *  \param[in] len: length of data
+ *  \return 1 success or 0 fail
+ */
+static int writer_put(CSV_WRITER* writer, const char* data, unsigned int len)
+{
+    unsigned int n;
+
+    while (len > 0)
+    {
+        if (writer->end >= writer->size)
+        {
+            if (!csv_writer_flush(writer)) return 0;
+        }
+
+        n = writer->size - writer->end;
+        if (n > len) n = len;
+        memcpy(writer->buffer + writer->end, data, n);
+        writer->end += n;
+        data += n;
+        len -= n;
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief Write a field to the current row, it is quoted when it contains `,` `"` or a line break.
+ *  \param[in] writer: writer
+ *  \param[in] text: field text, NULL as empty
+ *  \param[in] len: length of text, negative to use the terminated length
+ *  \return 1 success or 0 fail
+ */
+int csv_write_field(CSV_WRITER* writer, const char* text, int len)
+{
+    unsigned int i, start, length;
+    int escape = 0;
+
+    if (!writer) return 0;
+    if (writer->error != CSV_E_OK) return 0;
+
+    if (!text) text = "";
+    length = (len < 0) ? strlen(text) : (unsigned int)len;
+
+    if (writer->count > 0)
+    {
+        if (!writer_put(writer, ",", 1)) return 0;
+    }
+    writer->count++;
+
+    for (i = 0; i < length; i++)
+    {
+        if (text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r')
+        {
+            escape = 1;
+            break;
+        }
+    }
+
+    if (!escape) return writer_put(writer, text, length);
+
+    /* Quote the field and double each quotation mark inside */
+    if (!writer_put(writer, "\"", 1)) return 0;
+    for (start = 0, i = 0; i < length; i++)
+    {
+        if (text[i] == '"')
+        {
+            if (!writer_put(writer, text + start, i + 1 - start)) return 0;
+            start = i;
+        }
+    }
+    if (!writer_put(writer, text + start, length - start)) return 0;
+
+    return writer_put(writer, "\"", 1);
+}
+
+/**
+ *  \brief End the current row.
+ *  \param[in] writer: writer
+ *  \return 1 success or 0 fail
+ */
+int csv_write_eol(CSV_WRITER* writer)
+{
+    if (!writer) return 0;
+    if (writer->error != CSV_E_OK) return 0;
+
+    writer->count = 0;
+
+    return writer_put(writer, "\n", 1);
+}
+
+/**
+ *  \brief Write a whole row.
+ *  \param[in] writer: writer
+ *  \param[in] texts: field texts
+ *  \param[in] count: count of fields
+ *  \return 1 success or 0 fail
+ */
+int csv_write_row(CSV_WRITER* writer, const char** texts, unsigned int count)
+{
+    unsigned int i;
+
+    if (!writer) return 0;
+    if (!texts && count > 0) return 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!csv_write_field(writer, texts[i], -1)) return 0;
+    }
+
+    return csv_write_eol(writer);
+}
+
+/**
+ *  \brief Read callback over `FILE*`.
+ *  \param[in] context: file
+ *  \param[out] data: data
+ *  \param[in] size: size of data
+ *  \return count of bytes read, 0 at the end, or -1 on error
+ */
+int csv_fread(void* context, char* data, int size)
+{
+    size_t n;
+
+    n = fread(data, 1, size, (FILE*)context);
+    if (n == 0 && ferror((FILE*)context)) return -1;
+
+    return (int)n;
+}
+
+/**
+ *  \brief Write callback over `FILE*`.
+ *  \param[in] context: file
+ *  \param[in] data: data
+ *  \param[in] len: length of data
+ *  \return 1 success or 0 fail
+ */
+int csv_fwrite(void* context, const char* data, int len)
+{
+    return fwrite(data, 1, len, (FILE*)context) == (size_t)len;
 }
 
 /**
@@ -1729,6 +2694,7 @@ csv_t csv_duplicate(csv_t csv)
     csv_t dp = NULL;
     ROW *row = NULL;
     unsigned int i, j;
+    unsigned int size;
 
     /* Check if the original CSV data structure is valid */
     if (!csv) return NULL;
@@ -1737,6 +2703,23 @@ csv_t csv_duplicate(csv_t csv)
     dp = csv_create(0, 0, NULL);
     if (!dp) return NULL;
 
+    /* The compact table is copied as a whole */
+    if (csv->table)
+    {
+        size = table_bind(csv->table);
+        dp->table = (TABLE *)csv_malloc(dp->alloc, size);
+        if (!dp->table)
+        {
+            csv_delete(dp);
+            return NULL;
+        }
+        memcpy(dp->table, csv->table, size);
+        table_bind(dp->table);
+        dp->size = dp->table->rows;
+
+        return dp;
+    }
+
     /* Iterate through each row and cell in the original CSV data structure */
     for (i = 1; i <= csv->size; i++)
     {
@@ -1805,6 +2788,7 @@ int csv_cut_cell_to(csv_t csv, unsigned int s_row, unsigned int s_col, unsigned
     char *swap;
 
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (!s_row || !s_col || !d_row || !d_col) return 0;
 
     if (!csv_set_text(csv, d_row, d_col, "")) return 0;
@@ -1844,6 +2828,7 @@ int csv_insert_cell(csv_t csv, unsigned int row, unsigned int col, int move_down
     char *text;
 
     if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
     if (csv->size == 0) return 0;
     if (!row || !col) return 0;
     if (row > csv->size) return 0;
@@ -1877,82 +2862,357 @@ int csv_insert_cell(csv_t csv, unsigned int row, unsigned int col, int move_down
     }
     else 
     {
-        /* If not moving other cells down, simply insert a new cell at the specified column in the given row */
-        r1 = it_row(csv, row - 1, csv->size);
-        if (col > r1->size) return 1;
+        /* If not moving other cells down, simply insert a new cell at the specified column in the given row */
+        r1 = it_row(csv, row - 1, csv->size);
+        if (col > r1->size) return 1;
+
+        c1 = cell_new(csv->alloc, 1);
+        if (!c1) return 0;
+        attach_cell(r1, col, c1);
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief Delete a cell in the given CSV table.
+ *
+ *  \param[in] csv handle
+ *  \param[in] row The index of the row where the cell is deleted
+ *  \param[in] col The index of the column where the cell is deleted
+ *  \param[in] move_up Whether to move other cells up
+ *                    - 0: Do not move other cells up
+ *                    - Non-zero: Move other cells left
+ *
+ *  \return Returns 1 if the cell is successfully deleted, 0 otherwise
+ */
+int csv_delete_cell(csv_t csv, unsigned int row, unsigned int col, int move_up)
+{
+    CELL *c1, *c2;
+    ROW *r1, *r2;
+    unsigned int i;
+    char *text, *old;
+
+    if (!csv) return 0;
+    if (!csv_modify(csv)) return 0;
+    if (csv->size == 0) return 0;
+    if (!row || !col) return 0;
+    if (row > csv->size) return 0;
+    if (col > csv_col(csv)) return 0;
+
+    if (move_up)
+    {
+        /* Delete the cell and move cells up from the given row to the end of the table */
+        for (i = row; i <= csv->size; i++)
+        {
+            if (!csv_get_text(csv, i, col))
+            {
+                /* If the current cell is empty, set it to an empty string */
+                if (!csv_set_text(csv, i, col, "")) return 0;
+            }
+        }
+
+        /* Set the cell at the specified row and column to an empty string */
+        if (!csv_set_text(csv, row, col, "")) return 0;
+
+        /* Starting from the given row, swap cell contents row by row and column by column to complete the move up operation */
+        for (i = row; i < csv->size; i++)
+        {
+            r1 = it_row(csv, i - 1, csv->size);
+            c1 = it_cell(r1, col - 1, r1->size);
+            r2 = it_row(csv, i, csv->size);
+            c2 = it_cell(r2, col - 1, r2->size);
+
+            text = c1->address;
+            c1->address = c2->address;
+            c2->address = text;
+        }
+    }
+    else  
+    {
+        /* If not moving other cells up, simply detach and free the cell at the specified column in the given row */
+        r1 = it_row(csv, row - 1, csv->size);
+        if (col > r1->size) return 1;
+
+        c1 = detach_cell(r1, col);
+        cell_free(csv->alloc, c1);
+    }
+
+    return 1;
+}
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64)
+/**
+ *  \brief Convert eight decimal digits at once, the bytes are handled as lanes of one 64-bit word.
+ *
+ *  \param[in] s text, at least 8 characters
+ *  \param[out] value value of the digits
+ *  \return 1 all 8 characters are digits or 0 not
+ */
+static int eight_digits(const char* s, uint32_t* value)
+{
+    uint64_t v;
+
+    memcpy(&v, s, 8);
+
+    /* Every byte is within '0' ~ '9' */
+    if (((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) != 0x3333333333333333ull) return 0;
+
+    /* Combine pairs, then quads, then both halves */
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) + (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+
+    *value = (uint32_t)v;
+
+    return 1;
+}
+#define EIGHT_DIGITS
+#endif
+
+/**
+ *  \brief Trim the blanks around a cell text.
+ *
+ *  \param[in,out] s start of text
+ *  \param[in,out] e end of text
+ *  \return 1 some text left or 0 empty
+ */
+static int trim_text(const char** s, const char** e)
+{
+    while (*s < *e && (**s == ' ' || **s == '\t')) (*s)++;
+    while (*e > *s && ((*e)[-1] == ' ' || (*e)[-1] == '\t' || (*e)[-1] == '\r')) (*e)--;
+
+    return *s < *e;
+}
+
+/**
+ *  \brief Convert cell text to int32_t.
+ *
+ *  \param[in] text cell text
+ *  \param[in] len length of text
+ *  \param[out] out int32_t value
+ *  \return @ref CSV_C_xxx
+ */
+static int convert_int32(const char* text, unsigned int len, void* out)
+{
+    const char* s = text;
+    const char* e = text + len;
+    int32_t* value = (int32_t*)out;
+    uint64_t v = 0;
+    int negative = 0;
+#ifdef EIGHT_DIGITS
+    uint32_t eight;
+#endif
+
+    *value = 0;
+
+    if (!trim_text(&s, &e)) return CSV_C_EMPTY;
+
+    if (*s == '-' || *s == '+')
+    {
+        negative = (*s == '-');
+        s++;
+        if (s == e) return CSV_C_INVALID;
+    }
+
+#ifdef EIGHT_DIGITS
+    /* Long numbers take the first eight digits in one step */
+    if (e - s >= 8 && eight_digits(s, &eight))
+    {
+        v = eight;
+        s += 8;
+    }
+#endif
+
+    for (; s < e; s++)
+    {
+        if (*s < '0' || *s > '9') return CSV_C_INVALID;
+
+        /* Stop accumulating once out of range, the rest is still checked */
+        if (v <= 0xFFFFFFFFull) v = v * 10 + (*s - '0');
+    }
+
+    if (v > (negative ? 2147483648ull : 2147483647ull))
+    {
+        *value = negative ? INT32_MIN : INT32_MAX;
+        return CSV_C_RANGE;
+    }
 
-        c1 = cell_new(1);
-        if (!c1) return 0;
-        attach_cell(r1, col, c1);
+    *value = negative ? (int32_t)(-(int64_t)v) : (int32_t)v;
+
+    return CSV_C_OK;
+}
+
+/**
+ *  \brief Convert cell text to double.
+ *
+ *  \param[in] text cell text
+ *  \param[in] len length of text
+ *  \param[out] value double value
+ *  \return @ref CSV_C_xxx
+ */
+static int convert_number(const char* text, unsigned int len, double* value)
+{
+    const char* s = text;
+    const char* e = text + len;
+    char* end = NULL;
+
+    *value = 0;
+
+    if (!trim_text(&s, &e)) return CSV_C_EMPTY;
+
+    *value = fpconv_strntod(s, e - s, &end);
+    if (end != e)
+    {
+        *value = 0;
+        return CSV_C_INVALID;
     }
 
-    return 1;
+    /* Overflow gives infinity */
+    if (*value > DBL_MAX || *value < -DBL_MAX) return CSV_C_RANGE;
+
+    return CSV_C_OK;
 }
 
 /**
- *  \brief Delete a cell in the given CSV table.
+ *  \brief Convert cell text to double.
  *
- *  \param[in] csv handle
- *  \param[in] row The index of the row where the cell is deleted
- *  \param[in] col The index of the column where the cell is deleted
- *  \param[in] move_up Whether to move other cells up
- *                    - 0: Do not move other cells up
- *                    - Non-zero: Move other cells left
+ *  \param[in] text cell text
+ *  \param[in] len length of text
+ *  \param[out] out double value
+ *  \return @ref CSV_C_xxx
+ */
+static int convert_double(const char* text, unsigned int len, void* out)
+{
+    return convert_number(text, len, (double*)out);
+}
+
+/**
+ *  \brief Convert cell text to float.
  *
- *  \return Returns 1 if the cell is successfully deleted, 0 otherwise
+ *  \param[in] text cell text
+ *  \param[in] len length of text
+ *  \param[out] out float value
+ *  \return @ref CSV_C_xxx
  */
-int csv_delete_cell(csv_t csv, unsigned int row, unsigned int col, int move_up)
+static int convert_float(const char* text, unsigned int len, void* out)
 {
-    CELL *c1, *c2;
-    ROW *r1, *r2;
-    unsigned int i;
-    char *text, *old;
+    double value;
+    int result;
+
+    result = convert_number(text, len, &value);
+    *(float*)out = (float)value;
+
+    /* Finite doubles beyond the float range become infinity */
+    if (result == CSV_C_OK && (value > FLT_MAX || value < -FLT_MAX)) result = CSV_C_RANGE;
+
+    return result;
+}
+
+/**
+ *  \brief Convert a column from row 1 down with a cell converter.
+ *
+ *  \param[in] csv csv handle
+ *  \param[in] col column index, counting from 1
+ *  \param[out] out output array
+ *  \param[in] size size of an output item
+ *  \param[in] n capacity of output array
+ *  \param[out] status status of each cell, can be NULL
+ *  \param[in] convert cell converter
+ *  \return count of values written
+ */
+static int column_convert(csv_t csv, unsigned int col, void* out, unsigned int size, unsigned int n, unsigned char* status, int (*convert)(const char*, unsigned int, void*))
+{
+    TABLE* table;
+    ROW* row;
+    CELL* cell;
+    const char* text;
+    unsigned int i, j, len;
+    int result;
 
     if (!csv) return 0;
-    if (csv->size == 0) return 0;
-    if (!row || !col) return 0;
-    if (row > csv->size) return 0;
-    if (col > csv_col(csv)) return 0;
+    if (!out) return 0;
+    if (col < 1) return 0;
 
-    if (move_up)
+    if (n > csv->size) n = csv->size;
+
+    table = csv->table;
+    row = csv->rows;
+
+    for (i = 0; i < n; i++)
     {
-        /* Delete the cell and move cells up from the given row to the end of the table */
-        for (i = row; i <= csv->size; i++)
+        text = "";
+        len = 0;
+
+        if (table)
         {
-            if (!csv_get_text(csv, i, col))
+            /* Loaded and not edited yet, the cell lengths come from the offsets */
+            j = table->index[i] + col - 1;
+            if (j < table->index[i + 1])
             {
-                /* If the current cell is empty, set it to an empty string */
-                if (!csv_set_text(csv, i, col, "")) return 0;
+                text = table->text + table->offset[j];
+                len = table_length(table, j);
             }
         }
-
-        /* Set the cell at the specified row and column to an empty string */
-        if (!csv_set_text(csv, row, col, "")) return 0;
-
-        /* Starting from the given row, swap cell contents row by row and column by column to complete the move up operation */
-        for (i = row; i < csv->size; i++)
+        else
         {
-            r1 = it_row(csv, i - 1, csv->size);
-            c1 = it_cell(r1, col - 1, r1->size);
-            r2 = it_row(csv, i, csv->size);
-            c2 = it_cell(r2, col - 1, r2->size);
-
-            text = c1->address;
-            c1->address = c2->address;
-            c2->address = text;
+            /* Walk the rows in order instead of seeking each one */
+            cell = (col <= row->size) ? it_cell(row, col - 1, row->size) : NULL;
+            if (cell && cell->address)
+            {
+                text = cell->address;
+                len = strlen(text);
+            }
+            row = row->next;
         }
-    }
-    else  
-    {
-        /* If not moving other cells up, simply detach and free the cell at the specified column in the given row */
-        r1 = it_row(csv, row - 1, csv->size);
-        if (col > r1->size) return 1;
 
-        c1 = detach_cell(r1, col);
-        cell_free(c1);
+        result = convert(text, len, (char*)out + i * size);
+        if (status) status[i] = (unsigned char)result;
     }
 
-    return 1;
+    return (int)n;
+}
+
+/**
+ *  \brief Convert a column into int32_t values, cells are decimal integers with optional sign and surrounding blanks.
+ *  \param[in] csv: csv handle
+ *  \param[in] col: column index, counting from 1
+ *  \param[out] out: values, the value of row `i + 1` goes to `out[i]`
+ *  \param[in] n: capacity of out
+ *  \param[out] status: @ref CSV_C_xxx of each cell, can be NULL
+ *  \return count of values written, the smaller of `n` and the number of rows
+ */
+int csv_column_to_int32(csv_t csv, unsigned int col, int32_t* out, unsigned int n, unsigned char* status)
+{
+    return column_convert(csv, col, out, sizeof(int32_t), n, status, convert_int32);
+}
+
+/**
+ *  \brief Convert a column into float values, cells are decimal numbers with surrounding blanks.
+ *  \param[in] csv: csv handle
+ *  \param[in] col: column index, counting from 1
+ *  \param[out] out: values, the value of row `i + 1` goes to `out[i]`
+ *  \param[in] n: capacity of out
+ *  \param[out] status: @ref CSV_C_xxx of each cell, can be NULL
+ *  \return count of values written, the smaller of `n` and the number of rows
+ */
+int csv_column_to_float(csv_t csv, unsigned int col, float* out, unsigned int n, unsigned char* status)
+{
+    return column_convert(csv, col, out, sizeof(float), n, status, convert_float);
+}
+
+/**
+ *  \brief Convert a column into double values, cells are decimal numbers with surrounding blanks.
+ *  \param[in] csv: csv handle
+ *  \param[in] col: column index, counting from 1
+ *  \param[out] out: values, the value of row `i + 1` goes to `out[i]`
+ *  \param[in] n: capacity of out
+ *  \param[out] status: @ref CSV_C_xxx of each cell, can be NULL
+ *  \return count of values written, the smaller of `n` and the number of rows
+ */
+int csv_column_to_double(csv_t csv, unsigned int col, double* out, unsigned int n, unsigned char* status)
+{
+    return column_convert(csv, col, out, sizeof(double), n, status, convert_double);
 }
 
 /**
@@ -2113,6 +3373,298 @@ static int strfind(const char *s, const char *d, int flag)
     return 0;  /* Substring not found */
 }
 
+#define INDEX_GRAMS                         (1u << 16) /* count of trigram buckets */
+
+/**
+ *  \brief Case folded FNV-1a hash of a text.
+ *
+ *  \param[in] s text
+ *  \return hash value
+ */
+static unsigned int index_hash(const char* s)
+{
+    unsigned int h = 2166136261u;
+
+    for (; *s; s++)
+    {
+        h ^= (unsigned char)tolower((unsigned char)*s);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+/**
+ *  \brief Case folded trigram bucket of three characters.
+ *
+ *  \param[in] s text, at least 3 characters
+ *  \return trigram bucket
+ */
+static unsigned int index_gram(const char* s)
+{
+    unsigned int g = ((unsigned int)tolower((unsigned char)s[0]) << 16) |
+                     ((unsigned int)tolower((unsigned char)s[1]) << 8) |
+                      (unsigned int)tolower((unsigned char)s[2]);
+
+    return (g * 2654435761u) >> 16;
+}
+
+/**
+ *  \brief Create a search index with the positions and hashes of the non-empty cells.
+ *
+ *  \param[in] csv csv handle
+ *  \return search index or NULL fail
+ */
+static INDEX* index_new(csv_t csv)
+{
+    INDEX* index;
+    const char* text;
+    unsigned int r, c, size, count = 0;
+
+    index = (INDEX*)calloc(1, sizeof(INDEX));
+    if (!index) return NULL;
+
+    size = csv_cell(csv);
+    index->cols = csv_col(csv);
+    index->rows = (unsigned int*)malloc((size + 1) * sizeof(unsigned int));
+    index->columns = (unsigned int*)malloc((size + 1) * sizeof(unsigned int));
+    index->hashes = (unsigned int*)malloc((size + 1) * sizeof(unsigned int));
+    index->hits = (unsigned int*)malloc((size + 1) * sizeof(unsigned int));
+    if (!index->rows || !index->columns || !index->hashes || !index->hits)
+    {
+        index_free(index);
+        return NULL;
+    }
+
+    for (r = 1; r <= csv->size; r++)
+    {
+        for (c = 1; (text = csv_get_text(csv, r, c)) != NULL; c++)
+        {
+            if (!text[0]) continue;
+
+            index->rows[count] = r;
+            index->columns[count] = c;
+            index->hashes[count] = index_hash(text);
+            count++;
+        }
+    }
+    index->cells = count;
+
+    return index;
+}
+
+/**
+ *  \brief Build the hash buckets for entire matches.
+ *
+ *  \param[in] index search index
+ *  \return 1 success or 0 fail
+ */
+static int index_build_hash(INDEX* index)
+{
+    unsigned int i, b;
+
+    index->mask = pow2gt(index->cells > 1 ? index->cells : 1) - 1;
+    index->buckets = (unsigned int*)malloc((index->mask + 1) * sizeof(unsigned int));
+    index->chain = (unsigned int*)malloc((index->cells + 1) * sizeof(unsigned int));
+    if (!index->buckets || !index->chain) return 0;
+
+    for (b = 0; b <= index->mask; b++) index->buckets[b] = index->cells;
+
+    /* Insert from back to front, so that each chain is in row order */
+    for (i = index->cells; i-- > 0; )
+    {
+        b = index->hashes[i] & index->mask;
+        index->chain[i] = index->buckets[b];
+        index->buckets[b] = i;
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief Build the trigram cell lists for substring matches.
+ *
+ *  \param[in] csv csv handle
+ *  \param[in] index search index
+ *  \return 1 success or 0 fail
+ */
+static int index_build_grams(csv_t csv, INDEX* index)
+{
+    unsigned int* last;
+    const char* text;
+    unsigned int i, g, pass, total;
+
+    index->grams = (unsigned int*)calloc(INDEX_GRAMS + 1, sizeof(unsigned int));
+    last = (unsigned int*)malloc(INDEX_GRAMS * sizeof(unsigned int));
+    if (!index->grams || !last)
+    {
+        free(last);
+        return 0;
+    }
+
+    /* Count cells of each bucket first, then fill, a cell is listed once per bucket */
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (g = 0; g < INDEX_GRAMS; g++) last[g] = index->cells;
+
+        for (i = 0; i < index->cells; i++)
+        {
+            text = csv_get_text(csv, index->rows[i], index->columns[i]);
+            for (; text[0] && text[1] && text[2]; text++)
+            {
+                g = index_gram(text);
+                if (last[g] == i) continue;
+                last[g] = i;
+
+                if (pass == 0) index->grams[g + 1]++;
+                else index->posts[index->grams[g]++] = i;
+            }
+        }
+
+        if (pass == 0)
+        {
+            /* Turn the counts into the start of each bucket */
+            for (g = 0; g < INDEX_GRAMS; g++) index->grams[g + 1] += index->grams[g];
+            total = index->grams[INDEX_GRAMS];
+
+            index->posts = (unsigned int*)malloc((total + 1) * sizeof(unsigned int));
+            if (!index->posts)
+            {
+                free(last);
+                return 0;
+            }
+        }
+    }
+
+    /* Filling has moved each start to the start of the next bucket, move them back */
+    for (g = INDEX_GRAMS; g > 0; g--) index->grams[g] = index->grams[g - 1];
+    index->grams[0] = 0;
+
+    free(last);
+
+    return 1;
+}
+
+/**
+ *  \brief Collect the candidate cells of a search through the index, building it when needed.
+ *         The candidates are a superset of the matches, each one is still checked with `strfind()`.
+ *
+ *  \param[in] csv csv handle
+ *  \param[in] text text to search
+ *  \param[in] flag matching options
+ *  \return search index holding the candidates, or NULL when the search should scan every cell
+ */
+static INDEX* index_search(csv_t csv, const char* text, int flag)
+{
+    INDEX* index = csv->index;
+    unsigned int *count, *list = NULL;
+    unsigned int i, g, n, best = 0, h, len;
+
+    len = strlen(text);
+
+    /* Short substrings match too many cells to gain from the index */
+    if (!(flag & CSV_F_FLAG_MatchEntire) && len < 3) return NULL;
+
+    if (!index)
+    {
+        index = index_new(csv);
+        if (!index) return NULL;
+        csv->index = index;
+    }
+
+    if (flag & CSV_F_FLAG_MatchEntire)
+    {
+        if (!index->buckets && !index_build_hash(index)) goto FAIL;
+
+        h = index_hash(text);
+        n = 0;
+        for (i = index->buckets[h & index->mask]; i < index->cells; i = index->chain[i])
+        {
+            if (index->hashes[i] == h) index->hits[n++] = i;
+        }
+        index->count = n;
+    }
+    else
+    {
+        if (!index->grams && !index_build_grams(csv, index)) goto FAIL;
+
+        /* Every match contains all trigrams of the text, the rarest one lists the fewest cells */
+        for (i = 0; i + 2 < len; i++)
+        {
+            g = index_gram(text + i);
+            n = index->grams[g + 1] - index->grams[g];
+            if (!list || n < best)
+            {
+                list = index->posts + index->grams[g];
+                best = n;
+            }
+        }
+        memcpy(index->hits, list, best * sizeof(unsigned int));
+        index->count = best;
+    }
+
+    /* The candidates are in row order, order them by column with a stable counting sort */
+    if ((flag & CSV_F_FLAG_MatchByCol) && index->count > 1)
+    {
+        count = (unsigned int*)calloc(index->cols + 2, sizeof(unsigned int));
+        list = (unsigned int*)malloc(index->count * sizeof(unsigned int));
+        if (!count || !list)
+        {
+            free(count);
+            free(list);
+            return NULL;
+        }
+
+        for (i = 0; i < index->count; i++) count[index->columns[index->hits[i]] + 1]++;
+        for (i = 1; i <= index->cols + 1; i++) count[i] += count[i - 1];
+        for (i = 0; i < index->count; i++) list[count[index->columns[index->hits[i]]]++] = index->hits[i];
+
+        memcpy(index->hits, list, index->count * sizeof(unsigned int));
+        free(count);
+        free(list);
+    }
+
+    /* Search from back to front */
+    if (flag & CSV_F_FLAG_MatchForward)
+    {
+        for (i = 0, n = index->count; i + 1 < n; i++, n--)
+        {
+            h = index->hits[i];
+            index->hits[i] = index->hits[n - 1];
+            index->hits[n - 1] = h;
+        }
+    }
+
+    return index;
+
+FAIL:
+    index_free(index);
+    csv->index = NULL;
+    return NULL;
+}
+
+/**
+ *  \brief Set whether `csv_find()` uses a search index, the index is built on the first search
+ *         and dropped by any edit, then built again on the next search.
+ *         Entire matches look up a hash of the cell texts, substring matches of 3 or more characters
+ *         look up the cells that contain the rarest trigram of the text.
+ *
+ *  \param[in] csv csv handle
+ *  \param[in] enable 1 use index or 0 scan every cell
+ */
+void csv_find_index(csv_t csv, int enable)
+{
+    if (!csv) return;
+
+    csv->indexing = enable ? 1 : 0;
+
+    if (!enable && csv->index)
+    {
+        index_free(csv->index);
+        csv->index = NULL;
+    }
+}
+
 /**
  *  \brief Find the first occurrence of a text within a CSV table.
  *
@@ -2131,6 +3683,8 @@ int csv_find(csv_t csv, const char* text, int flag, unsigned int* row, unsigned
     static unsigned int match_row = 0, match_col = 0, *x, *y;
     static unsigned int size_row = 0, size_col = 0, *size_x, *size_y;
     static int move_x, move_y;
+    static INDEX *index = NULL;
+    static unsigned int hit = 0;
     char *t;
 
     /* Check if the CSV data structure exists */
@@ -2178,6 +3732,37 @@ int csv_find(csv_t csv, const char* text, int flag, unsigned int* row, unsigned
             *x = 1;
             *y = 1;
         }
+
+        /* Collect the candidates through the search index */
+        index = csv->indexing ? index_search(csv, text, flag) : NULL;
+        hit = 0;
+    }
+
+    /* Check the candidates only, an edit drops the index and the scan below goes on from the last match */
+    if (index && index == csv->index)
+    {
+        while (hit < index->count)
+        {
+            match_row = index->rows[index->hits[hit]];
+            match_col = index->columns[index->hits[hit]];
+            hit++;
+
+            t = (char *)csv_get_text(csv, match_row, match_col);
+            if (t && strfind(t, cmp, flag))
+            {
+                *row = match_row;
+                *col = match_col;
+
+                *y += move_y;
+
+                return 1;  /* Text found */
+            }
+        }
+
+        /* Leave the scan at its end as well */
+        *x = (flag & CSV_F_FLAG_MatchForward) ? 0 : *size_x + 1;
+
+        return -1;  /* Found end */
     }
     
     for (; 1 <= *x && *x <= *size_x; *x += move_x)
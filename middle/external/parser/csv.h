@@ -19,6 +19,7 @@ extern "C"
 #endif
 
 #include <stdlib.h>
+#include <stdint.h>
 
 /* version infomation */
 
@@ -26,6 +27,16 @@ extern "C"
 #define CSV_V_MINOR                         0
 #define CSV_V_PATCH                         0
 
+/* configuration information */
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define CSV_USE_PTHREAD                     1   /**< 1 parse chunks on POSIX threads in `csv_loads_mt()`, 0 always parse sequentially */
+#else
+#define CSV_USE_PTHREAD                     0
+#endif
+#define CSV_THREAD_MAX                      64  /**< most threads used by `csv_loads_mt()` */
+#define CSV_CHUNK_MIN                       (64 * 1024) /**< least bytes of text given to each thread */
+
 /* csv type definition, hiding structural members, not for external use */
 
 typedef struct CSV* csv_t;
@@ -35,6 +46,79 @@ typedef struct CSV* csv_t;
 #define CSV_E_OK                            (0) /* no error */
 #define CSV_E_MEMORY                        (1) /* memory allocation failed */
 #define CSV_E_OPEN                          (2) /* fail to open file */
+#define CSV_E_OVERFLOW                      (3) /* row does not fit in the stream buffer or field array */
+#define CSV_E_READ                          (4) /* stream read callback failed */
+#define CSV_E_WRITE                         (5) /* stream write callback failed */
+
+/* allocator of the rows, cells and texts of a loaded csv, it must outlive the csv,
+ * the search index and the memory returned to the caller still come from the C library */
+
+typedef struct
+{
+    void* (*alloc)(void* user, unsigned int size);  /**< allocate a block, NULL fail */
+    void (*free)(void* user, void* block);          /**< release a block of `alloc` */
+    void* user;                                     /**< user data of the callbacks, such as an arena */
+} CSV_ALLOC;
+
+/* parse context, keeps the error information of one parsing call instead of the shared one */
+
+typedef struct
+{
+    const CSV_ALLOC* alloc;                 /**< input, allocator of the loaded csv, NULL the C library */
+    int type;                               /**< error type, @ref CSV_E_xxx */
+    int line;                               /**< error line */
+    int column;                             /**< error column */
+} CSV_CTX;
+
+/* cell status of column conversion */
+
+#define CSV_C_OK                            (0) /* converted */
+#define CSV_C_EMPTY                         (1) /* empty or missing cell, the value is 0 */
+#define CSV_C_INVALID                       (2) /* not a number, the value is 0 */
+#define CSV_C_RANGE                         (3) /* out of range of the type, integers saturate and floating values are infinity */
+
+/* stream callbacks */
+
+typedef int (*csv_read_t)(void* context, char* data, int size); /* return count of bytes read, 0 at the end, negative on error */
+typedef int (*csv_write_t)(void* context, const char* data, int len); /* return 0 to abort */
+
+/* field of a streamed row, the text lives in the reader buffer and is valid until the next row is read */
+
+typedef struct
+{
+    const char* text;                       /**< unescaped field text, terminated */
+    unsigned int length;                    /**< length of field text */
+} CSV_FIELD;
+
+/* streaming reader, reads one row at a time through a fixed buffer, members are not for external use */
+
+typedef struct
+{
+    char* buffer;                           /**< sliding buffer, must hold the longest row */
+    unsigned int size;                      /**< size of buffer */
+    unsigned int begin;                     /**< start of the data that has not been consumed */
+    unsigned int end;                       /**< end of the data in buffer */
+    CSV_FIELD* fields;                      /**< fields of current row */
+    unsigned int capacity;                  /**< capacity of fields */
+    csv_read_t read;                        /**< read callback */
+    void* context;                          /**< context of read callback */
+    unsigned int line;                      /**< line of the next row, or of the failing row after an error */
+    int eof;                                /**< read callback reached the end */
+    int error;                              /**< error type, @ref CSV_E_xxx */
+} CSV_READER;
+
+/* buffered streaming writer, members are not for external use */
+
+typedef struct
+{
+    char* buffer;                           /**< output buffer */
+    unsigned int size;                      /**< size of buffer */
+    unsigned int end;                       /**< end of the data in buffer */
+    unsigned int count;                     /**< count of fields written in current row */
+    csv_write_t write;                      /**< write callback */
+    void* context;                          /**< context of write callback */
+    int error;                              /**< error type, @ref CSV_E_xxx */
+} CSV_WRITER;
 
 /* find flag */
 
@@ -46,8 +130,31 @@ typedef struct CSV* csv_t;
 /* load csv */
 
 csv_t csv_loads(const char* text);
+csv_t csv_loads_ex(const char* text, CSV_CTX* ctx);
 csv_t csv_file_load(const char* filename);
 
+/* load csv on several threads, the text is split at line breaks outside quotation marks,
+ * `threads` not greater than 0 uses the count of online processors */
+
+csv_t csv_loads_mt(const char* text, int threads, CSV_CTX* ctx);
+csv_t csv_file_load_mt(const char* filename, int threads);
+
+/* stream csv row by row with constant memory */
+
+void csv_reader_init(CSV_READER* reader, char* buffer, unsigned int size, CSV_FIELD* fields, unsigned int capacity, csv_read_t read, void* context);
+int csv_read_row(CSV_READER* reader);
+
+void csv_writer_init(CSV_WRITER* writer, char* buffer, unsigned int size, csv_write_t write, void* context);
+int csv_write_field(CSV_WRITER* writer, const char* text, int len);
+int csv_write_eol(CSV_WRITER* writer);
+int csv_write_row(CSV_WRITER* writer, const char** texts, unsigned int count);
+int csv_writer_flush(CSV_WRITER* writer);
+
+/* stream callbacks over `FILE*`, the context is the file */
+
+int csv_fread(void* context, char* data, int size);
+int csv_fwrite(void* context, const char* data, int len);
+
 /* when loading fails, use this method to locate the error */
 
 int csv_error_info(int* line, int* column);
@@ -68,6 +175,12 @@ csv_t csv_duplicate(csv_t csv);
 int csv_to_array(csv_t csv, unsigned int o_row, unsigned int o_col, void *array, unsigned int row_size, unsigned int col_size);
 void csv_minify(csv_t csv);
 
+/* convert a column from row 1 down into numbers, `status` receives @ref CSV_C_xxx of each cell and can be NULL */
+
+int csv_column_to_int32(csv_t csv, unsigned int col, int32_t* out, unsigned int n, unsigned char* status);
+int csv_column_to_float(csv_t csv, unsigned int col, float* out, unsigned int n, unsigned char* status);
+int csv_column_to_double(csv_t csv, unsigned int col, double* out, unsigned int n, unsigned char* status);
+
 /* get the number of CSV rows, columns, cells */
 
 unsigned int csv_row(csv_t csv);
@@ -101,6 +214,7 @@ int csv_cut_cell_to(csv_t csv, unsigned int s_row, unsigned int s_col, unsigned
 /* Find operation */
 
 int csv_find(csv_t csv, const char* text, int flag, unsigned int* row, unsigned int* col);
+void csv_find_index(csv_t csv, int enable);
 
 /* Universal traversal method. */
 #define csv_for_each(csv, row, col, text)                           \
@@ -11,9 +11,12 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "ini.h"
+#include "fmap.h"
+#include "fsave.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 /* dump buffer define */
 typedef struct
@@ -23,41 +26,65 @@ typedef struct
     unsigned int end;           /**< end of buffer used */
 } BUFFER;
 
-/* iterator define */
+/* name index define, open addressing over insertion positions */
 typedef struct
 {
-    void *p;                    /**< iteration pointer */
-    unsigned int i;             /**< iteration index */
-} ITERATOR;
+    int* slots;                 /**< position + 1 of the entry in each slot, 0 is empty */
+    unsigned int mask;          /**< slot count - 1 */
+} INDEX;
 
 /* key-value define */
-typedef struct PAIR
+typedef struct
 {
-    struct PAIR *next;          /**< next pair */
     char* key;                  /**< key */
     char* value;                /**< value */
+    int raw;                    /**< length of the value text not yet cooked in situ, -1 the value is terminated */
+    unsigned int hash;          /**< case folded hash of key */
+    int offset;                 /**< offset of the value in the file */
+    int span;                   /**< length of the value in the file, a new value up to this length is patched in place */
+    int dirty;                  /**< value changed since load or save */
 } PAIR;
 
 /* section define */
-typedef struct SECTION
+typedef struct
 {
-    struct SECTION *next;       /**< next section */
     char* name;                 /**< section name */
-    PAIR* pairs;                /**< pairs base */
-    ITERATOR iterator;          /**< pair iterator */
+    unsigned int hash;          /**< hash of section name */
+    PAIR** pairs;               /**< pairs in insertion order */
     int count;                  /**< pair count */
+    int capacity;               /**< capacity of pairs */
+    INDEX index;                /**< key index */
 } SECTION;
 
+/* node of the in situ pool, each line of text holds at most one */
+typedef union
+{
+    SECTION section;            /**< section node */
+    PAIR pair;                  /**< pair node */
+} NODE;
+
 /* ini structure define */
 typedef struct INI 
 {
-    SECTION* sections;          /**< sections base */
-    ITERATOR iterator;          /**< section iterator */
+    SECTION** sections;         /**< sections in insertion order */
     int count;                  /**< section count */
+    int capacity;               /**< capacity of sections */
+    INDEX index;                /**< section index */
+    NODE* pool;                 /**< nodes of an in situ ini, NULL the ini owns its strings and can be modified */
+    int used;                   /**< used nodes of pool */
+    long size;                  /**< size of the file the value offsets refer to, 0 unknown */
+    unsigned long check;        /**< check value of the file the value offsets refer to, @ref fsave_check */
+    int dirty;                  /**< changes since load or save, @ref DIRTY_xxx */
+    const INI_ALLOC* alloc;     /**< allocator of the sections, pairs and strings, NULL the C library */
 } INI;
 
-static int etype = 0;           /**< error type */
-static int eline = 0;           /**< error line */
+/* changes of ini since load or save */
+#define DIRTY_VALUE             (0x01)  /* values of existing pairs changed */
+#define DIRTY_LAYOUT            (0x02)  /* sections or pairs added or removed */
+
+static INI_CTX ectx;            /**< error information of the calls without context */
+
+static const char* pair_value(PAIR* pair);
 
 #define E(type)                 etype=(type)
 #define iscomment(c)            ((c) == '#' || (c) == ';')      /* ini supports `#` and `;` style annotations */
@@ -83,19 +110,71 @@ static unsigned int pow2gt(unsigned int x)
     return x + 1;
 }
 
+/**
+ *  \brief Allocate memory of an ini with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] size Size of memory.
+ *  \return Address of memory or NULL fail.
+ */
+static void* ini_malloc(const INI_ALLOC* alloc, unsigned int size)
+{
+    return alloc ? alloc->alloc(alloc->user, size) : malloc(size);
+}
+
+/**
+ *  \brief Release memory of an ini with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] block Address of memory.
+ */
+static void ini_free(const INI_ALLOC* alloc, void* block)
+{
+    if (alloc) alloc->free(alloc->user, block);
+    else free(block);
+}
+
+/**
+ *  \brief Resize memory of an ini with its allocator, an allocator that cannot resize gets a new block and a copy.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] block Address of memory, NULL to allocate.
+ *  \param[in] used Size of the memory in use, copied to the new block.
+ *  \param[in] size New size of memory.
+ *  \return Address of memory or NULL fail, the old memory is kept on failure.
+ */
+static void* ini_realloc(const INI_ALLOC* alloc, void* block, unsigned int used, unsigned int size)
+{
+    void* address;
+
+    if (!alloc) return realloc(block, size);
+
+    address = alloc->alloc(alloc->user, size);
+    if (!address) return NULL;
+
+    if (block)
+    {
+        memcpy(address, block, used < size ? used : size);
+        alloc->free(alloc->user, block);
+    }
+
+    return address;
+}
+
 /**
  *  \brief Duplicate a given string.
  * 
+ *  \param[in] alloc Allocator of the copy, NULL the C library.
  *  \param[in] str String to be duplicated.
  *  \param[in] len Length of the string.
  *  \return Pointer to the duplicated string if successful, NULL otherwise.
  */
-static char* ini_strdup(const char* str, int len)
+static char* ini_strdup(const INI_ALLOC* alloc, const char* str, int len)
 {
     char* s;
 
     /* Allocate memory for the new string */
-    s = (char*)malloc(len + 1);
+    s = (char*)ini_malloc(alloc, len + 1);
     if (!s) return NULL;
 
     /* Copy the given string into the allocated memory */
@@ -105,33 +184,6 @@ static char* ini_strdup(const char* str, int len)
     return s;
 }
 
-/**
- *  \brief Compare the first n1 characters of two strings.
- *
- *  \param[in] s1 The first string to compare
- *  \param[in] n1 The number of characters to compare in s1
- *  \param[in] s2 The second string to compare
- *  \param[in] n2 The number of characters to compare in s2
- *
- *  \return Returns an integer less than, equal to, or greater than zero if the first n1 characters of s1 is found,
- *          respectively, to be less than, to match, or be greater than the first n2 characters of s2.
- */
-static int ini_strnncmp(const char* s1, int n1, const char* s2, int n2)
-{
-    int i = 0;
-    if (s1 == s2) return 0;
-    if (!s1) return -1;
-    if (!s2) return 1;
-    if (n1 != n2) return n1 - n2;
-    
-    for (i = 0; i < n1; i++)
-    {
-        if (s1[i] != s2[i]) return (s1[i] - s2[i]);
-    }
-
-    return 0;
-}
-
 /**
  *  \brief Compare the first n1 characters of two strings case-insensitively.
  *
@@ -183,6 +235,97 @@ static int expansion(BUFFER* buf, unsigned int needed)
 #define buf_putc(c)         (buf->address[buf->end++]=(c))      /* put a non zero character into buf */
 #define buf_end()           (buf->address[buf->end])            /* obtain the tail of buf */
 
+/**
+ *  \brief Hash a name, keys are case folded since they match case-insensitively.
+ *
+ *  \param[in] text The name
+ *  \param[in] len The length of the name
+ *  \param[in] fold 1 fold the case, 0 keep the case
+ *
+ *  \return Returns the FNV-1a hash of the name
+ */
+static unsigned int name_hash(const char* text, int len, int fold)
+{
+    unsigned int hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)(fold ? tolower((unsigned char)text[i]) : text[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ *  \brief Allocate slots for an index that holds the given number of entries.
+ *         The old slots are kept when the allocation fails.
+ *
+ *  \param[in] alloc Allocator of the slots
+ *  \param[in] index The index
+ *  \param[in] count Number of entries to hold
+ *
+ *  \return Returns 1 if successful, 0 otherwise
+ */
+static int index_reset(const INI_ALLOC* alloc, INDEX* index, int count)
+{
+    unsigned int size;
+    int* slots;
+
+    /* Keep at most half of the slots used */
+    size = pow2gt(count * 2 + 2);
+    slots = (int*)ini_malloc(alloc, size * sizeof(int));
+    if (!slots) return 0;
+
+    if (index->slots) ini_free(alloc, index->slots);
+    index->slots = slots;
+    index->mask = size - 1;
+
+    return 1;
+}
+
+/**
+ *  \brief Insert a position into the index.
+ *
+ *  \param[in] index The index, with a free slot
+ *  \param[in] hash Hash of the name at the position
+ *  \param[in] pos Position of the entry
+ */
+static void index_insert(INDEX* index, unsigned int hash, int pos)
+{
+    unsigned int i = hash & index->mask;
+
+    while (index->slots[i]) i = (i + 1) & index->mask;
+    index->slots[i] = pos + 1;
+}
+
+/**
+ *  \brief Rebuild the section index in its slots after the positions are changed.
+ *
+ *  \param[in] ini The INI file object
+ */
+static void ini_reindex(ini_t ini)
+{
+    int i;
+
+    memset(ini->index.slots, 0, (ini->index.mask + 1) * sizeof(int));
+    for (i = 0; i < ini->count; i++) index_insert(&ini->index, ini->sections[i]->hash, i);
+}
+
+/**
+ *  \brief Rebuild the key index of a section in its slots after the positions are changed.
+ *
+ *  \param[in] sect The section object
+ */
+static void section_reindex(SECTION* sect)
+{
+    int i;
+
+    memset(sect->index.slots, 0, (sect->index.mask + 1) * sizeof(int));
+    for (i = 0; i < sect->count; i++) index_insert(&sect->index, sect->pairs[i]->hash, i);
+}
+
 /**
  *  \brief Get the section at the specified index in an INI file.
  *
@@ -193,18 +336,8 @@ static int expansion(BUFFER* buf, unsigned int needed)
  */
 static SECTION* ini_section(ini_t ini, int index)
 {
-    if (index >= ini->count) return NULL;
-    if (index < ini->iterator.i || !ini->iterator.p || index == 0)
-    {
-        ini->iterator.i = 0;
-        ini->iterator.p = ini->sections;
-    }
-    while (ini->iterator.p && ini->iterator.i < index)
-    {
-        ini->iterator.p = ((SECTION *)(ini->iterator.p))->next;
-        ini->iterator.i++;
-    }
-    return ini->iterator.p;
+    if (index < 0 || index >= ini->count) return NULL;
+    return ini->sections[index];
 }
 
 /**
@@ -217,65 +350,87 @@ static SECTION* ini_section(ini_t ini, int index)
  */
 static PAIR* section_pair(SECTION *sect, int index)
 {
-    if (index >= sect->count) return NULL;
-    if (index < sect->iterator.i || !sect->iterator.p || index == 0)
-    {
-        sect->iterator.i = 0;
-        sect->iterator.p = sect->pairs;
-    }
-    while (sect->iterator.p && sect->iterator.i < index)
-    {
-        sect->iterator.p = ((SECTION *)(sect->iterator.p))->next;
-        sect->iterator.i++;
-    }
-    return sect->iterator.p;
+    if (index < 0 || index >= sect->count) return NULL;
+    return sect->pairs[index];
 }
 
 /**
- *  \brief create an ini object.
- *  \param[in] none
- *  \return ini object
+ *  \brief Create an ini object whose sections, pairs and strings come from an allocator.
+ *
+ *  \param[in] alloc Allocator, NULL the C library
+ *
+ *  \return Returns the ini object, or NULL if it cannot be allocated
  */
-ini_t ini_create(void)
+static ini_t ini_new(const INI_ALLOC* alloc)
 {
     ini_t ini = NULL;
 
     /* Allocate ini structure space */
-    ini = (ini_t)malloc(sizeof(INI));
+    ini = (ini_t)ini_malloc(alloc, sizeof(INI));
     if (!ini) return NULL;
 
     /* Initialize ini structure member variables */
     ini->sections = NULL;
     ini->count = 0;
-    ini->iterator.p = NULL;
-    ini->iterator.i = 0;
+    ini->capacity = 0;
+    ini->index.slots = NULL;
+    ini->index.mask = 0;
+    ini->pool = NULL;
+    ini->used = 0;
+    ini->size = 0;
+    ini->check = 0;
+    ini->dirty = 0;
+    ini->alloc = alloc;
 
     return ini;
 }
 
+/**
+ *  \brief create an ini object.
+ *  \param[in] none
+ *  \return ini object
+ */
+ini_t ini_create(void)
+{
+    return ini_new(NULL);
+}
+
+/**
+ *  \brief Free a pair.
+ *
+ *  \param[in] alloc Allocator of the pair
+ *  \param[in] pair The pair to be freed
+ */
+static void pair_free(const INI_ALLOC* alloc, PAIR *pair)
+{
+    if (pair->key) ini_free(alloc, pair->key);
+    if (pair->value) ini_free(alloc, pair->value);
+    ini_free(alloc, pair);
+}
+
 /**
  *  \brief Free the memory allocated for a section in an INI file.
  *
+ *  \param[in] alloc Allocator of the section
  *  \param[in] sect The section object to be freed
+ *  \param[in] insitu 1 the section is a pool node pointing into the text, only its arrays are freed
  */
-static void section_free(SECTION *sect)
+static void section_free(const INI_ALLOC* alloc, SECTION *sect, int insitu)
 {
-    PAIR *pair = NULL, *next = NULL;
+    int i;
 
     if (!sect) return;
 
-    /* Traverse and free each pair */
-    pair = sect->pairs;
-    while (pair)
+    if (sect->pairs) 
     {
-        next = pair->next;
-        if (pair->key) free(pair->key);
-        if (pair->value) free(pair->value);
-        free(pair);
-        pair = next;
+        /* Traverse and free each pair */
+        if (!insitu) for (i = 0; i < sect->count; i++) pair_free(alloc, sect->pairs[i]);
+        ini_free(alloc, sect->pairs);
     }
-    if (sect->name) free(sect->name);
-    free(sect);
+    if (sect->index.slots) ini_free(alloc, sect->index.slots);
+    if (insitu) return;
+    if (sect->name) ini_free(alloc, sect->name);
+    ini_free(alloc, sect);
 }
 
 /**
@@ -285,22 +440,17 @@ static void section_free(SECTION *sect)
  */
 void ini_delete(ini_t ini)
 {
-    SECTION *sect = NULL, *next = NULL;
+    int i;
 
     if (!ini) return;
 
     /* Traverse and free each section */
-    sect = ini->sections;
-    while (sect)
-    {
-        next = sect->next;
-
-        section_free(sect);
+    for (i = 0; i < ini->count; i++) section_free(ini->alloc, ini->sections[i], ini->pool ? 1 : 0);
+    if (ini->sections) ini_free(ini->alloc, ini->sections);
+    if (ini->index.slots) ini_free(ini->alloc, ini->index.slots);
+    if (ini->pool) ini_free(ini->alloc, ini->pool);
 
-        sect = next;
-    }
-
-    free(ini);
+    ini_free(ini->alloc, ini);
 }
 
 /**
@@ -314,18 +464,20 @@ void ini_delete(ini_t ini)
  */
 static int find_section(ini_t ini, const char* section, int len)
 {
-    int i;
+    unsigned int hash, i;
     SECTION* sect = NULL;
 
     if (!ini) return -1;
+    if (!ini->index.slots) return -1;
 
-    /* Find if a section with the same name already exists */
-    for (i = 0; i < ini->count; i++)
+    /* Probe the slots from the hash until an empty one */
+    hash = name_hash(section, len, 0);
+    for (i = hash & ini->index.mask; ini->index.slots[i]; i = (i + 1) & ini->index.mask)
     {
-        sect = ini_section(ini, i);
-        if (ini_strnncmp(sect->name, strlen(sect->name), section, len) == 0)
+        sect = ini->sections[ini->index.slots[i] - 1];
+        if (sect->hash == hash && strncmp(sect->name, section, len) == 0 && sect->name[len] == '\0')
         {
-            return i;
+            return ini->index.slots[i] - 1;
         }
     }
 
@@ -340,32 +492,10 @@ static int find_section(ini_t ini, const char* section, int len)
  */
 int ini_section_index(ini_t ini, const char* section)
 {
-    int i;
-    SECTION* sect = NULL;
-
     if (!ini) return -1;
     if (!section) return -1;
 
-    if (ini->iterator.p)
-    {
-        /* at the current iteration position */
-        if (strcmp(((SECTION*)(ini->iterator.p))->name, section) == 0)
-        {
-            return ini->iterator.i;
-        }
-    }
-
-    /* Find if a section with the same name already exists */
-    for (i = 0; i < ini->count; i++)
-    {
-        sect = ini_section(ini, i);
-        if (strcmp(sect->name, section) == 0)
-        {
-            return i;
-        }
-    }
-
-    return -1;
+    return find_section(ini, section, strlen(section));
 }
 
 /**
@@ -399,31 +529,56 @@ const char* ini_section_name(ini_t ini, int index)
 static SECTION* add_section(ini_t ini, const char* section, int len)
 {
     SECTION* sect = NULL;
+    SECTION** sections = NULL;
+    int capacity;
 
-    /* Create a new section and add it to the INI file structure */
-    sect = (SECTION*)malloc(sizeof(SECTION));
-    if (!sect) return NULL;
+    /* Make room at the end of the sections and in the index */
+    if (ini->count == ini->capacity)
+    {
+        capacity = ini->capacity ? ini->capacity * 2 : 4;
+        sections = (SECTION**)ini_realloc(ini->alloc, ini->sections, ini->capacity * sizeof(SECTION*), capacity * sizeof(SECTION*));
+        if (!sections) return NULL;
+        ini->sections = sections;
+        ini->capacity = capacity;
+    }
+    if ((unsigned int)(ini->count + 1) * 2 > ini->index.mask)
+    {
+        if (!index_reset(ini->alloc, &ini->index, ini->count + 1)) return NULL;
+        ini_reindex(ini);
+    }
 
-    /* Allocate space for section name */
-    sect->name = ini_strdup(section, len);
-    if (!sect->name) 
+    /* An in situ section takes a pool node and refers to the name in the text */
+    if (ini->pool)
     {
-        free(sect);
-        return NULL;
+        sect = &ini->pool[ini->used++].section;
+        sect->name = (char*)section;
+    }
+    else
+    {
+        /* Create a new section and add it to the INI file structure */
+        sect = (SECTION*)ini_malloc(ini->alloc, sizeof(SECTION));
+        if (!sect) return NULL;
+
+        /* Allocate space for section name */
+        sect->name = ini_strdup(ini->alloc, section, len);
+        if (!sect->name) 
+        {
+            ini_free(ini->alloc, sect);
+            return NULL;
+        }
     }
 
     /* Initialize section structure variables */
+    sect->hash = name_hash(section, len, 0);
     sect->pairs = NULL;
     sect->count = 0;
-    sect->iterator.p = NULL;
-    sect->iterator.i = 0;
-    sect->next = NULL;
-
-    /* Link the new section to ini */
-    if (ini->count == 0) ini->sections = sect;
-    else ini_section(ini, ini->count - 1)->next = sect;
+    sect->capacity = 0;
+    sect->index.slots = NULL;
+    sect->index.mask = 0;
 
-    ini->count++;
+    /* Append the new section to ini */
+    index_insert(&ini->index, sect->hash, ini->count);
+    ini->sections[ini->count++] = sect;
 
     return sect;
 }
@@ -439,25 +594,19 @@ static SECTION* add_section(ini_t ini, const char* section, int len)
  */
 static int find_pair(SECTION *sect, const char *key, int len)
 {
-    int i = 0;
+    unsigned int hash, i;
     PAIR *pair = NULL;
 
-    if (sect->iterator.p)
-    {
-        /* at the current iteration position */
-        if (ini_strcsnncmp(((PAIR*)(sect->iterator.p))->key, strlen(((PAIR*)(sect->iterator.p))->key), key, len) == 0)
-        {
-            return sect->iterator.i;
-        }
-    }
+    if (!sect->index.slots) return -1;
 
-    /* Traverse the pairs in the section and match the same key */
-    for (i = 0; i < sect->count; i++)
+    /* Probe the slots from the hash until an empty one, keys match case-insensitively */
+    hash = name_hash(key, len, 1);
+    for (i = hash & sect->index.mask; sect->index.slots[i]; i = (i + 1) & sect->index.mask)
     {
-        pair = section_pair(sect, i);
-        if (ini_strcsnncmp(pair->key, strlen(pair->key), key, len) == 0)
+        pair = sect->pairs[sect->index.slots[i] - 1];
+        if (pair->hash == hash && ini_strcsnncmp(pair->key, strlen(pair->key), key, len) == 0)
         {
-            return i;
+            return sect->index.slots[i] - 1;
         }
     }
 
@@ -466,7 +615,9 @@ static int find_pair(SECTION *sect, const char *key, int len)
 
 /**
  * \brief Add a new key-value pair to a section in an INI file.
+ *        A pair of an in situ ini refers to the key and the raw value text instead of copying them.
  *
+ * \param[in] ini The INI file object
  * \param[in] sect The section object
  * \param[in] key The key to add
  * \param[in] key_len The length of the key
@@ -475,49 +626,78 @@ static int find_pair(SECTION *sect, const char *key, int len)
  *
  * \return Returns a pointer to the newly added pair, or NULL if the pair cannot be added
  */
-static PAIR* add_pair(SECTION* sect, const char* key, int key_len, const char* value, int value_len)
+static PAIR* add_pair(ini_t ini, SECTION* sect, const char* key, int key_len, const char* value, int value_len)
 {
     PAIR* pair;
+    PAIR** pairs;
+    int capacity;
 
     if (!sect) return NULL;
 
-    /* Allocate pair space and initialize */
-    pair = (PAIR *)malloc(sizeof(PAIR));
-    if (!pair) return NULL;
-    pair->next = NULL;
-    pair->key = NULL;
-    pair->value = NULL;
-
-    /* duplicate the key */
-    if (key)
+    /* Make room at the end of the pairs and in the index */
+    if (sect->count == sect->capacity)
     {
-        pair->key = ini_strdup(key, key_len);
-        if (!pair->key) goto FAIL;
+        capacity = sect->capacity ? sect->capacity * 2 : 4;
+        pairs = (PAIR**)ini_realloc(ini->alloc, sect->pairs, sect->capacity * sizeof(PAIR*), capacity * sizeof(PAIR*));
+        if (!pairs) return NULL;
+        sect->pairs = pairs;
+        sect->capacity = capacity;
+    }
+    if ((unsigned int)(sect->count + 1) * 2 > sect->index.mask)
+    {
+        if (!index_reset(ini->alloc, &sect->index, sect->count + 1)) return NULL;
+        section_reindex(sect);
     }
 
-    /* Duplicate the value */
-    if (value)
+    if (ini->pool)
     {
-        pair->value = ini_strdup(value, value_len);
-        if (!pair->value) goto FAIL;
+        /* An in situ pair takes a pool node, the value is cooked when accessed */
+        pair = &ini->pool[ini->used++].pair;
+        pair->key = (char*)key;
+        pair->value = (char*)value;
+        pair->raw = value_len;
+        pair->hash = name_hash(key, key_len, 1);
+        pair->offset = 0;
+        pair->span = 0;
+        pair->dirty = 0;
     }
+    else
+    {
+        /* Allocate pair space and initialize */
+        pair = (PAIR *)ini_malloc(ini->alloc, sizeof(PAIR));
+        if (!pair) return NULL;
+        pair->key = NULL;
+        pair->value = NULL;
+        pair->raw = -1;
+        pair->hash = name_hash(key, key ? key_len : 0, 1);
+        pair->offset = 0;
+        pair->span = 0;
+        pair->dirty = 0;
+
+        /* duplicate the key */
+        if (key)
+        {
+            pair->key = ini_strdup(ini->alloc, key, key_len);
+            if (!pair->key) goto FAIL;
+        }
 
-    /* Link the new pair to section */
-    if (sect->count > 0) section_pair(sect, sect->count - 1)->next = pair;
-    else sect->pairs = pair;
+        /* Duplicate the value */
+        if (value)
+        {
+            pair->value = ini_strdup(ini->alloc, value, value_len);
+            if (!pair->value) goto FAIL;
+        }
+    }
 
-    sect->count++;
+    /* Append the new pair to section */
+    index_insert(&sect->index, pair->hash, sect->count);
+    sect->pairs[sect->count++] = pair;
 
     return pair;
 
 FAIL:
     /* Free the allocated space before exiting the function */
-    if (pair)
-    {
-        if (pair->key) free(pair->key);
-        if (pair->value) free(pair->value);
-        free(pair);
-    }
+    pair_free(ini->alloc, pair);
     return NULL;
 }
 
@@ -532,6 +712,7 @@ int ini_add_section(ini_t ini, const char* section)
     int i;
 
     if (!ini) return 0;
+    if (ini->pool) return 0; /* in situ ini is read-only */
     if (!section) return 0;
 
     /* Find if a section with the same name already exists */
@@ -544,7 +725,11 @@ int ini_add_section(ini_t ini, const char* section)
         // if (!(section[i] >= ' ' && section[i] <= '~')) return 0; /* Not a printable character */
     }
 
-    return add_section(ini, section, i) == NULL ? 0 : 1;
+    if (add_section(ini, section, i) == NULL) return 0;
+
+    ini->dirty |= DIRTY_LAYOUT;
+
+    return 1;
 }
 
 /**
@@ -556,31 +741,25 @@ int ini_add_section(ini_t ini, const char* section)
 int ini_remove_section(ini_t ini, const char* section)
 {
     int i;
-    SECTION* sect = NULL;
-    SECTION* prev = NULL;
 
     if (!ini) return 0;
+    if (ini->pool) return 0; /* in situ ini is read-only */
     if (!section) return 0;
 
     /* Find if a section with the same name already exists */
-    for (i = 0; i < ini->count; i++)
-    {
-        sect = ini_section(ini, i);
-        if (strcmp(sect->name, section) == 0) break;
-        prev = sect;
-    }
-    if (i == ini->count || sect == NULL) return 0;
-
-    /* Adjusting linked list */
-    if (prev) prev->next = sect->next;
-    else ini->sections = sect->next;
+    i = ini_section_index(ini, section);
+    if (i < 0) return 0;
 
-    section_free(sect);
+    section_free(ini->alloc, ini->sections[i], 0);
 
+    /* Close the gap to keep the insertion order */
+    memmove(&ini->sections[i], &ini->sections[i + 1], (ini->count - i - 1) * sizeof(SECTION*));
     ini->count--;
 
-    /* reset iterator */
-    ini->iterator.p = NULL;
+    /* The positions behind have moved */
+    ini_reindex(ini);
+
+    ini->dirty |= DIRTY_LAYOUT;
 
     return 1;
 }
@@ -601,6 +780,7 @@ int ini_set_value(ini_t ini, const char* section, const char* key, const char* v
     PAIR *pair = NULL;
 
     if (!ini) return 0;
+    if (ini->pool) return 0; /* in situ ini is read-only */
     if (!section) return 0;
     if (!key) return 0;
     if (!value) return 0;
@@ -616,6 +796,7 @@ int ini_set_value(ini_t ini, const char* section, const char* key, const char* v
         }
         if (add_section(ini, section, i) == NULL) return 0;
         sect = ini_section(ini, ini->count - 1);
+        ini->dirty |= DIRTY_LAYOUT;
     }
     else  
     {
@@ -631,21 +812,24 @@ int ini_set_value(ini_t ini, const char* section, const char* key, const char* v
             if (key[i] == '\0') break;
             // if (!(key[i] >= ' ' && key[i] <= '~')) return 0; /* Not a printable character */
         }
-        if (add_pair(sect, key, i, value, strlen(value)) == NULL) return 0;
+        if (add_pair(ini, sect, key, i, value, strlen(value)) == NULL) return 0;
+        ini->dirty |= DIRTY_LAYOUT;
     }
     else
     {
         pair = section_pair(sect, i);
 
         /* Duplicate the value to be set first */
-        tvalue = ini_strdup(value, strlen(value));
+        tvalue = ini_strdup(ini->alloc, value, strlen(value));
         if (!tvalue) return 0;
 
         /* The original value needs to be free */
-        if (pair->value) free(pair->value);
+        if (pair->value) ini_free(ini->alloc, pair->value);
 
         /* Update value */
         pair->value = tvalue;
+        pair->dirty = 1;
+        ini->dirty |= DIRTY_VALUE;
     }
 
     return 1;
@@ -684,7 +868,7 @@ const char* ini_get_value(ini_t ini, const char* section, const char* key)
     pair = section_pair(sect, i);
     if (!pair) return NULL;
 
-    return pair->value;
+    return pair_value(pair);
 }
 
 /**
@@ -797,9 +981,9 @@ int ini_remove_key(ini_t ini, const char* section, const char* key)
 {
     int i = 0;
     SECTION *sect = NULL;
-    PAIR *pair = NULL, *prev = NULL;
 
     if (!ini) return 0;
+    if (ini->pool) return 0; /* in situ ini is read-only */
     if (!section) return 0;
     if (!key) return 0;
 
@@ -811,29 +995,22 @@ int ini_remove_key(ini_t ini, const char* section, const char* key)
     sect = ini_section(ini, i);
     if (!sect) return 0;
 
-    /* Traverse section matching key */
-    for (i = 0; i < sect->count; i++)
-    {
-        pair = section_pair(sect, i);
-        if (ini_strcsnncmp(pair->key, strlen(pair->key), key, strlen(key)) == 0) break;
-        prev = pair;
-    }
-    if (i == sect->count) return 0; /* Not matched */
-
-    /* Adjusting linked list */
-    if (prev) prev->next = pair->next;
-    else sect->pairs = pair->next;
+    /* Matching key */
+    i = find_pair(sect, key, strlen(key));
+    if (i < 0) return 0;
 
     /* Free pair space */
-    if (pair->key) free(pair->key);
-    if (pair->value) free(pair->value);
-    free(pair);
+    pair_free(ini->alloc, sect->pairs[i]);
 
+    /* Close the gap to keep the insertion order */
+    memmove(&sect->pairs[i], &sect->pairs[i + 1], (sect->count - i - 1) * sizeof(PAIR*));
     sect->count--;
 
-    /* Reset iterator */
-    sect->iterator.p = NULL;
-    
+    /* The positions behind have moved */
+    section_reindex(sect);
+
+    ini->dirty |= DIRTY_LAYOUT;
+
     return 1;
 }
 
@@ -842,15 +1019,17 @@ int ini_remove_key(ini_t ini, const char* section, const char* key)
  *
  * \param[in] ini The INI file object
  * \param[in] buf The buffer to print the INI contents to
+ * \param[in] track 1 record where the values are printed and clear their changes, for the printing saved to file
  *
  * \return Returns 1 if the printing is successful, 0 otherwise
  */
-static int print_ini(ini_t ini, BUFFER* buf)
+static int print_ini(ini_t ini, BUFFER* buf, int track)
 {
     int i, j, k;
     int olen = 0;
     SECTION* sect = NULL;
     PAIR* pair = NULL;
+    const char* value = NULL;
 
     /* Traverse each section */
     for (i = 0; i < ini->count; i++) 
@@ -888,21 +1067,28 @@ static int print_ini(ini_t ini, BUFFER* buf)
             buf_putc(' ');
 
             /* Get length of value */
+            value = pair_value(pair);
             olen = 0;
             k = 0;
             while (1)
             {
-                if (!pair->value[olen]) break;
-                if (pair->value[olen] == '\n') k++; /* Print `\t` before line breaks */
+                if (!value[olen]) break;
+                if (value[olen] == '\n') k++; /* Print `\t` before line breaks */
                 olen++;
             }
             if (!buf_append(olen + k + 1)) return 0;
 
             /* Print value */
+            if (track) pair->offset = buf->end;
             for (k = 0; k < olen; k++)
             {
-                buf_putc(pair->value[k]);
-                if (pair->value[k] == '\n') buf_putc('\t');
+                buf_putc(value[k]);
+                if (value[k] == '\n') buf_putc('\t');
+            }
+            if (track)
+            {
+                pair->span = buf->end - pair->offset;
+                pair->dirty = 0;
             }
             buf_putc('\n');
         }
@@ -940,7 +1126,7 @@ char* ini_dumps(ini_t ini, int preset, int *len)
     p.end = 0;
 
     /* Print the ini data to the BUFFER structure */
-    if (!print_ini(ini, &p))
+    if (!print_ini(ini, &p, 0))
     {
         free(p.address);
         return NULL;
@@ -984,6 +1170,133 @@ int ini_file_dump(ini_t ini, char* filename)
     return len;
 }
 
+/**
+ *  \brief save the ini object into a file atomically, the file is replaced as a whole by a temporary file.
+ *  \param[in] ini: ini handle
+ *  \param[in] *filename: file name
+ *  \return length of the file or negative fail
+ */
+int ini_file_save(ini_t ini, const char* filename)
+{
+    BUFFER p;
+
+    if (!ini) return -1;
+    if (!filename) return -1;
+
+    /* initialize buffer */
+    p.address = (char*)malloc(1);
+    if (!p.address) return -1;
+    p.size = 1;
+    p.end = 0;
+
+    /* Print the ini data and record where the values are in the file */
+    if (!print_ini(ini, &p, 1))
+    {
+        ini->size = 0;
+        free(p.address);
+        return -1;
+    }
+
+    if (fsave_atomic(filename, p.address, p.end) != FSAVE_E_OK)
+    {
+        ini->size = 0;
+        free(p.address);
+        return -1;
+    }
+    ini->size = p.end;
+    ini->check = fsave_check(p.address, p.end);
+    ini->dirty = 0;
+
+    free(p.address);
+
+    return p.end;
+}
+
+/**
+ *  \brief save the changes of the ini object into the file it was loaded from or last saved to.
+ *         When only values changed and each new value fits in the length of the old one, the values are
+ *         overwritten in place and padded with spaces, otherwise the file is saved as a whole by `ini_file_save()`.
+ *  \param[in] ini: ini handle
+ *  \param[in] *filename: file name
+ *  \return number of bytes written, 0 nothing changed, or negative fail
+ */
+int ini_file_patch(ini_t ini, const char* filename)
+{
+    FSAVE_PATCH* patches;
+    SECTION* sect;
+    PAIR* pair;
+    char* data;
+    int count = 0, total = 0, len;
+    int i, j, error;
+
+    if (!ini) return -1;
+    if (!filename) return -1;
+
+    if (!ini->dirty) return 0;
+    if ((ini->dirty & DIRTY_LAYOUT) || ini->size <= 0) return ini_file_save(ini, filename);
+
+    /* Each changed value must be one line that fits in place */
+    for (i = 0; i < ini->count; i++)
+    {
+        sect = ini->sections[i];
+        for (j = 0; j < sect->count; j++)
+        {
+            pair = sect->pairs[j];
+            if (!pair->dirty) continue;
+            len = strlen(pair->value);
+            if (len > pair->span || strchr(pair->value, '\n')) return ini_file_save(ini, filename);
+            count++;
+            total += pair->span;
+        }
+    }
+
+    /* One allocation for the patches and their contents */
+    patches = (FSAVE_PATCH*)malloc(count * sizeof(FSAVE_PATCH) + total);
+    if (!patches) return -1;
+    data = (char*)(patches + count);
+
+    count = 0;
+    for (i = 0; i < ini->count; i++)
+    {
+        sect = ini->sections[i];
+        for (j = 0; j < sect->count; j++)
+        {
+            pair = sect->pairs[j];
+            if (!pair->dirty) continue;
+            len = strlen(pair->value);
+            memcpy(data, pair->value, len);
+            memset(data + len, ' ', pair->span - len);
+            patches[count].offset = pair->offset;
+            patches[count].data = data;
+            patches[count].size = pair->span;
+            data += pair->span;
+            count++;
+        }
+    }
+
+    error = fsave_patch(filename, &ini->check, patches, count);
+    free(patches);
+
+    /* Not the file the offsets refer to, save it as a whole */
+    if (error == FSAVE_E_CHANGED) return ini_file_save(ini, filename);
+
+    /* The file may have a part of the patches, the offsets are no longer trusted */
+    if (error != FSAVE_E_OK)
+    {
+        ini->size = 0;
+        return -1;
+    }
+
+    for (i = 0; i < ini->count; i++)
+    {
+        sect = ini->sections[i];
+        for (j = 0; j < sect->count; j++) sect->pairs[j]->dirty = 0;
+    }
+    ini->dirty = 0;
+
+    return total;
+}
+
 /**
  * \brief Skip leading spaces, tabs, and carriage returns in a string.
  *
@@ -1045,8 +1358,13 @@ static const char* value_scope(const char* text, int depth)
 {
     const char *s = text;
     const char *sentinel = NULL;
+    const char *last = NULL;
 
     s = lend(s);
+
+    /* End of the last line with actual characters, trailing empty and comment lines are not part of the value */
+    last = s;
+
     while (*s)
     {   
         /* Sentinel locate non empty characters on a new line */
@@ -1064,6 +1382,7 @@ static const char* value_scope(const char* text, int depth)
         {
             s = sentinel;
             s = lend(s);
+            if (*sentinel != 0 && *sentinel != '\n') last = s;
         }
         /* Exceeding the depth, determine whether to stop detection based on the current sentinel character */
         else  
@@ -1077,42 +1396,107 @@ static const char* value_scope(const char* text, int depth)
         }
     }
 
-    /* Starting from the position of the sentry, probe back and remove empty lines (as there are no actual characters) */
-    while (*s == 0 || *s == '\n')
+    return last;
+}
+
+/**
+ * \brief Get the value of a pair, the raw value text of an in situ pair is cooked in place at the first access.
+ *        Lines are trimmed and joined with `\n` and comment lines are dropped, the same as the copying parser,
+ *        the cooked value is never longer than the raw text, and is terminated at the end of it.
+ *
+ * \param[in] pair The pair
+ *
+ * \return Returns the terminated value
+ */
+static const char* pair_value(PAIR* pair)
+{
+    const char *text, *end, *tail, *s;
+    char *out;
+
+    if (pair->raw < 0) return pair->value;
+
+    text = pair->value;
+    end = text + pair->raw;
+    out = pair->value;
+
+    while (text < end)
     {
-        /* Starting from the line break position and detecting backwards */
-        sentinel = rskip(s - 1, text);
-        if (*sentinel != 0 && *sentinel != '\n') break;
+        text = skip(text);
+        if (text >= end) break;
+
+        /* skip comments */
+        if (iscomment(*text))
+        {
+            text = lend(text);
+            if (*text == '\n') text++;
+            continue;
+        }
+
+        /* Line break inside the value */
+        if (*text == '\n')
+        {
+            *out++ = '\n';
+            text++;
+            continue;
+        }
 
-        /* Fallback by an empty line */
-        s = sentinel;
+        /* Trimmed content of the line */
+        tail = lend(text);
+        s = rskip(tail - 1, text);
+        memmove(out, text, s - text + 1);
+        out += s - text + 1;
+        text = tail;
     }
+    *out = '\0';
+    pair->raw = -1;
 
-    return s;
+    return pair->value;
 }
 
 /**
- *  \brief load ini from string.
+ *  \brief Parse ini text.
  *  \param[in] *text: string text
+ *  \param[in] insitu: 1 parse in situ, names are terminated in the text and values are cooked there on access
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
  *  \return ini handle or NULL fail
  */
-ini_t ini_loads(const char* text)
+static ini_t ini_parse(const char* text, int insitu, INI_CTX* ctx)
 {
     ini_t ini;
     const char *s = NULL, *tail = NULL;
     const char *scope = NULL;
+    const char *base = text, *start = NULL;
     char *value = NULL;
     int len = 0;
     int depth = 0; /* current line depth */
     SECTION *sect = NULL;
     PAIR *pair = NULL;
+    int etype = INI_E_OK;       /* error information of this call */
+    int eline = 1;
 
     if (!text) return NULL;
-    ini = ini_create();
-    if (!ini) return NULL;
+    ini = ini_new(ctx ? ctx->alloc : NULL);
+    if (!ini)
+    {
+        E(INI_E_MEMORY);
+        goto FAIL;
+    }
+
+    /* Every section and pair starts a line, so the lines bound the nodes of the pool */
+    if (insitu)
+    {
+        len = 1;
+        for (s = text; *s; s++) if (*s == '\n') len++;
+        ini->pool = (NODE*)ini_malloc(ini->alloc, len * sizeof(NODE));
+        if (!ini->pool)
+        {
+            E(INI_E_MEMORY);
+            goto FAIL;
+        }
+    }
 
-    eline = 1;
-    etype = INI_E_OK;
+    /* Taken before the parsing, which modifies an in situ text */
+    ini->check = fsave_check(text, strlen(text));
 
     while (*text)
     {
@@ -1132,8 +1516,8 @@ ini_t ini_loads(const char* text)
             {
                 text++;
                 eline++;
-                continue;
             }
+            continue;
         }
         
         /* Exceeded the range of the previous value and does not belong to the previous value. Starting a new parsing */
@@ -1183,6 +1567,9 @@ ini_t ini_loads(const char* text)
                     goto FAIL;
                 }
 
+                /* The name is terminated in place of `]` */
+                if (insitu) *(char*)tail = '\0';
+
                 /* Update parsing location */
                 text = s;
                 pair = NULL;
@@ -1235,24 +1622,38 @@ ini_t ini_loads(const char* text)
                     goto FAIL;
                 }
 
-                /* Add pair to section */
-                pair = add_pair(sect, text, tail - text + 1, "", 0);
+                /* After determining the key, we need to explore the scope of the value.
+                 *
+                 * The indentation depth of the incoming section is used to determine 
+                 * whether the depth of the value is within the depth range of the section. 
+                 */
+                scope = value_scope(s + 1, depth); 
+
+                /* Add pair to section, an in situ pair records the raw value text within the scope */
+                if (insitu) pair = add_pair(ini, sect, text, tail - text + 1, s + 1, scope - s - 1);
+                else pair = add_pair(ini, sect, text, tail - text + 1, "", 0);
                 if (!pair)
                 {
                     E(INI_E_MEMORY);
                     goto FAIL;
                 }
 
+                /* Record where the trimmed value lies in the text, to patch it in place later */
+                start = skip(s + 1);
+                pair->offset = start - base;
+                if (start < scope) pair->span = rskip(scope - 1, start) - start + 1;
+
                 /* Update parsing location */
                 len = 0;
                 text = s + 1; /* skip delimiter '=' and ':' */
 
-                /* After determining the key, we need to explore the scope of the value.
-                 *
-                 * The indentation depth of the incoming section is used to determine 
-                 * whether the depth of the value is within the depth range of the section. 
-                 */
-                scope = value_scope(text, depth); 
+                /* The value of an in situ pair is cooked on access, continue after its scope,
+                 * the key is terminated behind it, which may be the delimiter */
+                if (insitu)
+                {
+                    *(char*)(tail + 1) = '\0';
+                    for (; text < scope; text++) if (*text == '\n') eline++;
+                }
             }
         }
         /* This line belongs to the previous line, still within the range of the previous value */
@@ -1270,7 +1671,7 @@ ini_t ini_loads(const char* text)
              */
             if (*text == '\n')
             {
-                value = realloc(pair->value, len + 1);
+                value = ini_realloc(ini->alloc, pair->value, len + 1, len + 2);
                 if (!value)
                 {
                     E(INI_E_MEMORY);
@@ -1300,7 +1701,7 @@ ini_t ini_loads(const char* text)
             s = rskip(tail - 1, text);
 
             /* Reassign space and append the content of the current line */
-            value = realloc(pair->value, len + (s - text + 1));
+            value = ini_realloc(ini->alloc, pair->value, len + 1, len + (s - text + 1) + 1);
             if (!value)
             {
                 E(INI_E_MEMORY);
@@ -1318,13 +1719,62 @@ ini_t ini_loads(const char* text)
         }
     }
 
+    /* The value offsets refer to a file of this size */
+    ini->size = text - base;
+
+    if (ctx)
+    {
+        ctx->type = INI_E_OK;
+        ctx->line = 0;
+    }
+
     return ini;
 
 FAIL:
     ini_delete(ini);
+    if (ctx)
+    {
+        ctx->type = etype;
+        ctx->line = eline;
+    }
     return NULL;
 }
 
+/**
+ *  \brief load ini from string, the error information is kept in the context,
+ *         so it can be called on several threads at once.
+ *  \param[in] *text: string text
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
+ *  \return ini handle or NULL fail
+ */
+ini_t ini_loads_ex(const char* text, INI_CTX* ctx)
+{
+    return ini_parse(text, 0, ctx);
+}
+
+/**
+ *  \brief load a read-only ini in situ, without copying any name or value.
+ *         Names and values point into the text, which is modified and must stay valid until the ini is deleted,
+ *         the ini can be read and dumped, but the calls that modify it fail.
+ *  \param[in] *text: string text, modified by the parsing
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
+ *  \return ini handle or NULL fail
+ */
+ini_t ini_loads_insitu(char* text, INI_CTX* ctx)
+{
+    return ini_parse(text, 1, ctx);
+}
+
+/**
+ *  \brief load ini from string.
+ *  \param[in] *text: string text
+ *  \return ini handle or NULL fail, use `ini_error_info()` to locate the error
+ */
+ini_t ini_loads(const char* text)
+{
+    return ini_loads_ex(text, &ectx);
+}
+
 /**
  *  \brief load ini from file.
  *  \param[in] *filename: file name
@@ -1332,56 +1782,33 @@ FAIL:
  */
 ini_t ini_file_load(const char* filename)
 {
-    FILE* f = NULL;
-    ini_t ini = NULL;
-    long len;
-    char* text = NULL;
+    ini_t ini;
+    FMAP map;
+    int error;
 
     if (!filename) return NULL;
 
-    eline = 0;
-
-    /* open file and get the length of file */
-    f = fopen(filename, "rb");
-    if (!f)
+    /* map file, the content is parsed in place without copying */
+    error = fmap_open(&map, filename);
+    if (error != FMAP_E_OK)
     {
-        E(INI_E_OPEN);
-        goto FAIL;
+        ectx.type = (error == FMAP_E_MEMORY) ? INI_E_MEMORY : INI_E_OPEN;
+        ectx.line = 0;
+        return NULL;
     }
-    fseek(f, 0, SEEK_END);
-    len = ftell(f);
-    fseek(f, 0, SEEK_SET);
 
-    /* read file */
-    text = (char*)malloc(len + 1);
-    if (text)
-    {
-        fread(text, 1, len, f);
-        fclose(f);
-        f = NULL;
-    }
-    else
-    {
-        E(INI_E_MEMORY);
-        goto FAIL;
-    }
-    text[len] = 0;
+    ini = ini_loads(map.data); /* load text */
 
-    /* load text */
-    ini = ini_loads(text);
-    if (!ini)
+    /* The file was truncated while loading, the text read is not valid */
+    if (fmap_close(&map) != FMAP_E_OK && ini)
     {
-        goto FAIL;
+        ini_delete(ini);
+        ini = NULL;
+        ectx.type = INI_E_OPEN;
+        ectx.line = 0;
     }
-    free(text);
 
     return ini;
-
-FAIL:
-    // printf("ini parse error! line %d, error %d.\r\n", eline, etype);
-    if (f) fclose(f);
-    if (text) free(text);
-    return NULL;
 }
 
 /**
@@ -1392,9 +1819,9 @@ FAIL:
  */
 int ini_error_info(int* line, int* type)
 {
-    if (etype == INI_E_OK) return 0;
-    if (line) *line = eline;
-    if (type) *type = etype;
+    if (ectx.type == INI_E_OK) return 0;
+    if (line) *line = ectx.line;
+    if (type) *type = ectx.type;
     return 1;
 }
 
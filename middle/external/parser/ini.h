@@ -41,11 +41,35 @@ typedef struct INI* ini_t;
 #define INI_E_OPEN                          (8) /* fail to open file */
 #define INI_E_MAX                           (9) /*  */
 
+/* allocator of the sections, pairs and strings of a loaded ini, it must outlive the ini,
+ * the memory returned to the caller still comes from the C library */
+
+typedef struct
+{
+    void* (*alloc)(void* user, unsigned int size);  /**< allocate a block, NULL fail */
+    void (*free)(void* user, void* block);          /**< release a block of `alloc` */
+    void* user;                                     /**< user data of the callbacks, such as an arena */
+} INI_ALLOC;
+
+/* parse context, keeps the error information of one parsing call instead of the shared one */
+
+typedef struct
+{
+    const INI_ALLOC* alloc;                 /**< input, allocator of the loaded ini, NULL the C library */
+    int type;                               /**< error type, @ref INI_E_xxx */
+    int line;                               /**< error line */
+} INI_CTX;
+
 /* load ini */
 
 ini_t ini_loads(const char* text);
+ini_t ini_loads_ex(const char* text, INI_CTX* ctx);
 ini_t ini_file_load(const char* filename);
 
+/* load read-only ini in situ, names and values point into the text, which is modified and must outlive the ini */
+
+ini_t ini_loads_insitu(char* text, INI_CTX* ctx);
+
 /* when loading fails, use this method to locate the error */
 
 int ini_error_info(int* line, int* type);
@@ -55,6 +79,11 @@ int ini_error_info(int* line, int* type);
 char* ini_dumps(ini_t ini, int preset, int *len);
 int ini_file_dump(ini_t ini, char* filename);
 
+/* save ini into file atomically, or only patch the changed values in place when they fit */
+
+int ini_file_save(ini_t ini, const char* filename);
+int ini_file_patch(ini_t ini, const char* filename);
+
 /* create and delete ini */
 
 ini_t ini_create(void);
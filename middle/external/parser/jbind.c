@@ -0,0 +1,837 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  jbind.c
+ *         \unit  jbind
+ *        \brief  This is a C language version of json struct binding, encode and decode without a json tree
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "jbind.h"
+#include "fpconv.h"
+#include <string.h>
+#include <stdint.h>
+
+/* pull reader define, walks the text without building anything */
+typedef struct
+{
+    const char* s;                          /**< current position */
+    const char* e;                          /**< end of text */
+} READER;
+
+/* stream writer define */
+typedef struct
+{
+    char* buffer;                           /**< output buffer, or chunk buffer when streaming */
+    int size;                               /**< size of buffer */
+    int end;                                /**< end of buffer used */
+    int total;                              /**< total length written */
+    jbind_write_t write;                    /**< flush callback, NULL when writing into the buffer only */
+    void* context;                          /**< context of flush callback */
+} WRITER;
+
+#define R_PEEK(r)                           (((r)->s < (r)->e) ? *(r)->s : '\0')
+#define IS_DIGIT(c)                         ((c) >= '0' && (c) <= '9')
+#define MEMBER(object, field)               ((char*)(object) + (field)->offset)
+
+/**
+ *  \brief Skip whitespace characters.
+ *  \param[in] r: reader
+ *  \return next character
+ */
+static char r_skip(READER* r)
+{
+    while (r->s < r->e && (unsigned char)*r->s <= ' ') r->s++;
+    return R_PEEK(r);
+}
+
+/**
+ *  \brief Match a literal word such as `true`.
+ *  \param[in] r: reader
+ *  \param[in] word: literal word
+ *  \return 1 match and skipped or 0 not match
+ */
+static int r_word(READER* r, const char* word)
+{
+    int len = strlen(word);
+    if (r->e - r->s < len || memcmp(r->s, word, len)) return 0;
+    r->s += len;
+    return 1;
+}
+
+/**
+ *  \brief Locate a string value without decoding it.
+ *  \param[in] r: reader, at the opening quote
+ *  \param[out] begin: first character of string content
+ *  \param[out] end: closing quote of string content
+ *  \param[out] escape: whether the content contains escape sequences
+ *  \return 1 success or 0 fail
+ */
+static int r_string(READER* r, const char** begin, const char** end, int* escape)
+{
+    const char* s = r->s;
+
+    if (R_PEEK(r) != '\"') return 0;
+    s++;
+
+    *escape = 0;
+    *begin = s;
+    while (s < r->e && *s != '\"')
+    {
+        if (*s == '\\')
+        {
+            *escape = 1;
+            s++;
+        }
+        s++;
+    }
+    if (s >= r->e) return 0;
+
+    *end = s;
+    r->s = s + 1;
+
+    return 1;
+}
+
+static unsigned int hex4(const char* s)
+{
+    unsigned int h = 0;
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        h <<= 4;
+        if (s[i] >= '0' && s[i] <= '9') h += s[i] - '0';
+        else if (s[i] >= 'A' && s[i] <= 'F') h += 10 + s[i] - 'A';
+        else if (s[i] >= 'a' && s[i] <= 'f') h += 10 + s[i] - 'a';
+        else return 0;
+    }
+    return h;
+}
+
+/**
+ *  \brief Decode string content into a char array, escape sequences are resolved.
+ *  \param[in] begin: first character of string content
+ *  \param[in] end: closing quote of string content
+ *  \param[out] out: output char array
+ *  \param[in] size: capacity of output, including terminator
+ *  \return length of decoded string or -1 not enough space
+ */
+static int unescape(const char* begin, const char* end, char* out, unsigned int size)
+{
+    unsigned int len = 0, uc, uc2, n;
+    char c;
+
+    while (begin < end)
+    {
+        c = *begin++;
+        if (c == '\\' && begin < end)
+        {
+            c = *begin++;
+            if (c == 'b') c = '\b';
+            else if (c == 'f') c = '\f';
+            else if (c == 'n') c = '\n';
+            else if (c == 'r') c = '\r';
+            else if (c == 't') c = '\t';
+            else if (c == 'u' && end - begin >= 4)
+            {
+                uc = hex4(begin);
+                begin += 4;
+
+                /* UTF16 surrogate pairs */
+                if (uc >= 0xD800 && uc <= 0xDBFF && end - begin >= 6 && begin[0] == '\\' && begin[1] == 'u')
+                {
+                    uc2 = hex4(begin + 2);
+                    if (uc2 >= 0xDC00 && uc2 <= 0xDFFF)
+                    {
+                        uc = 0x10000 + (((uc & 0x3FF) << 10) | (uc2 & 0x3FF));
+                        begin += 6;
+                    }
+                }
+
+                /* Write UTF-8 sequence */
+                n = (uc < 0x80) ? 1 : (uc < 0x800) ? 2 : (uc < 0x10000) ? 3 : 4;
+                if (len + n >= size) return -1;
+                switch (n)
+                {
+                case 1: out[len] = (char)uc; break;
+                case 2: out[len] = (char)(0xC0 | (uc >> 6)); out[len + 1] = (char)(0x80 | (uc & 0x3F)); break;
+                case 3: out[len] = (char)(0xE0 | (uc >> 12)); out[len + 1] = (char)(0x80 | ((uc >> 6) & 0x3F)); out[len + 2] = (char)(0x80 | (uc & 0x3F)); break;
+                case 4: out[len] = (char)(0xF0 | (uc >> 18)); out[len + 1] = (char)(0x80 | ((uc >> 12) & 0x3F)); out[len + 2] = (char)(0x80 | ((uc >> 6) & 0x3F)); out[len + 3] = (char)(0x80 | (uc & 0x3F)); break;
+                }
+                len += n;
+                continue;
+            }
+        }
+        if (len + 1 >= size) return -1;
+        out[len++] = c;
+    }
+
+    out[len] = '\0';
+
+    return len;
+}
+
+/**
+ *  \brief Compare the key in text with the field key.
+ *  \param[in] begin: first character of key content
+ *  \param[in] end: closing quote of key content
+ *  \param[in] escape: whether the key contains escape sequences
+ *  \param[in] key: field key
+ *  \return 1 equal or 0 not equal
+ */
+static int key_equal(const char* begin, const char* end, int escape, const char* key)
+{
+    char temp[64];
+    int len;
+
+    if (!escape)
+    {
+        len = end - begin;
+        return (!strncmp(begin, key, len) && key[len] == '\0');
+    }
+
+    /* Keys with escape sequences are rare, decode them in a small local buffer */
+    len = unescape(begin, end, temp, sizeof(temp));
+    if (len < 0) return 0;
+
+    return !strcmp(temp, key);
+}
+
+/**
+ *  \brief Read a number value.
+ *  \param[in] r: reader
+ *  \param[out] number: value as double
+ *  \param[out] magnitude: absolute value as integer, valid when the text is an integer within 64 bits
+ *  \param[out] negative: whether the text has a minus sign
+ *  \param[out] isint: whether `magnitude` is valid
+ *  \return 1 success or 0 fail
+ */
+static int r_number(READER* r, double* number, uint64_t* magnitude, int* negative, int* isint)
+{
+    const char* begin = r->s;
+    const char* s = r->s;
+    uint64_t u = 0;
+
+    *isint = 1;
+    *negative = 0;
+
+    if (s < r->e && *s == '-')
+    {
+        *negative = 1;
+        s++;
+    }
+    if (!(s < r->e && IS_DIGIT(*s))) return 0;
+
+    /* Integer part, accumulated directly to keep 64-bit precision */
+    while (s < r->e && IS_DIGIT(*s))
+    {
+        if (u > (UINT64_MAX - (uint64_t)(*s - '0')) / 10) *isint = 0;
+        else u = u * 10 + (uint64_t)(*s - '0');
+        s++;
+    }
+
+    /* Decimal part */
+    if (s < r->e && *s == '.')
+    {
+        s++;
+        if (!(s < r->e && IS_DIGIT(*s))) return 0;
+        while (s < r->e && IS_DIGIT(*s)) s++;
+        *isint = 0;
+    }
+
+    /* Exponent part */
+    if (s < r->e && (*s == 'e' || *s == 'E'))
+    {
+        s++;
+        if (s < r->e && (*s == '+' || *s == '-')) s++;
+        if (!(s < r->e && IS_DIGIT(*s))) return 0;
+        while (s < r->e && IS_DIGIT(*s)) s++;
+        *isint = 0;
+    }
+
+    *magnitude = u;
+
+    /* The conversion of an integer to double rounds the same as parsing the text */
+    if (*isint) *number = *negative ? -(double)u : (double)u;
+    else *number = fpconv_strntod(begin, s - begin, NULL);
+
+    r->s = s;
+
+    return 1;
+}
+
+/**
+ *  \brief Skip a whole json value.
+ *  \param[in] r: reader
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int skip_value(READER* r, int depth)
+{
+    const char *b, *e;
+    double d;
+    uint64_t u;
+    int escape, negative, isint, error;
+    char c = r_skip(r);
+
+    if (depth > JBIND_DEPTH_MAX) return JBIND_E_DEPTH;
+
+    if (c == '\"') return r_string(r, &b, &e, &escape) ? JBIND_E_OK : JBIND_E_SYNTAX;
+    if (c == '-' || IS_DIGIT(c)) return r_number(r, &d, &u, &negative, &isint) ? JBIND_E_OK : JBIND_E_SYNTAX;
+    if (r_word(r, "true") || r_word(r, "false") || r_word(r, "null")) return JBIND_E_OK;
+
+    if (c == '[' || c == '{')
+    {
+        r->s++;
+        if (r_skip(r) == (c == '[' ? ']' : '}'))
+        {
+            r->s++;
+            return JBIND_E_OK;
+        }
+        while (1)
+        {
+            /* Object member key */
+            if (c == '{')
+            {
+                if (r_skip(r) != '\"' || !r_string(r, &b, &e, &escape)) return JBIND_E_SYNTAX;
+                if (r_skip(r) != ':') return JBIND_E_SYNTAX;
+                r->s++;
+            }
+
+            error = skip_value(r, depth + 1);
+            if (error) return error;
+
+            /* Separator or the end of container */
+            if (r_skip(r) == ',')
+            {
+                r->s++;
+                continue;
+            }
+            if (R_PEEK(r) != (c == '[' ? ']' : '}')) return JBIND_E_SYNTAX;
+            r->s++;
+            return JBIND_E_OK;
+        }
+    }
+
+    return JBIND_E_SYNTAX;
+}
+
+/**
+ *  \brief Store an integer into a member of any width, in two's complement.
+ */
+static void store_int(void* p, unsigned int size, uint64_t v)
+{
+    switch (size)
+    {
+    case 1: *(uint8_t*)p = (uint8_t)v; break;
+    case 2: *(uint16_t*)p = (uint16_t)v; break;
+    case 4: *(uint32_t*)p = (uint32_t)v; break;
+    case 8: *(uint64_t*)p = v; break;
+    }
+}
+
+/**
+ *  \brief Check a number read against an integer member and get the bits to store.
+ *  \param[in] field: field binding
+ *  \param[in] d: value as double
+ *  \param[in] u: absolute value as integer
+ *  \param[in] negative: whether the value is negative
+ *  \param[in] isint: whether `u` is valid
+ *  \param[out] v: value in two's complement
+ *  \return error type
+ */
+static int check_int(const JBIND_FIELD* field, double d, uint64_t u, int negative, int isint, uint64_t* v)
+{
+    double a = negative ? -d : d;
+    uint64_t max;
+
+    if (field->size != 1 && field->size != 2 && field->size != 4 && field->size != 8) return JBIND_E_INVALID;
+
+    /* Fractions and exponents are accepted when the value is integral, like 1e3 */
+    if (!isint)
+    {
+        if (!(a >= 0 && a < 18446744073709551616.0)) return JBIND_E_RANGE;
+        u = (uint64_t)a;
+        if ((double)u != a) return JBIND_E_RANGE;
+    }
+
+    max = (field->size == 8) ? UINT64_MAX : ((uint64_t)1 << (field->size * 8)) - 1;
+
+    if ((field->type & ~JBIND_T_ARRAY) == JBIND_T_INT)
+    {
+        /* Negatives reach one more than positives */
+        if (u > (max >> 1) + (negative ? 1 : 0)) return JBIND_E_RANGE;
+    }
+    else
+    {
+        if (negative && u != 0) return JBIND_E_RANGE;
+        if (u > max) return JBIND_E_RANGE;
+    }
+
+    /* Negate in unsigned arithmetic, which is defined for the most negative value */
+    *v = negative ? (uint64_t)0 - u : u;
+
+    return JBIND_E_OK;
+}
+
+/**
+ *  \brief Load an integer from a member of any width.
+ */
+static int64_t load_int(const void* p, unsigned int size, int sign)
+{
+    switch (size)
+    {
+    case 1: return sign ? (int64_t)*(const int8_t*)p : (int64_t)*(const uint8_t*)p;
+    case 2: return sign ? (int64_t)*(const int16_t*)p : (int64_t)*(const uint16_t*)p;
+    case 4: return sign ? (int64_t)*(const int32_t*)p : (int64_t)*(const uint32_t*)p;
+    case 8: return *(const int64_t*)p;
+    }
+    return 0;
+}
+
+static int decode_object(READER* r, const JBIND* bind, void* object, int depth);
+
+/**
+ *  \brief Decode one json value into one element of a member.
+ *  \param[in] r: reader
+ *  \param[in] field: field binding
+ *  \param[out] p: address of element
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int decode_element(READER* r, const JBIND_FIELD* field, void* p, int depth)
+{
+    const char *b, *e;
+    double d;
+    uint64_t u, v;
+    int escape, negative, isint, error;
+    unsigned int type = field->type & ~JBIND_T_ARRAY;
+    char c = r_skip(r);
+
+    /* null keeps the current value */
+    if (r_word(r, "null")) return JBIND_E_OK;
+
+    switch (type)
+    {
+    case JBIND_T_BOOL:
+        if (r_word(r, "true")) store_int(p, field->size, 1);
+        else if (r_word(r, "false")) store_int(p, field->size, 0);
+        else return JBIND_E_TYPE;
+        return JBIND_E_OK;
+
+    case JBIND_T_INT:
+    case JBIND_T_UINT:
+    case JBIND_T_FLOAT:
+    case JBIND_T_DOUBLE:
+        if (!(c == '-' || IS_DIGIT(c))) return JBIND_E_TYPE;
+        if (!r_number(r, &d, &u, &negative, &isint)) return JBIND_E_SYNTAX;
+        if (type == JBIND_T_FLOAT) *(float*)p = (float)d;
+        else if (type == JBIND_T_DOUBLE) *(double*)p = d;
+        else
+        {
+            error = check_int(field, d, u, negative, isint, &v);
+            if (error != JBIND_E_OK) return error;
+            store_int(p, field->size, v);
+        }
+        return JBIND_E_OK;
+
+    case JBIND_T_STRING:
+        if (c != '\"') return JBIND_E_TYPE;
+        if (!r_string(r, &b, &e, &escape)) return JBIND_E_SYNTAX;
+        if (!escape)
+        {
+            if ((unsigned int)(e - b) >= field->size) return JBIND_E_SIZE;
+            memcpy(p, b, e - b);
+            ((char*)p)[e - b] = '\0';
+        }
+        else if (unescape(b, e, (char*)p, field->size) < 0) return JBIND_E_SIZE;
+        return JBIND_E_OK;
+
+    case JBIND_T_OBJECT:
+        if (c != '{') return JBIND_E_TYPE;
+        return decode_object(r, field->bind, p, depth + 1);
+    }
+
+    return JBIND_E_INVALID;
+}
+
+/**
+ *  \brief Decode a json value into a member.
+ *  \param[in] r: reader
+ *  \param[in] field: field binding
+ *  \param[out] object: address of struct
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int decode_field(READER* r, const JBIND_FIELD* field, void* object, int depth)
+{
+    char* p = MEMBER(object, field);
+    int* count;
+    unsigned int n = 0;
+    int error;
+
+    if (!(field->type & JBIND_T_ARRAY)) return decode_element(r, field, p, depth);
+
+    if (r_word(r, "null")) return JBIND_E_OK;
+    if (r_skip(r) != '[') return JBIND_E_TYPE;
+    if (depth + 1 > JBIND_DEPTH_MAX) return JBIND_E_DEPTH;
+    r->s++;
+
+    count = (int*)((char*)object + field->count);
+
+    if (r_skip(r) != ']')
+    {
+        while (1)
+        {
+            if (n >= field->capacity) return JBIND_E_SIZE;
+
+            error = decode_element(r, field, p + n * field->size, depth + 1);
+            if (error) return error;
+            n++;
+
+            if (r_skip(r) != ',') break;
+            r->s++;
+        }
+        if (R_PEEK(r) != ']') return JBIND_E_SYNTAX;
+    }
+    r->s++;
+
+    *count = (int)n;
+
+    return JBIND_E_OK;
+}
+
+/**
+ *  \brief Decode a json object into a struct.
+ *  \param[in] r: reader, at `{`
+ *  \param[in] bind: struct binding
+ *  \param[out] object: address of struct
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int decode_object(READER* r, const JBIND* bind, void* object, int depth)
+{
+    const char *b, *e;
+    const JBIND_FIELD* field;
+    unsigned int i, hint = 0;
+    int escape, error;
+
+    if (depth > JBIND_DEPTH_MAX) return JBIND_E_DEPTH;
+    if (r_skip(r) != '{') return JBIND_E_TYPE;
+    r->s++;
+
+    if (r_skip(r) == '}')
+    {
+        r->s++;
+        return JBIND_E_OK;
+    }
+
+    while (1)
+    {
+        if (r_skip(r) != '\"' || !r_string(r, &b, &e, &escape)) return JBIND_E_SYNTAX;
+        if (r_skip(r) != ':') return JBIND_E_SYNTAX;
+        r->s++;
+
+        /* Keys usually come in table order, start matching after the previous one */
+        field = NULL;
+        for (i = 0; i < bind->size; i++)
+        {
+            if (key_equal(b, e, escape, bind->fields[(hint + i) % bind->size].key))
+            {
+                hint = (hint + i) % bind->size;
+                field = &bind->fields[hint];
+                hint++;
+                break;
+            }
+        }
+
+        /* Unknown keys are skipped */
+        if (field) error = decode_field(r, field, object, depth);
+        else error = skip_value(r, depth + 1);
+        if (error) return error;
+
+        if (r_skip(r) != ',') break;
+        r->s++;
+    }
+
+    if (R_PEEK(r) != '}') return JBIND_E_SYNTAX;
+    r->s++;
+
+    return JBIND_E_OK;
+}
+
+/**
+ *  \brief decode json text into a struct, no memory is allocated.
+ *         keys missing in the text keep the current member value, and unknown keys are skipped.
+ *  \param[in] bind: struct binding
+ *  \param[out] object: address of struct
+ *  \param[in] text: json text
+ *  \param[in] len: length of text, negative for a terminated string
+ *  \return error type, @ref JBIND_E_xxx
+ */
+int jbind_loads(const JBIND* bind, void* object, const char* text, int len)
+{
+    READER r;
+    int error;
+
+    if (!bind || !object || !text) return JBIND_E_INVALID;
+
+    r.s = text;
+    r.e = text + (len < 0 ? (int)strlen(text) : len);
+
+    error = decode_object(&r, bind, object, 1);
+    if (error) return error;
+
+    /* Only whitespace is allowed after the object */
+    if (r_skip(&r) != '\0' || r.s != r.e) return JBIND_E_SYNTAX;
+
+    return JBIND_E_OK;
+}
+
+/**
+ *  \brief Put data to writer, flush the chunk when it is full.
+ *  \param[in] w: writer
+ *  \param[in] data: data
+ *  \param[in] len: length of data
+ *  \return error type
+ */
+static int w_put(WRITER* w, const char* data, int len)
+{
+    int n;
+
+    while (len > 0)
+    {
+        /* Keep one byte for the terminator */
+        if (w->end >= w->size - 1)
+        {
+            if (!w->write) return JBIND_E_SIZE;
+            if (!w->write(w->context, w->buffer, w->end)) return JBIND_E_WRITE;
+            w->end = 0;
+        }
+
+        n = w->size - 1 - w->end;
+        if (n > len) n = len;
+        memcpy(w->buffer + w->end, data, n);
+        w->end += n;
+        w->total += n;
+        data += n;
+        len -= n;
+    }
+
+    return JBIND_E_OK;
+}
+
+#define W_PUTC(w, c)                        do { char c_ = (c); if ((error = w_put((w), &c_, 1))) return error; } while (0)
+#define W_PUTS(w, s, n)                     do { if ((error = w_put((w), (s), (n)))) return error; } while (0)
+
+/**
+ *  \brief Convert 64-bit integer to text.
+ */
+static int i64toa(int64_t v, int sign, char* buffer)
+{
+    char temp[24];
+    uint64_t u = (uint64_t)v;
+    int i = 0, len = 0;
+
+    if (sign && v < 0)
+    {
+        buffer[len++] = '-';
+        u = 0 - u;
+    }
+
+    do
+    {
+        temp[i++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    while (i > 0) buffer[len++] = temp[--i];
+
+    return len;
+}
+
+/**
+ *  \brief Write a string with escape sequences.
+ */
+static int encode_string(WRITER* w, const char* s, unsigned int size)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char* run = s;
+    const char* end = s;
+    char esc[6];
+    unsigned char c;
+    int error;
+
+    W_PUTC(w, '\"');
+
+    /* Plain runs are written at once, only escapes are written one by one */
+    while ((unsigned int)(end - s) < size && *end)
+    {
+        c = (unsigned char)*end;
+        if (c >= ' ' && c != '\"' && c != '\\')
+        {
+            end++;
+            continue;
+        }
+
+        W_PUTS(w, run, end - run);
+
+        esc[0] = '\\';
+        if (c == '\"' || c == '\\') { esc[1] = (char)c; W_PUTS(w, esc, 2); }
+        else if (c == '\b') { esc[1] = 'b'; W_PUTS(w, esc, 2); }
+        else if (c == '\f') { esc[1] = 'f'; W_PUTS(w, esc, 2); }
+        else if (c == '\n') { esc[1] = 'n'; W_PUTS(w, esc, 2); }
+        else if (c == '\r') { esc[1] = 'r'; W_PUTS(w, esc, 2); }
+        else if (c == '\t') { esc[1] = 't'; W_PUTS(w, esc, 2); }
+        else
+        {
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hex[c >> 4];
+            esc[5] = hex[c & 0xF];
+            W_PUTS(w, esc, 6);
+        }
+
+        run = ++end;
+    }
+    W_PUTS(w, run, end - run);
+
+    W_PUTC(w, '\"');
+
+    return JBIND_E_OK;
+}
+
+static int encode_object(WRITER* w, const JBIND* bind, const void* object, int depth);
+
+/**
+ *  \brief Write one element of a member.
+ */
+static int encode_element(WRITER* w, const JBIND_FIELD* field, const void* p, int depth)
+{
+    char temp[FPCONV_BUFFER_SIZE];
+    int len = 0;
+
+    switch (field->type & ~JBIND_T_ARRAY)
+    {
+    case JBIND_T_BOOL:
+        if (load_int(p, field->size, 0)) return w_put(w, "true", 4);
+        return w_put(w, "false", 5);
+    case JBIND_T_INT: len = i64toa(load_int(p, field->size, 1), 1, temp); break;
+    case JBIND_T_UINT: len = i64toa(load_int(p, field->size, 0), 0, temp); break;
+    case JBIND_T_FLOAT: len = fpconv_ftoa(*(const float*)p, temp); break;
+    case JBIND_T_DOUBLE: len = fpconv_dtoa(*(const double*)p, temp); break;
+    case JBIND_T_STRING: return encode_string(w, (const char*)p, field->size);
+    case JBIND_T_OBJECT: return encode_object(w, field->bind, p, depth + 1);
+    default: return JBIND_E_INVALID;
+    }
+
+    return w_put(w, temp, len);
+}
+
+/**
+ *  \brief Write a struct as json object.
+ */
+static int encode_object(WRITER* w, const JBIND* bind, const void* object, int depth)
+{
+    const JBIND_FIELD* field;
+    const char* p;
+    unsigned int i;
+    int n, j, error;
+
+    if (!bind || depth > JBIND_DEPTH_MAX) return JBIND_E_DEPTH;
+
+    W_PUTC(w, '{');
+
+    for (i = 0; i < bind->size; i++)
+    {
+        field = &bind->fields[i];
+        p = (const char*)object + field->offset;
+
+        if (i) W_PUTC(w, ',');
+        W_PUTC(w, '\"');
+        W_PUTS(w, field->key, strlen(field->key));
+        W_PUTS(w, "\":", 2);
+
+        if (field->type & JBIND_T_ARRAY)
+        {
+            /* Clamp the element count to the capacity */
+            n = *(const int*)((const char*)object + field->count);
+            if (n < 0) n = 0;
+            if ((unsigned int)n > field->capacity) n = field->capacity;
+
+            W_PUTC(w, '[');
+            for (j = 0; j < n; j++)
+            {
+                if (j) W_PUTC(w, ',');
+                error = encode_element(w, field, p + j * field->size, depth + 1);
+                if (error) return error;
+            }
+            W_PUTC(w, ']');
+        }
+        else
+        {
+            error = encode_element(w, field, p, depth);
+            if (error) return error;
+        }
+    }
+
+    W_PUTC(w, '}');
+
+    return JBIND_E_OK;
+}
+
+/**
+ *  \brief encode a struct to compact json text, no memory is allocated.
+ *  \param[in] bind: struct binding
+ *  \param[in] object: address of struct
+ *  \param[out] buffer: output buffer
+ *  \param[in] size: size of buffer
+ *  \return length of text, excluding the terminator, or negative error type
+ */
+int jbind_dumps(const JBIND* bind, const void* object, char* buffer, int size)
+{
+    return jbind_dump_stream(bind, object, buffer, size, NULL, NULL);
+}
+
+/**
+ *  \brief encode a struct to compact json text in chunks, e.g. directly to a serial port.
+ *  \param[in] bind: struct binding
+ *  \param[in] object: address of struct
+ *  \param[in] buffer: chunk buffer
+ *  \param[in] size: size of chunk buffer, at least 2
+ *  \param[in] write: called with each full chunk and the last partial chunk, NULL to only write into the buffer
+ *  \param[in] context: context of write callback
+ *  \return total length of text, or negative error type
+ */
+int jbind_dump_stream(const JBIND* bind, const void* object, char* buffer, int size, jbind_write_t write, void* context)
+{
+    WRITER w;
+    int error;
+
+    if (!bind || !object || !buffer || size < 2) return -JBIND_E_INVALID;
+
+    w.buffer = buffer;
+    w.size = size;
+    w.end = 0;
+    w.total = 0;
+    w.write = write;
+    w.context = context;
+
+    error = encode_object(&w, bind, object, 1);
+    if (error) return -error;
+
+    /* Flush the last partial chunk */
+    if (write && w.end > 0)
+    {
+        if (!write(context, w.buffer, w.end)) return -JBIND_E_WRITE;
+        w.end = 0;
+    }
+
+    buffer[w.end] = '\0';
+
+    return w.total;
+}
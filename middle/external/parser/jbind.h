@@ -0,0 +1,174 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  jbind.h
+ *         \unit  jbind
+ *        \brief  This is a C language version of json struct binding, encode and decode without a json tree
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __jbind_H
+#define __jbind_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+/* version infomation */
+
+#define JBIND_V_MAJOR                       1
+#define JBIND_V_MINOR                       0
+#define JBIND_V_PATCH                       0
+
+/* configuration information */
+
+#define JBIND_DEPTH_MAX                     (32) /* maximum nesting depth of json values */
+
+/* field type define */
+
+#define JBIND_T_BOOL                        (0x01) /* integer member of any width, json true or false */
+#define JBIND_T_INT                         (0x02) /* signed integer member of 1, 2, 4 or 8 bytes */
+#define JBIND_T_UINT                        (0x03) /* unsigned integer member of 1, 2, 4 or 8 bytes */
+#define JBIND_T_FLOAT                       (0x04) /* float member */
+#define JBIND_T_DOUBLE                      (0x05) /* double member */
+#define JBIND_T_STRING                      (0x06) /* char array member, holds a terminated string */
+#define JBIND_T_OBJECT                      (0x07) /* struct member, described by another binding */
+#define JBIND_T_ARRAY                       (0x80) /* flag, fixed capacity array of the types above */
+
+/* error type define */
+
+#define JBIND_E_OK                          (0) /* ok, no error */
+#define JBIND_E_INVALID                     (1) /* invalid parameter */
+#define JBIND_E_SYNTAX                      (2) /* json text syntax error */
+#define JBIND_E_TYPE                        (3) /* json value type does not match the member type */
+#define JBIND_E_SIZE                        (4) /* string or array exceeds the member capacity, or output space is not enough */
+#define JBIND_E_DEPTH                       (5) /* nesting deeper than `JBIND_DEPTH_MAX` */
+#define JBIND_E_WRITE                       (6) /* stream write callback failed */
+#define JBIND_E_RANGE                       (7) /* number out of the range of an integer member, or not integral */
+
+/* binding of one struct member */
+typedef struct
+{
+    const char* key;                        /**< json key, the member name */
+    unsigned int type;                      /**< member type, @ref JBIND_T_xxx */
+    unsigned int offset;                    /**< offset of member in struct */
+    unsigned int size;                      /**< size of member, or size of one element for arrays */
+    unsigned int capacity;                  /**< count of elements, 1 for non arrays */
+    unsigned int count;                     /**< offset of the `int` element count member for arrays */
+    const struct JBIND* bind;               /**< binding of the nested struct for object types */
+} JBIND_FIELD;
+
+/* binding of a struct */
+typedef struct JBIND
+{
+    const JBIND_FIELD* fields;              /**< field table */
+    unsigned int size;                      /**< count of fields */
+} JBIND;
+
+/* stream write callback, return 0 to abort */
+typedef int (*jbind_write_t)(void* context, const char* data, int len);
+
+/* Field table generation
+ *
+ * A struct is described by a field list macro taking `(X, S)`, each entry is `X(S, kind, member, extra)`.
+ * `kind` is one of the `JBIND_F_xxx` suffixes below, `extra` is the nested binding for object kinds and 0 otherwise.
+ * Array kinds bind a fixed capacity array member `member[N]`, and the element count is kept in an `int member_count` member.
+ * `JBIND_DEFINE(name, S, list)` expands the list into a field table and a `const JBIND name` definition.
+ */
+
+#define JBIND_MEMBER_SIZE(s, m)             (sizeof(((s*)0)->m))
+#define JBIND_ELEMENT_SIZE(s, m)            (sizeof(((s*)0)->m[0]))
+#define JBIND_SCALAR(s, m, t, b)            { #m, (t), offsetof(s, m), JBIND_MEMBER_SIZE(s, m), 1, 0, (b) }
+#define JBIND_VECTOR(s, m, t, b)            { #m, (t) | JBIND_T_ARRAY, offsetof(s, m), JBIND_ELEMENT_SIZE(s, m), \
+                                              JBIND_MEMBER_SIZE(s, m) / JBIND_ELEMENT_SIZE(s, m), offsetof(s, m##_count), (b) }
+
+#define JBIND_F_BOOL(s, m, x)               JBIND_SCALAR(s, m, JBIND_T_BOOL, NULL)
+#define JBIND_F_INT(s, m, x)                JBIND_SCALAR(s, m, JBIND_T_INT, NULL)
+#define JBIND_F_UINT(s, m, x)               JBIND_SCALAR(s, m, JBIND_T_UINT, NULL)
+#define JBIND_F_FLOAT(s, m, x)              JBIND_SCALAR(s, m, JBIND_T_FLOAT, NULL)
+#define JBIND_F_DOUBLE(s, m, x)             JBIND_SCALAR(s, m, JBIND_T_DOUBLE, NULL)
+#define JBIND_F_STRING(s, m, x)             JBIND_SCALAR(s, m, JBIND_T_STRING, NULL)
+#define JBIND_F_OBJECT(s, m, x)             JBIND_SCALAR(s, m, JBIND_T_OBJECT, &(x))
+#define JBIND_F_BOOL_ARRAY(s, m, x)         JBIND_VECTOR(s, m, JBIND_T_BOOL, NULL)
+#define JBIND_F_INT_ARRAY(s, m, x)          JBIND_VECTOR(s, m, JBIND_T_INT, NULL)
+#define JBIND_F_UINT_ARRAY(s, m, x)         JBIND_VECTOR(s, m, JBIND_T_UINT, NULL)
+#define JBIND_F_FLOAT_ARRAY(s, m, x)        JBIND_VECTOR(s, m, JBIND_T_FLOAT, NULL)
+#define JBIND_F_DOUBLE_ARRAY(s, m, x)       JBIND_VECTOR(s, m, JBIND_T_DOUBLE, NULL)
+#define JBIND_F_STRING_ARRAY(s, m, x)       JBIND_VECTOR(s, m, JBIND_T_STRING, NULL)
+#define JBIND_F_OBJECT_ARRAY(s, m, x)       JBIND_VECTOR(s, m, JBIND_T_OBJECT, &(x))
+
+#define JBIND_ENTRY(s, kind, m, x)          JBIND_F_##kind(s, m, x),
+
+#define JBIND_DEFINE(name, s, list)                                                     \
+    static const JBIND_FIELD name##_fields[] = { list(JBIND_ENTRY, s) };                \
+    const JBIND name = { name##_fields, sizeof(name##_fields) / sizeof(name##_fields[0]) }
+
+/* Encode struct to json text */
+
+int jbind_dumps(const JBIND* bind, const void* object, char* buffer, int size);
+int jbind_dump_stream(const JBIND* bind, const void* object, char* buffer, int size, jbind_write_t write, void* context);
+
+/* Decode json text into struct */
+
+int jbind_loads(const JBIND* bind, void* object, const char* text, int len);
+
+#if 0 /* for example */
+#include <stdio.h>
+#include "jbind.h"
+
+typedef struct
+{
+    double min;
+    double max;
+} range_t;
+
+typedef struct
+{
+    int channel;
+    float gain;
+    char name[16];
+    unsigned short samples[8];
+    int samples_count;
+    range_t limit;
+} adc_cfg_t;
+
+#define RANGE_FIELDS(X, S)                  \
+    X(S, DOUBLE,        min,        0)      \
+    X(S, DOUBLE,        max,        0)      \
+
+#define ADC_CFG_FIELDS(X, S)                \
+    X(S, INT,           channel,    0)      \
+    X(S, FLOAT,         gain,       0)      \
+    X(S, STRING,        name,       0)      \
+    X(S, UINT_ARRAY,    samples,    0)      \
+    X(S, OBJECT,        limit,      range_bind) \
+
+JBIND_DEFINE(range_bind, range_t, RANGE_FIELDS);
+JBIND_DEFINE(adc_cfg_bind, adc_cfg_t, ADC_CFG_FIELDS);
+
+int main(void)
+{
+    adc_cfg_t cfg = { 0 };
+    char text[256];
+
+    /* Missing keys keep the current value, unknown keys are skipped */
+    if (jbind_loads(&adc_cfg_bind, &cfg, "{\"channel\":3,\"gain\":1.5,\"name\":\"ain3\",\"samples\":[1,2,3],\"limit\":{\"min\":0,\"max\":5}}", -1) != JBIND_E_OK) return 1;
+
+    /* {"channel":3,"gain":1.5,"name":"ain3","samples":[1,2,3],"limit":{"min":0.0,"max":5.0}} */
+    if (jbind_dumps(&adc_cfg_bind, &cfg, text, sizeof(text)) > 0) printf("%s\r\n", text);
+
+    return 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -11,11 +11,13 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "json.h"
+#include "fpconv.h"
+#include "cbor.h"
+#include "fmap.h"
+#include "fsave.h"
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
-#include <math.h>
-#include <float.h>
 
 /* dump buffer define */
 typedef struct
@@ -23,13 +25,20 @@ typedef struct
     char* address;                          /**< buffer base address */
     unsigned int size;                      /**< size of buffer */
     unsigned int end;                       /**< end of buffer used */
+    int track;                              /**< record where the values are printed, for the printing saved to file */
+    long origin;                            /**< file offset of the buffer base when tracking */
 } BUFFER;
 
 /* json define */
 typedef struct JSON {
     struct JSON* next;                      /**< next json */
+    const JSON_ALLOC* alloc;                /**< allocator of the json itself, its key and string, NULL the C library */
     char* key;                              /**< the key of json is empty when the type is array */
     int type;                               /**< json base type, @ref JSON_TYPE_xxx */
+    int offset;                             /**< offset of the value in the file */
+    int span;                               /**< length of the value in the file, 0 unknown, a new value up to this length is patched in place */
+    int dirty;                              /**< changes since load or save, @ref DIRTY_xxx */
+    unsigned long check;                    /**< check value of the file the offsets refer to, kept by the root, @ref fsave_check */
     union
     {
         int bool_;                          /**< bool type */
@@ -40,17 +49,31 @@ typedef struct JSON {
     } value;
 } JSON;
 
-static const char* lbegin = 0;              /**< beginning of line */
-static int eline = 0;                       /**< line of error message */
-static int ecolumn = 0;                     /**< column of error message */
-static int etype = 0;                       /**< type of error message */
+/* changes of json since load or save */
+#define DIRTY_VALUE                         (0x01)  /* value changed, or children attached or detached */
+#define DIRTY_KEY                           (0x02)  /* key changed */
+
+/* parser state define, one for each parsing call */
+typedef struct
+{
+    const char* base;                       /**< beginning of text */
+    const char* lbegin;                     /**< beginning of line */
+    int eline;                              /**< line of error message */
+    int ecolumn;                            /**< column of error message */
+    int etype;                              /**< type of error message */
+    int depth;                              /**< current nesting depth */
+    int depth_max;                          /**< maximum nesting depth, 0 unlimited */
+    const JSON_ALLOC* alloc;                /**< allocator of the loaded json */
+} PARSER;
+
+static JSON_CTX ectx;                       /**< error information of the calls without context */
 
 /* predeclare these prototypes. */
-static const char* parse_text(json_t json, const char* text);
+static const char* parse_text(PARSER* p, json_t json, const char* text);
 static int print_json(json_t json, BUFFER* buf, int depth, int format);
 
 /* set error message and type */
-#define E(type)                             (etype=(type),ecolumn=text-lbegin)
+#define E(type)                             (p->etype=(type),p->ecolumn=text-p->lbegin)
 
 /**
  *  \brief for analysing failed parses
@@ -61,14 +84,14 @@ static int print_json(json_t json, BUFFER* buf, int depth, int format);
 int json_error_info(int* line, int* column)
 {
     /* No error occurred, return directly */
-    if (etype == JSON_E_OK) return JSON_E_OK;
+    if (ectx.type == JSON_E_OK) return JSON_E_OK;
 
     /* Output the line and column where the error is located */
-    if (line) *line = eline;
-    if (column) *column = ecolumn;
+    if (line) *line = ectx.line;
+    if (column) *column = ectx.column;
 
     /* Return error type */
-    return etype;
+    return ectx.type;
 }
 
 /**
@@ -94,19 +117,43 @@ static int json_strccmp(const char* s1, const char* s2)
     return tolower(*(const unsigned char*)s1) - tolower(*(const unsigned char*)s2);
 }
 
+/**
+ *  \brief Allocate memory of a json with its allocator.
+ *  \param[in] alloc: allocator, NULL the C library
+ *  \param[in] size: size of memory
+ *  \return address of memory or NULL fail
+ */
+static void* json_malloc(const JSON_ALLOC* alloc, unsigned int size)
+{
+    return alloc ? alloc->alloc(alloc->user, size) : malloc(size);
+}
+
+/**
+ *  \brief Release memory of a json with its allocator.
+ *  \param[in] alloc: allocator, NULL the C library
+ *  \param[in] block: address of memory
+ *  \return none
+ */
+static void json_free(const JSON_ALLOC* alloc, void* block)
+{
+    if (alloc) alloc->free(alloc->user, block);
+    else free(block);
+}
+
 /**
  *  \brief Duplicate a given string.
  * 
+ *  \param[in] alloc Allocator of the copy, NULL the C library.
  *  \param[in] str String to be duplicated.
  *  \param[in] len Length of the string.
  *  \return Pointer to the duplicated string if successful, NULL otherwise.
  */
-static char* json_strdup(const char* str, int len)
+static char* json_strdup(const JSON_ALLOC* alloc, const char* str, int len)
 {
     char* s;
 
     /* Allocate memory for the new string */
-    s = (char*)malloc(len + 1);
+    s = (char*)json_malloc(alloc, len + 1);
     if (!s) return NULL;
 
     /* Copy the given string into the allocated memory */
@@ -154,6 +201,19 @@ static int expansion(BUFFER *buf, unsigned int needed)
 #define buf_putc(c)         (buf->address[buf->end++]=(c))      /* put a non zero character into buf */
 #define buf_end()           (buf->address[buf->end])            /* obtain the tail of buf */
 
+/**
+ *  \brief Check whether a string starts with 4 hex digits.
+ *
+ *  \param[in] str The input string
+ *
+ *  \return 1 if there are 4 hex digits, 0 otherwise
+ */
+static int ishex4(const char* str)
+{
+    return isxdigit((unsigned char)str[0]) && isxdigit((unsigned char)str[1]) &&
+           isxdigit((unsigned char)str[2]) && isxdigit((unsigned char)str[3]);
+}
+
 static unsigned int parse_hex4(const char* str)
 {
     unsigned int h = 0;
@@ -192,14 +252,25 @@ static void json_utf(const char **in, char **out)
     int len = 0;
     unsigned int uc, uc2;
     unsigned char mask_first_byte[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
+
+    /* The escape is consumed even when it is invalid, but never beyond the hex digits that are there */
+    if (!ishex4(ptr + 1))
+    {
+        while (isxdigit((unsigned char)ptr[1])) ptr++;
+        *in = ptr;
+        return;
+    }
+
     uc = parse_hex4(ptr + 1); ptr += 4; /* get the unicode char. */
+    *in = ptr;
     if ((uc >= 0xDC00 && uc <= 0xDFFF) || uc == 0) return; /* check for invalid.    */
     if (uc >= 0xD800 && uc <= 0xDBFF) /* UTF16 surrogate pairs. */
     {
-        if (ptr[1] != '\\' || ptr[2] != 'u') return; /* missing second-half of surrogate */
+        if (ptr[1] != '\\' || ptr[2] != 'u' || !ishex4(ptr + 3)) return; /* missing second-half of surrogate */
         uc2 = parse_hex4(ptr + 3);
-        ptr += 6;
         if (uc2 < 0xDC00 || uc2>0xDFFF)    return; /* invalid second-half of surrogate */
+        ptr += 6;
+        *in = ptr;
         uc = 0x10000 + (((uc & 0x3FF) << 10) | (uc2 & 0x3FF));
     }
     len = 4;
@@ -215,6 +286,7 @@ static void json_utf(const char **in, char **out)
     case 1: *--ptr2 = (uc | mask_first_byte[len]);
     }
     ptr2 += len;
+    *out = ptr2;
 }
 
 /**
@@ -224,15 +296,15 @@ static void json_utf(const char **in, char **out)
  *
  *  \return Returns a pointer to the first non-whitespace character in the string
  */
-static const char* skip(const char* in)
+static const char* skip(PARSER* p, const char* in)
 {
     while (in && *in && (unsigned char)*in <= ' ')
     {
         /* when a newline character is encountered, record the current parsing line */
         if (*in == '\n') 
         { 
-            eline++; 
-            lbegin = in; /* Record line start position */
+            p->eline++; 
+            p->lbegin = in; /* Record line start position */
         } 
 
         in++;
@@ -242,20 +314,34 @@ static const char* skip(const char* in)
 }
 
 /**
- *  \brief create a null json object.
+ *  \brief create a null json object with an allocator.
+ *  \param[in] alloc: allocator of the json, its key and string, NULL the C library
  *  \return json handle or NULL fail
  */
-json_t json_create(void)
+static json_t json_new(const JSON_ALLOC* alloc)
 {
     json_t json;
 
     /* Allocate json structure space and initialize */
-    json = (json_t)malloc(sizeof(JSON));
-    if (json) memset(json, 0, sizeof(JSON));
+    json = (json_t)json_malloc(alloc, sizeof(JSON));
+    if (json)
+    {
+        memset(json, 0, sizeof(JSON));
+        json->alloc = alloc;
+    }
 
     return json;
 }
 
+/**
+ *  \brief create a null json object.
+ *  \return json handle or NULL fail
+ */
+json_t json_create(void)
+{
+    return json_new(NULL);
+}
+
 /**
  *  \brief delete the json entity and its sub-entities.
  *  \param[in] json: json handle
@@ -271,13 +357,13 @@ void json_delete(json_t json)
         /* For arrays or object types, recursively delete child json */
         if (json->type == JSON_TYPE_ARRAY || json->type == JSON_TYPE_OBJECT) json_delete(json->value.child_);
         /* String type, then free the string */
-        else if (json->type == JSON_TYPE_STRING) free(json->value.string_);
+        else if (json->type == JSON_TYPE_STRING && json->value.string_) json_free(json->alloc, json->value.string_);
 
         /* Free the key of json */
-        if (json->key) free(json->key);
+        if (json->key) json_free(json->alloc, json->key);
 
         /* Delete self */
-        free(json); 
+        json_free(json->alloc, json); 
 
         json = next;
     }
@@ -418,17 +504,19 @@ json_t json_set_key(json_t json, const char* key)
     /* The current key and the one to be set can be the same, and can be set successfully directly */
     if (json->key && (json->key == key || !strcmp(json->key, key))) return json;
 
+    json->dirty |= DIRTY_KEY;
+
     /* If the passed in key is not empty, duplicate a backup */
     if (key)
     {
-        k = json_strdup(key, strlen(key));
+        k = json_strdup(json->alloc, key, strlen(key));
         if (!k) return NULL;
     }
     /* Otherwise, clear the json key */
     else k = NULL;
 
     /* Release the old key to update the new one */
-    if (json->key) free(json->key);
+    if (json->key) json_free(json->alloc, json->key);
     json->key = k;
 
     return json;
@@ -443,8 +531,10 @@ json_t json_set_null(json_t json)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* delete string value */
-    if (json->type == JSON_TYPE_STRING) free(json->value.string_); 
+    if (json->type == JSON_TYPE_STRING && json->value.string_) json_free(json->alloc, json->value.string_); 
     /* delete child objects */
     else if (json->type == JSON_TYPE_ARRAY || json->type == JSON_TYPE_OBJECT) json_delete(json->value.child_); 
     
@@ -465,6 +555,8 @@ json_t json_set_bool(json_t json, int b)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_BOOL) json_set_null(json);
 
@@ -485,6 +577,8 @@ json_t json_set_int(json_t json, int num)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_INT || json->type != JSON_TYPE_FLOAT) json_set_null(json);
 
@@ -505,6 +599,8 @@ json_t json_set_float(json_t json, double num)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_INT || json->type != JSON_TYPE_FLOAT) json_set_null(json);
 
@@ -527,6 +623,8 @@ json_t json_set_string(json_t json, const char* string)
 
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_STRING) json_set_null(json);
 
@@ -539,14 +637,14 @@ json_t json_set_string(json_t json, const char* string)
     /* If the passed in string is not empty, duplicate a backup */
     if (string) 
     {
-        s = json_strdup(string, strlen(string));
+        s = json_strdup(json->alloc, string, strlen(string));
         if (!s) return NULL;
     }
     /* Otherwise, clear the json string */
     else s = NULL;
 
     /* Release the old string to update the new one */
-    if (json->value.string_) free(json->value.string_);
+    if (json->value.string_) json_free(json->alloc, json->value.string_);
     json->value.string_ = s;
 
     return json;
@@ -562,6 +660,8 @@ json_t json_set_object(json_t json, json_t object)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_OBJECT) json_set_null(json);
 
@@ -588,6 +688,8 @@ json_t json_set_array(json_t json, json_t array)
 {
     if (!json) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* If the current type does not match, set the type to null first */
     if (json->type != JSON_TYPE_ARRAY) json_set_null(json);
 
@@ -927,6 +1029,262 @@ json_t json_to_key_valist(json_t json, char* key, ...)
     return c;
 }
 
+/* path step types */
+#define STEP_KEY                            (0) /* child with the key */
+#define STEP_INDEX                          (1) /* child at the index */
+#define STEP_ALL                            (2) /* all children */
+
+/* path step define */
+typedef struct
+{
+    int type;                               /**< step type, @ref STEP_xxx */
+    int index;                              /**< index of STEP_INDEX */
+    const char* key;                        /**< lower case key of STEP_KEY */
+    unsigned int length;                    /**< length of key */
+} STEP;
+
+/* compiled path define */
+typedef struct JSON_PATH
+{
+    STEP* steps;                            /**< steps */
+    int count;                              /**< count of steps */
+} JSON_PATH;
+
+/* state of one query */
+typedef struct
+{
+    const JSON_PATH* path;                  /**< path */
+    json_path_match_t match;                /**< match callback */
+    void* context;                          /**< context of match callback */
+    int count;                              /**< count of matches */
+} QUERY;
+
+/**
+ *  \brief compile a path, to query json without parsing it again.
+ *         `$.cfg.items[*].name`, `$` is the json the query starts from and can be omitted,
+ *         `.key` or `["key"]` selects the child with the key, ignoring case like `json_get()`,
+ *         `[n]` selects the child at the index, `.*` or `[*]` selects all children.
+ *  \param[in] path: path
+ *  \return compiled path or NULL fail
+ */
+json_path_t json_path_compile(const char* path)
+{
+    JSON_PATH* p;
+    STEP* step;
+    const char* s;
+    char* keys;
+    char q;
+    int count = 0, bare = 0, i;
+    size_t len;
+
+    if (!path) return NULL;
+
+    /* Each step begins with `.` or `[`, or is the first key of a path without `$` */
+    for (s = path; *s; s++) if (*s == '.' || *s == '[') count++;
+    len = s - path;
+    count++;
+
+    p = (JSON_PATH*)malloc(sizeof(JSON_PATH) + count * sizeof(STEP) + len + 1);
+    if (!p) return NULL;
+    p->steps = (STEP*)(p + 1);
+    p->count = 0;
+    keys = (char*)(p->steps + count);
+
+    /* A path without `$` may begin with a key */
+    s = path;
+    if (*s == '$') s++;
+    else if (*s && *s != '.' && *s != '[') bare = 1;
+
+    while (*s)
+    {
+        step = &p->steps[p->count];
+
+        if (*s == '.' || bare)
+        {
+            if (!bare) s++;
+            bare = 0;
+            if (*s == '*')
+            {
+                step->type = STEP_ALL;
+                s++;
+            }
+            else
+            {
+                step->type = STEP_KEY;
+                step->key = keys;
+                for (len = 0; *s && *s != '.' && *s != '['; s++, len++) *keys++ = (char)tolower((unsigned char)*s);
+                if (len == 0) goto FAIL;
+                *keys++ = 0;
+                step->length = (unsigned int)len;
+            }
+        }
+        else if (*s == '[')
+        {
+            s++;
+            if (*s == '*')
+            {
+                step->type = STEP_ALL;
+                s++;
+            }
+            else if (*s == '\"' || *s == '\'')
+            {
+                /* Quoted key may have any characters but its quote */
+                q = *s++;
+                step->type = STEP_KEY;
+                step->key = keys;
+                for (len = 0; *s && *s != q; s++, len++) *keys++ = (char)tolower((unsigned char)*s);
+                if (*s++ != q) goto FAIL;
+                *keys++ = 0;
+                step->length = (unsigned int)len;
+            }
+            else
+            {
+                if (*s < '0' || *s > '9') goto FAIL;
+                for (i = 0; *s >= '0' && *s <= '9'; s++)
+                {
+                    if (i > (INT_MAX - 9) / 10) goto FAIL;
+                    i = i * 10 + (*s - '0');
+                }
+                step->type = STEP_INDEX;
+                step->index = i;
+            }
+            if (*s++ != ']') goto FAIL;
+        }
+        else goto FAIL;
+
+        p->count++;
+    }
+
+    return p;
+
+FAIL:
+    free(p);
+    return NULL;
+}
+
+/**
+ *  \brief delete a compiled path.
+ *  \param[in] path: compiled path
+ *  \return none
+ */
+void json_path_delete(json_path_t path)
+{
+    if (path) free(path);
+}
+
+/**
+ *  \brief Check whether a key equals the lower case key of a path step, ignoring case.
+ *  \param[in] key: key, can be NULL
+ *  \param[in] step: step with key
+ *  \return 1 equal or 0 not
+ */
+static int step_key(const char* key, const STEP* step)
+{
+    unsigned int i;
+
+    if (!key) return 0;
+
+    for (i = 0; i < step->length; i++)
+    {
+        if (tolower((unsigned char)key[i]) != (unsigned char)step->key[i]) return 0;
+    }
+
+    return key[i] == 0;
+}
+
+/**
+ *  \brief Query the children of a json matched by a step.
+ *  \param[in] q: query
+ *  \param[in] json: matched json
+ *  \param[in] step: index of the next step
+ *  \return 1 go on or 0 stop
+ */
+static int query_json(QUERY* q, json_t json, int step)
+{
+    const STEP* s;
+    json_t c;
+    int i;
+
+    if (step == q->path->count)
+    {
+        q->count++;
+        return q->match ? q->match(q->context, json) : 1;
+    }
+
+    /* Only array and object have child objects */
+    if (json->type != JSON_TYPE_ARRAY && json->type != JSON_TYPE_OBJECT) return 1;
+
+    s = &q->path->steps[step];
+    c = json->value.child_;
+
+    if (s->type == STEP_KEY)
+    {
+        /* The first child with the key, like `json_get()` */
+        if (json->type != JSON_TYPE_OBJECT) return 1;
+        while (c && !step_key(c->key, s)) c = c->next;
+        return c ? query_json(q, c, step + 1) : 1;
+    }
+
+    if (s->type == STEP_INDEX)
+    {
+        for (i = s->index; c && i > 0; i--) c = c->next;
+        return c ? query_json(q, c, step + 1) : 1;
+    }
+
+    for (; c; c = c->next)
+    {
+        if (!query_json(q, c, step + 1)) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief query json with a compiled path, the matches are reported in document order.
+ *  \param[in] json: json handle the query starts from
+ *  \param[in] path: compiled path
+ *  \param[in] match: callback of each match, returns 0 to stop, can be NULL to count only
+ *  \param[in] context: context of match callback
+ *  \return count of matches, negative fail
+ */
+int json_path_query(json_t json, json_path_t path, json_path_match_t match, void* context)
+{
+    QUERY q;
+
+    if (!json || !path) return -1;
+
+    q.path = path;
+    q.match = match;
+    q.context = context;
+    q.count = 0;
+
+    query_json(&q, json, 0);
+
+    return q.count;
+}
+
+/**
+ *  \brief Keep the first match of a query and stop.
+ */
+static int query_first(void* context, json_t json)
+{
+    *(json_t*)context = json;
+    return 0;
+}
+
+/**
+ *  \brief get the first json matched by a compiled path.
+ *  \param[in] json: json handle the query starts from
+ *  \param[in] path: compiled path
+ *  \return matched json or NULL
+ */
+json_t json_path_get(json_t json, json_path_t path)
+{
+    json_t out = NULL;
+    json_path_query(json, path, query_first, &out);
+    return out;
+}
+
 /**
  *  \brief insert a json object inito json by index.
  *  \param[in] json: json handle
@@ -946,6 +1304,8 @@ json_t json_attach(json_t json, int index, json_t ins)
     /* Check if the `ins` has a key and determine if it matches the type of `json` */
     if (!(json->type == JSON_TYPE_ARRAY && !ins->key) && !(json->type == JSON_TYPE_OBJECT && ins->key)) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* Traverse and iterate to the specified index */
     c = json->value.child_;
     while (c && index > 0)
@@ -986,6 +1346,8 @@ json_t json_detach(json_t json, const char* key, int index)
     c = json_get_child(json, key, index, &prev);
     if (!c) return NULL;
 
+    json->dirty |= DIRTY_VALUE;
+
     /* Detach `c` from the child linked list */
     if (prev) prev->next = c->next;
     if (c == json->value.child_) json->value.child_ = c->next;
@@ -1014,11 +1376,13 @@ json_t json_copy(json_t json)
 
     copy->type = json->type;
     copy->value = json->value;
+    /* The children are copied below, never shared with the original */
+    if (json->type == JSON_TYPE_OBJECT || json->type == JSON_TYPE_ARRAY) copy->value.child_ = NULL;
 
     /* If it is a string type, copy the string */
     if (json->type == JSON_TYPE_STRING && json->value.string_)
     {
-        copy->value.string_ = json_strdup(json->value.string_, strlen(json->value.string_));
+        copy->value.string_ = json_strdup(NULL, json->value.string_, strlen(json->value.string_));
         if (!copy->value.string_) 
         { 
             json_delete(copy); 
@@ -1029,7 +1393,7 @@ json_t json_copy(json_t json)
     /* If there is a key, copy the key */
     if (json->key)
     {
-        copy->key = json_strdup(json->key, strlen(json->key));
+        copy->key = json_strdup(NULL, json->key, strlen(json->key));
         if (!copy->key) 
         { 
             json_delete(copy); 
@@ -1079,17 +1443,15 @@ json_t json_copy(json_t json)
  *
  *  \return Returns a pointer to the next character after the parsed number in the string, or NULL if there was an error in parsing the number
  */
-static const char* parse_number(json_t json, const char* text)
+static const char* parse_number(PARSER* p, json_t json, const char* text)
 {
+    const char* begin = text;           /* Beginning of number text */
     double number = 0;                  /* Converted number */
-    int sign = 1, scale = 0;            /* Sign and scale of integer part */
-    int e_sign = 1, e_scale = 0;        /* Sign and scale of exponent part */
     int isint = 1;                      /* Flag for whether there is only an integer part within a string */
 
     /* First, check if there is a negative number with `-` before it */
     if (*text == '-')
     {
-        sign = -1;
         text++;
 
         /* Check if the first character is a valid number */
@@ -1100,17 +1462,8 @@ static const char* parse_number(json_t json, const char* text)
         }
     }
 
-    /* Skip invalid `0` in the previous section */
-    while (*text == '0') text++;
-    
     /* Integer part */
-    if (*text >= '1' && *text <= '9')
-    {
-        do
-        {
-            number = (number * 10.0) + (*text++ - '0'); /* carry addition */
-        } while (*text >= '0' && *text <= '9');
-    }
+    while (*text >= '0' && *text <= '9') text++;
 
     /* Decimal part */
     if (*text == '.')
@@ -1124,12 +1477,7 @@ static const char* parse_number(json_t json, const char* text)
             return NULL; 
         }
 
-        /* The number of decimal parts is also increased by 10 times first, and then reduced according to the scale later on */
-        do
-        {
-            number = (number * 10.0) + (*text++ - '0');
-            scale--;
-        } while (*text >= '0' && *text <= '9');
+        while (*text >= '0' && *text <= '9') text++;
 
         /* Decimal part present, marked as non integer */
         isint = 0;
@@ -1140,14 +1488,8 @@ static const char* parse_number(json_t json, const char* text)
     {
         text++;
 
-        /* Symbol `+` skip */
-        if (*text == '+') text++;
-        /* Symbol `-` with sign */
-        else if (*text == '-')
-        {
-            e_sign = -1;
-            text++;
-        }
+        /* Symbol `+` or `-` skip */
+        if (*text == '+' || *text == '-') text++;
 
         /* Check if the first character is a valid number */
         if (!(*text >= '0' && *text <= '9')) 
@@ -1156,18 +1498,14 @@ static const char* parse_number(json_t json, const char* text)
             return NULL; 
         }
 
-        /* Conversion exponent part */
-        while (*text >= '0' && *text <= '9') 
-        { 
-            e_scale = (e_scale * 10) + (*text++ - '0'); /* number */
-        }
+        while (*text >= '0' && *text <= '9') text++;
 
         /* Exponent part present, marked as non integer */
         isint = 0;
     }
 
-    /* Calculated conversion result */
-    number = (double)sign * number * pow(10.0, (scale + e_scale * e_sign));
+    /* The grammar has been checked, convert the whole number at once */
+    number = fpconv_strntod(begin, text - begin, NULL);
 
     /* As an integer and within the scope of an integer */
     if (isint && INT_MIN <= number && number <= INT_MAX) 
@@ -1191,7 +1529,7 @@ static const char* parse_number(json_t json, const char* text)
  *  \param[out] buf: the address used to receive the parsed string pointer
  *  \return the new address of the transformed text
  */
-static const char* parse_string_buffer(char** buf, const char* text)
+static const char* parse_string_buffer(PARSER* p, char** buf, const char* text)
 {
     const char* ptr = text + 1;
     char* ptr2;
@@ -1210,12 +1548,12 @@ static const char* parse_string_buffer(char** buf, const char* text)
     /* Get the length of the string */
     while (*ptr && *ptr != '\"')
     {
-        if (*ptr++ == '\\') ptr++; /* skip escaped quotes. */
+        if (*ptr++ == '\\' && *ptr) ptr++; /* skip escaped quotes. */
         len++;
     }
 
     /* Allocate storage space based on the calculated string length */
-    out = (char*)malloc(len + 1);
+    out = (char*)json_malloc(p->alloc, len + 1);
     if (!out) 
     {
         E(JSON_E_MEMORY);
@@ -1233,6 +1571,7 @@ static const char* parse_string_buffer(char** buf, const char* text)
         else 
         {
             ptr++;
+            if (!*ptr) break; /* the text ends right after the backslash */
             if (*ptr == 'b') { *ptr2++ = '\b'; }
             else if (*ptr == 'f') { *ptr2++ = '\f'; }
             else if (*ptr == 'n') { *ptr2++ = '\n'; }
@@ -1258,11 +1597,11 @@ static const char* parse_string_buffer(char** buf, const char* text)
  *  \param[in] text: string text
  *  \return the new address of the transformed text
  */
-static const char* parse_string(json_t json, const char* text)
+static const char* parse_string(PARSER* p, json_t json, const char* text)
 {
     json->value.string_ = NULL;
     json->type = JSON_TYPE_STRING;
-    return parse_string_buffer(&(json->value.string_), text);
+    return parse_string_buffer(p, &(json->value.string_), text);
 }
 
 /**
@@ -1273,7 +1612,7 @@ static const char* parse_string(json_t json, const char* text)
  *
  *  \return Returns a pointer to the next character after the parsed array in the string, or NULL if there was an error in parsing the array
  */
-static const char* parse_array(json_t json, const char* text)
+static const char* parse_array(PARSER* p, json_t json, const char* text)
 {
     json_t child, prev = NULL;
 
@@ -1288,7 +1627,7 @@ static const char* parse_array(json_t json, const char* text)
     json->type = JSON_TYPE_ARRAY;
 
     /* Skip useless characters */
-    text = skip(text + 1);
+    text = skip(p, text + 1);
 
     /* Encountered `]`, indicating that it is an empty array, return directly */
     if (*text == ']') return text + 1;
@@ -1300,7 +1639,7 @@ static const char* parse_array(json_t json, const char* text)
         if (prev) text++; 
 
         /* Create json objects as array member */
-        child = json_create();
+        child = json_new(p->alloc);
         if (!child) 
         { 
             E(JSON_E_MEMORY); 
@@ -1308,7 +1647,7 @@ static const char* parse_array(json_t json, const char* text)
         }
 
         /* skip meaningless character parsing. */
-        text = skip(parse_text(child, skip(text))); 
+        text = skip(p, parse_text(p, child, skip(p, text))); 
         /* parse_text has already logged the error message */
         if (!text) 
         {
@@ -1343,7 +1682,7 @@ static const char* parse_array(json_t json, const char* text)
  *
  *  \return Returns a pointer to the next character after the parsed object in the string, or NULL if there was an error in parsing the object
  */
-static const char* parse_object(json_t json, const char* text)
+static const char* parse_object(PARSER* p, json_t json, const char* text)
 {
     char* key = NULL;
     json_t child, prev = NULL;
@@ -1359,7 +1698,7 @@ static const char* parse_object(json_t json, const char* text)
     json->type = JSON_TYPE_OBJECT;
 
     /* Skip useless characters */
-    text = skip(text + 1);
+    text = skip(p, text + 1);
 
     /* Encountered `}`, indicating that it is an empty object, return directly */
     if (*text == '}') return text + 1;
@@ -1371,10 +1710,10 @@ static const char* parse_object(json_t json, const char* text)
         if (prev) text++;
 
         /* First, parse the key section */
-        text = skip(parse_string_buffer(&key, skip(text)));
+        text = skip(p, parse_string_buffer(p, &key, skip(p, text)));
         if (!text)
         {
-            if (key) free(key);
+            if (key) json_free(p->alloc, key);
             E(JSON_E_VALUE);
             return NULL;
         }
@@ -1382,25 +1721,26 @@ static const char* parse_object(json_t json, const char* text)
         /* Not the correct key-value delimiter */
         if (*text != ':') /* fail! */
         {
-            if (key) free(key);
+            if (key) json_free(p->alloc, key);
             E(JSON_E_KEY);
             return NULL;
         }
 
         /* Create json objects as object member */
-        child = json_create();
+        child = json_new(p->alloc);
         if (!child) 
         { 
+            json_free(p->alloc, key);
             E(JSON_E_MEMORY); 
             return NULL; 
         }
 
         /* skip any spacing, get the text. */
-        text = skip(parse_text(child, skip(text + 1)));
+        text = skip(p, parse_text(p, child, skip(p, text + 1)));
         /* parse_text has already logged the error message */
         if (!text) 
         {
-            if (key) free(key);
+            if (key) json_free(p->alloc, key);
             if (child) json_delete(child);
             return NULL;
         }
@@ -1431,7 +1771,7 @@ static const char* parse_object(json_t json, const char* text)
  *
  *  \return Returns a pointer to the next character after the parsed value in the string, or NULL if there was an error in parsing the value
  */
-static const char* parse_text(json_t json, const char* text)
+static const char* parse_value(PARSER* p, json_t json, const char* text)
 {
     if (!strncmp(text, "null", 4))
     {
@@ -1450,14 +1790,48 @@ static const char* parse_text(json_t json, const char* text)
         json->value.bool_ = JSON_TRUE;
         return text + 4;
     }
-    if (*text == '-' || (*text >= '0' && *text <= '9')) return parse_number(json, text);
-    if (*text == '\"') return parse_string(json, text);
-    if (*text == '[') return parse_array(json, text);
-    if (*text == '{') return parse_object(json, text);
+    if (*text == '-' || (*text >= '0' && *text <= '9')) return parse_number(p, json, text);
+    if (*text == '\"') return parse_string(p, json, text);
+    if (*text == '[' || *text == '{')
+    {
+        /* Limit the nesting depth of arrays and objects */
+        if (p->depth_max > 0 && p->depth >= p->depth_max)
+        {
+            E(JSON_E_DEPTH);
+            return NULL;
+        }
+
+        p->depth++;
+        text = (*text == '[') ? parse_array(p, json, text) : parse_object(p, json, text);
+        p->depth--;
+
+        return text;
+    }
     E(JSON_E_INVALID);
     return NULL;
 }
 
+/**
+ *  \brief Parse a json value in a json string, and record where its text is.
+ *
+ *  \param[in,out] json The json object to store the parsed value
+ *  \param[in] text The input string containing the value
+ *
+ *  \return Returns a pointer to the next character after the parsed value in the string, or NULL if there was an error in parsing the value
+ */
+static const char* parse_text(PARSER* p, json_t json, const char* text)
+{
+    const char* end;
+
+    end = parse_value(p, json, text);
+    if (!end) return NULL;
+
+    json->offset = text - p->base;
+    json->span = end - text;
+
+    return end;
+}
+
 /**
  *  \brief convert numbers in json to text and append to buf.
  *  \param[in] json: json handle
@@ -1466,41 +1840,37 @@ static const char* parse_text(json_t json, const char* text)
  */
 static int print_number(json_t json, BUFFER* buf)
 {
-    double num = json->value.float_;
+    double number;
     int len = 0;
 
-    /* Number is 0 */
-    if (num == 0)
-    {
-        if (!buf_append(1)) return 0;
-        buf_putc('0');
-    }
+    if (!buf_append(FPCONV_BUFFER_SIZE)) return 0;
+
     /* The number type is an integer type */
-    else if (json->type == JSON_TYPE_INT)
-    {
-        if (!buf_append(20)) return 0;
-        len = sprintf(&buf_end(), "%d", (int)json->value.int_);
-        buf->end += len;
-    }
-    /* The number type is a floating point type */
+    if (json->type == JSON_TYPE_INT) len = fpconv_itoa(json->value.int_, &buf_end());
+    /* The number type is a floating point type, use the shortest text that reads back the same value */
     else if (json->type == JSON_TYPE_FLOAT)
     {
-        if (!buf_append(64)) return 0;
-        /* use full transformation within bounded space */
-        if (fabs(floor(num) - num) <= DBL_EPSILON && fabs(num) < 1.0e60) len = sprintf(&buf_end(), "%.1lf", num);
-        /* use exponential form conversion beyond the limited range */
-        else if (fabs(num) < 1.0e-6 || fabs(num) > 1.0e9) len = sprintf(&buf_end(), "%e", num);
-        /* default conversion */
-        else
+        number = json->value.float_;
+
+        /* There is no nan in json, it is written as null */
+        if (number != number)
         {
-            len = sprintf(&buf_end(), "%lf", num);
-            while (len > 0 && (&buf_end())[len-1] == '0' && (&buf_end())[len-2] != '.') len--; /* remove the invalid 0 in the decimal part */
+            memcpy(&buf_end(), "null", 4);
+            len = 4;
         }
-        buf->end += len;
+        /* There is no infinity in json, it is written as a number out of range, which reads back as infinity */
+        else if (number - number != 0)
+        {
+            memcpy(&buf_end(), number < 0 ? "-1e999" : "1e999", number < 0 ? 6 : 5);
+            len = number < 0 ? 6 : 5;
+        }
+        else len = fpconv_dtoa(number, &buf_end());
     }
     /* Not of number type */
     else return 0;
 
+    buf->end += len;
+
     return 1;
 }
 
@@ -1754,7 +2124,7 @@ static int print_object(json_t json, BUFFER* buf, int depth, int format)
  *
  *  \return Returns 1 if the printing is successful, 0 otherwise
  */
-static int print_json(json_t json, BUFFER* buf, int depth, int format)
+static int print_value(json_t json, BUFFER* buf, int depth, int format)
 {
     switch (json->type)
     {
@@ -1800,6 +2170,32 @@ static int print_json(json_t json, BUFFER* buf, int depth, int format)
     return 1;
 }
 
+/**
+ * \brief Print a json value to a buffer, and record where it is printed when tracking.
+ *
+ * \param[in] json The json value to print
+ * \param[in] buf The buffer to print the json value to
+ * \param[in] depth The current depth of the json value (used for pretty printing)
+ * \param[in] format The formatting option (compact or indented)
+ *
+ * \return Returns 1 if the printing is successful, 0 otherwise
+ */
+static int print_json(json_t json, BUFFER* buf, int depth, int format)
+{
+    unsigned int start = buf->end;
+
+    if (!print_value(json, buf, depth, format)) return 0;
+
+    if (buf->track)
+    {
+        json->offset = buf->origin + start;
+        json->span = buf->end - start;
+        json->dirty = 0;
+    }
+
+    return 1;
+}
+
 /**
  *  \brief convert json to text, using a buffered strategy.
  *  \param[in] json: json handle
@@ -1820,6 +2216,8 @@ char* json_dumps(json_t json, int preset, int unformat, int* len)
     if (!p.address) return NULL;
     p.size = preset;
     p.end = 0;
+    p.track = 0;
+    p.origin = 0;
 
     /* Start printing json */
     if (!print_json(json, &p, 0, !unformat)) 
@@ -1881,47 +2279,265 @@ int json_file_dump(json_t json, char* filename)
 }
 
 /**
- *  \brief json text parser.
+ *  \brief save json into a file atomically, the file is replaced as a whole by a temporary file.
+ *  \param[in] json: json handle
+ *  \param[in] filename: file name
+ *  \return file length or negative fail
+ */
+int json_file_save(json_t json, const char* filename)
+{
+    BUFFER p, *buf = &p;
+
+    if (!json) return -1;
+    if (!filename) return -1;
+
+    /* Allocate buffer and initialize */
+    p.address = (char*)malloc(1);
+    if (!p.address) return -1;
+    p.size = 1;
+    p.end = 0;
+    p.track = 1;
+    p.origin = 0;
+
+    /* Print json and record where the values are in the file */
+    if (!print_json(json, buf, 0, 1) || fsave_atomic(filename, p.address, p.end) != FSAVE_E_OK)
+    {
+        json->span = 0;
+        free(p.address);
+        return -1;
+    }
+    json->check = fsave_check(p.address, p.end);
+    free(p.address);
+
+    return p.end;
+}
+
+/* patches of json being collected */
+typedef struct
+{
+    BUFFER buf;                             /**< contents of the patches, back to back */
+    FSAVE_PATCH* patches;                   /**< patches */
+    int count;                              /**< count of patches */
+    int capacity;                           /**< capacity of patches */
+} PATCHER;
+
+/**
+ *  \brief Print a changed json value compactly over its old text, padded with spaces.
+ *  \param[in] json: json handle
+ *  \param[in] pt: patcher
+ *  \return 1 success or 0 the value does not fit
+ */
+static int patch_region(json_t json, PATCHER* pt)
+{
+    BUFFER* buf = &pt->buf;
+    FSAVE_PATCH* patches;
+    unsigned int start = buf->end;
+    int span = json->span;
+    int capacity;
+
+    if (span <= 0) return 0;
+
+    /* The values inside are recorded at their new offsets */
+    buf->origin = (long)json->offset - (long)start;
+    if (!print_json(json, buf, 0, 0)) return 0;
+    if (buf->end - start > (unsigned int)span) return 0;
+
+    if (!buf_append(span - (buf->end - start))) return 0;
+    memset(buf->address + buf->end, ' ', span - (buf->end - start));
+    buf->end = start + span;
+
+    /* The old text remains the room for later changes */
+    json->span = span;
+
+    if (pt->count == pt->capacity)
+    {
+        capacity = pt->capacity ? pt->capacity * 2 : 8;
+        patches = (FSAVE_PATCH*)realloc(pt->patches, capacity * sizeof(FSAVE_PATCH));
+        if (!patches) return 0;
+        pt->patches = patches;
+        pt->capacity = capacity;
+    }
+
+    /* The contents are located after collecting, as the buffer may move */
+    pt->patches[pt->count].offset = json->offset;
+    pt->patches[pt->count].data = NULL;
+    pt->patches[pt->count].size = span;
+    pt->count++;
+
+    return 1;
+}
+
+/**
+ *  \brief Collect the patches of the changes under a json value.
+ *  \param[in] json: json handle
+ *  \param[in] pt: patcher
+ *  \return 1 success or 0 a change does not fit
+ */
+static int patch_json(json_t json, PATCHER* pt)
+{
+    json_t child;
+
+    if (json->dirty & DIRTY_VALUE) return patch_region(json, pt);
+    if (json->type != JSON_TYPE_ARRAY && json->type != JSON_TYPE_OBJECT) return 1;
+
+    /* A changed key is printed by the parent */
+    for (child = json->value.child_; child; child = child->next)
+    {
+        if (child->dirty & DIRTY_KEY) return patch_region(json, pt);
+    }
+
+    for (child = json->value.child_; child; child = child->next)
+    {
+        if (!patch_json(child, pt)) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ *  \brief save the changes of json into the file it was loaded from or last saved to.
+ *         Each changed value is printed compactly over its old text and padded with spaces when it fits,
+ *         otherwise the file is saved as a whole by `json_file_save()`.
+ *  \param[in] json: json handle, the root
+ *  \param[in] filename: file name
+ *  \return number of bytes written, 0 nothing changed, or negative fail
+ */
+int json_file_patch(json_t json, const char* filename)
+{
+    PATCHER pt;
+    unsigned long total = 0;
+    int i, error;
+
+    if (!json) return -1;
+    if (!filename) return -1;
+
+    /* The root spans the whole file */
+    if (json->offset != 0 || json->span <= 0 || (json->dirty & DIRTY_VALUE)) return json_file_save(json, filename);
+    json->dirty = 0;
+
+    pt.buf.address = (char*)malloc(1);
+    if (!pt.buf.address) return -1;
+    pt.buf.size = 1;
+    pt.buf.end = 0;
+    pt.buf.track = 1;
+    pt.buf.origin = 0;
+    pt.patches = NULL;
+    pt.count = 0;
+    pt.capacity = 0;
+
+    if (!patch_json(json, &pt))
+    {
+        free(pt.buf.address);
+        if (pt.patches) free(pt.patches);
+        return json_file_save(json, filename);
+    }
+
+    for (i = 0; i < pt.count; i++)
+    {
+        pt.patches[i].data = pt.buf.address + total;
+        total += pt.patches[i].size;
+    }
+
+    error = (pt.count > 0) ? fsave_patch(filename, &json->check, pt.patches, pt.count) : FSAVE_E_OK;
+
+    free(pt.buf.address);
+    if (pt.patches) free(pt.patches);
+
+    /* Not the file the offsets refer to, save it as a whole */
+    if (error == FSAVE_E_CHANGED) return json_file_save(json, filename);
+
+    /* The file may have a part of the patches, the offsets are no longer trusted */
+    if (error != FSAVE_E_OK)
+    {
+        json->span = 0;
+        return -1;
+    }
+
+    return total;
+}
+
+/**
+ *  \brief json text parser, the error information is kept in the context, so it can be called on several threads at once.
  *  \param[in] text: address of text
- *  \return the address of the next meaningful character
+ *  \param[in,out] ctx: parse context, `alloc` and `depth` are input and the error information is output, can be NULL
+ *  \return json handle or NULL fail
  */
-json_t json_loads(const char* text)
+json_t json_loads_ex(const char* text, JSON_CTX* ctx)
 {
+    PARSER parser, *p = &parser;
     json_t json = NULL;
 
     /* reset error info */
-    lbegin = text;
-    eline = 1;
-    etype = JSON_E_OK;
+    parser.base = text;
+    parser.lbegin = text;
+    parser.eline = 1;
+    parser.ecolumn = 0;
+    parser.etype = JSON_E_OK;
+    parser.depth = 0;
+    parser.depth_max = ctx ? ctx->depth : 0;
+    parser.alloc = ctx ? ctx->alloc : NULL;
+
+    if (!text)
+    {
+        p->etype = JSON_E_INVALID;
+        goto END;
+    }
 
     /* create json object and parse */
-    json = json_create();
+    json = json_new(parser.alloc);
     if (!json) 
     { 
         E(JSON_E_MEMORY); 
-        return NULL;
+        goto END;
     }
 
-    text = parse_text(json, skip(text));
+    text = parse_text(p, json, skip(p, text));
     /* parse failure. error is set. */
     if (!text) 
     { 
         json_delete(json); 
-        return NULL; 
+        json = NULL;
+        goto END;
     }
 
     /* check whether there are meaningless characters after the text after parsing */
-    text = skip(text);
+    text = skip(p, text);
     if (*text) 
     { 
         json_delete(json); 
+        json = NULL;
         E(JSON_E_END); 
-        return NULL; 
+        goto END;
+    }
+
+    /* The root spans the whole text, and the check value of the text tells the file the offsets refer to */
+    json->offset = 0;
+    json->span = text - parser.base;
+    json->check = fsave_check(parser.base, text - parser.base);
+
+END:
+    /* output error info */
+    if (ctx)
+    {
+        ctx->type = parser.etype;
+        ctx->line = parser.eline;
+        ctx->column = parser.ecolumn;
     }
 
     return json;
 }
 
+/**
+ *  \brief json text parser.
+ *  \param[in] text: address of text
+ *  \return json handle or NULL fail, use `json_error_info()` to locate the error
+ */
+json_t json_loads(const char* text)
+{
+    ectx.depth = 0;
+    return json_loads_ex(text, &ectx);
+}
+
 /**
  *  \brief load a json file, parse and generate json objects.
  *  \param[in] filename: file name
@@ -1929,42 +2545,331 @@ json_t json_loads(const char* text)
  */
 json_t json_file_load(char* filename)
 {
-    FILE* f;
     json_t json = NULL;
-    long len;
-    char* data;
+    FMAP map;
 
-    /* Open file */
-    f = fopen(filename, "rb");
-    if (!f) return NULL;
+    /* Map file, the content is parsed in place without copying */
+    if (fmap_open(&map, filename) != FMAP_E_OK) return NULL;
 
-    /* Get the length of file */
-    fseek(f, 0, SEEK_END);
-    len = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    /* Load json string */
+    json = json_loads(map.data);
 
-    /* read file */
-    data = (char*)malloc(len + 1);
-    if (data) 
-    { 
-        /* Read the file content into `data` */
-        fread(data, 1, len, f); 
-        fclose(f); 
+    /* Release the mapping, the text read is not valid when the file was truncated while loading */
+    if (fmap_close(&map) != FMAP_E_OK && json)
+    {
+        json_delete(json);
+        json = NULL;
     }
-    else 
-    { 
-        fclose(f); 
-        return NULL; 
+
+    return json;
+}
+
+/**
+ *  \brief convert json to cbor and append to buf.
+ *  \param[in] json: json handle
+ *  \param[in] buf: buf handle
+ *  \param[in] depth: current nesting depth, deeper than `CBOR_DEPTH_MAX` fails as `json_cbor_loads()` would
+ *  \return 1 success or 0 fail
+ */
+static int print_cbor(json_t json, BUFFER* buf, int depth)
+{
+    json_t c;
+    int len;
+
+    if (depth > CBOR_DEPTH_MAX) return 0;
+
+    /* Each head, number or simple value takes at most `CBOR_HEAD_MAX` bytes */
+    if (!buf_append(CBOR_HEAD_MAX)) return 0;
+
+    switch (json->type)
+    {
+    case JSON_TYPE_NULL: buf_putc((char)0xF6); break;
+    case JSON_TYPE_BOOL: buf_putc((char)(json->value.bool_ ? 0xF5 : 0xF4)); break;
+    case JSON_TYPE_INT:
+    {
+        if (json->value.int_ >= 0) buf->end += cbor_put_head((unsigned char*)&buf_end(), CBOR_MAJOR_UINT, (unsigned int)json->value.int_);
+        else buf->end += cbor_put_head((unsigned char*)&buf_end(), CBOR_MAJOR_NINT, (unsigned int)(-1 - json->value.int_));
+        break;
+    }
+    case JSON_TYPE_FLOAT: buf->end += cbor_put_float((unsigned char*)&buf_end(), json->value.float_); break;
+    case JSON_TYPE_STRING:
+    {
+        len = json->value.string_ ? strlen(json->value.string_) : 0;
+        buf->end += cbor_put_head((unsigned char*)&buf_end(), CBOR_MAJOR_TEXT, len);
+        if (!buf_append(len)) return 0;
+        memcpy(&buf_end(), json->value.string_, len);
+        buf->end += len;
+        break;
     }
+    case JSON_TYPE_ARRAY:
+    case JSON_TYPE_OBJECT:
+    {
+        buf->end += cbor_put_head((unsigned char*)&buf_end(), json->type == JSON_TYPE_ARRAY ? CBOR_MAJOR_ARRAY : CBOR_MAJOR_MAP, json_size(json));
 
-    /* Add string terminator */
-    data[len] = 0;
+        for (c = json->value.child_; c; c = c->next)
+        {
+            /* Object members are key and value pairs */
+            if (json->type == JSON_TYPE_OBJECT)
+            {
+                len = c->key ? strlen(c->key) : 0;
+                if (!buf_append(CBOR_HEAD_MAX + len)) return 0;
+                buf->end += cbor_put_head((unsigned char*)&buf_end(), CBOR_MAJOR_TEXT, len);
+                memcpy(&buf_end(), c->key, len);
+                buf->end += len;
+            }
 
-    /* Load json string */
-    json = json_loads(data);
+            if (!print_cbor(c, buf, depth + 1)) return 0;
+        }
+        break;
+    }
+    default: buf_putc((char)0xF6); break; /* unknown type as null */
+    }
+
+    return 1;
+}
 
-    /* Free up space */
-    free(data);
+/**
+ *  \brief convert json to cbor (RFC 8949), the binary form is usually less than half of the text.
+ *         Nesting deeper than `CBOR_DEPTH_MAX` fails, so every cbor dumped can be loaded back.
+ *  \param[in] json: json handle
+ *  \param[in] preset: preset is a guess at the final size, guessing well reduces reallocation
+ *  \param[out] len: address that receives the length of cbor data
+ *  \return address of cbor data, free it when finished
+ */
+void* json_cbor_dumps(json_t json, int preset, int* len)
+{
+    BUFFER p;
+
+    if (!json) return NULL;
+
+    /* Allocate buffer and initialize */
+    if (preset < 1) preset = 1;
+    p.address = (char*)malloc(preset);
+    if (!p.address) return NULL;
+    p.size = preset;
+    p.end = 0;
+    p.track = 0;
+    p.origin = 0;
+
+    /* Start converting json */
+    if (!print_cbor(json, &p, 1))
+    {
+        free(p.address);
+        return NULL;
+    }
+
+    /* Output conversion length */
+    if (len) *len = p.end;
+
+    return p.address;
+}
+
+/**
+ *  \brief read a whole cbor string, chunks of indefinite length strings are joined.
+ *  \param[in] reader: cbor reader
+ *  \param[in] item: string item that has been read
+ *  \param[out] out: address that receives the allocated string
+ *  \return error type
+ */
+static int parse_cbor_string(CBOR_READER* reader, CBOR_ITEM* item, char** out)
+{
+    CBOR_ITEM chunk;
+    char* s;
+    char* temp;
+    unsigned int len = 0;
+    int error;
+
+    /* Definite length string is copied directly */
+    if (item->value.s.len != CBOR_INDEFINITE)
+    {
+        *out = json_strdup(NULL, item->value.s.data, item->value.s.len);
+        return *out ? JSON_E_OK : JSON_E_MEMORY;
+    }
+
+    s = json_strdup(NULL, "", 0);
+    if (!s) return JSON_E_MEMORY;
+
+    while (1)
+    {
+        error = cbor_read(reader, &chunk);
+        if (error || (chunk.type != CBOR_T_BREAK && (chunk.type != item->type || chunk.value.s.len == CBOR_INDEFINITE)))
+        {
+            free(s);
+            return JSON_E_VALUE;
+        }
+        if (chunk.type == CBOR_T_BREAK) break;
+
+        temp = (char*)realloc(s, len + chunk.value.s.len + 1);
+        if (!temp)
+        {
+            free(s);
+            return JSON_E_MEMORY;
+        }
+        s = temp;
+        memcpy(s + len, chunk.value.s.data, chunk.value.s.len);
+        len += chunk.value.s.len;
+        s[len] = '\0';
+    }
+
+    *out = s;
+
+    return JSON_E_OK;
+}
+
+/**
+ *  \brief parse one cbor item and fill the result into json.
+ *  \param[in,out] json: json handle
+ *  \param[in] reader: cbor reader
+ *  \param[in] depth: current nesting depth
+ *  \return error type
+ */
+static int parse_cbor(json_t json, CBOR_READER* reader, int depth)
+{
+    CBOR_ITEM item, key;
+    json_t child, prev = NULL;
+    unsigned int i;
+    int error;
+
+    if (depth > CBOR_DEPTH_MAX) return JSON_E_INVALID;
+
+    /* Tags are skipped, the tagged item is kept */
+    do {
+        if (cbor_read(reader, &item)) return JSON_E_INVALID;
+    } while (item.type == CBOR_T_TAG);
+
+    switch (item.type)
+    {
+    case CBOR_T_NULL:
+    case CBOR_T_SIMPLE: json->type = JSON_TYPE_NULL; break;
+    case CBOR_T_BOOL:
+    {
+        json->type = JSON_TYPE_BOOL;
+        json->value.bool_ = item.value.b ? JSON_TRUE : JSON_FALSE;
+        break;
+    }
+    case CBOR_T_INT:
+    {
+        /* Integers out of int range are kept as float, the same as parsing text */
+        if (item.value.i >= INT_MIN && item.value.i <= INT_MAX)
+        {
+            json->type = JSON_TYPE_INT;
+            json->value.int_ = (int)item.value.i;
+        }
+        else
+        {
+            json->type = JSON_TYPE_FLOAT;
+            json->value.float_ = (double)item.value.i;
+        }
+        break;
+    }
+    case CBOR_T_UINT:
+    {
+        json->type = JSON_TYPE_FLOAT;
+        json->value.float_ = (double)item.value.u;
+        break;
+    }
+    case CBOR_T_FLOAT:
+    {
+        json->type = JSON_TYPE_FLOAT;
+        json->value.float_ = item.value.f;
+        break;
+    }
+    case CBOR_T_STRING:
+    case CBOR_T_BYTES:
+    {
+        json->type = JSON_TYPE_STRING;
+        json->value.string_ = NULL;
+        return parse_cbor_string(reader, &item, &json->value.string_);
+    }
+    case CBOR_T_ARRAY:
+    case CBOR_T_MAP:
+    {
+        json->type = (item.type == CBOR_T_ARRAY) ? JSON_TYPE_ARRAY : JSON_TYPE_OBJECT;
+        json->value.child_ = NULL;
+
+        for (i = 0; item.value.count == CBOR_INDEFINITE || i < item.value.count; i++)
+        {
+            /* Indefinite length containers end with a break */
+            if (item.value.count == CBOR_INDEFINITE && reader->s < reader->e && *reader->s == 0xFF)
+            {
+                reader->s++;
+                break;
+            }
+
+            /* Create json objects as member */
+            child = json_create();
+            if (!child) return JSON_E_MEMORY;
+
+            /* Linking members to the linked list first, so it is released with its parent on failure */
+            if (prev) prev->next = child;
+            else json->value.child_ = child;
+            prev = child;
+
+            /* Map keys must be strings */
+            if (item.type == CBOR_T_MAP)
+            {
+                if (cbor_read(reader, &key)) return JSON_E_KEY;
+                if (key.type != CBOR_T_STRING && key.type != CBOR_T_BYTES) return JSON_E_KEY;
+                error = parse_cbor_string(reader, &key, &child->key);
+                if (error) return (error == JSON_E_MEMORY) ? error : JSON_E_KEY;
+            }
+
+            error = parse_cbor(child, reader, depth + 1);
+            if (error) return error;
+        }
+        break;
+    }
+    default: return JSON_E_INVALID;
+    }
+
+    return JSON_E_OK;
+}
+
+/**
+ *  \brief cbor (RFC 8949) parser, builds the same json tree as `json_loads()` for the equivalent text.
+ *         byte strings are converted to strings, tags are ignored, undefined and simple values are converted to null.
+ *         on failure, `json_error_info()` reports line 0 and the byte offset as column.
+ *  \param[in] data: address of cbor data
+ *  \param[in] len: length of cbor data
+ *  \return json handle or NULL fail
+ */
+json_t json_cbor_loads(const void* data, int len)
+{
+    CBOR_READER reader;
+    json_t json = NULL;
+
+    /* reset error info */
+    ectx.line = 0;
+    ectx.column = 0;
+    ectx.type = JSON_E_OK;
+
+    if (!data || len <= 0)
+    {
+        ectx.type = JSON_E_INVALID;
+        return NULL;
+    }
+
+    cbor_reader_init(&reader, data, len);
+
+    /* create json object and parse */
+    json = json_create();
+    if (!json)
+    {
+        ectx.type = JSON_E_MEMORY;
+        return NULL;
+    }
+
+    ectx.type = parse_cbor(json, &reader, 1);
+
+    /* check whether there is data after the item */
+    if (ectx.type == JSON_E_OK && reader.s != reader.e) ectx.type = JSON_E_END;
+
+    if (ectx.type != JSON_E_OK)
+    {
+        ectx.column = cbor_reader_offset(&reader);
+        json_delete(json);
+        return NULL;
+    }
 
     return json;
 }
@@ -1993,7 +2898,7 @@ void json_minify(char* text)
         else if (*text == '/' && text[1] == '*') 
         {
             while (*text && !(*text == '*' && text[1] == '/')) text++;
-            text += 2;
+            if (*text) text += 2;
         }
         /* string literals, which are \" sensitive. */
         else if (*text == '\"') 
@@ -2001,10 +2906,10 @@ void json_minify(char* text)
             *into++ = *text++;
             while (*text && *text != '\"')
             {
-                if (*text == '\\') *into++ = *text++;
+                if (*text == '\\' && text[1]) *into++ = *text++;
                 *into++ = *text++;
             }
-            *into++ = *text++;
+            if (*text) *into++ = *text++;
         }
         /* all other characters. */
         else *into++ = *text++; 
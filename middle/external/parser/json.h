@@ -32,6 +32,10 @@ extern "C"
 
 typedef struct JSON* json_t;
 
+/* compiled path type definition, hiding structural members, not for external use */
+
+typedef struct JSON_PATH* json_path_t;
+
 /* json normal types define */
 
 #define JSON_TYPE_UNKNOW                    (0) /* unknown type */
@@ -56,10 +60,30 @@ typedef struct JSON* json_t;
 #define JSON_E_MEMORY                       (5) /* memory allocation failed */
 #define JSON_E_SQUARE                       (6) /* mising ']' */
 #define JSON_E_CURLY                        (7) /* mising '}' */
+#define JSON_E_DEPTH                        (8) /* nesting deeper than the context limit */
+
+/* allocator of the nodes, keys and strings of a loaded json, it must outlive the json */
+typedef struct
+{
+    void* (*alloc)(void* user, unsigned int size);  /**< allocate a block, NULL fail */
+    void (*free)(void* user, void* block);          /**< release a block of `alloc` */
+    void* user;                                     /**< user data of the callbacks, such as an arena */
+} JSON_ALLOC;
+
+/* parse context, keeps the error information of one parsing call instead of the shared one */
+typedef struct
+{
+    const JSON_ALLOC* alloc;                /**< input, allocator of the loaded json, NULL the C library */
+    int depth;                              /**< input, maximum nesting depth of arrays and objects, 0 unlimited */
+    int type;                               /**< output, error type, @ref JSON_E_xxx */
+    int line;                               /**< output, error line */
+    int column;                             /**< output, error column */
+} JSON_CTX;
 
 /* Load json */
 
 json_t json_loads(const char* text);
+json_t json_loads_ex(const char* text, JSON_CTX* ctx);
 json_t json_file_load(char* filename);
 
 /* When loading fails, use this method to locate the error */
@@ -71,6 +95,16 @@ int json_error_info(int* line, int* column);
 char* json_dumps(json_t json, int preset, int unformat, int* len);
 int json_file_dump(json_t json, char* filename);
 
+/* Save json into file atomically, or only patch the changed values in place when they fit */
+
+int json_file_save(json_t json, const char* filename);
+int json_file_patch(json_t json, const char* filename);
+
+/* Convert json to and from cbor (RFC 8949), the compact binary form of json */
+
+void* json_cbor_dumps(json_t json, int preset, int* len);
+json_t json_cbor_loads(const void* data, int len);
+
 /* Create and delete json */
 
 json_t json_create(void);
@@ -117,6 +151,16 @@ json_t json_get(json_t json, const char* key, int index);
 json_t json_to_index_valist(json_t json, int index, ...);
 json_t json_to_key_valist(json_t json, char* key, ...);
 
+/* Query json with compiled paths like `$.cfg.items[*].name` */
+
+/* callback of each match, returns 0 to stop */
+typedef int (*json_path_match_t)(void* context, json_t json);
+
+json_path_t json_path_compile(const char* path);
+void json_path_delete(json_path_t path);
+int json_path_query(json_t json, json_path_t path, json_path_match_t match, void* context);
+json_t json_path_get(json_t json, json_path_t path);
+
 /* json storage structure adjustment method */
 /* Usually used in conjunction with other methods */
 
@@ -11,6 +11,7 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "txls.h"
+#include "fmap.h"
 #include <string.h>
 #include <stdio.h>
 #include <stddef.h>
@@ -24,195 +25,300 @@ typedef struct
     unsigned int end;           /**< end of buffer used */
 } BUFFER;
 
-/* iterator define */
-typedef struct
-{
-    void *p;                    /**< iteration pointer */
-    unsigned int i;             /**< iteration index */
-} ITERATOR;
-
 /* smallest memory cell */
-typedef struct CELL
+typedef struct
 {
-    struct CELL *next;          /**< next cell */
-    char* address;              /**< address of cell content */
+    char* address;              /**< address of cell content, NULL for empty content */
+    unsigned int size;          /**< output size of cell content */
 } CELL;
 
-/* column storage */
-typedef struct COLUMN
+/* column attributes */
+typedef struct
 {
-    struct COLUMN *next;        /**< next column */
-    CELL *cells;                /**< the cell base address of this column */
-    ITERATOR iterator;          /**< cell list iterator */
     int align;                  /**< alignment */
     unsigned int width;         /**< the output width of this column when neatly outputting */
+    unsigned int count;         /**< count of cells as wide as the width, 0 when the width is out of date */
 } COLUMN;
 
 /* type of txls */
 typedef struct TXLS
 {
+    CELL *cells;                /**< cells base, row by row, row 0 is the header */
     COLUMN *columns;            /**< columns base */
-    ITERATOR iterator;          /**< column iterator */
+    unsigned int capacity;      /**< capacity of cells */
+    unsigned int size;          /**< capacity of columns */
     unsigned int col;           /**< column count */
     unsigned int row;           /**< row count */
+    const TXLS_ALLOC *alloc;    /**< allocator of the cells and columns, NULL the C library */
 } TXLS;
 
-/* parsing error message storage */
-static int etype = 0;
-static int eline = 0;
+/* error information of the calls without context */
+static TXLS_CTX ectx;
 
-#define E(type) etype=(type)
+#define E(e) p->type=(e)
 
-static COLUMN *txls_column(txls_t txls, int index, int size)
+/* cell at the column and row, both starting from 0 */
+#define txls_cell(txls, c, r)   (&(txls)->cells[(r) * (txls)->col + (c)])
+
+/**
+ *  \brief Calculate the smallest power of 2 that is greater than or equal to a given number.
+ * 
+ *  \param[in] x The given number.
+ *  \return The smallest power of 2 greater than or equal to x.
+ */
+static unsigned int pow2gt(unsigned int x)
 {
-    if (index >= size) return NULL;
-    if (index < txls->iterator.i || !txls->iterator.p || index == 0)
-    {
-        txls->iterator.i = 0;
-        txls->iterator.p = txls->columns;
-    }
-    while (txls->iterator.p && txls->iterator.i < index)
+    int b = sizeof(int) * 8;
+    int i = 1;
+
+    --x;
+    while (i < b)
     {
-        txls->iterator.p = ((COLUMN *)(txls->iterator.p))->next;
-        txls->iterator.i++;
+        x |= (x >> i);
+        i <<= 1;
     }
-    return txls->iterator.p;
+
+    return x + 1;
+}
+
+/**
+ *  \brief Allocate memory of a txls with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] size Size of memory.
+ *  \return Address of memory or NULL fail.
+ */
+static void* txls_malloc(const TXLS_ALLOC* alloc, unsigned int size)
+{
+    return alloc ? alloc->alloc(alloc->user, size) : malloc(size);
+}
+
+/**
+ *  \brief Release memory of a txls with its allocator.
+ * 
+ *  \param[in] alloc Allocator, NULL the C library.
+ *  \param[in] block Address of memory.
+ */
+static void txls_free(const TXLS_ALLOC* alloc, void* block)
+{
+    if (alloc) alloc->free(alloc->user, block);
+    else free(block);
 }
 
-static CELL *column_cell(COLUMN *column, int index, int size)
+/**
+ *  \brief Make sure an array can hold the given count of items, otherwise add capacity.
+ *         An allocator that cannot resize gets a new block and a copy of the items.
+ *
+ *  \param[in] alloc Allocator of the array, NULL the C library
+ *  \param[in] base Base address of the array
+ *  \param[in,out] capacity Capacity of the array, updated when it grows
+ *  \param[in] count Required count of items
+ *  \param[in] size Size of an item
+ *  \return Base address of the array, or NULL if the allocation fails, the array is kept then
+ */
+static void* reserve(const TXLS_ALLOC* alloc, void* base, unsigned int* capacity, unsigned int count, unsigned int size)
 {
-    if (index >= size) return NULL;
-    if (index < column->iterator.i || !column->iterator.p || index == 0)
+    unsigned int n;
+    void* grown;
+
+    if (count <= *capacity) return base;
+    n = pow2gt(count);
+    if (alloc)
     {
-        column->iterator.i = 0;
-        column->iterator.p = column->cells;
+        grown = alloc->alloc(alloc->user, n * size);
+        if (!grown) return NULL;
+        if (base)
+        {
+            memcpy(grown, base, (size_t)*capacity * size);
+            alloc->free(alloc->user, base);
+        }
     }
-    while (column->iterator.p && column->iterator.i < index)
+    else
     {
-        column->iterator.p = ((CELL *)(column->iterator.p))->next;
-        column->iterator.i++;
+        grown = realloc(base, (size_t)n * size);
+        if (!grown) return NULL;
     }
-    return column->iterator.p;
+    *capacity = n;
+
+    return grown;
 }
 
 /**
- *  \brief create a txls object
- *  \param[in] col: number of columns
- *  \param[in] row: number of rows
- *  \return txls handle or NULL FAIL
+ * \brief Calculate the size of a string considering special characters
+ *
+ * \param[in] s Pointer to the input string
+ * \return The calculated size of the string taking special characters into account
  */
-txls_t txls_create(unsigned int col, unsigned int row)
+static unsigned int tsize(const char *s)
 {
-    txls_t txls = NULL;
-    unsigned int i;
-
-    /* create null txls and initialize */
-    txls = (txls_t)malloc(sizeof(TXLS));
-    if (!txls) return NULL;
-    txls->columns = NULL;
-    txls->col = 0;
-    txls->row = 0;
+    unsigned int size = 0; /* Initialize the size counter */
 
-    /* Insert Column */
-    for (i = 0; i < col; i++)
+    /* Loop through the string until the end */
+    while (s && *s) 
     {
-        if (!txls_insert_column(txls, 1)) goto FAIL;
-    }
+        /* A newline is output as "<br>" */
+        if (*s == '\n') size += 4; 
+        /* A '|' is output as "\|" */
+        else if (*s == '|') size += 2; 
+        /* Other characters are output as they are */
+        else size++; 
 
-    /* Insert Row */
-    for (i = 0; i < row; i++)
-    {
-        if (!txls_insert_row(txls, 1)) goto FAIL;
+        s++;
     }
 
-    txls->col = col;
-    txls->row = row;
+    return size;
+}
 
-    return txls;
+/**
+ * \brief Count a cell of the given size into the width of its column
+ *
+ * \param[in] column Pointer to the COLUMN structure
+ * \param[in] size Output size of the cell
+ * \return void
+ */
+static void width_enter(COLUMN *column, unsigned int size)
+{
+    /* The width is out of date, it will be recalculated when used */
+    if (column->count == 0) return;
 
-FAIL:
-    txls_delete(txls);
-    return NULL;
+    if (size > column->width)
+    {
+        column->width = size;
+        column->count = 1;
+    }
+    else if (size == column->width) column->count++;
 }
 
 /**
- * \brief Create a new CELL structure and allocate memory for it
+ * \brief Remove a cell of the given size from the width of its column
  *
- * \param[in] len Length of the address string to be allocated
- * \return A pointer to the newly created CELL structure, or NULL if the allocation fails
+ * \param[in] column Pointer to the COLUMN structure
+ * \param[in] size Output size of the cell
+ * \return void
  */
-static CELL* new_cell(int len)
+static void width_leave(COLUMN *column, unsigned int size)
 {
-    CELL *cell;
-    
-    /* If the length is negative, return NULL */
-    if (len < 0) return NULL; 
-    
-    /* Allocate memory for the CELL structure */
-    cell = (CELL *)malloc(sizeof(CELL));  
-    if (!cell) return NULL;
-    
-    /* Allocate memory for the address string */
-    cell->address = malloc(len + 1);
-    if (!cell->address)
+    /* When the last widest cell leaves, the width becomes out of date */
+    if (column->count > 0 && size == column->width) column->count--;
+}
+
+/**
+ * \brief Get the width of a column, recalculate it if it is out of date
+ *
+ * \param[in] txls The txls_t structure
+ * \param[in] col The column index, starting from 0
+ * \return The output width of the column
+ */
+static unsigned int column_width(txls_t txls, unsigned int col)
+{
+    COLUMN *column = &txls->columns[col];
+    CELL *cell = txls_cell(txls, col, 0);
+    unsigned int i;
+
+    if (column->count > 0) return column->width;
+
+    /* Walk down the column to find the widest cells */
+    column->width = 0;
+    for (i = 0; i <= txls->row; i++, cell += txls->col)
     {
-        free(cell);
-        return NULL;
+        if (cell->size > column->width)
+        {
+            column->width = cell->size;
+            column->count = 1;
+        }
+        else if (cell->size == column->width) column->count++;
     }
-    
-    /* Add a null terminator to the end of the address string */
-    cell->address[len] = 0; 
-    cell->next = NULL;
-    
-    return cell;
+
+    return column->width;
 }
 
 /**
- * \brief Free the memory allocated for a CELL structure
+ * \brief Replace the content of a cell and keep the column width up to date
  *
- * \param[in] cell Pointer to the CELL structure to be freed
+ * \param[in] txls The txls_t structure
+ * \param[in] col The column index of the cell, starting from 0
+ * \param[in] cell Pointer to the CELL structure
+ * \param[in] address New content, taken over by the cell, NULL for empty content
  * \return void
  */
-static void free_cell(CELL* cell)
+static void cell_assign(txls_t txls, unsigned int col, CELL *cell, char* address)
 {
-    if (!cell) return;
-    
-    /* If the address string is allocated, free the memory */
-    if (cell->address) free(cell->address); 
+    unsigned int size = cell->size;
+
+    if (cell->address) txls_free(txls->alloc, cell->address);
+    cell->address = address;
+    cell->size = tsize(address);
 
-    /* Free the memory allocated for the CELL structure */
-    free(cell); 
+    /* Count the new size first, so that a cell growing wider does not make the width out of date */
+    width_enter(&txls->columns[col], cell->size);
+    width_leave(&txls->columns[col], size);
 }
 
 /**
- * \brief Free the memory allocated for a COLUMN structure and its associated CELL structures
+ *  \brief Create a null txls whose cells and columns come from an allocator.
  *
- * \param[in] column Pointer to the COLUMN structure to be freed
- * \return void
+ *  \param[in] alloc allocator, NULL the C library
+ *  \return txls handle or NULL fail
  */
-static void free_column(COLUMN *column)
+static txls_t txls_new(const TXLS_ALLOC* alloc)
 {
-    CELL *cell = NULL;
+    txls_t txls;
 
-    /* Check if the column pointer is not NULL */
-    if (column)  
+    txls = (txls_t)txls_malloc(alloc, sizeof(TXLS));
+    if (!txls) return NULL;
+    txls->cells = NULL;
+    txls->columns = NULL;
+    txls->capacity = 0;
+    txls->size = 0;
+    txls->col = 0;
+    txls->row = 0;
+    txls->alloc = alloc;
+
+    return txls;
+}
+
+/**
+ *  \brief create a txls object
+ *  \param[in] col: number of columns
+ *  \param[in] row: number of rows
+ *  \return txls handle or NULL FAIL
+ */
+txls_t txls_create(unsigned int col, unsigned int row)
+{
+    txls_t txls = NULL;
+    unsigned int i;
+
+    /* create null txls and initialize */
+    txls = txls_new(NULL);
+    if (!txls) return NULL;
+    txls->row = row;
+
+    if (col > 0)
     {
-        /* Loop through the cells in the column */
-        while (column->cells)  
-        {
-            /* Store the next cell pointer */
-            cell = column->cells->next; 
+        /* All cells are empty at first */
+        txls->cells = (CELL *)calloc((size_t)(row + 1) * col, sizeof(CELL));
+        if (!txls->cells) goto FAIL;
+        txls->capacity = (row + 1) * col;
 
-            /* Free the memory allocated for the current cell */
-            free_cell(column->cells);  
+        txls->columns = (COLUMN *)malloc(col * sizeof(COLUMN));
+        if (!txls->columns) goto FAIL;
+        txls->size = col;
 
-            /* Move to the next cell */
-            column->cells = cell;  
+        for (i = 0; i < col; i++)
+        {
+            txls->columns[i].align = TXLS_ALIGN_UNKNOW;
+            txls->columns[i].width = 0;
+            txls->columns[i].count = row + 1;
         }
-
-        /* Free the memory allocated for the COLUMN structure */
-        free(column);  
     }
+
+    txls->col = col;
+
+    return txls;
+
+FAIL:
+    txls_delete(txls);
+    return NULL;
 }
 
 /**
@@ -222,17 +328,21 @@ static void free_column(COLUMN *column)
  */
 void txls_delete(txls_t txls)
 {
+    unsigned int i, count;
+
     if (!txls) return;
 
-    /* Loop through all columns in the txls_t structure */
-    while (txls->col) 
+    /* Free the content of all cells */
+    count = txls->col * (txls->row + 1);
+    for (i = 0; i < count; i++)
     {
-        /* Delete the first column of the txls_t structure */
-        txls_delete_column(txls, 1); 
+        if (txls->cells[i].address) txls_free(txls->alloc, txls->cells[i].address);
     }
 
-    /* Free the memory allocated for the txls_t structure */
-    free(txls); 
+    /* Free the arrays and the txls_t structure */
+    if (txls->cells) txls_free(txls->alloc, txls->cells);
+    if (txls->columns) txls_free(txls->alloc, txls->columns);
+    txls_free(txls->alloc, txls);
 }
 
 /**
@@ -260,16 +370,17 @@ unsigned int txls_row(txls_t txls)
 /**
  *  \brief Duplicate a given string.
  * 
+ *  \param[in] alloc Allocator of the copy, NULL the C library.
  *  \param[in] str String to be duplicated.
  *  \param[in] len Length of the string.
  *  \return Pointer to the duplicated string if successful, NULL otherwise.
  */
-static char* txls_strdup(const char* str, int len)
+static char* txls_strdup(const TXLS_ALLOC* alloc, const char* str, int len)
 {
     char* s;
 
     /* Allocate memory for the new string */
-    s = (char*)malloc(len + 1);
+    s = (char*)txls_malloc(alloc, len + 1);
     if (!s) return NULL;
 
     /* Copy the given string into the allocated memory */
@@ -279,62 +390,6 @@ static char* txls_strdup(const char* str, int len)
     return s;
 }
 
-/**
- * \brief Calculate the size of a string considering special characters
- *
- * \param[in] s Pointer to the input string
- * \return The calculated size of the string taking special characters into account
- */
-static unsigned int tsize(char *s)
-{
-    unsigned int size = 0; /* Initialize the size counter */
-
-    /* Loop through the string until the end */
-    while (s && *s++) 
-    {
-        /* If the current character is a newline, increase the size by 3 */
-        if (*s == '\n') size += 3; 
-        /* If the current character is a '|', increase the size by 1 */
-        else if (*s == '|') size++; 
-        
-        /* Increase the size for every character */
-        size++; 
-    }
-
-    return size;
-}
-
-/**
- * \brief Update the width of a column based on the content of its cells
- *
- * \param[in] column Pointer to the COLUMN structure to be updated
- * \param[in] cell Pointer to the CELL structure to be excluded from width calculation
- * \param[in] row The row index for which the width is being updated
- * \return void
- */
-static void update_width(COLUMN *column, CELL *cell, unsigned int row)
-{
-    CELL *c = NULL;
-    unsigned int i;
-    unsigned int size = 0;
-
-    /* Reset the column width to 0 */
-    column->width = 0;
-
-    /* Iterate through the rows up to the specified row index */
-    for (i = 0; i <= row; i++) 
-    {
-        /* Get the cell at the specified row index */
-        c = column_cell(column, i, row + 1);
-
-        /* Calculate the size of the cell's address */
-        size = tsize(c->address);
-
-        /* Update the column width if the size is greater */
-        if (c != cell && size >= column->width) column->width = size; 
-    }
-}
-
 /**
  *  \brief set the alignment of the column
  *  \param[in] txls: txls handle
@@ -347,10 +402,10 @@ int txls_set_align(txls_t txls, unsigned int col, int align)
     COLUMN *column;
     
     if (!txls) return 0;
+    if (col < 1 || col > txls->col) return 0; 
     
     /* Get the specified column from the txls_t structure */
-    column = txls_column(txls, col - 1, txls->col); 
-    if (!column) return 0;
+    column = &txls->columns[col - 1]; 
     
     /* Check the alignment value */
     switch (align) 
@@ -377,7 +432,6 @@ int txls_set_align(txls_t txls, unsigned int col, int align)
  */
 const char* txls_get_text(txls_t txls, unsigned int col, unsigned int row)
 {
-    COLUMN *column;
     CELL *cell;
     
     if (!txls) return NULL;
@@ -386,13 +440,10 @@ const char* txls_get_text(txls_t txls, unsigned int col, unsigned int row)
     if (col < 1 || col > txls->col) return NULL; 
     if (row > txls->row) return NULL;
     
-    /* Get the specified column from the txls_t structure */
-    column = txls_column(txls, col - 1, txls->col); 
-
-    /* Get the cell at the specified row index */
-    cell = column_cell(column, row, txls->row + 1); 
+    /* Get the cell directly from the cell array */
+    cell = txls_cell(txls, col - 1, row); 
     
-    return cell ? cell->address : NULL;
+    return cell->address ? cell->address : "";
 }
 
 /**
@@ -406,9 +457,7 @@ const char* txls_get_text(txls_t txls, unsigned int col, unsigned int row)
  */
 int txls_set_text(txls_t txls, unsigned int col, unsigned int row, const char* text)
 {
-    COLUMN *column;
-    CELL *cell;
-    char* s;
+    char* s = NULL;
     int len = 0;
     int i;
     
@@ -419,12 +468,6 @@ int txls_set_text(txls_t txls, unsigned int col, unsigned int row, const char* t
     if (col < 1 || col > txls->col) return 0;
     if (row > txls->row) return 0;
 
-    /* Get the specified column from the txls_t structure */
-    column = txls_column(txls, col - 1, txls->col);
-
-    /* Get the cell at the specified row index */
-    cell = column_cell(column, row, txls->row + 1);
-
     /* Loop through the text to calculate its length */
     for (i = 0;;i++)
     {
@@ -433,15 +476,15 @@ int txls_set_text(txls_t txls, unsigned int col, unsigned int row, const char* t
         len++;
     }
 
-    /* Copy the text content to a new memory location */
-    s = txls_strdup(text, len);
-    if (!s) return 0;
-
-    /* Free the memory occupied by the original cell content */
-    if (cell->address) free(cell->address);
+    /* Copy the text content to a new memory location, empty content takes no memory */
+    if (len > 0)
+    {
+        s = txls_strdup(txls->alloc, text, len);
+        if (!s) return 0;
+    }
 
     /* Set the cell's address to the copied text */
-    cell->address = s;
+    cell_assign(txls, col - 1, txls_cell(txls, col - 1, row), s);
 
     return 1;
 }
@@ -455,69 +498,46 @@ int txls_set_text(txls_t txls, unsigned int col, unsigned int row, const char* t
  */
 int txls_insert_column(txls_t txls, unsigned int col)
 {
-    COLUMN *column = NULL, *pcolumn = NULL;
-    CELL *cell = NULL, *pcell = NULL;
-    unsigned int i;
+    CELL *cells;
+    COLUMN *columns;
+    unsigned int rows, r, c, n;
 
     if (!txls) return 0;
 
     /* If the column index is out of range, return 0 */
     if (col > txls->col + 1 || col < 1) return 0; 
 
-    /* Allocate memory for the new column */
-    column = (COLUMN *)malloc(sizeof(COLUMN)); 
-    if (!column) goto FAIL;
-
-    /**< Initialize the new column */
-    column->align = TXLS_ALIGN_UNKNOW;
-    column->cells = NULL; 
+    c = col - 1;
+    n = txls->col + 1;
+    rows = txls->row + 1;
 
-    /* Loop through the rows to create new cells for the new column */
-    for (i = 0; i <= txls->row; i++) 
-    {
-        /* Create a new cell */
-        cell = new_cell(0); 
-        if (!cell) goto FAIL;
-
-        /* Set the first cell of the new column */
-        if (!column->cells) column->cells = cell; 
-
-        /* Set the next pointer of the previous cell to the new cell */
-        if (pcell) pcell->next = cell;
-
-        /* Update the previous cell pointer */
-        pcell = cell; 
-    }
+    /* Make room for the new column */
+    cells = (CELL *)reserve(txls->alloc, txls->cells, &txls->capacity, rows * n, sizeof(CELL));
+    if (!cells) return 0;
+    txls->cells = cells;
+    columns = (COLUMN *)reserve(txls->alloc, txls->columns, &txls->size, n, sizeof(COLUMN));
+    if (!columns) return 0;
+    txls->columns = columns;
 
-    /* If the new column is to be inserted at the beginning */
-    if (col == 1)
+    /* Spread the rows from the last one, so that each row is moved before it is overwritten */
+    for (r = rows; r-- > 0; )
     {
-        /* Set the next pointer of the new column to the current first column */
-        column->next = txls->columns;
-        /* Update the txls_t structure to point to the new first column */
-        txls->columns = column; 
+        memmove(&cells[r * n + c + 1], &cells[r * txls->col + c], (txls->col - c) * sizeof(CELL));
+        memmove(&cells[r * n], &cells[r * txls->col], c * sizeof(CELL));
+        cells[r * n + c].address = NULL;
+        cells[r * n + c].size = 0;
     }
-    /* If the new column is to be inserted in the middle or at the end */
-    else
-    {
-        /* Get the column before the specified position */
-        pcolumn = txls_column(txls, col - 2, txls->col);
 
-        /* Set the next pointer of the new column to the next column of the previous column */
-        column->next = pcolumn->next; 
-        /* Update the next pointer of the previous column to the new column */
-        pcolumn->next = column; 
-    }
+    /**< Initialize the new column, all of its cells are empty */
+    memmove(&columns[c + 1], &columns[c], (txls->col - c) * sizeof(COLUMN));
+    columns[c].align = TXLS_ALIGN_UNKNOW;
+    columns[c].width = 0;
+    columns[c].count = rows;
 
     /* Increment the total column count in the txls_t structure */
     txls->col++; 
 
     return 1;
-
-FAIL:
-    /* Free the memory allocated for the new column in case of failure */
-    if (column) free_column(column);
-    return 0;
 }
 
 /**
@@ -528,36 +548,27 @@ FAIL:
  */
 int txls_delete_column(txls_t txls, unsigned int col)
 {
-    COLUMN *column = NULL, *pcolumn = NULL;
+    CELL *cells;
+    unsigned int rows, r, c, n;
 
     if (!txls) return 0;
 
     /* If the column index is out of range, return 0 */
     if (col > txls->col || col < 1) return 0;
 
-    /* If the first column is to be deleted */
-    if (col == 1) 
-    {
-        /* Get the first column from the txls_t structure */
-        column = txls_column(txls, 0, txls->col);
+    c = col - 1;
+    n = txls->col - 1;
+    rows = txls->row + 1;
+    cells = txls->cells;
 
-        /* Update the txls_t structure to point to the next column as the new first column */
-        txls->columns = column->next; 
-    }
-    /* If a column in the middle or at the end is to be deleted */
-    else 
+    /* Close up the rows from the first one, freeing the cells of the column on the way */
+    for (r = 0; r < rows; r++)
     {
-        /* Get the column before the specified position */
-        pcolumn = txls_column(txls, col - 2, txls->col);
-
-        /* Get the column to be deleted */
-        column = pcolumn->next;
-        /* Update the next pointer of the previous column to skip the column to be deleted */ 
-        pcolumn->next = column->next; 
+        if (cells[r * txls->col + c].address) txls_free(txls->alloc, cells[r * txls->col + c].address);
+        memmove(&cells[r * n], &cells[r * txls->col], c * sizeof(CELL));
+        memmove(&cells[r * n + c], &cells[r * txls->col + c + 1], (n - c) * sizeof(CELL));
     }
-    
-    /* Free the memory allocated for the deleted column */
-    free_column(column); 
+    memmove(&txls->columns[c], &txls->columns[c + 1], (n - c) * sizeof(COLUMN));
 
     /* Decrement the total column count in the txls_t structure */
     txls->col--; 
@@ -573,8 +584,7 @@ int txls_delete_column(txls_t txls, unsigned int col)
  */
 int txls_insert_row(txls_t txls, unsigned int row)
 {
-    COLUMN *column = NULL;
-    CELL *cell = NULL, *pcell = NULL;
+    CELL *cells;
     unsigned int i;
 
     if (!txls) return 0;
@@ -582,50 +592,31 @@ int txls_insert_row(txls_t txls, unsigned int row)
     /* If the row index is out of range, return 0 */
     if (row > txls->row + 1 || row < 1) return 0;
 
-    /* Loop through the columns to create new cells for the new row */
-    for (i = 0; i < txls->col; i++)
+    /* Without columns, there are no cells to insert */
+    if (txls->col > 0)
     {
-        /* Create a new cell */
-        cell = new_cell(0); 
-        if (!cell) goto FAIL;
-        
-        /* Get the current column */
-        column = txls_column(txls, i, txls->col);
+        /* Make room for the new row */
+        cells = (CELL *)reserve(txls->alloc, txls->cells, &txls->capacity, (txls->row + 2) * txls->col, sizeof(CELL));
+        if (!cells) return 0;
+        txls->cells = cells;
 
-        /* Get the cell before the specified position */
-        pcell = column_cell(column, row - 1, txls->row + 1); 
+        /* Move the following rows back by one row */
+        cells = txls_cell(txls, 0, row);
+        memmove(cells + txls->col, cells, (txls->row + 1 - row) * txls->col * sizeof(CELL));
 
-        /* Set the next pointer of the new cell to the cell at the specified position */
-        cell->next = pcell->next; 
-        /* Update the next pointer of the previous cell to the new cell */
-        pcell->next = cell; 
+        /* The cells of the new row are empty */
+        for (i = 0; i < txls->col; i++)
+        {
+            cells[i].address = NULL;
+            cells[i].size = 0;
+            width_enter(&txls->columns[i], 0);
+        }
     }
 
     /* Increment the total row count in the txls_t structure */
     txls->row++; 
 
     return 1;
-
-FAIL:
-    /* In case of failure, revert the changes and free the memory */
-    while (i--) 
-    {
-        /* Get the current column */
-        column = txls_column(txls, i, txls->col); 
-
-        /* Get the cell before the specified position */
-        pcell = column_cell(column, row - 1, txls->row + 1); 
-
-        /* Get the cell to be deleted */
-        cell = pcell->next; 
-        /* Update the next pointer of the previous cell to skip the cell to be deleted */
-        pcell->next = cell->next; 
-
-        /* Free the memory occupied by the deleted cell */
-        free(cell); 
-    }
-
-    return 0;
 }
 
 /**
@@ -636,8 +627,7 @@ FAIL:
  */
 int txls_delete_row(txls_t txls, unsigned int row)
 {
-    COLUMN *column = NULL;
-    CELL *cell = NULL, *pcell = NULL;
+    CELL *cells;
     unsigned int i;
 
     if (!txls) return 0;
@@ -645,22 +635,19 @@ int txls_delete_row(txls_t txls, unsigned int row)
     /* If the row index is out of range, return 0 */
     if (row > txls->row || row < 1) return 0; 
 
-    /* Loop through the columns to delete the cells of the specified row */
-    for (i = 0; i < txls->col; i++) 
+    /* Without columns, there are no cells to delete */
+    if (txls->col > 0)
     {
-        /* Get the current column */
-        column = txls_column(txls, i, txls->col); 
-
-        /* Get the cell before the specified position */
-        pcell = column_cell(column, row - 1, txls->row + 1);
-
-        /* Get the cell to be deleted */
-        cell = pcell->next; 
-        /* Update the next pointer of the previous cell to skip the cell to be deleted */
-        pcell->next = cell->next; 
+        /* Free the cells of the specified row */
+        cells = txls_cell(txls, 0, row);
+        for (i = 0; i < txls->col; i++) 
+        {
+            width_leave(&txls->columns[i], cells[i].size);
+            if (cells[i].address) txls_free(txls->alloc, cells[i].address);
+        }
 
-        /* Free the memory occupied by the deleted cell */
-        free_cell(cell);
+        /* Move the following rows forward by one row */
+        memmove(cells, cells + txls->col, (txls->row - row) * txls->col * sizeof(CELL));
     }
 
     /* Decrement the total row count in the txls_t structure */
@@ -669,27 +656,6 @@ int txls_delete_row(txls_t txls, unsigned int row)
     return 1;
 }
 
-/**
- *  \brief Calculate the smallest power of 2 that is greater than or equal to a given number.
- * 
- *  \param[in] x The given number.
- *  \return The smallest power of 2 greater than or equal to x.
- */
-static unsigned int pow2gt(unsigned int x)
-{
-    int b = sizeof(int) * 8;
-    int i = 1;
-
-    --x;
-    while (i < b)
-    {
-        x |= (x >> i);
-        i <<= 1;
-    }
-
-    return x + 1;
-}
-
 /**
  *  \brief confirm whether buf still has the required capacity, otherwise add capacity.
  *  \param[in] buf: buf handle
@@ -723,16 +689,16 @@ static int expansion(BUFFER* buf, unsigned int needed)
  * \param[in] buf Pointer to the BUFFER structure for storing the printed content
  * \return 1 if the cell content is successfully printed into the buffer, 0 if the operation fails or the cell pointer is NULL
  */
-static int print_cel(CELL *cell, unsigned int width, int align, BUFFER* buf)
+static int print_cel(const CELL *cell, unsigned int width, int align, BUFFER* buf)
 {
     int i = 0;
-    char* addr = NULL;
+    const char* addr = NULL;
     unsigned int size = 0;
 
     if (!cell) return 0;
 
-    /* Calculate the size of the cell's address */
-    size = tsize(cell->address); 
+    /* The output size of the cell is kept with the cell */
+    size = cell->size; 
 
     /* Calculate the width to be filled with spaces */
     if (width < 1) width = 1;
@@ -834,8 +800,8 @@ static int print_txls(txls_t txls, BUFFER* buf, int neat)
 {
     /* Pointer to a COLUMN structure */
     COLUMN *column;
-    /* Pointers to CELL structures */
-    CELL *cell;
+    /* Pointers to CELL structures, the cells are printed in storage order */
+    const CELL *cell;
     /* Loop counters */
     unsigned int i, j;
 
@@ -849,18 +815,14 @@ static int print_txls(txls_t txls, BUFFER* buf, int neat)
         return 1;
     }
 
+    cell = txls->cells;
+
     /* Loop through each row */
     for (i = 0; i <= txls->row; i++)
     {
         /* Loop through each column */
-        for (j = 0; j < txls->col; j++)
+        for (j = 0, column = txls->columns; j < txls->col; j++, column++, cell++)
         {
-            /* Get the column at index j */
-            column = txls_column(txls, j, txls->col);
-
-            /* Get the cell at (i, j) */
-            cell = column_cell(column, i, txls->row + 1);
-
             /* Print the cell contents */
             if (!print_cel(cell, neat ? column->width : 0, column->align, buf)) return 0;
         }
@@ -874,11 +836,8 @@ static int print_txls(txls_t txls, BUFFER* buf, int neat)
         if (i == 0)
         {
             /* Loop through each column */
-            for (j = 0; j < txls->col; j++)
+            for (j = 0, column = txls->columns; j < txls->col; j++, column++)
             {
-                /* Get the column at index j */
-                column = txls_column(txls, j, txls->col);
-
                 /* Print the dividing line */
                 if (!print_div(neat ? column->width : 0, column->align, buf)) return 0;
             }
@@ -915,8 +874,7 @@ static int print_txls(txls_t txls, BUFFER* buf, int neat)
 char* txls_dumps(txls_t txls, int neat, int* len)
 {
     BUFFER p;
-    COLUMN *column;
-    unsigned int i;
+    unsigned int i, width;
     int preset = 1;
 
     if (!txls) return NULL;
@@ -929,9 +887,9 @@ char* txls_dumps(txls_t txls, int neat, int* len)
     {
         for (i = 0; i < txls->col; i++)
         {
-            column = txls_column(txls, i, txls->col);
-            update_width(column, NULL, txls->row);
-            preset += (column->width - 1) * (txls->row + 2);
+            /* The widths are kept up to date by the edits, only the out of date ones are recalculated */
+            width = column_width(txls, i);
+            if (width > 1) preset += (width - 1) * (txls->row + 2);
         }
     }
 
@@ -1015,10 +973,12 @@ static const char* skip(const char* in)
  * \brief Parses a string in the given text and assigns it to the CELL structure.
  *
  * \param[in] text The input text to parse.
+ * \param[in,out] txls The txls_t structure the cell belongs to.
+ * \param[in] col The column index of the cell, starting from 0.
  * \param[out] cell Pointer to the CELL structure to store the parsed string.
  * \return A pointer to the remaining text after parsing the string.
  */
-static const char* parse_string(const char* text, CELL *cell)
+static const char* parse_string(TXLS_CTX* p, const char* text, txls_t txls, unsigned int col, CELL *cell)
 {
     const char *s, *e, *h;
     int len = 0, i= 0;
@@ -1069,7 +1029,7 @@ static const char* parse_string(const char* text, CELL *cell)
     /* Allocate space and assign cell contents */
     if (len)
     {
-        address = (char*)malloc(len + 1);
+        address = (char*)txls_malloc(txls->alloc, len + 1);
         if (!address)
         {
             E(TXLS_E_MEMORY);
@@ -1110,8 +1070,7 @@ static const char* parse_string(const char* text, CELL *cell)
             h++;
         }
         address[i] = 0;
-        if (cell->address) free(cell->address);
-        cell->address = address;
+        cell_assign(txls, col, cell, address);
     }
 
     return s;
@@ -1120,15 +1079,14 @@ static const char* parse_string(const char* text, CELL *cell)
 /**
  * \brief Parses the header of a table in the given text and updates the txls_t structure.
  *
+ * \param[in,out] p Parse context that receives the error information.
  * \param[in] text The input text to parse.
  * \param[in,out] txls The txls_t structure to update with the parsed header information.
  * \return A pointer to the remaining text after parsing the header.
  */
-static const char* parse_head(const char* text, txls_t txls)
+static const char* parse_head(TXLS_CTX* p, const char* text, txls_t txls)
 {
     const char* s = text;
-    COLUMN *column;
-    CELL *cell;
     int i = 0;
     int align = 0;
 
@@ -1151,15 +1109,13 @@ static const char* parse_head(const char* text, txls_t txls)
                 E(TXLS_E_MEMORY);
                 return s;
             }
-            column = txls_column(txls, txls->col - 1, txls->col);
-            cell = column_cell(column, 0, txls->row + 1);
-            s = parse_string(s, cell);
-            if (etype) return s;
+            s = parse_string(p, s, txls, txls->col - 1, txls_cell(txls, txls->col - 1, 0));
+            if (p->type) return s;
         }
         else if (*s == '\n')
         {
             s++;
-            eline++;
+            p->line++;
             break;
         }
     }
@@ -1176,10 +1132,9 @@ static const char* parse_head(const char* text, txls_t txls)
     {
         if (*s == '|')
         {
-            column = txls_column(txls, txls->col - i, txls->col);
             s = skip(s + 1);
             if (*s == '\n') continue;
-            if (i < 0)
+            if (i <= 0)
             {
                 E(TXLS_E_HEAD);
                 return s;
@@ -1207,8 +1162,8 @@ static const char* parse_head(const char* text, txls_t txls)
                 E(TXLS_E_END);
                 return s;
             }
+            txls->columns[txls->col - i].align = align;
             i--;
-            column->align = align;
         }
         else if (*s == '\n')
         {
@@ -1217,7 +1172,7 @@ static const char* parse_head(const char* text, txls_t txls)
                 E(TXLS_E_HEAD);
                 return s;
             }
-            eline++;
+            p->line++;
             s++;
             break;
         }
@@ -1229,16 +1184,15 @@ static const char* parse_head(const char* text, txls_t txls)
 /**
  * \brief Parses a line of a table in the given text and updates the txls_t structure.
  *
+ * \param[in,out] p Parse context that receives the error information.
  * \param[in] text The input text to parse.
  * \param[in,out] txls The txls_t structure to update with the parsed line information.
  * \return A pointer to the remaining text after parsing the line.
  */
-static const char* parse_line(const char* text, txls_t txls)
+static const char* parse_line(TXLS_CTX* p, const char* text, txls_t txls)
 {
     const char* s = text;
-    COLUMN *column;
-    CELL *cell;
-    int i = 0;
+    unsigned int i = 0;
 
     s = skip(s);
     if (!*s) return s;
@@ -1267,15 +1221,14 @@ static const char* parse_line(const char* text, txls_t txls)
                 while (*s && *s != '\n') s++;
                 continue;
             }
-            column = txls_column(txls, i++, txls->col);
-            cell = column_cell(column, txls->row, txls->row + 1);
-            s = parse_string(s + 1, cell);
-            if (etype) return s;
+            s = parse_string(p, s + 1, txls, i, txls_cell(txls, i, txls->row));
+            i++;
+            if (p->type) return s;
         }
         else if (*s == '\n')
         {
             s++;
-            eline++;
+            p->line++;
             break;
         }
     }
@@ -1284,43 +1237,58 @@ static const char* parse_line(const char* text, txls_t txls)
 }
 
 /**
- *  \brief load txls text and generate txls.
+ *  \brief load txls text and generate txls, the error information is kept in the context,
+ *         so it can be called on several threads at once.
  *  \param[in] *text: address of text
+ *  \param[in,out] *ctx: parse context, `alloc` is input and the error information is output, can be NULL
  *  \return txls handler
  */
-txls_t txls_loads(const char* text)
+txls_t txls_loads_ex(const char* text, TXLS_CTX* ctx)
 {
+    TXLS_CTX state = { NULL, TXLS_E_OK, 1 }, *p = &state;
     txls_t txls;
-    CELL *ll = NULL, *base = NULL, *up;
-    int count = 0;
     const char* s;
 
     if (!text) return NULL;
-    txls = txls_create(0, 0);
+    if (ctx) state.alloc = ctx->alloc;
+    txls = txls_new(state.alloc);
     if (!txls)
     {
         E(TXLS_E_MEMORY);
-        return NULL;
+        goto FAIL;
     }
 
-    etype = TXLS_E_OK;
-    eline = 1;
-
-    s = parse_head(text, txls);
-    if (etype) goto FAIL;
+    s = parse_head(p, text, txls);
+    if (p->type) goto FAIL;
     while (1)
     {
-        s = parse_line(s, txls);
-        if (etype) goto FAIL;
+        s = parse_line(p, s, txls);
+        if (p->type) goto FAIL;
         if (!*s) break;
     }
+    if (ctx)
+    {
+        ctx->type = TXLS_E_OK;
+        ctx->line = 0;
+    }
     return txls;
 
 FAIL:
     txls_delete(txls);
+    if (ctx) *ctx = state;
     return NULL;
 }
 
+/**
+ *  \brief load txls text and generate txls.
+ *  \param[in] *text: address of text
+ *  \return txls handler, use `txls_error_info()` to locate the error
+ */
+txls_t txls_loads(const char* text)
+{
+    return txls_loads_ex(text, &ectx);
+}
+
 /**
  *  \brief load txls file and generate txls.
  *  \param[in] *filename: filename
@@ -1329,57 +1297,32 @@ FAIL:
 txls_t txls_file_load(const char* filename)
 {
     txls_t txls;
-    FILE* f;
-    long len;
-    char* text;
+    FMAP map;
+    int error;
 
     if (!filename) return NULL;
 
-    eline = 0;
-
-    /* open file and get the length of file */
-    f = fopen(filename, "rb");
-    if (!f)
+    /* map file, the content is parsed in place without copying */
+    error = fmap_open(&map, filename);
+    if (error != FMAP_E_OK)
     {
-        E(TXLS_E_OPEN);
-        goto FAIL;
+        ectx.type = (error == FMAP_E_MEMORY) ? TXLS_E_MEMORY : TXLS_E_OPEN;
+        ectx.line = 0;
+        return NULL;
     }
 
-    /* get file length */
-    fseek(f, 0, SEEK_END);
-    len = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    txls = txls_loads(map.data); /* load text */
 
-    /* read file */
-    text = (char*)malloc(len + 1);
-    if (text)
+    /* The file was truncated while loading, the text read is not valid */
+    if (fmap_close(&map) != FMAP_E_OK && txls)
     {
-        fread(text, 1, len, f);
-        fclose(f);
-        f = NULL;
+        txls_delete(txls);
+        txls = NULL;
+        ectx.type = TXLS_E_OPEN;
+        ectx.line = 0;
     }
-    else
-    {
-        E(TXLS_E_MEMORY);
-        goto FAIL;
-    }
-    text[len] = 0;
-    
-    txls = txls_loads(text); /* load text */
-    if (!txls)
-    {
-        goto FAIL;
-    }
-    
-    free(text);
 
     return txls;
-
-FAIL:
-    // printf("error line %d code %d\r\n", eline, etype); /* output error information */
-    if (f) fclose(f);
-    if (text) free(text);
-    return NULL;
 }
 
 /**
@@ -1390,7 +1333,7 @@ FAIL:
  */
 int txls_error_info(int* line)
 {
-    if (etype == TXLS_E_OK) return TXLS_E_OK;
-    if (line) *line = eline;
-    return etype;
+    if (ectx.type == TXLS_E_OK) return TXLS_E_OK;
+    if (line) *line = ectx.line;
+    return ectx.type;
 }
@@ -42,6 +42,25 @@ typedef struct TXLS *txls_t;
 #define TXLS_E_MEMORY                       (7) /* memory allocation failed */
 #define TXLS_E_OPEN                         (8) /* fail to open file */
 
+/* allocator of the cells and texts of a loaded txls, it must outlive the txls,
+ * the memory returned to the caller still comes from the C library */
+
+typedef struct
+{
+    void* (*alloc)(void* user, unsigned int size);  /**< allocate a block, NULL fail */
+    void (*free)(void* user, void* block);          /**< release a block of `alloc` */
+    void* user;                                     /**< user data of the callbacks, such as an arena */
+} TXLS_ALLOC;
+
+/* parse context, keeps the error information of one parsing call instead of the shared one */
+
+typedef struct
+{
+    const TXLS_ALLOC* alloc;                /**< input, allocator of the loaded txls, NULL the C library */
+    int type;                               /**< error type, @ref TXLS_E_xxx */
+    int line;                               /**< error line */
+} TXLS_CTX;
+
 /* cell alignment */
 
 #define TXLS_ALIGN_UNKNOW                   (0)
@@ -52,6 +71,7 @@ typedef struct TXLS *txls_t;
 /* Load txls */
 
 txls_t txls_loads(const char* text);
+txls_t txls_loads_ex(const char* text, TXLS_CTX* ctx);
 txls_t txls_file_load(const char* filename);
 
 /* When loading fails, use this method to locate the error */
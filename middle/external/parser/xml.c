@@ -11,10 +11,12 @@
  *    \copyright  Copyright (C) 2023 Lamdonn.
  ********************************************************************************************************/
 #include "xml.h"
+#include "fmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 /* dump buffer define */
 typedef struct
@@ -36,19 +38,14 @@ typedef struct ATTR
 typedef struct XML
 {
     struct XML *next;                       /**< next xml */
+    const XML_ALLOC* alloc;                 /**< allocator of the node, its name, text and attributes, NULL the C library */
     char* name;                             /**< name of xml */
     ATTR* attrs;                            /**< attributes */
     char* text;                             /**< text of xml */
     struct XML *child;                      /**< child of xml */
 } XML;
 
-static const char* lbegin = NULL;           /**< beginning of line */
-static int etype = XML_E_OK;                /**< type of error message */
-static int eline = 0;                       /**< line of error message */
-static int ecolumn = 0;                     /**< column of error message */
-
-/* set error message and type */
-#define E(type)                             (etype=(type),ecolumn=text-lbegin)
+static XML_CTX ectx;                        /**< error information of the calls without context */
 
 /**
  *  \brief for analysing failed parses
@@ -59,14 +56,14 @@ static int ecolumn = 0;                     /**< column of error message */
 int xml_error_info(int* line, int* column)
 {
     /* No error occurred, return directly */
-    if (etype == XML_E_OK) return XML_E_OK;
+    if (ectx.type == XML_E_OK) return XML_E_OK;
 
     /* Output the line and column where the error is located */
-    if (line) *line = eline;
-    if (column) *column = ecolumn;
+    if (line) *line = ectx.line;
+    if (column) *column = ectx.column;
 
     /* Return error type */
-    return etype;
+    return ectx.type;
 }
 
 /**
@@ -89,19 +86,43 @@ static int pow2gt(int x)
     return x + 1;
 }
 
+/**
+ *  \brief Allocate memory of a node with its allocator.
+ *  \param[in] alloc: allocator, NULL the C library
+ *  \param[in] size: size of memory
+ *  \return address of memory or NULL fail
+ */
+static void* xml_malloc(const XML_ALLOC* alloc, unsigned int size)
+{
+    return alloc ? alloc->alloc(alloc->user, size) : malloc(size);
+}
+
+/**
+ *  \brief Release memory of a node with its allocator.
+ *  \param[in] alloc: allocator, NULL the C library
+ *  \param[in] block: address of memory
+ *  \return none
+ */
+static void xml_free(const XML_ALLOC* alloc, void* block)
+{
+    if (alloc) alloc->free(alloc->user, block);
+    else free(block);
+}
+
 /**
  *  \brief Duplicate a given string.
  * 
+ *  \param[in] alloc Allocator of the copy, NULL the C library.
  *  \param[in] str String to be duplicated.
  *  \return Pointer to the duplicated string if successful, NULL otherwise.
  */
-static char* xml_strdup(const char* str)
+static char* xml_strdup(const XML_ALLOC* alloc, const char* str)
 {
     int size = (int)strlen(str) + 1;
     char* s;
 
     /* Allocate memory for the new string */
-    s = (char*)malloc(size);
+    s = (char*)xml_malloc(alloc, size);
     if (!s) return NULL;
 
     /* Copy the given string into the allocated memory */
@@ -159,41 +180,17 @@ static int expansion(BUFFER *buf, unsigned int needed)
 #define buf_puts(s, len)       do{for(int i=0;i<len;i++)buf_putc((s)[i]);}while(0) /* put the specified length character set to buf */
 #define buf_end()              (buf->address[buf->end]) /* obtain the address at the tail of buf */
 
-/**
-* \brief Skip leading whitespace characters in a text.
-*
-* \param[in] text The text to process.
-* \return A pointer to the first non-whitespace character in the text.
-*/
-static const char* skip(const char* text)
-{
-    while (text && *text && (unsigned char)(*text) <= ' ')
-    {
-        /* when a newline character is encountered, record the current parsing line */
-        if (*text == '\n') 
-        { 
-            /* Increase eline and set lbegin to the current position */
-            eline++; 
-            lbegin = text; 
-        } 
-
-        /* Move to the next character */
-        text++;
-    }
-
-    /* Return a pointer to the first non-whitespace character */
-    return text; 
-}
-
 /**
 * \brief Create a new ATTR object.
 *
+* \param[in] alloc Allocator of the node the attribute belongs to.
 * \return A pointer to a newly allocated ATTR object with its memory initialized to zero.
 */
-static ATTR* new_attr()
+static ATTR* new_attr(const XML_ALLOC* alloc)
 {
     /* Allocate memory for a new ATTR object */
-    ATTR* attr = (ATTR*)malloc(sizeof(ATTR));
+    ATTR* attr = (ATTR*)xml_malloc(alloc, sizeof(ATTR));
+    if (!attr) return NULL;
 
     /* Initialize the memory of the ATTR object to zero */
     memset(attr, 0, sizeof(ATTR));
@@ -204,9 +201,10 @@ static ATTR* new_attr()
 /**
 * \brief Delete a linked list of ATTR objects and free the memory.
 *
+* \param[in] alloc Allocator of the node the attributes belong to.
 * \param[in] attrs The head of the linked list of ATTR objects to delete.
 */
-static void attribute_delete(ATTR* attrs)
+static void attribute_delete(const XML_ALLOC* alloc, ATTR* attrs)
 {
     ATTR* next;
 
@@ -216,13 +214,13 @@ static void attribute_delete(ATTR* attrs)
         next = attrs->next;
 
         /* Free the memory allocated for the name */
-        if (attrs->name) free(attrs->name);
+        if (attrs->name) xml_free(alloc, attrs->name);
 
         /* Free the memory allocated for the value */
-        if (attrs->value) free(attrs->value);
+        if (attrs->value) xml_free(alloc, attrs->value);
 
         /* Free the memory allocated for the current ATTR object */
-        free(attrs);
+        xml_free(alloc, attrs);
 
         /* Move to the next ATTR object in the linked list */
         attrs = next;
@@ -232,18 +230,20 @@ static void attribute_delete(ATTR* attrs)
 /**
 * \brief Create a new XML node.
 *
+* \param[in] alloc Allocator of the node, NULL the C library.
 * \return A pointer to a newly allocated XML node object with its memory initialized to zero, or NULL if memory allocation fails.
 */
-static xml_t new_node(void)
+static xml_t new_node(const XML_ALLOC* alloc)
 {
     /* Allocate memory for a new XML node object */
-    xml_t node = (xml_t)malloc(sizeof(XML)); 
+    xml_t node = (xml_t)xml_malloc(alloc, sizeof(XML)); 
 
     /* Check if memory allocation fails, return NULL */
     if (!node) return NULL; 
 
     /* Initialize the memory of the XML node object to zero */
     memset(node, 0, sizeof(XML)); 
+    node->alloc = alloc;
 
     /* Return a pointer to the newly created XML node object */
     return node; 
@@ -261,13 +261,13 @@ void xml_delete(xml_t xml)
     if (xml)
     {
         /* Free the memory allocated for the name */
-        if (xml->name) free(xml->name); 
+        if (xml->name) xml_free(xml->alloc, xml->name); 
 
         /* Free the memory allocated for the text */
-        if (xml->text) free(xml->text); 
+        if (xml->text) xml_free(xml->alloc, xml->text); 
 
         /* Delete the attributes of the XML node */
-        if (xml->attrs) attribute_delete(xml->attrs); 
+        if (xml->attrs) attribute_delete(xml->alloc, xml->attrs); 
 
         /* Recursively delete the child node */
         while (xml->child)
@@ -283,7 +283,7 @@ void xml_delete(xml_t xml)
         }
 
         /* Free the memory allocated for the XML node itself */
-        free(xml); 
+        xml_free(xml->alloc, xml); 
     }
 }
 
@@ -331,10 +331,11 @@ static int check_name(const char* name, int *len)
 /**
 * \brief Duplicate an XML node name with validity check.
 *
+* \param[in] alloc Allocator of the copy, NULL the C library.
 * \param[in] name The name of the XML node to duplicate.
 * \return A newly allocated string containing the duplicated name, or NULL if the name is invalid or memory allocation fails.
 */
-static char *name_strdup(const char* name)
+static char *name_strdup(const XML_ALLOC* alloc, const char* name)
 {
     char *s;
     int len = 0, ret = 0;
@@ -344,7 +345,7 @@ static char *name_strdup(const char* name)
     if (ret == 0 || ret == 2) return NULL;
 
     /* Allocating space */
-    s = malloc(len + 1); 
+    s = xml_malloc(alloc, len + 1); 
     if (!s) return NULL;
 
     /* Copy string */
@@ -357,10 +358,11 @@ static char *name_strdup(const char* name)
 /**
 * \brief Duplicate an XML node value with validity check.
 *
+* \param[in] alloc Allocator of the copy, NULL the C library.
 * \param[in] value The value of the XML node to duplicate.
 * \return A newly allocated string containing the duplicated value, or NULL if the value contains non-printable characters or memory allocation fails.
 */
-static char *value_strdup(const char* value)
+static char *value_strdup(const XML_ALLOC* alloc, const char* value)
 {
     char *s = (char *)value;
     int len = 0;
@@ -373,7 +375,7 @@ static char *value_strdup(const char* value)
     }
 
     /* Allocating space and assigning */
-    s = malloc(len + 1);
+    s = xml_malloc(alloc, len + 1);
     if (!s) return NULL;
     memcpy(s, value, len);
     s[len] = 0;
@@ -393,11 +395,11 @@ xml_t xml_create(const char* name)
     if (!name) return NULL;
 
     /* Create a new XML node */
-    xml = new_node();
+    xml = new_node(NULL);
     if (!xml) return NULL;
 
     /* Assign to the name of XML */
-    xml->name = name_strdup(name);
+    xml->name = name_strdup(NULL, name);
     if (!xml->name) 
     {
         free(xml); 
@@ -424,15 +426,15 @@ int xml_add_attribute(xml_t xml, const char *name, const char *value)
     if (!value) return 0;
 
     /* Create a new XML attribute */
-    attr = new_attr();
+    attr = new_attr(xml->alloc);
     if (!attr) return 0;
 
     /* Assign to the attribute name */
-    attr->name = name_strdup(name);
+    attr->name = name_strdup(xml->alloc, name);
     if (!attr->name) goto FAIL;
 
     /* Assign to the attribute value */
-    attr->value = value_strdup(value);
+    attr->value = value_strdup(xml->alloc, value);
     if (!attr->value) goto FAIL;
 
     /* Attach attribute */
@@ -442,9 +444,9 @@ int xml_add_attribute(xml_t xml, const char *name, const char *value)
     return 1;
 
 FAIL:
-    if (attr->name) free(attr->name);
-    if (attr->value) free(attr->value);
-    free(attr);
+    if (attr->name) xml_free(xml->alloc, attr->name);
+    if (attr->value) xml_free(xml->alloc, attr->value);
+    xml_free(xml->alloc, attr);
     return 0;
 }
 
@@ -488,11 +490,11 @@ int xml_remove_attribute(xml_t xml, const char *name, int index)
     else xml->attrs = attr->next;
 
     /* Free the memory for the attribute name and value */
-    if (attr->name) free(attr->name);
-    if (attr->value) free(attr->value);
+    if (attr->name) xml_free(xml->alloc, attr->name);
+    if (attr->value) xml_free(xml->alloc, attr->value);
 
     /* Free the memory for the attribute object */
-    free(attr);
+    xml_free(xml->alloc, attr);
 
     return 1;
 }
@@ -671,11 +673,11 @@ int xml_set_text(xml_t xml, const char *text)
     if (!text) return 0;
 
     /* Duplicate the text content */
-    s = xml_strdup(text);
+    s = xml_strdup(xml->alloc, text);
     if (!s) return 0;
 
     /* Free the previous text content if it exists */
-    if (xml->text) free(xml->text);
+    if (xml->text) xml_free(xml->alloc, xml->text);
 
     /* Set the text content of the XML node */
     xml->text = s;
@@ -918,704 +920,1358 @@ int xml_file_dump(xml_t xml, char* filename)
     return len;
 }
 
+/* reader states */
+#define READ_HEAD                           (0) /* at the beginning, the head notes may follow */
+#define READ_ROOT                           (1) /* before the root element */
+#define READ_CONTENT                        (2) /* in the content of an element */
+#define READ_ATTR                           (3) /* in the attributes of the reported start tag */
+#define READ_EMPTY                          (4) /* after the attributes of the reported `<name/>` */
+#define READ_DONE                           (5) /* the root element has ended */
+#define READ_FAIL                           (6) /* stopped on error */
+
+/* results of the lexing steps besides the event types, 0 is error */
+#define LEX_MORE                            (-1) /* the data ends inside the token */
+#define LEX_NEXT                            (-2) /* the state changed without an event */
+
+#define is_space(c)                         ((unsigned char)(c) <= ' ')
+#define is_alpha(c)                         (((c) | 0x20) >= 'a' && ((c) | 0x20) <= 'z')
+#define is_name_head(c)                     ((unsigned char)(c) >= 0x80 || is_alpha(c))
+#define is_name_char(c)                     (is_name_head(c) || ((c) >= '0' && (c) <= '9') || (c)=='_' || (c)=='-' || (c)=='.' || (c)==':')
+
 /**
- *  \brief skip XML comments.
- *  \param[in] text: The text content to skip.
- *  \return The character address after skip
+ *  \brief Count the lines of the reader data up to a position.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position in data
+ *  \return none
  */
-static const char* skip_comment(const char *text)
+static void reader_count(XML_READER* reader, unsigned int pos)
 {
-    if (*text == '<')
+    const char* s = reader->data + reader->counted;
+    const char* e = reader->data + pos;
+
+    while (s < e && (s = (const char*)memchr(s, '\n', e - s)))
     {
-        /* Matched to the front of the comment label */
-        if (!strncmp(text, "<!--", 4))
-        {
-            /* skip "<!--" */
-            text += 4;
+        reader->lines++;
+        reader->lbegin = reader->offset + (s - reader->data);
+        s++;
+    }
 
-            while (*text)
-            {
-                /* Because the tail is "-->", skip characters that are not '-' first */
-                while (*text && *text != '-')
-                {
-                    /* Record line breaks */
-                    if (*text == '\n') 
-                    {
-                        eline++, lbegin = text;
-                    }
-                    text++;
-                }
+    if (pos > reader->counted) reader->counted = pos;
+}
 
-                /* It ends at the end of the string, and the annotation does not form a closed interval */
-                if (!*text) 
-                {
-                    E(XML_E_COMMENT); 
-                    return text;
-                }
+/**
+ *  \brief Locate a position of the reader data as the line and column of the reader.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position in data, not before the last located one
+ *  \return none
+ */
+static void reader_mark(XML_READER* reader, unsigned int pos)
+{
+    reader_count(reader, pos);
 
-                /* Matched to the end of the annotation label, the annotation has formed a complete closed interval */
-                if (!strncmp(text, "-->", 3)) break;
+    reader->line = reader->lines;
+    reader->column = (int)(reader->offset + pos - reader->lbegin);
+}
 
-                text++;
-            }
+/**
+ *  \brief Stop the reader on error.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position of error in data
+ *  \param[in] type: error type
+ *  \return 0, for returning from the lexing steps
+ */
+static int reader_fail(XML_READER* reader, unsigned int pos, int type)
+{
+    reader_mark(reader, pos);
+    reader->error = type;
+    reader->state = READ_FAIL;
+    return 0;
+}
 
-            /* skip "-->" */
-            text += 3;
-        }
-    }
-    return text;
-} 
+/**
+ *  \brief Move the data not yet consumed to the front of the stream buffer.
+ *  \param[in] reader: reader
+ *  \return none
+ */
+static void reader_slide(XML_READER* reader)
+{
+    if (reader->begin == 0) return;
+
+    /* The lines of the data moved out are counted first */
+    reader_count(reader, reader->begin);
+    reader->counted -= reader->begin;
+
+    memmove(reader->buffer, reader->buffer + reader->begin, reader->end - reader->begin);
+    reader->offset += reader->begin;
+    reader->end -= reader->begin;
+    reader->begin = 0;
+}
 
 /**
- *  \brief Parsing name.
- *  \param[in] text: The text content to parse.
- *  \param[out] name: Output the name generated by parsing
- *  \return The character address after parse
+ *  \brief Read more data into the stream buffer.
+ *  \param[in] reader: reader
+ *  \return 1 success or 0 fail
  */
-static const char* parse_name(const char *text, char **name)
+static int reader_fill(XML_READER* reader)
 {
-    int len = 0, ret = 0;
-    char *s;
+    int n;
 
-    /* Check the validity of the name and obtain the length */
-    ret = check_name(text, &len);
-    if (ret == 0 || ret == 1) 
-    {
-        E(XML_E_ILLEGAL); 
-        return text + len;
-    }
+    reader_slide(reader);
 
-    /* Allocate space for name */
-    s = (char*)malloc(len + 1);
-    if (!s) 
-    {
-        E(XML_E_MEMORY); 
-        return text + len;
-    }
+    /* The token being lexed is as large as the buffer */
+    if (reader->end >= reader->size) return reader_fail(reader, reader->end, XML_E_OVERFLOW);
 
-    /* Assign a value to name and output it */
-    memcpy(s, text, len);
-    s[len] = 0;
-    *name = s;
+    n = reader->read(reader->context, reader->buffer + reader->end, (int)(reader->size - reader->end));
+    if (n < 0) return reader_fail(reader, reader->end, XML_E_READ);
 
-    return text + len;
+    if (n == 0) reader->eof = 1;
+    else reader->end += n;
+
+    return 1;
 }
 
 /**
- *  \brief Parsing one attribute.
- *  \param[in] text: The text content to parse.
- *  \param[out] attr: Output the attributes generated by parsing
- *  \return The character address after parse
+ *  \brief Skip whitespace characters of the reader data.
+ *  \param[in] reader: reader
+ *  \param[in] pos: start position
+ *  \return position of the first non-whitespace character, or end
  */
-static const char* parse_one_attribute(const char *text, ATTR* attr)
+static unsigned int skip_space(XML_READER* reader, unsigned int pos)
 {
-    char* s;
-    int len = 0, ret = 0;
-    char *name, *value;
-    char q = 0; /* quote: single or double */
+    while (pos < reader->end && is_space(reader->data[pos])) pos++;
+    return pos;
+}
+
+/**
+ *  \brief Match a string at a position of the reader data.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position
+ *  \param[in] s: string
+ *  \param[in] n: length of string
+ *  \return 1 matched, 0 not matched, LEX_MORE undecided before more data
+ */
+static int match(XML_READER* reader, unsigned int pos, const char* s, unsigned int n)
+{
+    unsigned int have = reader->end - pos;
 
-    text = skip(text);
-    if (*text == '>') return text; /* null attributes */
+    if (have >= n) return memcmp(reader->data + pos, s, n) == 0;
+    if (memcmp(reader->data + pos, s, have) != 0) return 0;
 
-    /* Check the validity of the name and obtain the length */
-    ret = check_name(text, &len);
-    /* Encountered illegal characters */
-    if (ret == 0)
+    return reader->eof ? 0 : LEX_MORE;
+}
+
+/**
+ *  \brief Find a string in the reader data.
+ *  \param[in] reader: reader
+ *  \param[in] pos: start position
+ *  \param[in] s: string
+ *  \param[in] n: length of string
+ *  \param[out] out: position after the string
+ *  \return 1 found or 0 not found
+ */
+static int find(XML_READER* reader, unsigned int pos, const char* s, unsigned int n, unsigned int* out)
+{
+    const char* d = reader->data;
+    const char* c;
+
+    while (pos + n <= reader->end)
     {
-        if (text[len] != '=') 
+        c = (const char*)memchr(d + pos, s[0], reader->end - pos - n + 1);
+        if (!c) break;
+
+        pos = c - d;
+        if (!memcmp(c, s, n))
         {
-            E(XML_E_ILLEGAL); 
-            return text + len;
+            *out = pos + n;
+            return 1;
         }
-    }
-    /* Parsed to the end of the text */
-    else if (ret == 1) 
-    {
-        E(XML_E_END); 
-        return text + len;
+        pos++;
     }
 
-    /* Allocate space for name */
-    name = (char*)malloc(len + 1);
-    if (!name) 
-    {
-        E(XML_E_MEMORY); 
-        return text + len;
-    }
+    return 0;
+}
+
+/**
+ *  \brief Lex a name.
+ *  \param[in] reader: reader
+ *  \param[in] pos: start position
+ *  \param[out] out: end of name
+ *  \param[in] type: error type when the input ends before the name
+ *  \return 1 success, 0 fail, LEX_MORE
+ */
+static int lex_name(XML_READER* reader, unsigned int pos, unsigned int* out, int type)
+{
+    const char* d = reader->data;
 
-    /* Assign a value to name */
-    strncpy(name, text, len);
-    name[len] = 0;
+    if (pos >= reader->end) return reader->eof ? reader_fail(reader, pos, type) : LEX_MORE;
+    if (!is_name_head(d[pos])) return reader_fail(reader, pos, XML_E_ILLEGAL);
 
-    /* Recorde name */
-    attr->name = name;
+    for (pos++; pos < reader->end && is_name_char(d[pos]); pos++);
 
-    /* Skip */
-    text += len;
-    text = skip(text);
+    /* The name may go on in the data not yet read */
+    if (pos >= reader->end && !reader->eof) return LEX_MORE;
 
-    /* No separator for name-value encountered */
-    if (*text != '=') 
-    {
-        E(XML_E_VALUE); 
-        return text;
-    }
+    *out = pos;
 
-    /* Record whether the attribute value is currently included in `'` or in `"` */
-    text = skip(++text);
-    if (*text == '\'') q = '\'';
-    else if (*text == '\"') q = '\"';
-    else 
-    {
-        E(XML_E_QUOTE); 
-        return text;
-    }
+    return 1;
+}
 
-    /* Initialize the value used to parse the value variable */
-    text++;
-    s = (char *)text;
-    len = 0;
+/**
+ *  \brief Lex an attribute `name="value"`.
+ *  \param[in] reader: reader
+ *  \param[in] pos: start position
+ *  \param[out] event: output name and raw value, can be NULL
+ *  \param[out] out: position after the attribute
+ *  \return 1 success, 0 fail, LEX_MORE
+ */
+static int lex_attribute(XML_READER* reader, unsigned int pos, XML_EVENT* event, unsigned int* out)
+{
+    const char* d = reader->data;
+    const char* s;
+    unsigned int name = pos, value;
+    int ret;
+    char q;
+
+    ret = lex_name(reader, pos, &pos, XML_E_END);
+    if (ret != 1) return ret;
 
-    /* How much space is needed for pre exploration and how many escape characters need to be parsed */
-    while (*s != q)
+    if (event)
     {
-        if (*s == '&')
-        {
-            if      (!strncmp(s, "&lt;", 4))   s += 3;
-            else if (!strncmp(s, "&gt;", 4))   s += 3;
-            else if (!strncmp(s, "&amp;", 5))  s += 4;
-            else if (!strncmp(s, "&apos;", 6)) s += 5;
-            else if (!strncmp(s, "&quot;", 6)) s += 5;
-        }
-        len++, s++;
+        event->name.text = d + name;
+        event->name.length = pos - name;
     }
 
-    /* Allocate space to store parsed content */
-    value = (char*)malloc(len + 1);
-    if (!value) 
+    /* Separator of name and value */
+    pos = skip_space(reader, pos);
+    if (pos >= reader->end) return reader->eof ? reader_fail(reader, pos, XML_E_END) : LEX_MORE;
+    if (d[pos] != '=') return reader_fail(reader, pos, XML_E_VALUE);
+
+    /* The value is included in `'` or in `"` */
+    pos = skip_space(reader, pos + 1);
+    if (pos >= reader->end) return reader->eof ? reader_fail(reader, pos, XML_E_END) : LEX_MORE;
+    q = d[pos];
+    if (q != '\'' && q != '\"') return reader_fail(reader, pos, XML_E_QUOTE);
+
+    value = ++pos;
+    s = (const char*)memchr(d + pos, q, reader->end - pos);
+    if (!s) return reader->eof ? reader_fail(reader, reader->end, XML_E_QUOTE) : LEX_MORE;
+
+    if (event)
     {
-        E(XML_E_MEMORY); 
-        return text;
+        event->value.text = d + value;
+        event->value.length = (unsigned int)(s - d) - value;
     }
 
-    /* Store character by character */
-    s = value;
-    while (*text != q)
+    *out = (unsigned int)(s - d) + 1;
+
+    return 1;
+}
+
+/**
+ *  \brief Lex a whole start tag, so that its attributes can be reported without reading.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position of `<`
+ *  \param[out] event: output name
+ *  \return 1 success, 0 fail, LEX_MORE
+ */
+static int lex_start(XML_READER* reader, unsigned int pos, XML_EVENT* event)
+{
+    const char* d = reader->data;
+    unsigned int name = pos + 1, s;
+    int ret;
+
+    ret = lex_name(reader, name, &pos, XML_E_END);
+    if (ret != 1) return ret;
+
+    event->name.text = d + name;
+    event->name.length = pos - name;
+    reader->cursor = pos;
+
+    while (1)
     {
-        /* Record line breaks */
-        if (*text == '\n') 
+        s = skip_space(reader, pos);
+        if (s >= reader->end) return reader->eof ? reader_fail(reader, s, XML_E_END) : LEX_MORE;
+
+        if (d[s] == '>')
         {
-            eline++, lbegin = text;
+            reader->tag = s + 1;
+            reader->empty = 0;
+            return 1;
         }
 
-        /* Record escape characters */
-        if (*text == '&')
+        if (d[s] == '/')
         {
-            if      (!strncmp(text, "&lt;", 4))   {text += 4; *s++ = '<'; continue;}
-            else if (!strncmp(text, "&gt;", 4))   {text += 4; *s++ = '>'; continue;}
-            else if (!strncmp(text, "&amp;", 5))  {text += 5; *s++ = '&'; continue;}
-            else if (!strncmp(text, "&apos;", 6)) {text += 6; *s++ = '\''; continue;}
-            else if (!strncmp(text, "&quot;", 6)) {text += 6; *s++ = '\"'; continue;}
+            ret = match(reader, s, "/>", 2);
+            if (ret != 1) return ret == 0 ? reader_fail(reader, s, XML_E_ILLEGAL) : ret;
+            reader->tag = s + 2;
+            reader->empty = 1;
+            return 1;
         }
 
-        /* Normal character */
-        *s++ = *text++;
+        ret = lex_attribute(reader, s, NULL, &pos);
+        if (ret != 1) return ret;
     }
-
-    /* Add the end of the string and record it */
-    value[len] = 0;
-    attr->value = value;
-
-    return text + 1; /* skip quote */
 }
 
 /**
- *  \brief Parse all attributes of the entire label.
- *  \param[in] text: The text content to parse.
- *  \param[out] out: Output the attributes generated by parsing
- *  \return The character address after parse
+ *  \brief Report a start tag at the begin of data.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return XML_EVENT_START, 0 fail, LEX_MORE
  */
-static const char* parse_attributes(const char *text, ATTR **out)
+static int read_start(XML_READER* reader, XML_EVENT* event)
 {
-    ATTR *first = NULL, *prev = NULL, *attr = NULL;
+    unsigned int len;
+    int ret;
 
-    *out = NULL; /* Reset output */
+    ret = lex_start(reader, reader->begin, event);
+    if (ret != 1) return ret;
 
-    /* Create new attributes to record the results of parsing */
-    attr = new_attr();
-    if (!attr) 
+    /* Keep the name to match the end tag */
+    if (reader->names)
     {
-        E(XML_E_MEMORY); 
-        return text;
+        len = event->name.length;
+        if (reader->capacity - reader->top < len + sizeof(len)) return reader_fail(reader, reader->begin, XML_E_OVERFLOW);
+        memcpy(reader->names + reader->top, event->name.text, len);
+        memcpy(reader->names + reader->top + len, &len, sizeof(len));
+        reader->top += len + sizeof(len);
     }
 
-    text = parse_one_attribute(text, attr);
-    /* parse error, or no attribute, return directly */
-    if (etype != XML_E_OK || !attr->name) 
-    {
-        attribute_delete(attr); 
-        return text;
-    } 
-    
-    /* Continue parsing other attributes */
-    first = attr, prev = first, *out = first;
-    while (*text)
+    /* The tag stays in data until its attributes have been reported */
+    reader->depth++;
+    reader->state = READ_ATTR;
+    reader_mark(reader, reader->begin);
+
+    event->value.text = NULL;
+    event->value.length = 0;
+
+    return XML_EVENT_START;
+}
+
+/**
+ *  \brief Report the end of an element, the end tag is `</name>` or the start tag `<name/>`.
+ *  \param[in] reader: reader
+ *  \param[in] pos: position of the tag
+ *  \param[in] next: position after the tag
+ *  \param[out] event: event with the name of the tag
+ *  \return XML_EVENT_END or 0 fail
+ */
+static int read_end(XML_READER* reader, unsigned int pos, unsigned int next, XML_EVENT* event)
+{
+    unsigned int len;
+
+    if (reader->names)
     {
-        /* Create new attributes to record the results of parsing */
-        attr = new_attr();
-        if (!attr) 
+        memcpy(&len, reader->names + reader->top - sizeof(len), sizeof(len));
+        if (len != event->name.length || memcmp(reader->names + reader->top - sizeof(len) - len, event->name.text, len))
         {
-            E(XML_E_MEMORY); 
-            return text;
+            return reader_fail(reader, pos, XML_E_LABEL);
         }
+        reader->top -= len + sizeof(len);
+    }
 
-        /* Parse other attributes */
-        text = parse_one_attribute(text, attr);
-        /* parse error */
-        if (etype != XML_E_OK) 
-        {
-            attribute_delete(attr); 
-            return text;
-        }
-        /* end attribute, all attributes have been parsed */
-        if (!attr->name) 
-        {
-            attribute_delete(attr); 
-            break;
-        } 
+    reader_mark(reader, pos);
+    reader->begin = next;
 
-        /* Link */
-        prev->next = attr;
-    }
+    reader->depth--;
+    reader->state = reader->depth > 0 ? READ_CONTENT : READ_DONE;
 
-    return text;
+    event->value.text = NULL;
+    event->value.length = 0;
+
+    return XML_EVENT_END;
 }
 
 /**
- *  \brief Parse text.
- *  \param[in] text: The text content to parse.
- *  \param[out] out: Output the attributes generated by parsing
- *  \return The character address after parse
+ *  \brief Skip the head notes `<?xml version="1.0" encoding="UTF-8"?>` at the beginning of the input.
+ *  \param[in] reader: reader
+ *  \return LEX_NEXT, 0 fail, LEX_MORE
  */
-static const char* parse_text(const char *text, char **out)
+static int read_head(XML_READER* reader)
 {
-    char *s, *t;
-    int len = 0;
+    const char* d = reader->data;
+    XML_EVENT attr;
+    unsigned int pos, s;
+    int ret, count = 0;
 
-    s = (char *)skip(text);
-    /* Not an escape, but a separate '<' character is not allowed */
-    if (*s == '<' && s[1] != '!') 
+    ret = match(reader, 0, "<?", 2);
+    if (ret == 1)
     {
-        *out = NULL; 
-        return s;
-    }
+        ret = lex_name(reader, 2, &pos, XML_E_ILLEGAL);
+        if (ret != 1) return ret;
 
-    /* Predict the length of text to allocate space */
-    while (*s)
-    {
-        /* Text contains special escape */
-        if (*s == '<')
+        /* Must comply with XML file header signature, `version` first and then `encoding` */
+        if (pos == 5 && !memcmp(d + 2, "xml", 3))
         {
-            /* Skip comments */
-            if (!strncmp(s, "<!--", 4))
+            while (1)
             {
-                s += 4;
-                while (*s)
+                s = skip_space(reader, pos);
+                if (s >= reader->end) return reader->eof ? reader_fail(reader, s, XML_E_NOTES) : LEX_MORE;
+                if (!is_name_head(d[s])) break;
+
+                ret = lex_attribute(reader, s, &attr, &pos);
+                if (ret != 1) return ret;
+
+                if (count == 0 && (attr.name.length != 7 || memcmp(attr.name.text, "version", 7)))
                 {
-                    while (*s && *s != '-') s++;
-                    if (!*s) {E(XML_E_COMMENT); return s;}
-                    if (!strncmp(s, "-->", 3)) break;
-                    s++;
+                    return reader_fail(reader, s, XML_E_VERSION);
                 }
-                s += 3;
-                continue;
-            }
-            /* Get CDATA */
-            else if (!strncmp(s, "<![CDATA[", 9))
-            {
-                s += 9;
-                while (*s)
+                if (count == 1 && (attr.name.length != 8 || memcmp(attr.name.text, "encoding", 8)))
                 {
-                    while (*s && *s != ']') s++, len++;
-                    if (!*s) {E(XML_E_COMMENT); return s;}
-                    if (!strncmp(s, "]]>", 3)) break;
-                    s++, len++;
+                    return reader_fail(reader, s, XML_E_ENCODING);
                 }
-                s += 3;
-                continue;
+                count++;
             }
-            else break;
+            if (count == 0) return reader_fail(reader, s, XML_E_VERSION);
         }
 
-        /* Normal escape characters */
-        if (*s == '&')
-        {
-            if      (!strncmp(s, "&lt;", 4))   s += 3;
-            else if (!strncmp(s, "&gt;", 4))   s += 3;
-            else if (!strncmp(s, "&amp;", 5))  s += 4;
-            else if (!strncmp(s, "&apos;", 6)) s += 5;
-            else if (!strncmp(s, "&quot;", 6)) s += 5;
-        }
-        s++, len++;
+        /* Determine whether the label forms a complete closed interval */
+        pos = skip_space(reader, pos);
+        ret = match(reader, pos, "?>", 2);
+        if (ret != 1) return ret == 0 ? reader_fail(reader, pos, XML_E_NOTES) : ret;
+
+        reader->begin = pos + 2;
     }
+    else if (ret != 0) return ret;
+
+    reader->state = READ_ROOT;
+
+    return LEX_NEXT;
+}
 
-    /* Allocate space */
-    t = (char *)malloc(len + 1);
-    if (!t) 
+/**
+ *  \brief Skip comments before the root element and report its start.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return XML_EVENT_START, 0 fail, LEX_MORE
+ */
+static int read_root(XML_READER* reader, XML_EVENT* event)
+{
+    unsigned int pos;
+    int ret;
+
+    while (1)
     {
-        E(XML_E_MEMORY); 
-        return text;
+        pos = skip_space(reader, reader->begin);
+        reader->begin = pos;
+
+        if (pos >= reader->end) return reader->eof ? reader_fail(reader, pos, XML_E_TEXT) : LEX_MORE;
+        if (reader->data[pos] != '<') return reader_fail(reader, pos, XML_E_LABEL);
+
+        ret = match(reader, pos, "<!--", 4);
+        if (ret != 1) break;
+
+        if (!find(reader, pos + 4, "-->", 3, &pos))
+        {
+            return reader->eof ? reader_fail(reader, reader->end, XML_E_COMMENT) : LEX_MORE;
+        }
+        reader->begin = pos;
     }
+    if (ret == LEX_MORE) return ret;
+
+    return read_start(reader, event);
+}
+
+/**
+ *  \brief Report the text, the next start tag or the end tag in the content of an element.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return event type, 0 fail, LEX_MORE
+ */
+static int read_content(XML_READER* reader, XML_EVENT* event)
+{
+    const char* d = reader->data;
+    const char* s;
+    unsigned int pos = reader->begin, t;
+    int blank = 1, ret;
 
-    /* Similar work when repeatedly predicting length to store characters in allocated space */
-    *out = t;
-    while (text < s)
+    /* The text goes up to the next tag, the comments and CDATA sections in it belong to it */
+    while (1)
     {
-        /* Skip comments */
-        text = skip_comment(text);
-        if (etype != XML_E_OK) return text;
+        s = (const char*)memchr(d + pos, '<', reader->end - pos);
+        t = s ? (unsigned int)(s - d) : reader->end;
+        for (; blank && pos < t; pos++) if (!is_space(d[pos])) blank = 0;
+        pos = t;
 
-        if (*text == '<')
+        /* No closing tag */
+        if (!s) return reader->eof ? reader_fail(reader, pos, XML_E_LABEL) : LEX_MORE;
+
+        /* Most tags are not comments or CDATA sections */
+        if (pos + 1 < reader->end && d[pos + 1] != '!') break;
+
+        ret = match(reader, pos, "<!--", 4);
+        if (ret == 1)
         {
-            if (!strncmp(text, "<![CDATA[", 9)) /* get CDATA */
+            if (!find(reader, pos + 4, "-->", 3, &pos))
             {
-                text += 9;
-                while (*text)
-                {
-                    while (*text && *text != ']')
-                    {
-                        if (*text == '\n') {eline++, lbegin = text;}
-                        *t++ = *text++;
-                    }
-                    if (!*text) {E(XML_E_CDATA); return text;}
-                    if (!strncmp(text, "]]>", 3)) break;
-                    *t++ = *text++;
-                }
-                text += 3;
-                continue;
+                return reader->eof ? reader_fail(reader, reader->end, XML_E_COMMENT) : LEX_MORE;
             }
+            blank = 0;
+            continue;
         }
-        if (*text == '\n') {eline++, lbegin = text;}
-        if (*text == '&')
+        if (ret != 0) return ret;
+
+        ret = match(reader, pos, "<![CDATA[", 9);
+        if (ret == 1)
         {
-            if      (!strncmp(text, "&lt;", 4))   {text += 4; *t++ = '<'; continue;}
-            else if (!strncmp(text, "&gt;", 4))   {text += 4; *t++ = '>'; continue;}
-            else if (!strncmp(text, "&amp;", 5))  {text += 5; *t++ = '&'; continue;}
-            else if (!strncmp(text, "&apos;", 6)) {text += 6; *t++ = '\''; continue;}
-            else if (!strncmp(text, "&quot;", 6)) {text += 6; *t++ = '\"'; continue;}
+            if (!find(reader, pos + 9, "]]>", 3, &pos))
+            {
+                return reader->eof ? reader_fail(reader, reader->end, XML_E_CDATA) : LEX_MORE;
+            }
+            blank = 0;
+            continue;
         }
-        *t++ = *text++;
+        if (ret != 0) return ret;
+
+        break;
     }
 
-    /* Add string terminator */
-    *t = 0;
+    /* Report the text before the tag, a blank one is dropped */
+    if (!blank)
+    {
+        reader_mark(reader, reader->begin);
+
+        event->name.text = NULL;
+        event->name.length = 0;
+        event->value.text = d + reader->begin;
+        event->value.length = pos - reader->begin;
+
+        reader->begin = pos;
+
+        return XML_EVENT_TEXT;
+    }
+    reader->begin = pos;
+
+    /* label tail */
+    ret = match(reader, pos, "</", 2);
+    if (ret == 1)
+    {
+        if (pos + 2 < reader->end && !is_name_head(d[pos + 2])) return reader_fail(reader, pos + 2, XML_E_LABEL);
+        ret = lex_name(reader, pos + 2, &t, XML_E_LABEL);
+        if (ret != 1) return ret;
+
+        /* Determine if a </name> end tag has been formed */
+        if (t >= reader->end || d[t] != '>') return reader_fail(reader, t, XML_E_LABEL);
+
+        event->name.text = d + pos + 2;
+        event->name.length = t - pos - 2;
+
+        return read_end(reader, pos, t + 1, event);
+    }
+    if (ret != 0) return ret;
 
-    return text;
+    return read_start(reader, event);
 }
 
 /**
- *  \brief Parse xml node.
- *  \param[in] text: The text content to parse.
- *  \param[out] node: Output the node information
- *  \return The character address after parse
+ *  \brief Report the next attribute of the start tag at the begin of data.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return XML_EVENT_ATTR or LEX_NEXT at the end of the tag
  */
-static const char* parse_node(const char* text, xml_t node)
+static int read_attribute(XML_READER* reader, XML_EVENT* event)
 {
-    xml_t tail = NULL, child;
-    ATTR* attrs = NULL;
-    int len = 0;
-    char *out = NULL;
-    const char *s = NULL;
-    
-    /* Get '<' */
-    while (*text)
+    unsigned int pos = skip_space(reader, reader->cursor);
+
+    /* The tag has been checked by `lex_start()`, so only its end or an attribute can follow */
+    if (reader->data[pos] == '>' || reader->data[pos] == '/')
     {
-        /* Exploring Character `<` */
-        text = skip(text);
-        if (*text != '<') 
+        if (reader->empty)
         {
-            E(XML_E_LABEL); 
-            return text;
+            reader->state = READ_EMPTY;
         }
-
-        /* Check if this is a comment, if it is, skip it */
-        s = skip_comment(text);
-        if (etype != XML_E_OK) return text;
-
-        /* Indicates that the middle comment has been skipped */
-        if (s > text) 
+        else
         {
-            text = s; 
-            continue;
-        }
-        /* Normal `<` */
-        else 
-        {
-            text = s; 
-            break;
+            reader->begin = reader->tag;
+            reader->state = READ_CONTENT;
         }
+        return LEX_NEXT;
     }
-    /* Skip `<` */
-    text++;
 
-    /* parse name */
-    s = parse_name(text, &node->name);
-    if (etype != XML_E_OK) return s;
-    len = s - text;
-    text = s;
+    lex_attribute(reader, pos, event, &reader->cursor);
+    reader_mark(reader, pos);
+
+    return XML_EVENT_ATTR;
+}
+
+/**
+ *  \brief Report the end of the element `<name/>` at the begin of data.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return XML_EVENT_END or 0 fail
+ */
+static int read_empty(XML_READER* reader, XML_EVENT* event)
+{
+    unsigned int name = reader->begin + 1, pos;
+
+    for (pos = name; is_name_char(reader->data[pos]); pos++);
+
+    event->name.text = reader->data + name;
+    event->name.length = pos - name;
+
+    return read_end(reader, reader->begin, reader->tag, event);
+}
+
+/**
+ *  \brief Initialize a pull reader on a whole text, the spans of events point into the text without copying.
+ *  \param[in] reader: reader
+ *  \param[in] text: text
+ *  \param[in] names: buffer to keep the names of open elements and match the end tags, NULL leaves it to the caller
+ *  \param[in] capacity: capacity of names
+ *  \return none
+ */
+void xml_reader_init(XML_READER* reader, const char* text, char* names, unsigned int capacity)
+{
+    if (!reader) return;
+
+    memset(reader, 0, sizeof(XML_READER));
+    reader->data = text ? text : "";
+    reader->end = (unsigned int)strlen(reader->data);
+    reader->eof = 1;
+    reader->names = names;
+    reader->capacity = names ? capacity : 0;
+    reader->lines = 1;
+    reader->line = 1;
+}
+
+/**
+ *  \brief Initialize a pull reader on a stream, the input goes through a fixed buffer,
+ *         so a tag or a text larger than the buffer fails with XML_E_OVERFLOW.
+ *  \param[in] reader: reader
+ *  \param[in] buffer: stream buffer
+ *  \param[in] size: size of stream buffer
+ *  \param[in] names: buffer to keep the names of open elements and match the end tags, NULL leaves it to the caller
+ *  \param[in] capacity: capacity of names
+ *  \param[in] read: read callback, NULL to give the input with `xml_reader_feed()`
+ *  \param[in] context: context of read callback
+ *  \return none
+ */
+void xml_reader_stream(XML_READER* reader, char* buffer, unsigned int size, char* names, unsigned int capacity, xml_read_t read, void* context)
+{
+    if (!reader) return;
+
+    memset(reader, 0, sizeof(XML_READER));
+    reader->data = buffer;
+    reader->buffer = buffer;
+    reader->size = buffer ? size : 0;
+    reader->read = read;
+    reader->context = context;
+    reader->names = names;
+    reader->capacity = names ? capacity : 0;
+    reader->lines = 1;
+    reader->line = 1;
+}
+
+/**
+ *  \brief Feed the input of a stream reader without read callback, usually after XML_EVENT_MORE.
+ *  \param[in] reader: reader
+ *  \param[in] data: input data
+ *  \param[in] size: size of data, 0 ends the input
+ *  \return count of bytes taken, may be less than size when the buffer is full, negative fail
+ */
+int xml_reader_feed(XML_READER* reader, const char* data, int size)
+{
+    unsigned int n;
+
+    if (!reader || !reader->buffer || reader->read || reader->eof || size < 0) return -1;
+    if (size > 0 && !data) return -1;
 
-    /* parsing the header tag is not over yet, and then parsing the attribute */
-    if (*text != '>')
+    if (size == 0)
     {
-        text = parse_attributes(text, &attrs);
-        node->attrs = attrs;
-        if (etype != XML_E_OK) return text;
+        reader->eof = 1;
+        return 0;
     }
- 
-    /* parse text */
-    text = parse_text(text + 1, &out);
-    node->text = out;
 
-    /* parse children and end tag */
-    while (*text)
+    /* The data of a reported start tag is still in use */
+    if (reader->state != READ_ATTR && reader->state != READ_EMPTY) reader_slide(reader);
+
+    n = reader->size - reader->end;
+    if (n > (unsigned int)size) n = (unsigned int)size;
+    memcpy(reader->buffer + reader->end, data, n);
+    reader->end += n;
+
+    return (int)n;
+}
+
+/**
+ *  \brief Pull the next event.
+ *  \param[in] reader: reader
+ *  \param[out] event: event
+ *  \return event type, @ref XML_EVENT_xxx
+ */
+int xml_read_event(XML_READER* reader, XML_EVENT* event)
+{
+    int ret;
+
+    if (!reader || !event) return XML_EVENT_ERROR;
+
+    while (1)
     {
-        /* Exploring Character `<` */
-        text = skip(text);
-        if (*text != '<') 
+        switch (reader->state)
         {
-            E(XML_E_ILLEGAL); 
-            return text;
+        case READ_HEAD: ret = read_head(reader); break;
+        case READ_ROOT: ret = read_root(reader, event); break;
+        case READ_CONTENT: ret = read_content(reader, event); break;
+        case READ_ATTR: ret = read_attribute(reader, event); break;
+        case READ_EMPTY: ret = read_empty(reader, event); break;
+        case READ_DONE: event->type = XML_EVENT_DONE; return XML_EVENT_DONE;
+        default: return XML_EVENT_ERROR;
         }
 
-        /* label tail */
-        if (text[1] == '/')
+        if (ret == LEX_NEXT) continue;
+
+        if (ret == LEX_MORE)
         {
-            /* Skip `</` */
-            text += 2;
-            if (memcmp(node->name, text, len)) 
+            /* Fed input, the caller gives more unless the buffer is full of one token */
+            if (!reader->read)
             {
-                E(XML_E_LABEL); 
-                return text;
+                if (reader->begin == 0 && reader->end >= reader->size)
+                {
+                    reader_fail(reader, reader->end, XML_E_OVERFLOW);
+                    return XML_EVENT_ERROR;
+                }
+                event->type = XML_EVENT_MORE;
+                return XML_EVENT_MORE;
             }
 
-            /* Skip name */
-            text += len;
+            if (!reader_fill(reader)) return XML_EVENT_ERROR;
+            continue;
+        }
 
-            /* Determine if a</table>end tag has been formed */
-            if (*text != '>') 
-            {
-                E(XML_E_LABEL); 
-                return text;
-            }
+        if (ret == 0) return XML_EVENT_ERROR;
 
-            /* Reset `len` */
-            len = 0;
+        event->type = ret;
+        return ret;
+    }
+}
 
-            /* Skip `>` */
-            text++;
+/**
+ *  \brief Decode the raw value of an attribute or a text, the entities and CDATA sections are converted
+ *         and the comments are dropped.
+ *  \param[in] text: raw value
+ *  \param[in] length: length of raw value
+ *  \param[out] out: output buffer, no smaller than `length + 1`
+ *  \return length of output, it is terminated
+ */
+unsigned int xml_unescape(const char* text, unsigned int length, char* out)
+{
+    const char* end = text + length;
+    const char* t;
+    char* s = out;
 
-            return text;
-        }
-        /* parsing child elements */
-        else 
-        {
-            /* Check if this is a comment, if it is, skip it */
-            s = skip_comment(text);
-            if (etype != XML_E_OK) return text;
+    while (text < end)
+    {
+        /* Copy the plain characters at once */
+        for (t = text; t < end && *t != '<' && *t != '&'; t++);
+        memcpy(s, text, t - text);
+        s += t - text;
+        text = t;
+        if (text >= end) break;
 
-            /* Indicates that the middle comment has been skipped */
-            if (s > text) 
+        if (*text == '<')
+        {
+            /* Skip comments */
+            if (end - text >= 4 && !memcmp(text, "<!--", 4))
             {
-                text = s; 
+                for (text += 4; text < end; text++)
+                {
+                    if (end - text >= 3 && !memcmp(text, "-->", 3))
+                    {
+                        text += 3;
+                        break;
+                    }
+                }
                 continue;
             }
-            /* Normal `<` */
-            else text = s;
 
-            /* Create a new node to store new parsing content */
-            child = new_node();
-            if (!child) 
+            /* Get CDATA */
+            if (end - text >= 9 && !memcmp(text, "<![CDATA[", 9))
             {
-                E(XML_E_MEMORY); 
-                return text;
+                for (text += 9; text < end; text++)
+                {
+                    if (end - text >= 3 && !memcmp(text, "]]>", 3))
+                    {
+                        text += 3;
+                        break;
+                    }
+                    *s++ = *text;
+                }
+                continue;
             }
+        }
+        else if (*text == '&')
+        {
+            if      (end - text >= 4 && !memcmp(text, "&lt;", 4))   {text += 4; *s++ = '<'; continue;}
+            else if (end - text >= 4 && !memcmp(text, "&gt;", 4))   {text += 4; *s++ = '>'; continue;}
+            else if (end - text >= 5 && !memcmp(text, "&amp;", 5))  {text += 5; *s++ = '&'; continue;}
+            else if (end - text >= 6 && !memcmp(text, "&apos;", 6)) {text += 6; *s++ = '\''; continue;}
+            else if (end - text >= 6 && !memcmp(text, "&quot;", 6)) {text += 6; *s++ = '\"'; continue;}
+        }
+
+        *s++ = *text++;
+    }
+
+    *s = 0;
+
+    return (unsigned int)(s - out);
+}
+
+/**
+ *  \brief Duplicate the name of an event.
+ *  \param[in] alloc: allocator of the copy
+ *  \param[in] span: name span
+ *  \return new string or NULL fail
+ */
+static char* span_strdup(const XML_ALLOC* alloc, const XML_SPAN* span)
+{
+    char* s = (char*)xml_malloc(alloc, span->length + 1);
+    if (!s) return NULL;
+
+    memcpy(s, span->text, span->length);
+    s[span->length] = 0;
+
+    return s;
+}
+
+/**
+ *  \brief Decode the raw value of an event into a new string.
+ *  \param[in] alloc: allocator of the copy
+ *  \param[in] span: value span
+ *  \return new string or NULL fail
+ */
+static char* span_unescape(const XML_ALLOC* alloc, const XML_SPAN* span)
+{
+    char* s = (char*)xml_malloc(alloc, span->length + 1);
+    if (!s) return NULL;
+
+    xml_unescape(span->text, span->length, s);
+
+    return s;
+}
+
+/**
+ *  \brief Build an xml node from the events after its start.
+ *  \param[in] reader: reader
+ *  \param[out] node: node
+ *  \param[in] event: the start event of node, reused for the following events
+ *  \param[in] depth: nesting depth of node
+ *  \param[in] depth_max: maximum nesting depth, 0 unlimited
+ *  \return 1 success or 0 fail
+ */
+static int load_node(XML_READER* reader, xml_t node, XML_EVENT* event, int depth, int depth_max)
+{
+    ATTR *attr, *last = NULL;
+    xml_t child, tail = NULL;
+
+    node->name = span_strdup(node->alloc, &event->name);
+    if (!node->name) goto MEMORY;
+
+    while (1)
+    {
+        switch (xml_read_event(reader, event))
+        {
+        case XML_EVENT_ATTR:
+        {
+            attr = new_attr(node->alloc);
+            if (!attr) goto MEMORY;
+
+            /* Add to attribute linked list */
+            if (!node->attrs) node->attrs = attr;
+            else last->next = attr;
+            last = attr;
+
+            attr->name = span_strdup(node->alloc, &event->name);
+            attr->value = span_unescape(node->alloc, &event->value);
+            if (!attr->name || !attr->value) goto MEMORY;
+            break;
+        }
+        case XML_EVENT_TEXT:
+        {
+            /* Only the text before the children is kept */
+            if (node->text || node->child) break;
+
+            node->text = span_unescape(node->alloc, &event->value);
+            if (!node->text) goto MEMORY;
+            break;
+        }
+        case XML_EVENT_START:
+        {
+            /* Create a new node to store new parsing content */
+            child = new_node(node->alloc);
+            if (!child) goto MEMORY;
 
             /* Add to child node linked list */
             if (!node->child) node->child = child;
             else tail->next = child;
             tail = child;
 
-            /* Parse child node */
-            text = parse_node(text, child);
-            if (etype != XML_E_OK) return text;
+            /* Limit the nesting depth of nodes */
+            if (depth_max > 0 && depth >= depth_max)
+            {
+                reader->error = XML_E_DEPTH;
+                return 0;
+            }
 
-            /* Skip the extra characters */
-            while (*text && *text != '<')
+            if (!load_node(reader, child, event, depth + 1, depth_max)) return 0;
+            break;
+        }
+        case XML_EVENT_END:
+        {
+            /* The end tag must close this node */
+            if (strlen(node->name) != event->name.length || memcmp(node->name, event->name.text, event->name.length))
             {
-                if (*text == '\n') 
-                {
-                    eline++, lbegin = text;
-                }
-                text++;
+                reader->error = XML_E_LABEL;
+                return 0;
             }
+            return 1;
+        }
+        default:
+            return 0;
+        }
+    }
+
+MEMORY:
+    reader->error = XML_E_MEMORY;
+    return 0;
+}
+
+/**
+ *  \brief load xml from text string, the error information is kept in the context,
+ *         so it can be called on several threads at once.
+ *  \param[in] text: text
+ *  \param[in,out] ctx: parse context, `alloc` and `depth` are input and the error information is output, can be NULL
+ *  \return xml object
+ */
+xml_t xml_loads_ex(const char* text, XML_CTX* ctx)
+{
+    XML_READER reader;
+    XML_EVENT event;
+    xml_t root = NULL;
+
+    /* The tree is built from the events, the end tags are matched against the node names */
+    xml_reader_init(&reader, text, NULL, 0);
+    if (!text) reader.error = XML_E_TEXT;
+    else if (xml_read_event(&reader, &event) == XML_EVENT_START)
+    {
+        /* Create a root node to store parsing information */
+        root = new_node(ctx ? ctx->alloc : NULL);
+        if (!root) reader.error = XML_E_MEMORY;
+        else if (!load_node(&reader, root, &event, 1, ctx ? ctx->depth : 0))
+        {
+            xml_delete(root);
+            root = NULL;
         }
     }
 
-    /* No closing tag */
-    if (len > 0) E(XML_E_LABEL);
+    /* output error info */
+    if (ctx)
+    {
+        ctx->type = reader.error;
+        ctx->line = reader.line;
+        ctx->column = reader.column;
+    }
+
+    return root;
+}
 
-    return text;
+/**
+ *  \brief load xml from text string.
+ *  \param[in] text: text
+ *  \return xml object, use `xml_error_info()` to locate the error
+ */
+xml_t xml_loads(const char* text)
+{
+    ectx.depth = 0;
+    return xml_loads_ex(text, &ectx);
 }
 
 /**
- *  \brief Parse xml file head.
- *  \param[in] text: The text content to parse.
- *  \return The character address after parse
+ *  \brief load xml from file.
+ *  \param[in] filename: file name
+ *  \return xml object
  */
-static const char* parse_head(const char* text)
+xml_t xml_file_load(const char* filename)
+{
+    xml_t xml = NULL;
+    FMAP map;
+
+    /* map file, the content is parsed in place without copying */
+    if (fmap_open(&map, filename) != FMAP_E_OK) return NULL;
+
+    /* load text */
+    xml = xml_loads(map.data);
+
+    /* The file was truncated while loading, the text read is not valid */
+    if (fmap_close(&map) != FMAP_E_OK && xml)
+    {
+        xml_delete(xml);
+        xml = NULL;
+    }
+
+    return xml;
+}
+
+/* path step define, selects the children of the matched node */
+typedef struct
+{
+    const char* name;                       /**< name of children, NULL any name */
+    unsigned int length;                    /**< length of name */
+    int index;                              /**< index among the children with the name, negative all */
+} STEP;
+
+/* compiled path define */
+typedef struct XML_PATH
 {
-    char *name = NULL, *version = NULL, *encoding = NULL;
-    ATTR *attr_version = NULL, *attr_encoding = NULL;
+    STEP* steps;                            /**< steps, the first one is for the node the query starts from */
+    int count;                              /**< count of steps */
+    const char* attr;                       /**< attribute name of the `@name` step at the end, NULL none */
+    unsigned int alen;                      /**< length of attribute name */
+} XML_PATH;
 
-    /* Skip `<?` */
-    text += 2;
+/* state of one query on the tree */
+typedef struct
+{
+    const XML_PATH* path;                   /**< path */
+    xml_path_match_t match;                 /**< match callback */
+    void* context;                          /**< context of match callback */
+    int count;                              /**< count of matches */
+} QUERY;
 
-    /* Parse name */
-    text = parse_name(text, &name);
-    if (etype != XML_E_OK) goto END;
+/**
+ *  \brief Check whether a name equals the name of a path step.
+ *  \param[in] name: terminated name
+ *  \param[in] step: step with name
+ *  \return 1 equal or 0 not
+ */
+static int step_name(const char* name, const STEP* step)
+{
+    /* The first character rejects most of the siblings before comparing */
+    if (!name || name[0] != step->name[0]) return 0;
+    return !strncmp(name, step->name, step->length) && name[step->length] == 0;
+}
 
-    /* Must comply with XML file header signature */
-    if (strcmp(name, "xml") == 0)
+/**
+ *  \brief compile a path, to query the xml tree or the events of a reader.
+ *         `a/b[2]@id`, steps are separated by `/` and select the children of the matched node,
+ *         `*` is any name, `[n]` is the nth of the children with the name from 0, `[*]` or no index are all of them,
+ *         `@name` at the end selects the attribute instead of the text, right after the last step or as a step
+ *         of its own, `a/b[2]@id` and `a/b[2]/@id` are the same.
+ *         A path beginning with `/` is absolute, its first step matches the node the query starts from, usually the root.
+ *  \param[in] path: path
+ *  \return compiled path or NULL fail
+ */
+xml_path_t xml_path_compile(const char* path)
+{
+    XML_PATH* p;
+    const char* s;
+    char* names;
+    int count = 2, i, n;
+    size_t len;
+
+    if (!path) return NULL;
+
+    /* Count the steps with the one of a relative path for any node, the names are copied into the same allocation */
+    for (s = path; *s; s++) if (*s == '/') count++;
+    len = s - path;
+
+    p = (XML_PATH*)malloc(sizeof(XML_PATH) + count * sizeof(STEP) + len + 1);
+    if (!p) return NULL;
+    memset(p, 0, sizeof(XML_PATH));
+    p->steps = (STEP*)(p + 1);
+    names = (char*)(p->steps + count);
+    memcpy(names, path, len + 1);
+
+    /* A relative path starts from any node */
+    s = names;
+    if (*s == '/') s++;
+    else
+    {
+        p->steps[0].name = NULL;
+        p->steps[0].index = -1;
+        p->count = 1;
+        if (!*s) return p;
+    }
+
+    while (1)
     {
-        /* Create new attributes to store version information */
-        attr_version = new_attr();
-        if (!attr_version) 
+        /* Attribute step at the end */
+        if (*s == '@')
         {
-            E(XML_E_MEMORY); 
-            goto END;
+            for (n = 1; is_name_char(s[n]); n++);
+            if (n == 1 || !is_name_head(s[1]) || s[n]) goto FAIL;
+            p->attr = s + 1;
+            p->alen = n - 1;
+            break;
         }
 
-        /* Parse attributes to determine if it is the expected `version` */
-        text = parse_one_attribute(text, attr_version);
-        if (etype != XML_E_OK) goto END; /* parse error */
-        if (strcmp(attr_version->name, "version")) 
+        /* Name step */
+        if (*s == '*')
         {
-            E(XML_E_VERSION); 
-            goto END;
+            p->steps[p->count].name = NULL;
+            n = 1;
         }
-
-        /* Create new attributes to store encoding information */
-        attr_encoding = new_attr();
-        if (!attr_encoding) 
+        else
         {
-            E(XML_E_MEMORY); 
-            goto END;
+            if (!is_name_head(*s)) goto FAIL;
+            for (n = 1; is_name_char(s[n]); n++);
+            p->steps[p->count].name = s;
+            p->steps[p->count].length = n;
         }
+        s += n;
 
-        /* Parse attributes to determine if it is the expected `encoding` */
-        text = parse_one_attribute(text, attr_encoding);
-        if (etype != XML_E_OK) goto END; /* parse error */
-        if (strcmp(attr_encoding->name, "encoding")) 
+        /* Index of step */
+        p->steps[p->count].index = -1;
+        if (*s == '[')
         {
-            E(XML_E_ENCODING); 
-            goto END;
+            s++;
+            if (*s == '*') s++;
+            else
+            {
+                if (*s < '0' || *s > '9') goto FAIL;
+                for (i = 0; *s >= '0' && *s <= '9'; s++)
+                {
+                    if (i > (INT_MAX - 9) / 10) goto FAIL;
+                    i = i * 10 + (*s - '0');
+                }
+                p->steps[p->count].index = i;
+            }
+            if (*s != ']') goto FAIL;
+            s++;
         }
-    }
+        p->count++;
 
-    /* Determine whether the label forms a complete closed interval */
-    text = skip(text);
-    if (strncmp(text, "?>", 2)) 
-    {
-        E(XML_E_NOTES); 
-        goto END;
+        if (!*s) break;
+        if (*s == '@') continue;
+        if (*s++ != '/' || !*s) goto FAIL;
     }
 
-    /* Skip `?>` */
-    text += 2;
+    return p;
 
-END:
-    if (attr_version) attribute_delete(attr_version);
-    if (attr_encoding) attribute_delete(attr_encoding);
-    if (name) free(name);
-    return text;
+FAIL:
+    free(p);
+    return NULL;
 }
 
 /**
- *  \brief load xml from text string.
- *  \param[in] text: text
- *  \return xml object
+ *  \brief delete a compiled path.
+ *  \param[in] path: compiled path
+ *  \return none
  */
-xml_t xml_loads(const char* text)
+void xml_path_delete(xml_path_t path)
 {
-    xml_t root;
+    if (path) free(path);
+}
 
-    etype = XML_E_OK;
-    eline = 1;
-    lbegin = text;
-    ecolumn = 0;
+/**
+ *  \brief Report the value of a node matched by all steps.
+ *  \param[in] q: query
+ *  \param[in] xml: matched node
+ *  \return 1 go on or 0 stop
+ */
+static int query_report(QUERY* q, xml_t xml)
+{
+    ATTR* attr;
 
-    /* parse head notes */
-    if (strncmp(text, "<?", 2) == 0)
+    if (!q->path->attr)
     {
-        text = parse_head(text);
-        if (etype != XML_E_OK) return NULL;
+        q->count++;
+        return q->match ? q->match(q->context, xml, xml->text) : 1;
     }
 
-    /* Create a root node to store parsing information */
-    root = new_node();
-    if (!root) 
+    for (attr = xml->attrs; attr; attr = attr->next)
     {
-        E(XML_E_MEMORY); 
-        return NULL;
+        if (!strcmp(attr->name, q->path->attr))
+        {
+            q->count++;
+            return q->match ? q->match(q->context, xml, attr->value) : 1;
+        }
     }
 
-    /* Start parsing and store the parsing results in root */
-    text = parse_node(text, root);
-    if (etype != XML_E_OK)
+    return 1;
+}
+
+/**
+ *  \brief Query the children of a node matched by a step.
+ *  \param[in] q: query
+ *  \param[in] xml: matched node
+ *  \param[in] step: index of the step matched
+ *  \return 1 go on or 0 stop
+ */
+static int query_node(QUERY* q, xml_t xml, int step)
+{
+    const STEP* s;
+    xml_t child;
+    int n = 0;
+
+    if (++step == q->path->count) return query_report(q, xml);
+
+    s = &q->path->steps[step];
+    for (child = xml->child; child; child = child->next)
     {
-        xml_delete(root);
-        return NULL;
+        if (s->name && !step_name(child->name, s)) continue;
+        if (s->index >= 0 && n++ != s->index) continue;
+
+        if (!query_node(q, child, step)) return 0;
+
+        /* Only one child has the index */
+        if (s->index >= 0) break;
     }
 
-    return root;
+    return 1;
 }
 
 /**
- *  \brief load xml from file.
- *  \param[in] filename: file name
- *  \return xml object
+ *  \brief query the xml tree with a compiled path, the matches are reported in document order.
+ *  \param[in] xml: xml handle the query starts from
+ *  \param[in] path: compiled path
+ *  \param[in] match: callback of each match with the node and its text, or the attribute value for `@name` paths,
+ *                    returns 0 to stop, can be NULL to count only
+ *  \param[in] context: context of match callback
+ *  \return count of matches, negative fail
  */
-xml_t xml_file_load(const char* filename)
+int xml_path_query(xml_t xml, xml_path_t path, xml_path_match_t match, void* context)
 {
-    FILE* f;
-    xml_t xml = NULL;
-    long len;
-    char* text;
-
-    /* open file and get the length of file */
-    f = fopen(filename, "rb");
-    if (!f) return NULL;
-    fseek(f, 0, SEEK_END);
-    len = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    /* read file */
-    text = (char*)malloc(len + 1);
-    if (text)
-    {
-        fread(text, 1, len, f);
-        fclose(f);
-    }
-    else
+    QUERY q;
+    const STEP* s;
+
+    if (!xml || !path) return -1;
+
+    q.path = path;
+    q.match = match;
+    q.context = context;
+    q.count = 0;
+
+    /* The first step is for the node itself, it is the only one with its name */
+    s = &path->steps[0];
+    if (s->name && !step_name(xml->name, s)) return 0;
+    if (s->index > 0) return 0;
+
+    query_node(&q, xml, 0);
+
+    return q.count;
+}
+
+/**
+ *  \brief Keep the first matched node of a query and stop.
+ */
+static int query_first(void* context, xml_t xml, const char* value)
+{
+    (void)value;
+    *(xml_t*)context = xml;
+    return 0;
+}
+
+/**
+ *  \brief Keep the first matched value of a query and stop.
+ */
+static int query_value(void* context, xml_t xml, const char* value)
+{
+    (void)xml;
+    *(const char**)context = value;
+    return 0;
+}
+
+/**
+ *  \brief get the first node matched by a compiled path.
+ *  \param[in] xml: xml handle the query starts from
+ *  \param[in] path: compiled path, for `@name` paths the node holding the attribute
+ *  \return matched node or NULL
+ */
+xml_t xml_path_get(xml_t xml, xml_path_t path)
+{
+    xml_t out = NULL;
+    xml_path_query(xml, path, query_first, &out);
+    return out;
+}
+
+/**
+ *  \brief get the value of the first match of a compiled path.
+ *  \param[in] xml: xml handle the query starts from
+ *  \param[in] path: compiled path
+ *  \return attribute value for `@name` paths or text of the node, NULL no match or no text
+ */
+const char* xml_path_value(xml_t xml, xml_path_t path)
+{
+    const char* out = NULL;
+    xml_path_query(xml, path, query_value, &out);
+    return out;
+}
+
+/**
+ *  \brief query the events of a pull reader with a compiled path, reading until the root element ends.
+ *         The root element is the node the query starts from, the text of an element is the one before its children.
+ *         The reader reads a whole text or has a read callback, it is not fed.
+ *  \param[in] reader: reader, usually just initialized
+ *  \param[in] path: compiled path
+ *  \param[in] match: callback of each match with the raw value, decode it with `xml_unescape()`,
+ *                    returns 0 to stop, can be NULL to count only
+ *  \param[in] context: context of match callback
+ *  \return count of matches, negative fail, see `error` of reader
+ */
+int xml_path_read(XML_READER* reader, xml_path_t path, xml_path_span_t match, void* context)
+{
+    XML_EVENT event;
+    const STEP* s;
+    int* counts;
+    int depth = 0, level = 0, count = 0, done = 0, type;
+
+    if (!reader || !path) return -1;
+
+    /* Occurrences of the names of each step under the matched elements */
+    counts = (int*)calloc(path->count, sizeof(int));
+    if (!counts) return -1;
+
+    while ((type = xml_read_event(reader, &event)) != XML_EVENT_DONE)
     {
-        fclose(f);
-        return NULL;
+        if (type == XML_EVENT_START)
+        {
+            depth++;
+
+            /* The elements from the root to `level` have matched the steps */
+            if (depth == level + 1 && level < path->count)
+            {
+                s = &path->steps[level];
+                if (s->name && (event.name.length != s->length || memcmp(event.name.text, s->name, s->length))) continue;
+                if (s->index >= 0 && counts[level]++ != s->index) continue;
+
+                level = depth;
+                if (level < path->count) counts[level] = 0;
+                done = 0;
+            }
+            /* The text of the matched element is over at its first child */
+            else if (depth == level + 1) done = 1;
+        }
+        else if (type == XML_EVENT_END)
+        {
+            if (depth == level) level--;
+            depth--;
+        }
+        else if (type == XML_EVENT_ATTR || type == XML_EVENT_TEXT)
+        {
+            if (level != path->count || depth != level) continue;
+
+            if (type == XML_EVENT_ATTR)
+            {
+                if (!path->attr || event.name.length != path->alen || memcmp(event.name.text, path->attr, path->alen)) continue;
+            }
+            else
+            {
+                if (path->attr || done) continue;
+                done = 1;
+            }
+
+            count++;
+            if (match && !match(context, &event.value)) break;
+        }
+        else
+        {
+            /* Error, or the reader waits to be fed */
+            count = -1;
+            break;
+        }
     }
-    text[len] = 0;
 
-    /* load text */
-    xml = xml_loads(text);
-    free(text);
+    free(counts);
 
-    return xml;
+    return count;
 }
@@ -28,6 +28,10 @@ extern "C"
 
 typedef struct XML *xml_t;
 
+/* compiled path type definition, hiding structural members, not for external use */
+
+typedef struct XML_PATH *xml_path_t;
+
 /* error type define */
 
 #define XML_E_OK                            (0) /* ok */
@@ -43,16 +47,115 @@ typedef struct XML *xml_t;
 #define XML_E_COMMENT                       (10) /* missing comment tail --> */
 #define XML_E_NOTES                         (11) /* head notes error */
 #define XML_E_CDATA                         (12) /* missing comment tail ]]> */
+#define XML_E_DEPTH                         (13) /* nesting deeper than the context limit */
+#define XML_E_OVERFLOW                      (14) /* a token or the open element names do not fit in the reader buffers */
+#define XML_E_READ                          (15) /* read callback failed */
+
+/* allocator of the nodes, names, texts and attributes of a loaded xml, it must outlive the xml */
+typedef struct
+{
+    void* (*alloc)(void* user, unsigned int size);  /**< allocate a block, NULL fail */
+    void (*free)(void* user, void* block);          /**< release a block of `alloc` */
+    void* user;                                     /**< user data of the callbacks, such as an arena */
+} XML_ALLOC;
+
+/* parse context, keeps the error information of one parsing call instead of the shared one */
+typedef struct
+{
+    const XML_ALLOC* alloc;                 /**< input, allocator of the loaded xml, NULL the C library */
+    int depth;                              /**< input, maximum nesting depth of nodes, 0 unlimited */
+    int type;                               /**< output, error type, @ref XML_E_xxx */
+    int line;                               /**< output, error line */
+    int column;                             /**< output, error column */
+} XML_CTX;
+
+/* pull parser event type define, returned by `xml_read_event()` */
+
+#define XML_EVENT_ERROR                     (-1) /* parse error, see `error` of reader */
+#define XML_EVENT_DONE                      (0) /* the root element has ended */
+#define XML_EVENT_START                     (1) /* start of element, `name` */
+#define XML_EVENT_ATTR                      (2) /* attribute of the element just started, `name` and raw `value` */
+#define XML_EVENT_TEXT                      (3) /* text content, raw `value` */
+#define XML_EVENT_END                       (4) /* end of element, `name`, also reported for `<name/>` */
+#define XML_EVENT_MORE                      (5) /* more input is needed, give it with `xml_reader_feed()` */
+
+/* read callback of the stream reader, returns the count of bytes read, 0 at the end, negative on error */
+typedef int (*xml_read_t)(void* context, char* data, int size);
+
+/* span of the input, not terminated */
+typedef struct
+{
+    const char* text;                       /**< address in the input */
+    unsigned int length;                    /**< length of span */
+} XML_SPAN;
+
+/* pull parser event, the spans stay valid until the next `xml_read_event()` or `xml_reader_feed()` */
+typedef struct
+{
+    int type;                               /**< event type, @ref XML_EVENT_xxx */
+    XML_SPAN name;                          /**< name of element or attribute */
+    XML_SPAN value;                         /**< raw value of attribute or text, decode it with `xml_unescape()` */
+} XML_EVENT;
+
+/* pull parser state, the members are read only for the caller */
+typedef struct
+{
+    const char* data;                       /**< text being parsed, the buffer when streaming */
+    char* buffer;                           /**< stream buffer, NULL when parsing a whole text */
+    unsigned int size;                      /**< size of stream buffer */
+    unsigned int begin;                     /**< start of the data not yet consumed */
+    unsigned int end;                       /**< end of the data */
+    unsigned long offset;                   /**< offset of data in the whole input */
+    xml_read_t read;                        /**< read callback, NULL when the input is fed */
+    void* context;                          /**< context of read callback */
+    int eof;                                /**< all input is in data */
+    char* names;                            /**< names of open elements to match end tags, NULL leaves it to the caller */
+    unsigned int capacity;                  /**< capacity of names */
+    unsigned int top;                       /**< used size of names */
+    unsigned int cursor;                    /**< next attribute of the reported start tag */
+    unsigned int tag;                       /**< end of the reported start tag */
+    int empty;                              /**< the reported start tag is `<name/>` */
+    int state;                              /**< parsing state */
+    int depth;                              /**< count of open elements */
+    unsigned int counted;                   /**< position up to which the lines are counted */
+    int lines;                              /**< line at counted */
+    unsigned long lbegin;                   /**< offset of the last line break before counted */
+    int line;                               /**< line of the last event or of the error */
+    int column;                             /**< column of the last event or of the error */
+    int error;                              /**< error type, @ref XML_E_xxx */
+} XML_READER;
 
 /* Load xml */
 
 xml_t xml_loads(const char* text);
+xml_t xml_loads_ex(const char* text, XML_CTX* ctx);
 xml_t xml_file_load(const char* filename);
 
 /* When loading fails, use this method to locate the error */
 
 int xml_error_info(int* line, int* column);
 
+/* Pull xml events, without building the tree */
+
+void xml_reader_init(XML_READER* reader, const char* text, char* names, unsigned int capacity);
+void xml_reader_stream(XML_READER* reader, char* buffer, unsigned int size, char* names, unsigned int capacity, xml_read_t read, void* context);
+int xml_reader_feed(XML_READER* reader, const char* data, int size);
+int xml_read_event(XML_READER* reader, XML_EVENT* event);
+unsigned int xml_unescape(const char* text, unsigned int length, char* out);
+
+/* Query xml with compiled paths like `a/b[2]@id`, on the tree or on the events of a reader */
+
+/* callback of each match, returns 0 to stop */
+typedef int (*xml_path_match_t)(void* context, xml_t xml, const char* value);
+typedef int (*xml_path_span_t)(void* context, const XML_SPAN* value);
+
+xml_path_t xml_path_compile(const char* path);
+void xml_path_delete(xml_path_t path);
+int xml_path_query(xml_t xml, xml_path_t path, xml_path_match_t match, void* context);
+xml_t xml_path_get(xml_t xml, xml_path_t path);
+const char* xml_path_value(xml_t xml, xml_path_t path);
+int xml_path_read(XML_READER* reader, xml_path_t path, xml_path_span_t match, void* context);
+
 /* Dump xml */
 
 char* xml_dumps(xml_t xml, int preset, int unformat, int* len);
@@ -0,0 +1,97 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fpconv.h
+ *         \unit  fpconv
+ *        \brief  This is a C language shared number and text conversion module
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __fpconv_H
+#define __fpconv_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* fpconv belongs to vstd, the base layer without the C library, so that `v_strtod()` does not depend on the
+ * upper layers. It only references `memcpy`, `memmove` and `memset`, which compilers require even when freestanding.
+ * The general modules and parsers using it add vstd to the include path. */
+
+/* Version infomation */
+
+#define FPCONV_V_MAJOR                      1
+#define FPCONV_V_MINOR                      0
+#define FPCONV_V_PATCH                      0
+
+/* Configuration information */
+
+#define FPCONV_EISEL_LEMIRE                 1   /**< 1 use the Eisel-Lemire parsing path (about 10KB table), 0 correct a rough product with big integers */
+
+/* Buffer size that can hold any text generated by `fpconv_dtoa()` or `fpconv_itoa()`, including the terminator */
+
+#define FPCONV_BUFFER_SIZE                  32
+
+/**
+ *  \brief Convert decimal text to double, compatible with the standard `strtod` for decimal input.
+ *         Up to 19 significant digits are converted exactly without any floating point rounding steps,
+ *         longer inputs close to a halfway point are decided by comparing all the digits with big integers,
+ *         on about 1KB of stack, without the C library or allocation.
+ *  \param[in] str: numeric text, leading whitespace is skipped, `[+-]digits[.digits][(e|E)[+-]digits]`
+ *  \param[out] endptr: receives the address after the last converted character, can be NULL
+ *  \return converted value, 0.0 and `endptr` equal to `str` when there is no number
+ */
+double fpconv_strtod(const char* str, char** endptr);
+
+/**
+ *  \brief Same as `fpconv_strtod()`, but never reads more than `len` characters.
+ *  \param[in] str: numeric text
+ *  \param[in] len: maximum number of characters to convert
+ *  \param[out] endptr: receives the address after the last converted character, can be NULL
+ *  \return converted value
+ */
+double fpconv_strntod(const char* str, unsigned int len, char** endptr);
+
+/**
+ *  \brief Convert decimal text to float, rounded once from the text, compatible with the standard `strtof`.
+ *         `(float)fpconv_strtod()` rounds twice and differs when the double lands exactly halfway between two floats.
+ *  \param[in] str: numeric text, same as `fpconv_strtod()`
+ *  \param[out] endptr: receives the address after the last converted character, can be NULL
+ *  \return converted value
+ */
+float fpconv_strtof(const char* str, char** endptr);
+
+/**
+ *  \brief Convert double to the shortest text that reads back to the same value (Grisu2).
+ *         Integral values in fixed notation keep a `.0` suffix, `1e21` and above or below `1e-6` use exponent notation.
+ *  \param[in] value: number to convert
+ *  \param[out] buffer: output buffer, at least `FPCONV_BUFFER_SIZE` bytes
+ *  \return length of the generated text, excluding the terminator
+ */
+int fpconv_dtoa(double value, char* buffer);
+
+/**
+ *  \brief Convert float to the shortest text that reads back to the same float, same layout as `fpconv_dtoa()`.
+ *  \param[in] value: number to convert
+ *  \param[out] buffer: output buffer, at least `FPCONV_BUFFER_SIZE` bytes
+ *  \return length of the generated text, excluding the terminator
+ */
+int fpconv_ftoa(float value, char* buffer);
+
+/**
+ *  \brief Convert int to decimal text.
+ *  \param[in] value: number to convert
+ *  \param[out] buffer: output buffer, at least `FPCONV_BUFFER_SIZE` bytes
+ *  \return length of the generated text, excluding the terminator
+ */
+int fpconv_itoa(int value, char* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,6 +13,7 @@
 #include "vstdlib.h"
 #include "vctype.h"
 #include "vstddef.h"
+#include "fpconv.h"
 
 int v_atoi(const char *str)
 {
@@ -55,13 +56,13 @@ double v_atof(const char *str)
 
 float v_strtof(const char *str, char **endptr)
 {
-    float result = v_strtold(str, endptr);
+    float result = fpconv_strtof(str, endptr);
     return result;
 }
 
 double v_strtod(const char *str, char **endptr)
 {
-    double result = v_strtold(str, endptr);
+    double result = fpconv_strtod(str, endptr);
     return result;
 }
 
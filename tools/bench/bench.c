@@ -0,0 +1,567 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench.c
+ *         \unit  bench
+ *        \brief  Benchmark of the parsers, throughput, allocations and peak RSS of load, dump and query,
+ *                and batch loading on several threads
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "json.h"
+#include "csv.h"
+#include "ini.h"
+#include "xml.h"
+#include "txls.h"
+
+/* Each file given on the command line is measured in its own process, so the peak RSS is of that document alone.
+ *
+ * The allocations are counted by wrapping malloc, calloc and realloc at link time, `-Wl,--wrap=malloc`,
+ * instead of valloc, whose bookkeeping of every block would dominate the timings.
+ *
+ * With `-t <threads>`, each file is loaded over and over by that many threads at once through `*_loads_ex()`,
+ * each thread with its own context, and with `-a` also with its own arena allocator that is reset after each
+ * document. The CPU time of each thread is measured besides the wall time, so the cost of a document on one
+ * thread can be compared across thread counts even on a host with fewer processors than threads.
+ */
+
+#define BENCH_TIME                          0.5     /**< seconds each measurement is repeated for */
+#define BENCH_THREADS                       64      /**< maximum threads of batch loading */
+#define ARENA_CHUNK                         (1 << 20) /**< smallest chunk of an arena */
+
+static __thread unsigned long allocs = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *block, size_t size);
+
+void *__wrap_malloc(size_t size) { allocs++; return __real_malloc(size); }
+void *__wrap_calloc(size_t num, size_t size) { allocs++; return __real_calloc(num, size); }
+void *__wrap_realloc(void *block, size_t size) { allocs++; return __real_realloc(block, size); }
+
+/* chunk of an arena, the blocks follow the header */
+typedef struct CHUNK
+{
+    struct CHUNK *next;
+    size_t size;
+    size_t used;
+    size_t reserved;                        /**< keeps the blocks 16-byte aligned */
+} CHUNK;
+
+/* arena of one thread, blocks are only released all at once by `arena_reset()` */
+typedef struct
+{
+    CHUNK *head;
+    size_t total;                           /**< bytes handed out since the last reset */
+} ARENA;
+
+/* allocators of every format on one arena, they must outlive the documents loaded with them */
+typedef struct
+{
+    JSON_ALLOC json;
+    CSV_ALLOC csv;
+    INI_ALLOC ini;
+    XML_ALLOC xml;
+    TXLS_ALLOC txls;
+} ALLOCS;
+
+/* document operations of a format */
+typedef struct
+{
+    const char *ext;
+    void *(*load)(const char *text);
+    void *(*load_ex)(const char *text, const ALLOCS *allocs);
+    char *(*dump)(void *doc, int *len);
+    long (*query)(void *doc);
+    void (*drop)(void *doc);
+} FORMAT;
+
+static void *arena_alloc(void *user, unsigned int size)
+{
+    ARENA *arena = user;
+    CHUNK *chunk = arena->head;
+    size_t need = ((size_t)size + 15) & ~(size_t)15;
+    char *block;
+
+    if (!chunk || chunk->used + need > chunk->size)
+    {
+        size_t n = need > ARENA_CHUNK ? need : ARENA_CHUNK;
+        chunk = __real_malloc(sizeof(CHUNK) + n);
+        if (!chunk) return NULL;
+        chunk->next = arena->head;
+        chunk->size = n;
+        chunk->used = 0;
+        arena->head = chunk;
+    }
+
+    block = (char *)(chunk + 1) + chunk->used;
+    chunk->used += need;
+    arena->total += need;
+    return block;
+}
+
+static void arena_free(void *user, void *block)
+{
+    (void)user;
+    (void)block;
+}
+
+static void arena_release(ARENA *arena)
+{
+    CHUNK *chunk, *next;
+
+    for (chunk = arena->head; chunk; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+    arena->head = NULL;
+}
+
+/* release everything, one chunk as large as the last document keeps the next one in a single chunk */
+static void arena_reset(ARENA *arena)
+{
+    CHUNK *chunk = arena->head;
+
+    if (chunk && !chunk->next && chunk->size >= arena->total)
+    {
+        chunk->used = 0;
+        arena->total = 0;
+        return;
+    }
+    arena_release(arena);
+    if (arena->total)
+    {
+        arena->head = __real_malloc(sizeof(CHUNK) + arena->total);
+        if (arena->head)
+        {
+            arena->head->next = NULL;
+            arena->head->size = arena->total;
+            arena->head->used = 0;
+        }
+    }
+    arena->total = 0;
+}
+
+static int json_count(void *context, json_t json)
+{
+    (void)json;
+    (*(long *)context)++;
+    return 1;
+}
+
+static void *b_json_load(const char *text) { return json_loads(text); }
+static void *b_json_load_ex(const char *text, const ALLOCS *allocs)
+{
+    JSON_CTX ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc = allocs ? &allocs->json : NULL;
+    return json_loads_ex(text, &ctx);
+}
+static char *b_json_dump(void *doc, int *len) { return json_dumps(doc, 0, 1, len); }
+static void b_json_drop(void *doc) { json_delete(doc); }
+static long b_json_query(void *doc)
+{
+    json_path_t path = json_path_compile("$.items[*].name");
+    long hits = 0;
+    json_path_query(doc, path, json_count, &hits);
+    json_path_delete(path);
+    return hits;
+}
+
+static void *b_csv_load(const char *text) { return csv_loads(text); }
+static void *b_csv_load_ex(const char *text, const ALLOCS *allocs)
+{
+    CSV_CTX ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc = allocs ? &allocs->csv : NULL;
+    return csv_loads_ex(text, &ctx);
+}
+static char *b_csv_dump(void *doc, int *len) { return csv_dumps(doc, len); }
+static void b_csv_drop(void *doc) { csv_delete(doc); }
+static long b_csv_query(void *doc)
+{
+    unsigned int row, col, rows = csv_row(doc), cols = csv_col(doc);
+    long hits = 0;
+    for (row = 1; row <= rows; row++)
+    {
+        for (col = 1; col <= cols; col++)
+        {
+            if (csv_get_text(doc, row, col)) hits++;
+        }
+    }
+    return hits;
+}
+
+static void *b_ini_load(const char *text) { return ini_loads(text); }
+static void *b_ini_load_ex(const char *text, const ALLOCS *allocs)
+{
+    INI_CTX ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc = allocs ? &allocs->ini : NULL;
+    return ini_loads_ex(text, &ctx);
+}
+static char *b_ini_dump(void *doc, int *len) { return ini_dumps(doc, 0, len); }
+static void b_ini_drop(void *doc) { ini_delete(doc); }
+static long b_ini_query(void *doc)
+{
+    const char *section;
+    char key[16];
+    int i, k, count = ini_section_count(doc);
+    long hits = 0;
+    for (i = 0; i < count; i++)
+    {
+        section = ini_section_name(doc, i);
+        for (k = 0; ; k++)
+        {
+            snprintf(key, sizeof(key), "k%d", k);
+            if (!ini_get_value(doc, section, key)) break;
+            hits++;
+        }
+    }
+    return hits;
+}
+
+static int xml_count(void *context, xml_t xml, const char *value)
+{
+    (void)xml;
+    (void)value;
+    (*(long *)context)++;
+    return 1;
+}
+
+static void *b_xml_load(const char *text) { return xml_loads(text); }
+static void *b_xml_load_ex(const char *text, const ALLOCS *allocs)
+{
+    XML_CTX ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc = allocs ? &allocs->xml : NULL;
+    return xml_loads_ex(text, &ctx);
+}
+static char *b_xml_dump(void *doc, int *len) { return xml_dumps(doc, 0, 1, len); }
+static void b_xml_drop(void *doc) { xml_delete(doc); }
+static long b_xml_query(void *doc)
+{
+    xml_path_t path = xml_path_compile("item/@id");
+    long hits = 0;
+    xml_path_query(doc, path, xml_count, &hits);
+    xml_path_delete(path);
+    return hits;
+}
+
+static void *b_txls_load(const char *text) { return txls_loads(text); }
+static void *b_txls_load_ex(const char *text, const ALLOCS *allocs)
+{
+    TXLS_CTX ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc = allocs ? &allocs->txls : NULL;
+    return txls_loads_ex(text, &ctx);
+}
+static char *b_txls_dump(void *doc, int *len) { return txls_dumps(doc, 0, len); }
+static void b_txls_drop(void *doc) { txls_delete(doc); }
+static long b_txls_query(void *doc)
+{
+    unsigned int row, col, rows = txls_row(doc), cols = txls_col(doc);
+    long hits = 0;
+    for (row = 1; row <= rows; row++)
+    {
+        for (col = 1; col <= cols; col++)
+        {
+            if (txls_get_text(doc, col, row)) hits++;
+        }
+    }
+    return hits;
+}
+
+static const FORMAT formats[] = {
+    { ".json", b_json_load, b_json_load_ex, b_json_dump, b_json_query, b_json_drop },
+    { ".csv", b_csv_load, b_csv_load_ex, b_csv_dump, b_csv_query, b_csv_drop },
+    { ".ini", b_ini_load, b_ini_load_ex, b_ini_dump, b_ini_query, b_ini_drop },
+    { ".xml", b_xml_load, b_xml_load_ex, b_xml_dump, b_xml_query, b_xml_drop },
+    { ".md", b_txls_load, b_txls_load_ex, b_txls_dump, b_txls_query, b_txls_drop },
+};
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double thread_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const FORMAT *find_format(const char *filename)
+{
+    const char *dot = strrchr(filename, '.');
+    unsigned int i;
+
+    for (i = 0; dot && i < sizeof(formats) / sizeof(formats[0]); i++)
+    {
+        if (strcmp(dot, formats[i].ext) == 0) return &formats[i];
+    }
+    fprintf(stderr, "%s: unknown format\n", filename);
+    return NULL;
+}
+
+static char *read_file(const char *filename, long *size)
+{
+    FILE *f = fopen(filename, "rb");
+    char *text;
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = malloc(*size + 1);
+    if (text && fread(text, 1, *size, f) != (size_t)*size)
+    {
+        free(text);
+        text = NULL;
+    }
+    fclose(f);
+    if (text) text[*size] = 0;
+    return text;
+}
+
+/* measure one file, in the child process */
+static int bench(const char *filename)
+{
+    const FORMAT *fmt;
+    struct rusage usage;
+    unsigned long load_allocs, dump_allocs, query_allocs;
+    double t, load_time, dump_time, query_time;
+    long size, hits = 0, n, load_n, dump_n, query_n;
+    char *text, *out;
+    void *doc;
+    int len = 0;
+
+    fmt = find_format(filename);
+    if (!fmt) return 1;
+    text = read_file(filename, &size);
+    if (!text)
+    {
+        fprintf(stderr, "%s: read fail\n", filename);
+        return 1;
+    }
+
+    /* load, the allocations are of the first document */
+    allocs = 0;
+    doc = fmt->load(text);
+    load_allocs = allocs;
+    if (!doc)
+    {
+        fprintf(stderr, "%s: load fail\n", filename);
+        return 1;
+    }
+    fmt->drop(doc);
+    t = now();
+    for (load_n = 0; (load_time = now() - t) < BENCH_TIME; load_n++) fmt->drop(fmt->load(text));
+
+    doc = fmt->load(text);
+
+    /* dump */
+    allocs = 0;
+    out = fmt->dump(doc, &len);
+    dump_allocs = allocs;
+    free(out);
+    t = now();
+    for (dump_n = 0; (dump_time = now() - t) < BENCH_TIME; dump_n++) free(fmt->dump(doc, &len));
+
+    /* query */
+    allocs = 0;
+    hits = fmt->query(doc);
+    query_allocs = allocs;
+    t = now();
+    for (query_n = 0; (query_time = now() - t) < BENCH_TIME; query_n++) n = fmt->query(doc);
+    (void)n;
+
+    fmt->drop(doc);
+    free(text);
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%-32s %9ld %9.1f %9lu %9.1f %9lu %9.1f %9lu %9ld %9ld\n", strrchr(filename, '/') ? strrchr(filename, '/') + 1 : filename,
+        size / 1024,
+        size * load_n / load_time / 1e6, load_allocs,
+        (double)len * dump_n / dump_time / 1e6, dump_allocs,
+        size * query_n / query_time / 1e6, query_allocs, hits,
+        usage.ru_maxrss);
+
+    return 0;
+}
+
+/* one thread of batch loading */
+typedef struct
+{
+    const FORMAT *fmt;
+    const char *text;
+    pthread_barrier_t *start;
+    int arena;                              /**< load with an arena allocator */
+    long docs;                              /**< documents loaded */
+    unsigned long allocs;                   /**< allocations of the C library */
+    double cpu;                             /**< CPU time of the thread */
+    int fail;
+} WORKER;
+
+static void *worker_run(void *argument)
+{
+    WORKER *w = argument;
+    ARENA arena = { NULL, 0 };
+    ALLOCS a = {
+        { arena_alloc, arena_free, &arena },
+        { arena_alloc, arena_free, &arena },
+        { arena_alloc, arena_free, &arena },
+        { arena_alloc, arena_free, &arena },
+        { arena_alloc, arena_free, &arena },
+    };
+    double t, cpu;
+    void *doc;
+
+    pthread_barrier_wait(w->start);
+
+    allocs = 0;
+    cpu = thread_time();
+    for (t = now(); now() - t < BENCH_TIME; w->docs++)
+    {
+        doc = w->fmt->load_ex(w->text, w->arena ? &a : NULL);
+        if (!doc)
+        {
+            w->fail = 1;
+            break;
+        }
+        w->fmt->drop(doc);
+        if (w->arena) arena_reset(&arena);
+    }
+    w->cpu = thread_time() - cpu;
+    w->allocs = allocs;
+
+    arena_release(&arena);
+
+    return NULL;
+}
+
+/* load one file on several threads at once, in the child process */
+static int batch(const char *filename, int threads, int arena)
+{
+    const FORMAT *fmt;
+    WORKER workers[BENCH_THREADS];
+    pthread_t ids[BENCH_THREADS];
+    pthread_barrier_t start;
+    double t, wall, cpu = 0;
+    long size, docs = 0;
+    unsigned long count = 0;
+    char *text;
+    int i, fail = 0;
+
+    fmt = find_format(filename);
+    if (!fmt) return 1;
+    text = read_file(filename, &size);
+    if (!text)
+    {
+        fprintf(stderr, "%s: read fail\n", filename);
+        return 1;
+    }
+
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (i = 0; i < threads; i++)
+    {
+        memset(&workers[i], 0, sizeof(WORKER));
+        workers[i].fmt = fmt;
+        workers[i].text = text;
+        workers[i].start = &start;
+        workers[i].arena = arena;
+        if (pthread_create(&ids[i], NULL, worker_run, &workers[i]) != 0)
+        {
+            fprintf(stderr, "%s: thread fail\n", filename);
+            _exit(1);
+        }
+    }
+    t = now();
+    pthread_barrier_wait(&start);
+    for (i = 0; i < threads; i++)
+    {
+        pthread_join(ids[i], NULL);
+        docs += workers[i].docs;
+        count += workers[i].allocs;
+        cpu += workers[i].cpu;
+        fail |= workers[i].fail;
+    }
+    wall = now() - t;
+    pthread_barrier_destroy(&start);
+    free(text);
+
+    if (fail || docs == 0)
+    {
+        fprintf(stderr, "%s: load fail\n", filename);
+        return 1;
+    }
+
+    printf("%-32s %9ld %9d %9s %9.1f %9.1f %9.1f %9.1f\n", strrchr(filename, '/') ? strrchr(filename, '/') + 1 : filename,
+        size / 1024, threads, arena ? "arena" : "libc",
+        docs / wall, size * docs / wall / 1e6,
+        cpu / docs * 1e6, (double)count / docs);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, status, ret = 0, threads = 0, arena = 0;
+    pid_t pid;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0) arena = 1;
+        else break;
+    }
+
+    if (i >= argc || threads < 0 || threads > BENCH_THREADS || (arena && !threads))
+    {
+        fprintf(stderr, "usage: %s [-t <threads> [-a]] <files of .json .csv .ini .xml .md>\n", argv[0]);
+        return 1;
+    }
+
+    if (threads)
+    {
+        printf("%-32s %9s %9s %9s %9s %9s %9s %9s\n", "file", "KiB",
+            "threads", "alloc", "docs/s", "MB/s", "cpu us", "allocs");
+    }
+    else
+    {
+        printf("%-32s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n", "file", "KiB",
+            "load MB/s", "allocs", "dump MB/s", "allocs", "qry MB/s", "allocs", "hits", "RSS KiB");
+    }
+    fflush(stdout);
+
+    for (; i < argc; i++)
+    {
+        pid = fork();
+        if (pid < 0) return 1;
+        if (pid == 0)
+        {
+            status = threads ? batch(argv[i], threads, arena) : bench(argv[i]);
+            fflush(stdout);
+            _exit(status);
+        }
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,61 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench.h
+ *         \unit  bench
+ *        \brief  Common helpers of the benchmark drivers
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __bench_H
+#define __bench_H
+
+#include <stdint.h>
+#include <time.h>
+
+/* Each measurement is repeated and the best time is taken, the other ones are disturbed by the system */
+#define BENCH_REPEAT                        3
+
+/* monotonic time in seconds */
+static inline double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* CPU time of the calling thread in seconds, what a thread would take on a core of its own */
+static inline double bench_thread_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* fixed pseudo random numbers, so every run measures the same data */
+static inline uint32_t bench_rand(uint64_t *state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(*state >> 33);
+}
+
+/* Best time of `BENCH_REPEAT` runs of a statement, `prepare` runs untimed before each one */
+#define BENCH_BEST(best, prepare, statement)                                \
+    do {                                                                    \
+        int bench_i_;                                                       \
+        double bench_t_;                                                    \
+        (best) = 1e30;                                                      \
+        for (bench_i_ = 0; bench_i_ < BENCH_REPEAT; bench_i_++)             \
+        {                                                                   \
+            prepare;                                                        \
+            bench_t_ = bench_now();                                         \
+            statement;                                                      \
+            bench_t_ = bench_now() - bench_t_;                              \
+            if (bench_t_ < (best)) (best) = bench_t_;                       \
+        }                                                                   \
+    } while (0)
+
+#endif
@@ -0,0 +1,171 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_cbor.c
+ *         \unit  bench
+ *        \brief  Benchmark of cbor against json text, size and encode/decode time of the same json_t
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "json.h"
+#include "cbor.h"
+
+/* usage: bench_cbor [json files], a tuning payload of 25 channels when no file is given
+ *
+ * Each document is loaded once into a json_t, then compact json text and cbor of it are measured:
+ * dump is `json_dumps()` against `json_cbor_dumps()`, load is `json_loads()` against `json_cbor_loads()`,
+ * and walk is a pass of `cbor_read()` over the cbor that builds nothing. Times are the best of 3 runs.
+ */
+
+#define CHANNELS                            25
+
+/* the payload the tuning tool sends, one object of parameters per ADC channel */
+static char *tuning_payload(void)
+{
+    char *text = malloc(CHANNELS * 192 + 128);
+    int i, len;
+
+    if (!text) return NULL;
+    len = sprintf(text, "{\"device\":\"iem\",\"version\":\"1.0.0\",\"rate\":1000,\"channels\":[");
+    for (i = 0; i < CHANNELS; i++)
+    {
+        len += sprintf(text + len, "%s{\"id\":%d,\"name\":\"ch%02d\",\"enabled\":%s,\"gain\":%g,\"offset\":%d,"
+            "\"eq\":[%g,%g,%g,%g,%g]}", i ? "," : "", i, i, (i % 3) ? "true" : "false",
+            1.0 + i * 0.25, -i * 12, 0.5, -1.25, 0.125 * i, 3.0, -0.0625);
+    }
+    sprintf(text + len, "]}");
+
+    return text;
+}
+
+static char *read_file(const char *filename)
+{
+    FILE *f = fopen(filename, "rb");
+    char *text;
+    long size;
+
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = malloc(size + 1);
+    if (text && fread(text, 1, size, f) != (size_t)size)
+    {
+        free(text);
+        text = NULL;
+    }
+    fclose(f);
+    if (text) text[size] = 0;
+
+    return text;
+}
+
+/* count the items of cbor without building anything */
+static long walk(const void *data, int len)
+{
+    CBOR_READER reader;
+    CBOR_ITEM item;
+    long count = 0;
+
+    cbor_reader_init(&reader, data, len);
+    while (cbor_read(&reader, &item) == CBOR_E_OK) count++;
+
+    return count;
+}
+
+static int bench(const char *name, const char *source)
+{
+    json_t json, back;
+    char *text, *check;
+    void *cbor;
+    int text_len = 0, cbor_len = 0, i, n;
+    long items = 0;
+    double t_dump, t_cbor_dump, t_load, t_cbor_load, t_walk;
+
+    json = json_loads(source);
+    if (!json)
+    {
+        fprintf(stderr, "%s: load fail\n", name);
+        return 1;
+    }
+
+    text = json_dumps(json, 0, 1, &text_len);
+    cbor = json_cbor_dumps(json, 0, &cbor_len);
+    if (!text || !cbor)
+    {
+        fprintf(stderr, "%s: dump fail\n", name);
+        return 1;
+    }
+
+    /* the cbor must come back to the same text */
+    back = json_cbor_loads(cbor, cbor_len);
+    check = back ? json_dumps(back, 0, 1, NULL) : NULL;
+    if (!check || strcmp(check, text) != 0)
+    {
+        fprintf(stderr, "%s: round trip differs\n", name);
+        return 1;
+    }
+    free(check);
+    json_delete(back);
+
+    /* about 50 MB of text each run */
+    n = 50000000 / (text_len + 1) + 1;
+
+    BENCH_BEST(t_dump, , for (i = 0; i < n; i++) free(json_dumps(json, 0, 1, NULL)));
+    BENCH_BEST(t_cbor_dump, , for (i = 0; i < n; i++) free(json_cbor_dumps(json, 0, NULL)));
+    BENCH_BEST(t_load, , for (i = 0; i < n; i++) json_delete(json_loads(text)));
+    BENCH_BEST(t_cbor_load, , for (i = 0; i < n; i++) json_delete(json_cbor_loads(cbor, cbor_len)));
+    BENCH_BEST(t_walk, , for (i = 0; i < n; i++) items += walk(cbor, cbor_len));
+
+    printf("%-28s %9d %9d %8.1f%% %10.0f %10.0f %10.0f %10.0f %10.0f\n", name, text_len, cbor_len,
+        100.0 * cbor_len / text_len,
+        t_dump / n * 1e9, t_cbor_dump / n * 1e9, t_load / n * 1e9, t_cbor_load / n * 1e9, t_walk / n * 1e9);
+
+    free(text);
+    free(cbor);
+    json_delete(json);
+
+    return items > 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name;
+    char *text;
+    int i, ret = 0;
+
+    printf("%-28s %9s %9s %9s %10s %10s %10s %10s %10s\n", "document", "json B", "cbor B", "ratio",
+        "dump ns", "cbor ns", "load ns", "cbor ns", "walk ns");
+
+    if (argc < 2)
+    {
+        text = tuning_payload();
+        if (!text) return 1;
+        ret = bench("tuning payload", text);
+        free(text);
+        return ret;
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        text = read_file(argv[i]);
+        if (!text)
+        {
+            fprintf(stderr, "%s: read fail\n", argv[i]);
+            ret = 1;
+            continue;
+        }
+        name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+        ret |= bench(name, text);
+        free(text);
+    }
+
+    return ret;
+}
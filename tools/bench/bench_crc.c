@@ -0,0 +1,95 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_crc.c
+ *         \unit  bench
+ *        \brief  Benchmark of the crc engines, bitwise against table driven, for every model
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "crc.h"
+
+/* usage: bench_crc [KiB], a buffer of 1 MiB by default, GB/s of the best of 3 runs
+ *
+ *   bitwise  `crc()`, the reference, eight shift steps per byte
+ *   named    the named function of the model, one lookup per byte
+ *   sliced   `crc_table()` of a table from `crc_table_init()`, `CRC_SLICE` bytes per step
+ *
+ * The results of the three engines are compared, a difference is reported instead of the speed.
+ */
+
+/* named functions return the width of the model, all of them are widened to 32 bits */
+#define NAMED(f)                            static uint32_t n_##f(uint8_t *data, uint32_t len) { return f(data, len); }
+
+NAMED(crc4_itu) NAMED(crc5_epc) NAMED(crc5_itu) NAMED(crc5_usb) NAMED(crc6_itu) NAMED(crc7_mmc)
+NAMED(crc8) NAMED(crc8_itu) NAMED(crc8_rohc) NAMED(crc8_maxim)
+NAMED(crc16_ibm) NAMED(crc16_maxim) NAMED(crc16_usb) NAMED(crc16_modbus) NAMED(crc16_ccitt)
+NAMED(crc16_ccitt_false) NAMED(crc16_x25) NAMED(crc16_xmodem) NAMED(crc16_dnp)
+NAMED(crc32) NAMED(crc32_mpeg_2)
+
+/* models in the order of `crcParaModelTable` */
+static const struct
+{
+    const char *name;
+    uint32_t (*named)(uint8_t *data, uint32_t len);
+} models[] = {
+    { "crc4_itu", n_crc4_itu }, { "crc5_epc", n_crc5_epc }, { "crc5_itu", n_crc5_itu }, { "crc5_usb", n_crc5_usb },
+    { "crc6_itu", n_crc6_itu }, { "crc7_mmc", n_crc7_mmc }, { "crc8", n_crc8 }, { "crc8_itu", n_crc8_itu },
+    { "crc8_rohc", n_crc8_rohc }, { "crc8_maxim", n_crc8_maxim }, { "crc16_ibm", n_crc16_ibm },
+    { "crc16_maxim", n_crc16_maxim }, { "crc16_usb", n_crc16_usb }, { "crc16_modbus", n_crc16_modbus },
+    { "crc16_ccitt", n_crc16_ccitt }, { "crc16_ccitt_false", n_crc16_ccitt_false }, { "crc16_x25", n_crc16_x25 },
+    { "crc16_xmodem", n_crc16_xmodem }, { "crc16_dnp", n_crc16_dnp }, { "crc32", n_crc32 },
+    { "crc32_mpeg_2", n_crc32_mpeg_2 },
+};
+
+int main(int argc, char *argv[])
+{
+    uint32_t len = (argc > 1 ? atoi(argv[1]) : 1024) * 1024u;
+    static crcTableType table;
+    uint64_t seed = 1;
+    uint32_t r_bitwise = 0, r_named = 0, r_sliced = 0, i;
+    double t_bitwise, t_named, t_sliced;
+    uint8_t *data;
+    unsigned int m;
+    int ret = 0;
+
+    data = malloc(len ? len : 1);
+    if (!len || !data)
+    {
+        fprintf(stderr, "usage: %s [KiB]\n", argv[0]);
+        return 1;
+    }
+    for (i = 0; i < len; i++) data[i] = (uint8_t)bench_rand(&seed);
+
+    printf("%u KiB, CRC_SLICE %d, GB/s\n", len / 1024, CRC_SLICE);
+    printf("%-20s %9s %9s %9s %9s\n", "model", "bitwise", "named", "sliced", "speedup");
+
+    for (m = 0; m < sizeof(models) / sizeof(models[0]); m++)
+    {
+        crc_table_init(&table, &crcParaModelTable[m]);
+
+        BENCH_BEST(t_bitwise, , r_bitwise = crc(data, len, &crcParaModelTable[m]));
+        BENCH_BEST(t_named, , r_named = models[m].named(data, len));
+        BENCH_BEST(t_sliced, , r_sliced = crc_table(data, len, &table));
+
+        if (r_named != r_bitwise || r_sliced != r_bitwise)
+        {
+            printf("%-20s WRONG %08X %08X %08X\n", models[m].name, r_bitwise, r_named, r_sliced);
+            ret = 1;
+            continue;
+        }
+
+        printf("%-20s %9.3f %9.3f %9.3f %8.1fx\n", models[m].name,
+            len / t_bitwise / 1e9, len / t_named / 1e9, len / t_sliced / 1e9, t_bitwise / t_sliced);
+    }
+
+    free(data);
+
+    return ret;
+}
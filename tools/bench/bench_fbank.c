@@ -0,0 +1,198 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_fbank.c
+ *         \unit  bench
+ *        \brief  Benchmark of the filter banks, samples per second of each channel for every kernel
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bench.h"
+#include "fbank.h"
+
+/* usage: bench_fbank [channels], 25 channels by default
+ *
+ *   Ms/s    million samples per second of each channel, `ROUNDS` blocks of `FRAMES` frames, best of 3 runs
+ *   error   largest difference to a filter in double with the coefficients unrounded, in full scale
+ *
+ * The biquad bank is a 4th order Butterworth lowpass in 2 stages, the FIR bank a 32 taps lowpass. The path of the
+ * float kernels is chosen at build time, `bench_fbank_scalar` is the same driver built without SSE.
+ * An error over `limit` is reported as WRONG.
+ */
+
+#define FRAMES                              4096
+#define ROUNDS                              32
+#define STAGES                              2
+#define TAPS                                32
+#define CHANNEL_MAX                         256
+
+static fbank_coef_t coef[STAGES];
+static double taps[TAPS];
+static double *signal, *expect;
+static float *f32_in, *f32_out;
+static int16_t *q15_in, *q15_out;
+static int32_t *q31_in, *q31_out;
+static int channels;
+
+/* the buffers of the banks, aligned to 4 bytes */
+static uint32_t biquad_buffer[FBANK_BIQUAD_BUFFER(CHANNEL_MAX, STAGES) / 4];
+static uint32_t fir_buffer[FBANK_FIR_BUFFER(CHANNEL_MAX, TAPS) / 4];
+static fbank_biquad_t biquad;
+static fbank_fir_t fir;
+
+static void biquad_f32(void) { fbank_biquad_f32(&biquad, f32_in, f32_out, FRAMES); }
+static void biquad_q15(void) { fbank_biquad_q15(&biquad, q15_in, q15_out, FRAMES); }
+static void biquad_q31(void) { fbank_biquad_q31(&biquad, q31_in, q31_out, FRAMES); }
+static void fir_f32(void) { fbank_fir_f32(&fir, f32_in, f32_out, FRAMES); }
+static void fir_q15(void) { fbank_fir_q15(&fir, q15_in, q15_out, FRAMES); }
+static void fir_q31(void) { fbank_fir_q31(&fir, q31_in, q31_out, FRAMES); }
+
+static const struct
+{
+    const char *name;
+    int format;
+    int is_fir;
+    void (*run)(void);
+    double limit;
+} kernels[] = {
+    { "biquad f32", FBANK_F32, 0, biquad_f32, 1e-4 },
+    { "biquad q15", FBANK_Q15, 0, biquad_q15, 1e-2 },
+    { "biquad q31", FBANK_Q31, 0, biquad_q31, 1e-6 },
+    { "fir f32", FBANK_F32, 1, fir_f32, 1e-4 },
+    { "fir q15", FBANK_Q15, 1, fir_q15, 1e-2 },
+    { "fir q31", FBANK_Q31, 1, fir_q31, 1e-6 },
+};
+
+#define KERNELS                             (int)(sizeof(kernels) / sizeof(kernels[0]))
+
+static int init(int k)
+{
+    if (kernels[k].is_fir) return fbank_fir_init(&fir, kernels[k].format, channels, TAPS, taps, fir_buffer);
+    return fbank_biquad_init(&biquad, kernels[k].format, channels, STAGES, coef, biquad_buffer);
+}
+
+/* the filters of the bank in double, channel by channel */
+static void reference(int is_fir)
+{
+    double x[STAGES + 1][3], y[STAGES][3], sum;
+    int c, f, s, t;
+
+    for (c = 0; c < channels; c++)
+    {
+        memset(x, 0, sizeof(x));
+        memset(y, 0, sizeof(y));
+        for (f = 0; f < FRAMES; f++)
+        {
+            if (is_fir)
+            {
+                for (sum = 0.0, t = 0; t < TAPS && t <= f; t++) sum += taps[t] * signal[(f - t) * channels + c];
+                expect[f * channels + c] = sum;
+                continue;
+            }
+            x[0][0] = signal[f * channels + c];
+            for (s = 0; s < STAGES; s++)
+            {
+                y[s][0] = coef[s].b0 * x[s][0] + coef[s].b1 * x[s][1] + coef[s].b2 * x[s][2] - coef[s].a1 * y[s][1] - coef[s].a2 * y[s][2];
+                x[s][2] = x[s][1]; x[s][1] = x[s][0];
+                y[s][2] = y[s][1]; y[s][1] = y[s][0];
+                x[s + 1][0] = y[s][0];
+            }
+            expect[f * channels + c] = y[STAGES - 1][0];
+        }
+    }
+}
+
+/* largest error of the first block from a cleared bank, in full scale */
+static double error(int k)
+{
+    double e, worst = 0.0, v;
+    int i;
+
+    init(k);
+    kernels[k].run();
+    for (i = 0; i < FRAMES * channels; i++)
+    {
+        if (kernels[k].format == FBANK_F32) v = f32_out[i];
+        else if (kernels[k].format == FBANK_Q15) v = q15_out[i] / 32768.0;
+        else v = q31_out[i] / 2147483648.0;
+        e = fabs(v - expect[i]);
+        if (e > worst) worst = e;
+    }
+
+    return worst;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = 1;
+    double t, e;
+    int i, c, k, r, failed = 0;
+
+    channels = (argc > 1) ? atoi(argv[1]) : 25;
+    if (channels < 1 || channels > CHANNEL_MAX) return 1;
+
+    signal = malloc(FRAMES * channels * sizeof(double));
+    expect = malloc(FRAMES * channels * sizeof(double));
+    f32_in = malloc(FRAMES * channels * sizeof(float));
+    f32_out = malloc(FRAMES * channels * sizeof(float));
+    q15_in = malloc(FRAMES * channels * sizeof(int16_t));
+    q15_out = malloc(FRAMES * channels * sizeof(int16_t));
+    q31_in = malloc(FRAMES * channels * sizeof(int32_t));
+    q31_out = malloc(FRAMES * channels * sizeof(int32_t));
+    if (!signal || !expect || !f32_in || !f32_out || !q15_in || !q15_out || !q31_in || !q31_out) return 1;
+
+    /* 4th order Butterworth lowpass at 50 Hz and 32 taps lowpass at 100 Hz, scanned at 1 kHz */
+    fbank_design_lowpass(&coef[0], 1000, 50, 0.5412);
+    fbank_design_lowpass(&coef[1], 1000, 50, 1.3066);
+    fbank_design_fir_lowpass(taps, TAPS, 1000, 100);
+
+    /* a tone of its own and noise on every channel, within half of full scale, taken exactly by every format */
+    for (i = 0; i < FRAMES; i++)
+    {
+        for (c = 0; c < channels; c++)
+        {
+            q15_in[i * channels + c] = (int16_t)floor(16384 * (0.6 * sin(i * (c + 1) * 0.01) + 0.4 * ((bench_rand(&seed) % 2001) / 1000.0 - 1.0)));
+            signal[i * channels + c] = q15_in[i * channels + c] / 32768.0;
+            f32_in[i * channels + c] = (float)signal[i * channels + c];
+            q31_in[i * channels + c] = (int32_t)q15_in[i * channels + c] * 65536;
+        }
+    }
+
+    printf("%d channels, %s float kernels, Ms/s per channel, best of %d\n", channels,
+        FBANK_USE_SSE ? "SSE" : (FBANK_USE_NEON ? "NEON" : "scalar"), BENCH_REPEAT);
+    printf("%-12s %8s %10s\n", "kernel", "Ms/s", "error");
+
+    for (k = 0; k < KERNELS; k++)
+    {
+        if (k == 0 || kernels[k].is_fir != kernels[k - 1].is_fir) reference(kernels[k].is_fir);
+
+        e = error(k);
+        BENCH_BEST(t, init(k), for (r = 0; r < ROUNDS; r++) kernels[k].run());
+
+        if (e > kernels[k].limit)
+        {
+            printf("%-12s %8s %10.1e\n", kernels[k].name, "WRONG", e);
+            failed = 1;
+            continue;
+        }
+        printf("%-12s %8.2f %10.1e\n", kernels[k].name, (double)FRAMES * ROUNDS / t / 1e6, e);
+    }
+
+    free(signal);
+    free(expect);
+    free(f32_in);
+    free(f32_out);
+    free(q15_in);
+    free(q15_out);
+    free(q31_in);
+    free(q31_out);
+
+    return failed;
+}
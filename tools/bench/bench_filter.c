@@ -0,0 +1,210 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_filter.c
+ *         \unit  bench
+ *        \brief  Benchmark of the sliding median and average filters against the old per-window ones
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bench.h"
+#include "filter.h"
+
+/* usage: bench_filter [count], 65536 samples by default, ns per sample of the best of 3 runs
+ *
+ *   median, average    filter_median() and filter_average() over the whole array
+ *   (old)              the algorithms before the sliding ones, every window copied and bubble sorted,
+ *                      or summed, the median is timed on the first `OLD_MEDIAN` samples only
+ *   stateful           filter_median_update() and filter_average_update() fed sample by sample
+ *
+ * Every result is checked against a window sorted or summed point by point, on the first `CHECK` samples for the
+ * array filters and on every `STRIDE`th sample of the stream for the stateful ones, a wrong one is reported
+ * instead of its time.
+ */
+
+#define WINDOWS                             5
+#define OLD_MEDIAN                          2048
+#define CHECK                               8192
+#define STRIDE                              97
+
+static const int windows[WINDOWS] = { 15, 61, 245, 981, 1025 };
+
+/* the old median, per point a copy of its window bubble sorted, the window shifted inside the data */
+static void old_median(double *data, int size, int window)
+{
+    double *array = malloc(window * sizeof(double)), temp;
+    int index, i, j, start;
+
+    if (window % 2 == 0) window++;
+    for (index = 0; index < size; index++)
+    {
+        start = index - window / 2;
+        if (start > size - window) start = size - window;
+        if (start < 0) start = 0;
+        for (i = 0; i < window; i++) array[i] = data[start + i];
+        for (i = 0; i < window - 1; i++)
+        {
+            for (j = 0; j < window - i - 1; j++)
+            {
+                if (array[j] > array[j + 1])
+                {
+                    temp = array[j];
+                    array[j] = array[j + 1];
+                    array[j + 1] = temp;
+                }
+            }
+        }
+        data[index] = array[window / 2];
+    }
+    free(array);
+}
+
+/* the old average, per point the sum of its window */
+static void old_average(double *data, int size, int window)
+{
+    double sum;
+    int i, j, start, end;
+
+    if (window % 2 == 0) window++;
+    for (i = 0; i < size; i++)
+    {
+        sum = 0.0;
+        start = i - window / 2;
+        end = start + window;
+        if (start < 0) start = 0;
+        if (end > size) end = size;
+        for (j = start; j < end; j++) sum += data[j];
+        data[i] = sum / window;
+    }
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* median of `count` values from `data`, sorted in `temp` */
+static double ref_median(const double *data, int count, double *temp)
+{
+    memcpy(temp, data, count * sizeof(double));
+    qsort(temp, count, sizeof(double), cmp_double);
+    return (count % 2) ? temp[count / 2] : (temp[count / 2 - 1] + temp[count / 2]) / 2;
+}
+
+static double ref_average(const double *data, int count)
+{
+    double sum = 0.0;
+    int i;
+
+    for (i = 0; i < count; i++) sum += data[i];
+    return sum / count;
+}
+
+static int near(double x, double y)
+{
+    return fabs(x - y) <= 1e-9 * (1.0 + fabs(y));
+}
+
+/* filter_median() and filter_average() on the first `CHECK` samples, the window shifted or cut at the ends */
+static int check_array(const double *data, int size, int window, double *work, double *temp)
+{
+    int i, start, end, w = (window % 2) ? window : window + 1;
+    int half = w / 2, wm = (w > size) ? size : w;
+
+    memcpy(work, data, size * sizeof(double));
+    filter_median(work, size, window);
+    for (i = 0; i < size; i++)
+    {
+        start = i - wm / 2;
+        if (start > size - wm) start = size - wm;
+        if (start < 0) start = 0;
+        if (work[i] != ref_median(data + start, wm, temp)) return 0;
+    }
+
+    memcpy(work, data, size * sizeof(double));
+    filter_average(work, size, window);
+    for (i = 0; i < size; i++)
+    {
+        start = (i - half < 0) ? 0 : i - half;
+        end = (i + half >= size) ? size - 1 : i + half;
+        if (!near(work[i], ref_average(data + start, end - start + 1))) return 0;
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 65536;
+    double *data, *work, *temp, *out, *buffer;
+    double t_median, t_old_median, t_average, t_old_average, t_smedian, t_saverage;
+    filter_median_t median;
+    filter_average_t average;
+    uint64_t seed = 1;
+    int w, i, count, ok, failed = 0;
+
+    if (n < CHECK) n = CHECK;
+    data = malloc(n * sizeof(double));
+    work = malloc(n * sizeof(double));
+    out = malloc(n * sizeof(double));
+    temp = malloc((n + CHECK) * sizeof(double));
+    buffer = malloc(FILTER_MEDIAN_BUFFER(windows[WINDOWS - 1]) * sizeof(double));
+    if (!data || !work || !out || !temp || !buffer) return 1;
+
+    /* a slow sine with noise and spikes */
+    for (i = 0; i < n; i++)
+    {
+        data[i] = sin(i * 1e-3) + (bench_rand(&seed) % 2001 - 1000) * 1e-4;
+        if (bench_rand(&seed) % 100 == 0) data[i] += 10.0;
+    }
+
+    printf("%d samples, ns per sample, best of %d\n", n, BENCH_REPEAT);
+    printf("%-6s %9s %10s %9s %9s | %9s %9s\n", "window", "median", "(old)", "average", "(old)", "stateful", "stateful");
+    printf("%-6s %9s %10s %9s %9s | %9s %9s\n", "", "", "", "", "", "median", "average");
+
+    for (w = 0; w < WINDOWS; w++)
+    {
+        BENCH_BEST(t_median, memcpy(work, data, n * sizeof(double)), filter_median(work, n, windows[w]));
+        BENCH_BEST(t_old_median, memcpy(work, data, OLD_MEDIAN * sizeof(double)), old_median(work, OLD_MEDIAN, windows[w]));
+        BENCH_BEST(t_average, memcpy(work, data, n * sizeof(double)), filter_average(work, n, windows[w]));
+        BENCH_BEST(t_old_average, memcpy(work, data, n * sizeof(double)), old_average(work, n, windows[w]));
+        BENCH_BEST(t_smedian, filter_median_init(&median, windows[w], buffer),
+            for (i = 0; i < n; i++) out[i] = filter_median_update(&median, data[i]));
+        BENCH_BEST(t_saverage, filter_average_init(&average, windows[w], buffer),
+            for (i = 0; i < n; i++) work[i] = filter_average_update(&average, data[i]));
+
+        /* the stateful filters see the samples up to the current one */
+        ok = check_array(data, CHECK, windows[w], temp + CHECK, temp);
+        for (i = 0; ok && i < n; i += STRIDE)
+        {
+            count = (i + 1 < windows[w]) ? i + 1 : windows[w];
+            ok = out[i] == ref_median(data + i + 1 - count, count, temp) && near(work[i], ref_average(data + i + 1 - count, count));
+        }
+        failed |= !ok;
+
+        if (!ok)
+        {
+            printf("%-6d %9s\n", windows[w], "WRONG");
+            continue;
+        }
+        printf("%-6d %9.1f %10.1f %9.1f %9.1f | %9.1f %9.1f\n", windows[w], t_median / n * 1e9, t_old_median / OLD_MEDIAN * 1e9,
+            t_average / n * 1e9, t_old_average / n * 1e9, t_smedian / n * 1e9, t_saverage / n * 1e9);
+        fflush(stdout);
+    }
+
+    free(data);
+    free(work);
+    free(out);
+    free(temp);
+    free(buffer);
+
+    return failed;
+}
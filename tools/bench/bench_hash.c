@@ -0,0 +1,156 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_hash.c
+ *         \unit  bench
+ *        \brief  Benchmark of the hashes, throughput over key sizes and avalanche and collision quality
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bench.h"
+#include "hash.h"
+
+/* usage: bench_hash
+ *
+ *   8B .. 1MB  MB/s hashing keys of that size, best of 3 runs
+ *   aval8/64   avalanche of 8 and 64 byte keys, the worst bias |p - 0.5| of any input bit and output bit pair,
+ *              where p is how often flipping the input bit flips the output bit, over `SAMPLES` random keys
+ *   coll       colliding 32-bit values of `KEYS` keys "key%d", the low 32 bits of 64-bit hashes
+ *   bkt        the largest of 2^16 buckets taken by the low 16 bits of the same keys
+ *
+ * A random function expects a bias of about 0.04 here, about 116 collisions and a largest bucket of about 35.
+ */
+
+#define SAMPLES                             2000
+#define KEYS                                1000000
+#define VOLUME                              (32 << 20)  /**< bytes hashed by each throughput run */
+
+#define WIDEN(f)                            static uint64_t w_##f(void *data, uint32_t size) { return f(data, size); }
+
+WIDEN(hash_bkdr) WIDEN(hash_ap) WIDEN(hash_djb) WIDEN(hash_js) WIDEN(hash_rs) WIDEN(hash_sdbm)
+WIDEN(hash_pjw) WIDEN(hash_elf) WIDEN(hash_dek) WIDEN(hash_bp) WIDEN(hash_fnv) WIDEN(hash_jdk6) WIDEN(hash_wy)
+
+static uint64_t w_hash_wy_seed(void *data, uint32_t size) { return hash_wy_seed(data, size, 0x9E3779B97F4A7C15ULL); }
+
+static const struct
+{
+    const char *name;
+    uint64_t (*hash)(void *data, uint32_t size);
+    int bits;
+} hashes[] = {
+    { "bkdr", w_hash_bkdr, 32 }, { "ap", w_hash_ap, 32 }, { "djb", w_hash_djb, 32 }, { "js", w_hash_js, 32 },
+    { "rs", w_hash_rs, 32 }, { "sdbm", w_hash_sdbm, 32 }, { "pjw", w_hash_pjw, 32 }, { "elf", w_hash_elf, 32 },
+    { "dek", w_hash_dek, 32 }, { "bp", w_hash_bp, 32 }, { "fnv", w_hash_fnv, 32 }, { "jdk6", w_hash_jdk6, 32 },
+    { "wy", w_hash_wy, 64 }, { "wy_seed", w_hash_wy_seed, 64 },
+};
+
+static const uint32_t sizes[] = { 8, 32, 1024, 1 << 20 };
+
+static uint64_t sink = 0;
+
+/* MB/s of keys of `size` bytes, taken at moving offsets of the buffer */
+static double throughput(uint64_t (*hash)(void *, uint32_t), uint8_t *buffer, uint32_t size)
+{
+    uint32_t n = VOLUME / size, i;
+    double t;
+
+    BENCH_BEST(t, , for (i = 0; i < n; i++) sink += hash(buffer + (i & 1023), size));
+
+    return (double)n * size / t / 1e6;
+}
+
+static double avalanche(uint64_t (*hash)(void *, uint32_t), int bits, uint32_t size)
+{
+    static uint32_t flips[64 * 8][64];
+    uint8_t key[64];
+    uint64_t seed = 7, h, d;
+    double bias, worst = 0;
+    uint32_t s, i, b;
+
+    memset(flips, 0, sizeof(flips));
+    for (s = 0; s < SAMPLES; s++)
+    {
+        for (i = 0; i < size; i++) key[i] = (uint8_t)bench_rand(&seed);
+        h = hash(key, size);
+        for (i = 0; i < size * 8; i++)
+        {
+            key[i / 8] ^= (uint8_t)(1 << (i % 8));
+            d = h ^ hash(key, size);
+            key[i / 8] ^= (uint8_t)(1 << (i % 8));
+            for (b = 0; b < (uint32_t)bits; b++) flips[i][b] += (d >> b) & 1;
+        }
+    }
+
+    for (i = 0; i < size * 8; i++)
+    {
+        for (b = 0; b < (uint32_t)bits; b++)
+        {
+            bias = fabs((double)flips[i][b] / SAMPLES - 0.5);
+            if (bias > worst) worst = bias;
+        }
+    }
+
+    return worst;
+}
+
+static int compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void collisions(uint64_t (*hash)(void *, uint32_t), long *coll, long *bucket)
+{
+    static uint32_t values[KEYS], buckets[1 << 16];
+    char key[16];
+    int i, len;
+
+    memset(buckets, 0, sizeof(buckets));
+    *bucket = 0;
+    for (i = 0; i < KEYS; i++)
+    {
+        len = sprintf(key, "key%d", i);
+        values[i] = (uint32_t)hash(key, len);
+        if (++buckets[values[i] & 0xFFFF] > *bucket) *bucket = buckets[values[i] & 0xFFFF];
+    }
+
+    qsort(values, KEYS, sizeof(uint32_t), compare);
+    *coll = 0;
+    for (i = 1; i < KEYS; i++) *coll += values[i] == values[i - 1];
+}
+
+int main(void)
+{
+    uint8_t *buffer = malloc((1 << 20) + 1024);
+    uint64_t seed = 1;
+    unsigned int h, s;
+    long coll, bucket;
+    uint32_t i;
+
+    if (!buffer) return 1;
+    for (i = 0; i < (1 << 20) + 1024; i++) buffer[i] = (uint8_t)bench_rand(&seed);
+
+    printf("%-10s %7s %7s %7s %7s | %6s %6s %7s %5s\n", "hash", "8B", "32B", "1KB", "1MB",
+        "aval8", "aval64", "coll", "bkt");
+
+    for (h = 0; h < sizeof(hashes) / sizeof(hashes[0]); h++)
+    {
+        printf("%-10s", hashes[h].name);
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) printf(" %7.0f", throughput(hashes[h].hash, buffer, sizes[s]));
+        collisions(hashes[h].hash, &coll, &bucket);
+        printf(" | %6.3f %6.3f %7ld %5ld\n", avalanche(hashes[h].hash, hashes[h].bits, 8),
+            avalanche(hashes[h].hash, hashes[h].bits, 64), coll, bucket);
+        fflush(stdout);
+    }
+
+    free(buffer);
+
+    return sink == 0;
+}
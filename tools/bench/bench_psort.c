@@ -0,0 +1,296 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_psort.c
+ *         \unit  bench
+ *        \brief  Benchmark of the parallel sorts, the critical path against the count of threads
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "bench.h"
+#include "sort.h"
+
+/* usage: bench_psort [count], 2M elements by default, seconds of the best of 3 runs
+ *
+ *   wall   elapsed time, it only shows a speedup with as many free cores as threads
+ *   crit   critical path, the time the sort would take with a core for every thread
+ *   proj   the 1-thread crit divided by crit, the projected speedup
+ *
+ * `pthread_create()` and `pthread_join()` are wrapped to follow the threads of the sort, each thread keeps a clock
+ * that advances by its own CPU time, starts at the clock of its creator and, on joining, jumps to the clock of
+ * the thread joined when that one is later. The clock of the caller when the sort returns is the critical path.
+ * Every result is checked, a wrong one is reported instead of its times.
+ */
+
+#define THREADS                             5
+#define NODE_MAX                            1024
+
+static const int threads[THREADS] = { 1, 2, 4, 8, 16 };
+
+/* timestamped sample, sorted by time */
+typedef struct
+{
+    double t;
+    int v;
+} SAMPLE;
+
+/* A thread followed */
+typedef struct
+{
+    pthread_t id;
+    void *(*start)(void *);
+    void *arg;
+    double begin;                           /**< clock of the creator when created */
+    double end;                             /**< own clock when returned */
+    int used;
+} NODE;
+
+static NODE nodes[NODE_MAX];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* clock of the calling thread, `base` when its CPU time was `cpu` */
+static __thread double base = 0, cpu = 0;
+
+static double clock_read(void)
+{
+    return base + bench_thread_time() - cpu;
+}
+
+static void clock_set(double value)
+{
+    cpu = bench_thread_time();
+    base = value;
+}
+
+int __real_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start)(void *), void *arg);
+int __real_pthread_join(pthread_t thread, void **retval);
+
+static void *node_start(void *arg)
+{
+    NODE *node = (NODE *)arg;
+    void *retval;
+
+    clock_set(node->begin);
+    retval = node->start(node->arg);
+    node->end = clock_read();
+
+    return retval;
+}
+
+int __wrap_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start)(void *), void *arg)
+{
+    NODE *node = NULL;
+    int i, error;
+
+    pthread_mutex_lock(&lock);
+    for (i = 0; i < NODE_MAX; i++)
+    {
+        if (!nodes[i].used)
+        {
+            node = &nodes[i];
+            node->used = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    if (!node) return __real_pthread_create(thread, attr, start, arg);
+
+    node->start = start;
+    node->arg = arg;
+    node->begin = clock_read();
+    error = __real_pthread_create(&node->id, attr, node_start, node);
+    if (error)
+    {
+        pthread_mutex_lock(&lock);
+        node->used = 0;
+        pthread_mutex_unlock(&lock);
+        return error;
+    }
+    *thread = node->id;
+
+    return 0;
+}
+
+int __wrap_pthread_join(pthread_t thread, void **retval)
+{
+    NODE *node = NULL;
+    double now;
+    int i, error;
+
+    error = __real_pthread_join(thread, retval);
+    now = clock_read();
+
+    pthread_mutex_lock(&lock);
+    for (i = 0; i < NODE_MAX; i++)
+    {
+        if (nodes[i].used && pthread_equal(nodes[i].id, thread))
+        {
+            node = &nodes[i];
+            break;
+        }
+    }
+
+    if (node)
+    {
+        clock_set(node->end > now ? node->end : now);
+        node->used = 0;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return error;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int sample_order(void *front, void *back)
+{
+    double f = ((SAMPLE *)front)->t, b = ((SAMPLE *)back)->t;
+    return (b > f) - (b < f);
+}
+
+static void *sample_addr(void *array, int index)
+{
+    return &((SAMPLE *)array)[index];
+}
+
+static void sample_swap(void *array, int index0, int index1)
+{
+    SAMPLE *a = (SAMPLE *)array, t = a[index0];
+    a[index0] = a[index1];
+    a[index1] = t;
+}
+
+static SOPS sops_sample = { sample_order, sample_addr, sample_swap };
+
+static int *ints, *ints_ref, *ints_work;
+static SAMPLE *samples, *samples_work;
+static int n;
+
+static int run_typed(int t) { return sort_parallel_int(ints_work, 0, n - 1, 0, t); }
+static int run_sops(int t) { return sort_parallel(ints_work, 0, n - 1, &sops_int_ascend, t); }
+static int run_sample(int t) { return sort_parallel(samples_work, 0, n - 1, &sops_sample, t); }
+
+static void prepare_ints(void) { memcpy(ints_work, ints, n * sizeof(int)); }
+static void prepare_samples(void) { memcpy(samples_work, samples, n * sizeof(SAMPLE)); }
+
+static int check_ints(void) { return !memcmp(ints_work, ints_ref, n * sizeof(int)); }
+
+static int check_samples(void)
+{
+    long long sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (i > 0 && samples_work[i - 1].t > samples_work[i].t) return 0;
+        sum += samples_work[i].v;
+    }
+
+    return sum == (long long)n * (n - 1) / 2;
+}
+
+static const struct
+{
+    const char *name;
+    int (*run)(int threads);
+    void (*prepare)(void);
+    int (*check)(void);
+} sorts[] = {
+    { "parallel_int", run_typed, prepare_ints, check_ints },
+    { "parallel(int SOPS)", run_sops, prepare_ints, check_ints },
+    { "parallel(sample SOPS)", run_sample, prepare_samples, check_samples },
+};
+
+#define SORTS                               (int)(sizeof(sorts) / sizeof(sorts[0]))
+
+int main(int argc, char *argv[])
+{
+    double wall[SORTS][THREADS], crit[SORTS][THREADS], w, c;
+    int ok[SORTS][THREADS];
+    uint64_t seed = 1;
+    int s, t, r, i, j, failed = 0;
+    SAMPLE x;
+
+    n = (argc > 1) ? atoi(argv[1]) : 2000000;
+    if (n < 2) n = 2;
+
+    ints = malloc(n * sizeof(int));
+    ints_ref = malloc(n * sizeof(int));
+    ints_work = malloc(n * sizeof(int));
+    samples = malloc(n * sizeof(SAMPLE));
+    samples_work = malloc(n * sizeof(SAMPLE));
+    if (!ints || !ints_ref || !ints_work || !samples || !samples_work) return 1;
+
+    /* random ints, and samples nearly in time order, 1% of them swapped with a near one */
+    for (i = 0; i < n; i++) ints[i] = (int)bench_rand(&seed);
+    memcpy(ints_ref, ints, n * sizeof(int));
+    qsort(ints_ref, n, sizeof(int), cmp_int);
+    for (i = 0; i < n; i++)
+    {
+        samples[i].t = i * 1e-3 + (bench_rand(&seed) % 1000) * 1e-7;
+        samples[i].v = i;
+    }
+    for (r = 0; r < n / 100; r++)
+    {
+        i = bench_rand(&seed) % n;
+        j = (i + 1 + bench_rand(&seed) % 16) % n;
+        x = samples[i]; samples[i] = samples[j]; samples[j] = x;
+    }
+
+    for (s = 0; s < SORTS; s++)
+    {
+        for (t = 0; t < THREADS; t++)
+        {
+            wall[s][t] = crit[s][t] = 1e30;
+            ok[s][t] = 1;
+            for (r = 0; r < BENCH_REPEAT; r++)
+            {
+                sorts[s].prepare();
+                clock_set(0);
+                w = bench_now();
+                ok[s][t] &= sorts[s].run(threads[t]);
+                w = bench_now() - w;
+                c = clock_read();
+                ok[s][t] &= sorts[s].check();
+                if (w < wall[s][t]) wall[s][t] = w;
+                if (c < crit[s][t]) crit[s][t] = c;
+            }
+            failed |= !ok[s][t];
+        }
+    }
+
+    printf("%d elements, seconds, best of %d\n%-8s", n, BENCH_REPEAT, "threads");
+    for (s = 0; s < SORTS; s++) printf(" | %-22s", sorts[s].name);
+    printf("\n%-8s", "");
+    for (s = 0; s < SORTS; s++) printf(" | %6s %6s %6s  ", "wall", "crit", "proj");
+    printf("\n");
+    for (t = 0; t < THREADS; t++)
+    {
+        printf("%-8d", threads[t]);
+        for (s = 0; s < SORTS; s++)
+        {
+            if (!ok[s][t]) printf(" | %-22s", "WRONG");
+            else printf(" | %6.3f %6.3f %5.1fx  ", wall[s][t], crit[s][t], crit[s][0] / crit[s][t]);
+        }
+        printf("\n");
+    }
+
+    free(ints);
+    free(ints_ref);
+    free(ints_work);
+    free(samples);
+    free(samples_work);
+
+    return failed;
+}
@@ -0,0 +1,223 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_save.c
+ *         \unit  bench
+ *        \brief  Benchmark of the save latency of ini and json after one value of a large file is changed
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "ini.h"
+#include "json.h"
+
+/* usage: bench_save [directory] [sections], 100 sections of 100 keys in `build` by default
+ *
+ * The document is saved once with `*_file_save()`, so the value spans are known, then each round changes the
+ * value of one key to another one of the same length and writes the file with:
+ *   patch   `*_file_patch()`, only the changed value is written in place
+ *   save    `*_file_save()`, the whole file through a temporary file and a rename
+ *   dump    `*_file_dump()`, the whole file rewritten in place, as before
+ * The median and the worst latency of `ROUNDS` rounds are reported, then the file is loaded back to check
+ * the last value. The written files are left in the directory.
+ */
+
+#define ROUNDS                              31
+#define KEYS                                100     /**< keys of a section */
+
+/* one way of writing the file, returns bytes written or negative fail */
+typedef int (*WRITE)(void *doc, const char *filename);
+/* change the value of one key of round `r` */
+typedef void (*CHANGE)(void *doc, int r, int sections);
+/* check the value of round `r` in the file, 1 it is there */
+typedef int (*CHECK)(const char *filename, int r, int sections);
+
+static void value_of(char *value, int r)
+{
+    sprintf(value, "%c%04d", 'a' + r % 26, r % 10000);
+}
+
+static int ini_patch(void *doc, const char *filename) { return ini_file_patch(doc, filename); }
+static int ini_save(void *doc, const char *filename) { return ini_file_save(doc, filename); }
+static int ini_dump(void *doc, const char *filename) { return ini_file_dump(doc, (char *)filename); }
+
+static void ini_change(void *doc, int r, int sections)
+{
+    char section[16], key[16], value[16];
+
+    sprintf(section, "s%d", (r * 7) % sections);
+    sprintf(key, "k%d", (r * 13) % KEYS);
+    value_of(value, r);
+    ini_set_value(doc, section, key, value);
+}
+
+static int ini_check(const char *filename, int r, int sections)
+{
+    ini_t ini = ini_file_load(filename);
+    char section[16], key[16], value[16];
+    const char *v;
+    int ok;
+
+    sprintf(section, "s%d", (r * 7) % sections);
+    sprintf(key, "k%d", (r * 13) % KEYS);
+    value_of(value, r);
+    v = ini ? ini_get_value(ini, section, key) : NULL;
+    ok = v && strcmp(v, value) == 0;
+    ini_delete(ini);
+
+    return ok;
+}
+
+static int json_patch(void *doc, const char *filename) { return json_file_patch(doc, filename); }
+static int json_save(void *doc, const char *filename) { return json_file_save(doc, filename); }
+static int json_dump(void *doc, const char *filename) { return json_file_dump(doc, (char *)filename); }
+
+static json_t json_key_of(json_t json, int r, int sections)
+{
+    char section[16], key[16];
+
+    sprintf(section, "s%d", (r * 7) % sections);
+    sprintf(key, "k%d", (r * 13) % KEYS);
+
+    return json_get(json_get(json, section, 0), key, 0);
+}
+
+static void json_change(void *doc, int r, int sections)
+{
+    char value[16];
+
+    value_of(value, r);
+    json_set_string(json_key_of(doc, r, sections), value);
+}
+
+static int json_check(const char *filename, int r, int sections)
+{
+    json_t json = json_file_load((char *)filename);
+    char value[16];
+    const char *v;
+    int ok;
+
+    value_of(value, r);
+    v = json ? json_value_string(json_key_of(json, r, sections)) : NULL;
+    ok = v && strcmp(v, value) == 0;
+    json_delete(json);
+
+    return ok;
+}
+
+static int compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* write the file `ROUNDS` times, one change before each */
+static int measure(const char *format, const char *method, void *doc, const char *filename, int sections,
+    WRITE write, CHANGE change, CHECK check, int *round)
+{
+    double t[ROUNDS];
+    long bytes = 0;
+    int i, n;
+
+    for (i = 0; i < ROUNDS; i++, (*round)++)
+    {
+        change(doc, *round, sections);
+        t[i] = bench_now();
+        n = write(doc, filename);
+        t[i] = bench_now() - t[i];
+        if (n < 0)
+        {
+            fprintf(stderr, "%s %s: write fail\n", format, method);
+            return 1;
+        }
+        bytes += n;
+    }
+    if (!check(filename, *round - 1, sections))
+    {
+        fprintf(stderr, "%s %s: the file does not hold the last value\n", format, method);
+        return 1;
+    }
+
+    qsort(t, ROUNDS, sizeof(double), compare);
+    printf("%-6s %-6s %9d %12ld %10.3f %10.3f\n", format, method, sections * KEYS, bytes / ROUNDS,
+        t[ROUNDS / 2] * 1e3, t[ROUNDS - 1] * 1e3);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *dir = argc > 1 ? argv[1] : "build";
+    int sections = argc > 2 ? atoi(argv[2]) : 100;
+    char ini_name[256], json_name[256], value[16];
+    char *text;
+    ini_t ini;
+    json_t json;
+    int s, k, len = 0, round = 0, ret = 0;
+
+    if (sections <= 0)
+    {
+        fprintf(stderr, "usage: %s [directory] [sections]\n", argv[0]);
+        return 1;
+    }
+    snprintf(ini_name, sizeof(ini_name), "%s/save.ini", dir);
+    snprintf(json_name, sizeof(json_name), "%s/save.json", dir);
+
+    text = malloc((size_t)sections * (KEYS * 24 + 32) + 16);
+    if (!text) return 1;
+
+    /* ini of `sections` sections of `KEYS` keys */
+    for (s = 0; s < sections; s++)
+    {
+        len += sprintf(text + len, "[s%d]\n", s);
+        for (k = 0; k < KEYS; k++)
+        {
+            value_of(value, s * KEYS + k);
+            len += sprintf(text + len, "k%d = %s\n", k, value);
+        }
+    }
+    ini = ini_loads(text);
+
+    /* json of the same shape, objects of string members */
+    len = sprintf(text, "{");
+    for (s = 0; s < sections; s++)
+    {
+        len += sprintf(text + len, "%s\"s%d\":{", s ? "," : "", s);
+        for (k = 0; k < KEYS; k++)
+        {
+            value_of(value, s * KEYS + k);
+            len += sprintf(text + len, "%s\"k%d\":\"%s\"", k ? "," : "", k, value);
+        }
+        len += sprintf(text + len, "}");
+    }
+    sprintf(text + len, "}");
+    json = json_loads(text);
+    free(text);
+
+    if (!ini || !json || ini_file_save(ini, ini_name) < 0 || json_file_save(json, json_name) < 0)
+    {
+        fprintf(stderr, "can not create %s and %s\n", ini_name, json_name);
+        return 1;
+    }
+
+    printf("%-6s %-6s %9s %12s %10s %10s\n", "format", "method", "keys", "bytes", "median ms", "max ms");
+
+    /* patch first, a plain dump does not keep the value spans */
+    ret |= measure("ini", "patch", ini, ini_name, sections, ini_patch, ini_change, ini_check, &round);
+    ret |= measure("ini", "save", ini, ini_name, sections, ini_save, ini_change, ini_check, &round);
+    ret |= measure("ini", "dump", ini, ini_name, sections, ini_dump, ini_change, ini_check, &round);
+    ret |= measure("json", "patch", json, json_name, sections, json_patch, json_change, json_check, &round);
+    ret |= measure("json", "save", json, json_name, sections, json_save, json_change, json_check, &round);
+    ret |= measure("json", "dump", json, json_name, sections, json_dump, json_change, json_check, &round);
+
+    ini_delete(ini);
+    json_delete(json);
+
+    return ret;
+}
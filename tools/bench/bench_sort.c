@@ -0,0 +1,127 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  bench_sort.c
+ *         \unit  bench
+ *        \brief  Benchmark of the sorts on random, sorted, reversed, nearly sorted and few-valued data
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "sort.h"
+
+/* usage: bench_sort [count], 1M ints by default, seconds of the best of 3 runs
+ *
+ * Every sort is checked against qsort, a wrong result is reported instead of its time.
+ */
+
+#define SHAPES                              5
+
+static const char *shapes[SHAPES] = { "random", "sorted", "reversed", "nearly", "4 values" };
+
+static void fill(int *a, int n, int shape)
+{
+    uint64_t seed = 1;
+    int i, j, t;
+
+    for (i = 0; i < n; i++)
+    {
+        switch (shape)
+        {
+        case 0: a[i] = (int)bench_rand(&seed); break;
+        case 1: case 3: a[i] = i; break;
+        case 2: a[i] = n - i; break;
+        default: a[i] = bench_rand(&seed) % 4; break;
+        }
+    }
+
+    /* nearly sorted, 1% of the elements swapped with a near one */
+    if (shape == 3)
+    {
+        for (i = 0; i < n / 100; i++)
+        {
+            j = bench_rand(&seed) % n;
+            t = (j + 1 + bench_rand(&seed) % 16) % n;
+            a[j] ^= a[t]; a[t] ^= a[j]; a[j] ^= a[t];
+        }
+    }
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int sops_shell(int *a, int n) { return sort_shell(a, 0, n - 1, &sops_int_ascend); }
+static int sops_heap(int *a, int n) { return sort_heap(a, 0, n - 1, &sops_int_ascend); }
+static int sops_quick(int *a, int n) { return sort_quick(a, 0, n - 1, &sops_int_ascend); }
+static int sops_intro(int *a, int n) { return sort_intro(a, 0, n - 1, &sops_int_ascend); }
+static int sops_merge(int *a, int n) { return sort_merge(a, 0, n - 1, &sops_int_ascend); }
+static int typed_int(int *a, int n) { return sort_int(a, 0, n - 1, 0); }
+static int typed_radix(int *a, int n) { return sort_radix_int(a, 0, n - 1, 0); }
+static int libc_qsort(int *a, int n) { qsort(a, n, sizeof(int), cmp_int); return 1; }
+
+static const struct
+{
+    const char *name;
+    int (*sort)(int *a, int n);
+} sorts[] = {
+    { "shell", sops_shell },
+    { "heap", sops_heap },
+    { "quick", sops_quick },
+    { "intro", sops_intro },
+    { "merge", sops_merge },
+    { "sort_int", typed_int },
+    { "radix", typed_radix },
+    { "qsort", libc_qsort },
+};
+
+#define SORTS                               (int)(sizeof(sorts) / sizeof(sorts[0]))
+
+int main(int argc, char *argv[])
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int *data, *ref, *work;
+    int shape, s;
+    double best;
+
+    if (n < 2) n = 2;
+    data = malloc(n * sizeof(int));
+    ref = malloc(n * sizeof(int));
+    work = malloc(n * sizeof(int));
+    if (!data || !ref || !work) return 1;
+
+    printf("%d ints, seconds, best of %d\n%-10s", n, BENCH_REPEAT, "");
+    for (s = 0; s < SORTS; s++) printf(" %9s", sorts[s].name);
+    printf("\n");
+
+    for (shape = 0; shape < SHAPES; shape++)
+    {
+        fill(data, n, shape);
+        memcpy(ref, data, n * sizeof(int));
+        qsort(ref, n, sizeof(int), cmp_int);
+
+        printf("%-10s", shapes[shape]);
+        for (s = 0; s < SORTS; s++)
+        {
+            BENCH_BEST(best, memcpy(work, data, n * sizeof(int)), sorts[s].sort(work, n));
+            if (memcmp(work, ref, n * sizeof(int))) printf(" %9s", "WRONG");
+            else printf(" %9.3f", best);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    free(data);
+    free(ref);
+    free(work);
+
+    return 0;
+}
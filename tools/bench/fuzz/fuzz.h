@@ -0,0 +1,34 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz.h
+ *         \unit  bench
+ *        \brief  Common of the libFuzzer harnesses of the parsers
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#ifndef __fuzz_H
+#define __fuzz_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The parsers take terminated text, the input of the fuzzer is copied and terminated,
+ * an input with a NUL inside is cut there, as the parsers would see it.
+ */
+static char* fuzz_text(const uint8_t* data, size_t size)
+{
+    char* text = (char*)malloc(size + 1);
+    if (!text) return NULL;
+    memcpy(text, data, size);
+    text[size] = 0;
+    return text;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#endif
@@ -0,0 +1,47 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_csv.c
+ *         \unit  bench
+ *        \brief  libFuzzer harness of csv, load sequentially and on threads, dump and load again, query
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fuzz.h"
+#include "csv.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    char* text = fuzz_text(data, size);
+    char* out;
+    csv_t csv, again;
+    unsigned int row, col;
+    int len;
+
+    if (!text) return 0;
+
+    csv = csv_loads(text);
+    if (csv)
+    {
+        for (row = 1; row <= csv_row(csv); row++)
+        {
+            for (col = 1; col <= csv_col(csv); col++) csv_get_text(csv, row, col);
+        }
+        out = csv_dumps(csv, &len);
+        if (out)
+        {
+            again = csv_loads(out);
+            if (!again) abort();
+            csv_delete(again);
+            free(out);
+        }
+        csv_delete(csv);
+    }
+    csv_delete(csv_loads_mt(text, 4, NULL));
+
+    free(text);
+    return 0;
+}
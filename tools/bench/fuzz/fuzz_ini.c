@@ -0,0 +1,50 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_ini.c
+ *         \unit  bench
+ *        \brief  libFuzzer harness of ini, load as a copy and in place, dump and load again, query
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fuzz.h"
+#include "ini.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    char* text = fuzz_text(data, size);
+    char* out;
+    const char* section;
+    ini_t ini, again;
+    int i, k, len;
+
+    if (!text) return 0;
+
+    ini = ini_loads(text);
+    if (ini)
+    {
+        for (i = 0; i < ini_section_count(ini); i++)
+        {
+            section = ini_section_name(ini, i);
+            for (k = 0; k < ini_pair_count(ini, section); k++) ini_get_value(ini, section, ini_key_name(ini, section, k));
+        }
+        out = ini_dumps(ini, 0, &len);
+        if (out)
+        {
+            again = ini_loads(out);
+            if (!again) abort();
+            ini_delete(again);
+            free(out);
+        }
+        ini_delete(ini);
+    }
+
+    /* The text is modified in place and kept by the ini */
+    ini_delete(ini_loads_insitu(text, NULL));
+
+    free(text);
+    return 0;
+}
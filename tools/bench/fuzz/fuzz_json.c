@@ -0,0 +1,59 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_json.c
+ *         \unit  bench
+ *        \brief  libFuzzer harness of json, load, dump and load again, query and cbor
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fuzz.h"
+#include "json.h"
+
+static int count(void* context, json_t json)
+{
+    (void)json;
+    (*(int*)context)++;
+    return 1;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static json_path_t path = NULL;
+    char* text = fuzz_text(data, size);
+    char* out;
+    void* cbor;
+    json_t json, again;
+    int len, hits = 0;
+
+    if (!text) return 0;
+    if (!path) path = json_path_compile("$.*[*].name");
+
+    json = json_loads(text);
+    if (json)
+    {
+        /* What was dumped must load again */
+        out = json_dumps(json, 0, 0, &len);
+        if (out)
+        {
+            again = json_loads(out);
+            if (!again) abort();
+            json_delete(again);
+            free(out);
+        }
+        cbor = json_cbor_dumps(json, 0, &len);
+        if (cbor)
+        {
+            json_delete(json_cbor_loads(cbor, len));
+            free(cbor);
+        }
+        json_path_query(json, path, count, &hits);
+        json_delete(json);
+    }
+
+    free(text);
+    return 0;
+}
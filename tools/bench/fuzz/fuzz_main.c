@@ -0,0 +1,50 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_main.c
+ *         \unit  bench
+ *        \brief  Replay of the harnesses on files, for the compilers without libFuzzer
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include "fuzz.h"
+
+/* Linked instead of libFuzzer, each file given is one input, for reproducing a crash
+ * or running the corpus under the sanitizers of gcc.
+ */
+int main(int argc, char* argv[])
+{
+    FILE* f;
+    uint8_t* data;
+    long size;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        f = fopen(argv[i], "rb");
+        if (!f)
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        data = (uint8_t*)malloc(size ? size : 1);
+        if (!data || fread(data, 1, size, f) != (size_t)size)
+        {
+            fclose(f);
+            free(data);
+            return 1;
+        }
+        fclose(f);
+        LLVMFuzzerTestOneInput(data, size);
+        free(data);
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_txls.c
+ *         \unit  bench
+ *        \brief  libFuzzer harness of txls, load, dump plain and neat and load again, query
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fuzz.h"
+#include "txls.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    char* text = fuzz_text(data, size);
+    char* out;
+    txls_t txls, again;
+    unsigned int row, col;
+    int neat, len;
+
+    if (!text) return 0;
+
+    txls = txls_loads(text);
+    if (txls)
+    {
+        for (row = 0; row <= txls_row(txls); row++)
+        {
+            for (col = 1; col <= txls_col(txls); col++) txls_get_text(txls, col, row);
+        }
+        for (neat = 0; neat < 2; neat++)
+        {
+            out = txls_dumps(txls, neat, &len);
+            if (!out) continue;
+            again = txls_loads(out);
+            if (!again) abort();
+            txls_delete(again);
+            free(out);
+        }
+        txls_delete(txls);
+    }
+
+    free(text);
+    return 0;
+}
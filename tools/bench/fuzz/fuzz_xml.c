@@ -0,0 +1,63 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  fuzz_xml.c
+ *         \unit  bench
+ *        \brief  libFuzzer harness of xml, load, dump and load again, query, pull events
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include "fuzz.h"
+#include "xml.h"
+
+static int count(void* context, xml_t xml, const char* value)
+{
+    (void)xml;
+    (void)value;
+    (*(int*)context)++;
+    return 1;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static xml_path_t path = NULL;
+    char* text = fuzz_text(data, size);
+    char* out;
+    char names[256];
+    XML_READER reader;
+    XML_EVENT event;
+    xml_t xml, again;
+    int len, type, hits = 0;
+
+    if (!text) return 0;
+    if (!path) path = xml_path_compile("*/*[1]/@id");
+
+    xml = xml_loads(text);
+    if (xml)
+    {
+        out = xml_dumps(xml, 0, 0, &len);
+        if (out)
+        {
+            again = xml_loads(out);
+            if (!again) abort();
+            xml_delete(again);
+            free(out);
+        }
+        xml_path_query(xml, path, count, &hits);
+        xml_delete(xml);
+    }
+
+    /* The reader runs over the same text without the tree */
+    xml_reader_init(&reader, text, names, sizeof(names));
+    do {
+        type = xml_read_event(&reader, &event);
+    } while (type > XML_EVENT_DONE && type != XML_EVENT_MORE);
+    xml_reader_init(&reader, text, names, sizeof(names));
+    xml_path_read(&reader, path, NULL, NULL);
+
+    free(text);
+    return 0;
+}
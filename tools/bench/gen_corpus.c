@@ -0,0 +1,246 @@
+/*********************************************************************************************************
+ *  ------------------------------------------------------------------------------------------------------
+ *  file description
+ *  ------------------------------------------------------------------------------------------------------
+ *         \file  gen_corpus.c
+ *         \unit  bench
+ *        \brief  Generate the benchmark corpus of the parsers, json, csv, ini, xml and txls
+ *       \author  Lamdonn
+ *      \version  v1.0.0
+ *      \license  GPL-2.0
+ *    \copyright  Copyright (C) 2023 Lamdonn.
+ ********************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Every format is generated in 8 variants, `<format>_<size>_<shape>_<kind>.<ext>`
+ *
+ * size:  small of about 4 KiB, large of the size given on the command line, 4 MiB by default
+ * shape: deep, nested nodes for json and xml, many rows or sections of few cells for the flat formats
+ *        wide, many siblings for json and xml, many columns or keys for the flat formats
+ * kind:  num, the values are integers and floats
+ *        str, the values are strings with escapes
+ *
+ * The documents are built so `bench.c` runs the same queries on all the variants of a format.
+ */
+
+#define SMALL_SIZE                          (4 * 1024)
+#define LARGE_SIZE                          (4 * 1024 * 1024)
+#define DEEP_LEVEL                          64
+
+static unsigned long seed = 1;
+
+/* fixed pseudo random numbers, so the corpus is the same on every run */
+static unsigned long rnd(void)
+{
+    seed = seed * 1103515245UL + 12345UL;
+    return (seed >> 16) & 0x7FFF;
+}
+
+/* a number value, integer or float of various exponents */
+static void put_number(FILE *f, unsigned long n)
+{
+    switch (n % 4)
+    {
+    case 0: fprintf(f, "%lu", rnd() * 7919UL); break;
+    case 1: fprintf(f, "-%lu", rnd()); break;
+    case 2: fprintf(f, "%.6g", (double)rnd() / 37.0); break;
+    default: fprintf(f, "%.17g", (double)rnd() * 1.0e-5 + 1.0e10); break;
+    }
+}
+
+/* words of the string values */
+static const char *words[] = { "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel" };
+#define WORD()                              words[rnd() % (sizeof(words) / sizeof(words[0]))]
+
+static void json_item(FILE *f, unsigned long i, int kind)
+{
+    int k;
+    if (kind)
+    {
+        fprintf(f, "{\"name\":\"item-%lu\",\"text\":[", i);
+        for (k = 0; k < 4; k++) fprintf(f, "%s\"%s \\\"%s\\\"\\t%s\\u00e9\"", k ? "," : "", WORD(), WORD(), WORD());
+        fputs("]", f);
+    }
+    else
+    {
+        fprintf(f, "{\"name\":%lu,\"values\":[", i);
+        for (k = 0; k < 8; k++) { if (k) fputc(',', f); put_number(f, i + k); }
+        fputs("]", f);
+    }
+}
+
+static void gen_json(FILE *f, long size, int deep, int kind)
+{
+    unsigned long i = 0;
+    int level;
+    fputs("{\"items\":[", f);
+    while (ftell(f) < size)
+    {
+        if (i) fputc(',', f);
+        if (deep)
+        {
+            for (level = 0; level < DEEP_LEVEL; level++) { json_item(f, i++, kind); fputs(",\"items\":[", f); }
+            for (level = 0; level < DEEP_LEVEL; level++) fputs("]}", f);
+        }
+        else
+        {
+            json_item(f, i++, kind);
+            fputc('}', f);
+        }
+    }
+    fputs("]}\n", f);
+}
+
+static void xml_item(FILE *f, unsigned long i, int kind)
+{
+    int k;
+    fprintf(f, "<item id=\"%lu\" name=\"", i);
+    if (kind) fprintf(f, "%s &amp; %s\">", WORD(), WORD());
+    else { put_number(f, i); fputs("\">", f); }
+    for (k = 0; k < 4; k++)
+    {
+        if (k) fputc(' ', f);
+        if (kind) fprintf(f, "%s &lt;%s&gt;", WORD(), WORD());
+        else put_number(f, i + k);
+    }
+}
+
+static void gen_xml(FILE *f, long size, int deep, int kind)
+{
+    unsigned long i = 0;
+    int level;
+    fputs("<?xml version=\"1.0\"?>\n<root>\n", f);
+    while (ftell(f) < size)
+    {
+        if (deep)
+        {
+            for (level = 0; level < DEEP_LEVEL; level++) xml_item(f, i++, kind);
+            for (level = 0; level < DEEP_LEVEL; level++) fputs("</item>", f);
+            fputc('\n', f);
+        }
+        else
+        {
+            xml_item(f, i++, kind);
+            fputs("</item>\n", f);
+        }
+    }
+    fputs("</root>\n", f);
+}
+
+static void gen_csv(FILE *f, long size, int deep, int kind)
+{
+    int cols = deep ? 4 : 64, c;
+    unsigned long r = 0;
+    while (ftell(f) < size)
+    {
+        for (c = 0; c < cols; c++)
+        {
+            if (c) fputc(',', f);
+            if (kind) fprintf(f, "\"%s, \"\"%s\"\" %s\"", WORD(), WORD(), WORD());
+            else put_number(f, r + c);
+        }
+        fputc('\n', f);
+        r++;
+    }
+}
+
+static void gen_ini(FILE *f, long size, int deep, int kind)
+{
+    int keys = deep ? 4 : 256, k;
+    unsigned long s = 0;
+    while (ftell(f) < size)
+    {
+        fprintf(f, "[s%lu]\n", s);
+        for (k = 0; k < keys; k++)
+        {
+            fprintf(f, "k%d = ", k);
+            if (kind) fprintf(f, "%s %s %s", WORD(), WORD(), WORD());
+            else put_number(f, s + k);
+            fputc('\n', f);
+        }
+        fputc('\n', f);
+        s++;
+    }
+}
+
+static void gen_txls(FILE *f, long size, int deep, int kind)
+{
+    int cols = deep ? 3 : 32, c;
+    unsigned long r = 0;
+    for (c = 0; c < cols; c++) fprintf(f, "| c%d ", c);
+    fputs("|\n", f);
+    for (c = 0; c < cols; c++) fputs("| --- ", f);
+    fputs("|\n", f);
+    while (ftell(f) < size)
+    {
+        for (c = 0; c < cols; c++)
+        {
+            fputs("| ", f);
+            if (kind) fprintf(f, "%s %s", WORD(), WORD());
+            else put_number(f, r + c);
+            fputc(' ', f);
+        }
+        fputs("|\n", f);
+        r++;
+    }
+}
+
+static const struct
+{
+    const char *name;
+    const char *ext;
+    void (*gen)(FILE *f, long size, int deep, int kind);
+} formats[] = {
+    { "json", "json", gen_json },
+    { "csv", "csv", gen_csv },
+    { "ini", "ini", gen_ini },
+    { "xml", "xml", gen_xml },
+    { "txls", "md", gen_txls },
+};
+
+int main(int argc, char *argv[])
+{
+    char path[1024];
+    long large = LARGE_SIZE, size;
+    unsigned int i;
+    int big, deep, kind;
+    FILE *f;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <dir> [large size in bytes]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) large = atol(argv[2]);
+    if (large < SMALL_SIZE) large = SMALL_SIZE;
+
+    for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+    {
+        for (big = 0; big < 2; big++)
+        {
+            for (deep = 0; deep < 2; deep++)
+            {
+                for (kind = 0; kind < 2; kind++)
+                {
+                    snprintf(path, sizeof(path), "%s/%s_%s_%s_%s.%s", argv[1], formats[i].name,
+                        big ? "large" : "small", deep ? "deep" : "wide", kind ? "str" : "num", formats[i].ext);
+                    f = fopen(path, "wb");
+                    if (!f)
+                    {
+                        perror(path);
+                        return 1;
+                    }
+                    seed = 1 + i * 8 + big * 4 + deep * 2 + kind;
+                    size = big ? large : SMALL_SIZE;
+                    formats[i].gen(f, size, deep, kind);
+                    fclose(f);
+                    printf("%s\n", path);
+                }
+            }
+        }
+    }
+
+    return 0;
+}